@@ -2,8 +2,12 @@
 #ifndef CLI_CONFIG_HPP
 #define CLI_CONFIG_HPP
 
+#include <chrono>
+#include <cstdio>
+#include <ctime>
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include "core/app/application.hpp"
 
@@ -21,6 +25,22 @@ inline auto DbCreated(const std::string& db_name) -> std::string {
   return "成功创建并切换到数据库: " + db_name;
 }
 
+// 列出前若干个 ID，批量结果过长时截断
+inline auto JoinIds(const IdList& ids) -> std::string {
+  constexpr size_t kMaxListed = 10;
+  std::string text;
+  for (size_t i = 0; i < ids.Size() && i < kMaxListed; ++i) {
+    if (i > 0) {
+      text += ", ";
+    }
+    text += ids[i];
+  }
+  if (ids.Size() > kMaxListed) {
+    text += " 等" + std::to_string(ids.Size()) + "个";
+  }
+  return text;
+}
+
 inline auto AddCompleted(const AddResult& result) -> std::string {
   std::string msg = "在 [" + result.target_db_name + "] 中添加完成。 ";
   msg += "成功: " + std::to_string(result.success_count) + "个。 ";
@@ -40,23 +60,221 @@ inline auto QueryCompleted(const QueryResult& result) -> std::string {
     msg += "未找到: " + std::to_string(result.not_found_count) + "个。 ";
   }
   if (result.invalid_format_count > 0) {
-    msg += "格式错误: " + std::to_string(result.invalid_format_count) + "个。";
+    msg += "格式错误: " + std::to_string(result.invalid_format_count) + "个。 ";
+  }
+  if (!result.found_ids.Empty()) {
+    msg += "命中: " + JoinIds(result.found_ids);
+  }
+  if (result.cancelled) {
+    msg += " (已取消，其余 ID 未查询)";
   }
   return msg;
 }
 
+inline auto CrossQueryCompleted(const CrossQueryResult& result) -> std::string {
+  std::string msg = "在 " + std::to_string(result.databases.size()) +
+                    " 个库中查询完成。 ";
+  msg += "存在: " + std::to_string(result.found_count) + "个。 ";
+  if (result.not_found_count > 0) {
+    msg += "均未找到: " + std::to_string(result.not_found_count) + "个。 ";
+  }
+  if (result.invalid_format_count > 0) {
+    msg += "格式错误: " + std::to_string(result.invalid_format_count) + "个。 ";
+  }
+  std::vector<size_t> per_db(result.databases.size(), 0);
+  for (const uint32_t db : result.hit_databases) {
+    ++per_db[db];
+  }
+  std::string hits;
+  for (size_t d = 0; d < per_db.size(); ++d) {
+    if (per_db[d] > 0) {
+      hits += (hits.empty() ? "" : ", ") + result.databases[d] + " " +
+              std::to_string(per_db[d]);
+    }
+  }
+  if (!hits.empty()) {
+    msg += "各库命中: " + hits;
+  }
+  return msg;
+}
+
+inline auto SetOperationCompleted(const SetOperationResult& result)
+    -> std::string {
+  std::string msg;
+  switch (result.operation) {
+    case SetOperation::kUnion:
+      msg = "并集";
+      break;
+    case SetOperation::kIntersect:
+      msg = "交集";
+      break;
+    case SetOperation::kDifference:
+      msg = "差集";
+      break;
+  }
+  std::string inputs;
+  for (size_t i = 0; i < result.inputs.size(); ++i) {
+    inputs += (inputs.empty() ? "" : ", ") + result.inputs[i];
+    if (i < result.input_counts.size()) {
+      inputs += " " + std::to_string(result.input_counts[i]);
+    }
+  }
+  msg += "运算完成 (" + inputs + ")。 ";
+  msg += "写入 " + std::to_string(result.output_count) + " 个 ID 到 " +
+         (result.to_file ? "文件 " : "新库 ") + result.target + "。";
+  return msg;
+}
+
 inline auto ImportCompleted(const ImportResult& result) -> std::string {
   std::string msg = "从文件导入到 [" + result.target_db_name + "] 完成。 ";
   msg += "成功: " + std::to_string(result.success_count) + "。 ";
   if (result.exist_count > 0) {
     msg += "已存在: " + std::to_string(result.exist_count) + "。 ";
   }
+  if (result.duplicate_count > 0) {
+    msg += "文件内重复: " + std::to_string(result.duplicate_count) + "。 ";
+  }
   if (result.invalid_format_count > 0) {
     msg += "格式错误: " + std::to_string(result.invalid_format_count) + "。";
   }
+  if (result.cancelled) {
+    msg += " (已取消，已导入的部分已保存)";
+  }
+  return msg;
+}
+
+// 导入中途写入失败：已提交的部分保留在库中
+inline auto ImportFailed(const ImportResult& result) -> std::string {
+  std::string msg = "错误：导入到 [" + result.target_db_name +
+                    "] 时写入数据库失败（磁盘已满、库被锁定或读写出错）。";
+  msg += " 已保存: 成功 " + std::to_string(result.success_count) + "，已存在 " +
+         std::to_string(result.exist_count) + "。";
+  return msg;
+}
+
+inline auto ExportCompleted(const ExportResult& result) -> std::string {
+  if (result.cancelled) {
+    return "已取消从 [" + result.target_db_name +
+           "] 导出，不完整的文件已删除: " + result.filepath;
+  }
+  return "已从 [" + result.target_db_name + "] 导出 " +
+         std::to_string(result.exported_count) +
+         " 条，文件路径: " + result.filepath;
+}
+
+inline auto CheckCompleted(const CheckResult& result) -> std::string {
+  std::string msg = "已对照 [" + result.target_db_name + "] 核对完成（";
+  msg += result.merge_join ? "归并连接" : "逐块查询";
+  msg += "）。 新: " + std::to_string(result.new_count) + "。 ";
+  msg += "已有: " + std::to_string(result.owned_count) + "。 ";
+  if (result.duplicate_count > 0) {
+    msg += "文件内重复: " + std::to_string(result.duplicate_count) + "。 ";
+  }
+  if (result.invalid_format_count > 0) {
+    msg += "格式错误: " + std::to_string(result.invalid_format_count) + "。 ";
+  }
+  msg += "输出目录: " + result.output_dir;
+  if (result.cancelled) {
+    msg += " (已取消，输出文件不完整)";
+  }
+  return msg;
+}
+
+inline auto DbMigrated(const std::string& db_name,
+                       const LayoutMigrationReport& result) -> std::string {
+  constexpr double kMiB = 1024.0 * 1024.0;
+  char sizes[96];
+  std::snprintf(sizes, sizeof(sizes), "%.1f MiB -> %.1f MiB",
+                static_cast<double>(result.bytes_before) / kMiB,
+                static_cast<double>(result.bytes_after) / kMiB);
+  return "已将 [" + db_name + "] 迁移为紧凑存储格式。 记录: " +
+         std::to_string(result.migrated_count) + "。 文件大小: " + sizes;
+}
+
+inline auto EngineStats(const RepositoryStats& stats) -> std::string {
+  std::string msg = "查询引擎: " + stats.engine;
+  if (stats.memory_bytes > 0) {
+    char detail[96];
+    std::snprintf(detail, sizeof(detail), " (载入 %.1f ms, 内存 %.1f MiB)",
+                  stats.load_ms,
+                  static_cast<double>(stats.memory_bytes) / (1024.0 * 1024.0));
+    msg += detail;
+  }
+  const FilterStats& filter = stats.filter;
+  if (filter.stale) {
+    msg += " | 过滤器已过期，请重建";
+  } else if (filter.loaded) {
+    char detail[160];
+    std::snprintf(detail, sizeof(detail),
+                  " | 过滤器: 误判率 %.2f%%, %.1f MiB, 查询 %llu 次, "
+                  "拦截 %llu 次, 误判 %llu 次",
+                  filter.false_positive_rate * 100.0,
+                  static_cast<double>(filter.memory_bytes) / (1024.0 * 1024.0),
+                  static_cast<unsigned long long>(filter.lookups),
+                  static_cast<unsigned long long>(filter.rejected),
+                  static_cast<unsigned long long>(filter.false_positives));
+    msg += detail;
+  }
   return msg;
 }
 
+inline auto MemoryStats(const CatalogMemoryStats& stats) -> std::string {
+  char detail[256];
+  std::snprintf(detail, sizeof(detail),
+                "连接内存: %.1f / %.1f MiB (已打开 %zu 个库, 每连接缓存 "
+                "%.1f MiB, 已回收 %llu 个连接)",
+                static_cast<double>(stats.used_bytes) / (1024.0 * 1024.0),
+                static_cast<double>(stats.budget_bytes) / (1024.0 * 1024.0),
+                stats.open_databases.size(),
+                static_cast<double>(stats.cache_bytes_per_connection) /
+                    (1024.0 * 1024.0),
+                static_cast<unsigned long long>(stats.evictions));
+  return detail;
+}
+
+// 库清单中的一项：名称、记录数、文件大小与修改时间
+inline auto DatabaseLabel(const DatabaseInfo& info) -> std::string {
+  char count[32] = "?";
+  if (info.record_count) {
+    std::snprintf(count, sizeof(count), "%zu", *info.record_count);
+  }
+  char modified[32] = "";
+  const std::time_t seconds =
+      std::chrono::system_clock::to_time_t(info.modified);
+  if (const std::tm* local = std::localtime(&seconds)) {
+    std::strftime(modified, sizeof(modified), "%Y-%m-%d %H:%M", local);
+  }
+  char detail[128];
+  std::snprintf(detail, sizeof(detail), " (%s 条, %.1f MiB, %s)", count,
+                static_cast<double>(info.size_bytes) / (1024.0 * 1024.0),
+                modified);
+  return info.name + detail;
+}
+
+// 长任务执行期间覆盖刷新的一行进度；fraction 为负表示总量未知
+inline auto JobProgressLine(size_t rows, double rows_per_second,
+                            double fraction) -> std::string {
+  char line[96];
+  if (fraction < 0.0) {
+    std::snprintf(line, sizeof(line), "已处理 %zu 行 (%.0f 行/秒)", rows,
+                  rows_per_second);
+  } else {
+    std::snprintf(line, sizeof(line), "%5.1f%%  已处理 %zu 行 (%.0f 行/秒)",
+                  fraction * 100.0, rows, rows_per_second);
+  }
+  return line;
+}
+
+inline auto FilterRebuilt(const std::string& db_name,
+                          const RepositoryStats& stats) -> std::string {
+  return "已重建 [" + db_name + "] 的负查询过滤器。 " + EngineStats(stats);
+}
+
+inline auto EngineSwitched(const std::string& db_name,
+                           const RepositoryStats& stats) -> std::string {
+  return "[" + db_name + "] " + EngineStats(stats);
+}
+
 // --- Error messages ---
 constexpr std::string_view kErrorDbNotExist = "错误：目标数据库不存在。";
 constexpr std::string_view kErrorDbCreateFailed = "错误：创建数据库文件失败。";
@@ -68,6 +286,53 @@ constexpr std::string_view kErrorQueryIdEmpty = "提示：请输入要查询的
 constexpr std::string_view kErrorIdInvalid = "错误：无效的选项或格式。";
 constexpr std::string_view kErrorFileOpenFailed = "错误：无法打开指定的文件。";
 constexpr std::string_view kErrorFileEmpty = "提示：文件为空或只包含空行。";
+constexpr std::string_view kErrorDbMigrateFailed =
+    "错误：迁移到紧凑存储格式失败，原库未改动。";
+constexpr std::string_view kErrorEngineSwitchFailed =
+    "错误：切换查询引擎失败，已保持原引擎。";
+constexpr std::string_view kErrorFilterRebuildFailed =
+    "错误：当前库的存储格式不支持过滤器，或重建失败。";
+constexpr std::string_view kErrorDbReadOnly =
+    "错误：当前库以只读快照方式打开，请先切换回其他查询引擎再写入。";
+constexpr std::string_view kErrorFileWriteFailed =
+    "错误：写入文件失败（磁盘已满或文件被占用），导出的文件不完整。";
+constexpr std::string_view kErrorCrossQueryFailed =
+    "错误：跨库查询时读取数据库失败。";
+constexpr std::string_view kErrorSetInputsInvalid =
+    "错误：集合运算至少需要两个互不相同的库。";
+constexpr std::string_view kErrorSetOperationFailed =
+    "错误：集合运算时读取或写入数据库失败。";
+
+// --- 脚本模式 ---
+constexpr std::string_view kScriptUsage =
+    "用法: MyAVLib_Cmd [--db <库名>] [--memory-budget <MiB>] <命令> "
+    "[参数...]\n"
+    "  add [ID...]       添加 ID；未给出 ID 时从标准输入逐行读取\n"
+    "  query [ID...]     查询 ID；未给出 ID 时从标准输入逐行读取\n"
+    "  query-all [ID...] 在数据目录下的全部库中并行查询，输入方式同 query\n"
+    "  import [--sorted [--sort-memory <MiB>]] <文件>\n"
+    "                    从 .txt 文件批量导入；--sorted 先排序去重再按键序\n"
+    "                    写入，内存受 --sort-memory 限制，超出部分暂存到磁盘\n"
+    "  check [--lookup|--merge-join] <文件> [输出目录]\n"
+    "                    核对候选清单，不修改库；在输出目录写出 new.txt\n"
+    "                    (库中没有)、owned.txt (已有) 与 invalid.txt\n"
+    "                    (格式错误)，默认按候选规模自动选择比对方式\n"
+    "  export <文件>     导出当前库全部 ID\n"
+    "  stats             输出当前库状态\n"
+    "  list              列出数据目录下的库: 记录数、字节数、修改时间\n"
+    "  overlap           输出各库 ID 数及全部库的并集、交集大小\n"
+    "  union|intersect|difference <库> <库> [库...] (--to-db <新库名> | "
+    "--to-file <文件>)\n"
+    "                    在库之间流式求并集/交集/差集（第一个库减其余库）\n"
+    "  serve [套接字]    常驻内存，在 Unix 域套接字上提供查询服务（仅 Linux）\n"
+    "不带参数运行时进入交互菜单。\n"
+    "add/query 每个输入输出一行: <状态>\\t<原始输入>，\n"
+    "状态为 added/exists/found/missing/invalid；\n"
+    "query-all 的 found 行另有一列以逗号分隔的命中库名；\n"
+    "出错时向标准错误输出并返回非零。\n";
+constexpr std::string_view kErrorUnknownCommand = "错误：未知命令或参数不足。";
+constexpr std::string_view kErrorServeUnsupported =
+    "错误：当前平台不支持常驻服务模式。";
 }  // namespace CLIConfig::Messages
 
 #endif
@@ -33,6 +33,24 @@ class CLIPresenter {
           return std::string(CLIConfig::Messages::kErrorFileOpenFailed);
         case ErrorCode::kFileEmpty:
           return std::string(CLIConfig::Messages::kErrorFileEmpty);
+        case ErrorCode::kDbMigrateFailed:
+          return std::string(CLIConfig::Messages::kErrorDbMigrateFailed);
+        case ErrorCode::kEngineSwitchFailed:
+          return std::string(CLIConfig::Messages::kErrorEngineSwitchFailed);
+        case ErrorCode::kFilterRebuildFailed:
+          return std::string(CLIConfig::Messages::kErrorFilterRebuildFailed);
+        case ErrorCode::kDbReadOnly:
+          return std::string(CLIConfig::Messages::kErrorDbReadOnly);
+        case ErrorCode::kFileWriteFailed:
+          return std::string(CLIConfig::Messages::kErrorFileWriteFailed);
+        case ErrorCode::kCrossQueryFailed:
+          return std::string(CLIConfig::Messages::kErrorCrossQueryFailed);
+        case ErrorCode::kSetInputsInvalid:
+          return std::string(CLIConfig::Messages::kErrorSetInputsInvalid);
+        case ErrorCode::kSetOperationFailed:
+          return std::string(CLIConfig::Messages::kErrorSetOperationFailed);
+        case ErrorCode::kImportFailed:
+          return CLIConfig::Messages::ImportFailed(app.GetLastImportResult());
         case ErrorCode::kNone:
           return std::string(CLIConfig::Messages::kUnknownError);
       }
@@ -53,8 +71,27 @@ class CLIPresenter {
         return CLIConfig::Messages::AddCompleted(app.GetLastAddResult());
       case ResultCode::kQueryCompleted:
         return CLIConfig::Messages::QueryCompleted(app.GetLastQueryResult());
+      case ResultCode::kCrossQueryCompleted:
+        return CLIConfig::Messages::CrossQueryCompleted(
+            app.GetLastCrossQueryResult());
+      case ResultCode::kSetOperationCompleted:
+        return CLIConfig::Messages::SetOperationCompleted(
+            app.GetLastSetOperationResult());
       case ResultCode::kImportCompleted:
         return CLIConfig::Messages::ImportCompleted(app.GetLastImportResult());
+      case ResultCode::kExportCompleted:
+        return CLIConfig::Messages::ExportCompleted(app.GetLastExportResult());
+      case ResultCode::kCheckCompleted:
+        return CLIConfig::Messages::CheckCompleted(app.GetLastCheckResult());
+      case ResultCode::kDbMigrated:
+        return CLIConfig::Messages::DbMigrated(app.GetCurrentDbName(),
+                                             app.GetLastMigrationResult());
+      case ResultCode::kEngineSwitched:
+        return CLIConfig::Messages::EngineSwitched(app.GetCurrentDbName(),
+                                                 app.GetRepositoryStats());
+      case ResultCode::kFilterRebuilt:
+        return CLIConfig::Messages::FilterRebuilt(app.GetCurrentDbName(),
+                                                app.GetRepositoryStats());
     }
 
     return std::string(CLIConfig::Messages::kUnknownError);
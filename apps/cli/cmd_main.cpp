@@ -1,14 +1,30 @@
 // cmd_main.cpp
 #include <memory>
+#include <string_view>
+#include <vector>
 
 #include "apps/cli/framework/cli_app.hpp"
+#include "apps/cli/framework/cli_script.hpp"
 #include "core/app/application.hpp"
 #include "core/infrastructure/database_manager.hpp"
 
-int main() {
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+int main(int argc, char** argv) {
+#ifdef _WIN32
+  SetConsoleOutputCP(CP_UTF8);
+#endif
+
   Application app(std::make_unique<DatabaseManager>());
+  // 带参数时以脚本模式执行单条命令，否则进入交互菜单
+  if (argc > 1) {
+    const std::vector<std::string_view> args(argv + 1, argv + argc);
+    CLIScript script(app);
+    return script.Run(args);
+  }
   CLIApp cli(app);
   cli.Run();
   return 0;
 }
-
@@ -1,24 +1,32 @@
 // apps/cli/framework/cli_app.cpp
 #include "apps/cli/framework/cli_app.hpp"
 
-#include <cstdlib>
+#include <cstdio>
 #include <iostream>
 #include <limits>
 
 #include "apps/cli/cli_presenter.hpp"
 
 #ifdef _WIN32
+#include <io.h>
 #include <windows.h>
+#else
+#include <unistd.h>
 #endif
 
 CLIApp::CLIApp(Application& app) : app_(app), commands_(app) {}
 
 void CLIApp::clear_screen() {
+  // 直接输出 ANSI 清屏序列，不再每轮 fork 一个 clear 进程；
+  // 输出被重定向时不写控制字符
 #ifdef _WIN32
-  system("cls");
+  const bool is_tty = _isatty(_fileno(stdout)) != 0;
 #else
-  system("clear");
+  const bool is_tty = isatty(fileno(stdout)) != 0;
 #endif
+  if (is_tty) {
+    std::cout << "\x1b[H\x1b[2J\x1b[3J" << std::flush;
+  }
 }
 
 void CLIApp::print_status_message() {
@@ -37,6 +45,12 @@ void CLIApp::print_menu(const std::string& current_db) {
   std::cout << "6. 查看当前库状态" << std::endl;
   std::cout << "7. 查看当前版本" << std::endl;
   std::cout << "8. 导出当前库到 .txt" << std::endl;
+  std::cout << "9. 将当前库迁移为紧凑存储格式" << std::endl;
+  std::cout << "10. 切换当前库的查询引擎 (SQLite / 内存哈希索引 / 只读快照)" << std::endl;
+  std::cout << "11. 重建当前库的负查询过滤器" << std::endl;
+  std::cout << "12. 在全部数据库中查询 (可批量, 用空格隔开)" << std::endl;
+  std::cout << "13. 库间集合运算 (并集 / 交集 / 差集)" << std::endl;
+  std::cout << "14. 核对 .txt 候选清单 (分为新 / 已有 / 格式错误)" << std::endl;
   std::cout << "0. 退出" << std::endl;
   std::cout << "请输入选项: ";
 }
@@ -47,7 +61,12 @@ void CLIApp::clear_cin() {
 
 void CLIApp::Run() {
 #ifdef _WIN32
-  SetConsoleOutputCP(CP_UTF8);
+  // 让 Windows 控制台解释 ANSI 转义序列
+  HANDLE console = GetStdHandle(STD_OUTPUT_HANDLE);
+  DWORD mode = 0;
+  if (GetConsoleMode(console, &mode)) {
+    SetConsoleMode(console, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+  }
 #endif
 
   app_.LoadDatabase();
@@ -108,6 +127,30 @@ void CLIApp::Run() {
         std::getline(std::cin, input_buffer);
         commands_.ExportToFile(input_buffer);
         break;
+      case 9:
+        commands_.MigrateToPackedLayout();
+        break;
+      case 10:
+        commands_.ToggleQueryEngine();
+        break;
+      case 11:
+        std::cout << "输入目标误判率 (留空则 0.01): ";
+        std::getline(std::cin, input_buffer);
+        commands_.RebuildFilter(input_buffer);
+        break;
+      case 12:
+        std::cout << "输入要在全部库中查询的内容: ";
+        std::getline(std::cin, input_buffer);
+        commands_.QueryAllDatabases(input_buffer);
+        break;
+      case 13:
+        commands_.CombineDatabases();
+        break;
+      case 14:
+        std::cout << "输入候选清单 .txt 文件路径: ";
+        std::getline(std::cin, input_buffer);
+        commands_.CheckFile(input_buffer);
+        break;
       case 0:
         clear_screen();
         std::cout << "程序退出。" << std::endl;
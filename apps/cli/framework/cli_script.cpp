@@ -0,0 +1,509 @@
+// apps/cli/framework/cli_script.cpp
+#include "apps/cli/framework/cli_script.hpp"
+
+#include <charconv>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "apps/cli/cli_config.hpp"
+#include "apps/cli/cli_presenter.hpp"
+#include "core/io/mapped_text_reader.hpp"
+#include "core/service/unix_socket_server.hpp"
+
+namespace {
+constexpr size_t kReadChunkBytes = 1 << 20;
+constexpr size_t kBatchLines = 4096;
+
+// 从标准输入按块读取，每次交出至多 kBatchLines 行，
+// 去掉行首尾的空格、制表符和 \r。
+// 批内各行只记偏移，整批读完后再生成视图，避免缓冲区扩容使视图失效
+class StdinLineBatcher {
+ public:
+  explicit StdinLineBatcher(std::FILE* input) : input_(input) {}
+
+  // 输入耗尽且没有剩余行时返回 false；视图在下次调用前有效
+  auto Next(std::vector<std::string_view>& lines) -> bool {
+    buffer_.erase(0, pos_);
+    pos_ = 0;
+    ranges_.clear();
+    while (ranges_.size() < kBatchLines) {
+      const size_t newline = buffer_.find('\n', pos_);
+      if (newline != std::string::npos) {
+        ranges_.emplace_back(pos_, newline);
+        pos_ = newline + 1;
+        continue;
+      }
+      if (!eof_ && Fill()) {
+        continue;
+      }
+      // 最后一行可能没有换行符
+      if (pos_ < buffer_.size()) {
+        ranges_.emplace_back(pos_, buffer_.size());
+        pos_ = buffer_.size();
+      }
+      break;
+    }
+
+    lines.clear();
+    for (const auto& [begin, end] : ranges_) {
+      const std::string_view line = Trim(
+          std::string_view(buffer_).substr(begin, end - begin));
+      if (!line.empty()) {
+        lines.push_back(line);
+      }
+    }
+    return !ranges_.empty();
+  }
+
+ private:
+  auto Fill() -> bool {
+    const size_t old_size = buffer_.size();
+    buffer_.resize(old_size + kReadChunkBytes);
+    const size_t read =
+        std::fread(buffer_.data() + old_size, 1, kReadChunkBytes, input_);
+    buffer_.resize(old_size + read);
+    if (read == 0) {
+      eof_ = true;
+    }
+    return read > 0;
+  }
+
+  static auto Trim(std::string_view line) -> std::string_view {
+    constexpr std::string_view kBlank = " \t\r";
+    const size_t first = line.find_first_not_of(kBlank);
+    if (first == std::string_view::npos) {
+      return {};
+    }
+    return line.substr(first, line.find_last_not_of(kBlank) - first + 1);
+  }
+
+  std::FILE* input_;
+  std::string buffer_;
+  size_t pos_ = 0;
+  bool eof_ = false;
+  std::vector<std::pair<size_t, size_t>> ranges_;
+};
+
+auto OutcomeLabel(IdOutcome outcome) -> std::string_view {
+  switch (outcome) {
+    case IdOutcome::kInvalid:
+      return "invalid";
+    case IdOutcome::kAdded:
+      return "added";
+    case IdOutcome::kExists:
+      return "exists";
+    case IdOutcome::kFound:
+      return "found";
+    case IdOutcome::kNotFound:
+      return "missing";
+    case IdOutcome::kSkipped:
+      break;
+  }
+  return {};
+}
+
+void WriteOut(std::string_view text) {
+  std::fwrite(text.data(), 1, text.size(), stdout);
+  std::fflush(stdout);
+}
+
+// 收到 SIGINT/SIGTERM 时让事件循环退出
+Service::UnixSocketServer* g_running_server = nullptr;
+
+extern "C" void StopServerOnSignal(int /*signal*/) {
+  if (g_running_server != nullptr) {
+    g_running_server->Stop();
+  }
+}
+
+auto DefaultSocketPath() -> std::string {
+  if (const char* runtime_dir = std::getenv("XDG_RUNTIME_DIR");
+      runtime_dir != nullptr && *runtime_dir != '\0') {
+    return (std::filesystem::path(runtime_dir) / "myavlib.sock").string();
+  }
+  return (std::filesystem::temp_directory_path() / "myavlib.sock").string();
+}
+
+void AppendField(std::string& out, std::string_view key,
+                 std::string_view value) {
+  out.append(key).append("\t").append(value).append("\n");
+}
+}  // namespace
+
+CLIScript::CLIScript(Application& app) : app_(app) {}
+
+auto CLIScript::Run(std::span<const std::string_view> args) -> int {
+  if (!args.empty() && (args[0] == "help" || args[0] == "--help" ||
+                        args[0] == "-h")) {
+    WriteOut(CLIConfig::Messages::kScriptUsage);
+    return kExitOk;
+  }
+
+  // 全局选项须写在命令之前
+  std::string_view db_name;
+  while (args.size() >= 2 && args[0].starts_with("--")) {
+    if (args[0] == "--db") {
+      db_name = args[1];
+    } else if (args[0] == "--memory-budget") {
+      size_t mib = 0;
+      const std::string_view value = args[1];
+      const auto [end, ec] =
+          std::from_chars(value.data(), value.data() + value.size(), mib);
+      if (ec != std::errc() || end != value.data() + value.size() ||
+          mib == 0) {
+        return ReportUsage();
+      }
+      app_.SetMemoryBudget(mib << 20);
+    } else {
+      break;
+    }
+    args = args.subspan(2);
+  }
+
+  app_.LoadDatabase();
+  if (app_.GetLastError() != ErrorCode::kNone) {
+    return ReportError();
+  }
+
+  if (!db_name.empty()) {
+    app_.SetCurrentDatabase(std::string(db_name));
+    if (app_.GetLastError() != ErrorCode::kNone) {
+      return ReportError();
+    }
+  }
+
+  if (args.empty()) {
+    return ReportUsage();
+  }
+
+  const std::string_view command = args[0];
+  const std::span<const std::string_view> rest = args.subspan(1);
+  if (command == "add" || command == "query" || command == "query-all") {
+    const IdCommand id_command = (command == "add")     ? IdCommand::kAdd
+                                 : (command == "query") ? IdCommand::kQuery
+                                                        : IdCommand::kQueryAll;
+    return rest.empty() ? RunIdsFromStdin(id_command)
+                        : RunIds(id_command, rest);
+  }
+  if (command == "import" && !rest.empty()) {
+    return RunImport(rest);
+  }
+  if (command == "check" && !rest.empty()) {
+    return RunCheck(rest);
+  }
+  if (command == "export" && rest.size() == 1) {
+    return RunExport(std::string(rest[0]));
+  }
+  if (command == "stats" && rest.empty()) {
+    return RunStats();
+  }
+  if (command == "list" && rest.empty()) {
+    return RunList();
+  }
+  if (command == "overlap" && rest.empty()) {
+    return RunCrossStats();
+  }
+  if (command == "union") {
+    return RunSetOperation(SetOperation::kUnion, rest);
+  }
+  if (command == "intersect") {
+    return RunSetOperation(SetOperation::kIntersect, rest);
+  }
+  if (command == "difference") {
+    return RunSetOperation(SetOperation::kDifference, rest);
+  }
+  if (command == "serve" && rest.size() <= 1) {
+    return RunServe(rest.empty() ? DefaultSocketPath() : std::string(rest[0]));
+  }
+
+  return ReportUsage();
+}
+
+auto CLIScript::RunIds(IdCommand command,
+                       std::span<const std::string_view> ids) -> int {
+  return ProcessBatch(command, ids) ? kExitOk : ReportError();
+}
+
+auto CLIScript::RunIdsFromStdin(IdCommand command) -> int {
+  StdinLineBatcher batcher(stdin);
+  std::vector<std::string_view> lines;
+  lines.reserve(kBatchLines);
+  while (batcher.Next(lines)) {
+    if (!lines.empty() && !ProcessBatch(command, lines)) {
+      return ReportError();
+    }
+  }
+  return kExitOk;
+}
+
+auto CLIScript::ProcessBatch(IdCommand command,
+                             std::span<const std::string_view> ids) -> bool {
+  const std::vector<IdOutcome>* outcomes = nullptr;
+  const CrossQueryResult* cross = nullptr;
+  switch (command) {
+    case IdCommand::kAdd:
+      app_.PerformAdd(ids);
+      outcomes = &app_.GetLastAddResult().outcomes;
+      break;
+    case IdCommand::kQuery:
+      app_.PerformQuery(ids);
+      outcomes = &app_.GetLastQueryResult().outcomes;
+      break;
+    case IdCommand::kQueryAll:
+      app_.PerformCrossQuery(ids);
+      cross = &app_.GetLastCrossQueryResult();
+      outcomes = &cross->outcomes;
+      break;
+  }
+  if (app_.GetLastError() != ErrorCode::kNone) {
+    return false;
+  }
+  output_.clear();
+  for (size_t i = 0; i < outcomes->size(); ++i) {
+    const std::string_view label = OutcomeLabel((*outcomes)[i]);
+    if (label.empty()) {
+      continue;
+    }
+    output_.append(label).append("\t").append(ids[i]);
+    if (cross != nullptr && (*outcomes)[i] == IdOutcome::kFound) {
+      output_.append("\t");
+      for (const uint32_t db : cross->HitsOf(i)) {
+        if (output_.back() != '\t') {
+          output_.append(",");
+        }
+        output_.append(cross->databases[db]);
+      }
+    }
+    output_.append("\n");
+  }
+  WriteOut(output_);
+  return true;
+}
+
+auto CLIScript::RunImport(std::span<const std::string_view> args) -> int {
+  ImportOptions options;
+  while (args.size() > 1 && args[0].starts_with("--")) {
+    if (args[0] == "--sorted") {
+      options.sorted_bulk_load = true;
+      args = args.subspan(1);
+    } else if (args[0] == "--sort-memory" && args.size() > 2) {
+      size_t mib = 0;
+      const std::string_view value = args[1];
+      const auto [end, ec] =
+          std::from_chars(value.data(), value.data() + value.size(), mib);
+      if (ec != std::errc() || end != value.data() + value.size() ||
+          mib == 0) {
+        return ReportUsage();
+      }
+      options.sort_memory_bytes = mib << 20;
+      args = args.subspan(2);
+    } else {
+      return ReportUsage();
+    }
+  }
+  if (args.size() != 1) {
+    return ReportUsage();
+  }
+  IO::MappedTextReader reader;
+  const ImportResult result =
+      app_.PerformImportFile(reader, std::string(args[0]), options);
+  if (app_.GetLastError() != ErrorCode::kNone) {
+    return ReportError();
+  }
+  output_.clear();
+  AppendField(output_, "added", std::to_string(result.success_count));
+  AppendField(output_, "exists", std::to_string(result.exist_count));
+  AppendField(output_, "duplicates", std::to_string(result.duplicate_count));
+  AppendField(output_, "invalid", std::to_string(result.invalid_format_count));
+  WriteOut(output_);
+  return kExitOk;
+}
+
+auto CLIScript::RunCheck(std::span<const std::string_view> args) -> int {
+  CheckOptions options;
+  if (!args.empty() && args[0] == "--lookup") {
+    options.strategy = CheckStrategy::kLookup;
+    args = args.subspan(1);
+  } else if (!args.empty() && args[0] == "--merge-join") {
+    options.strategy = CheckStrategy::kMergeJoin;
+    args = args.subspan(1);
+  }
+  if (args.empty() || args.size() > 2) {
+    return ReportUsage();
+  }
+  const std::string output_dir = args.size() == 2 ? std::string(args[1]) : ".";
+  IO::MappedTextReader reader;
+  const CheckResult result = app_.PerformCheckFile(
+      reader, std::string(args[0]), output_dir, options);
+  if (app_.GetLastError() != ErrorCode::kNone) {
+    return ReportError();
+  }
+  output_.clear();
+  AppendField(output_, "new", std::to_string(result.new_count));
+  AppendField(output_, "owned", std::to_string(result.owned_count));
+  AppendField(output_, "duplicates", std::to_string(result.duplicate_count));
+  AppendField(output_, "invalid", std::to_string(result.invalid_format_count));
+  AppendField(output_, "strategy", result.merge_join ? "merge-join" : "lookup");
+  WriteOut(output_);
+  return kExitOk;
+}
+
+auto CLIScript::RunExport(const std::string& filepath) -> int {
+  const ExportResult result = app_.PerformExport(filepath);
+  if (app_.GetLastError() != ErrorCode::kNone) {
+    return ReportError();
+  }
+  output_.clear();
+  AppendField(output_, "exported", std::to_string(result.exported_count));
+  AppendField(output_, "file", result.filepath);
+  WriteOut(output_);
+  return kExitOk;
+}
+
+auto CLIScript::RunStats() -> int {
+  const RepositoryStats stats = app_.GetRepositoryStats();
+  output_.clear();
+  AppendField(output_, "db", app_.GetCurrentDbName());
+  AppendField(output_, "records", std::to_string(app_.GetTotalRecords()));
+  AppendField(output_, "engine", stats.engine);
+  AppendField(output_, "load_ms", std::to_string(stats.load_ms));
+  AppendField(output_, "memory_bytes", std::to_string(stats.memory_bytes));
+  const CatalogMemoryStats pool = app_.GetMemoryStats();
+  AppendField(output_, "open_dbs", std::to_string(pool.open_databases.size()));
+  AppendField(output_, "pool_bytes", std::to_string(pool.used_bytes));
+  AppendField(output_, "pool_budget", std::to_string(pool.budget_bytes));
+  AppendField(output_, "cache_bytes",
+              std::to_string(pool.cache_bytes_per_connection));
+  AppendField(output_, "evictions", std::to_string(pool.evictions));
+  const FilterStats& filter = stats.filter;
+  AppendField(output_, "filter",
+              filter.stale ? "stale" : (filter.loaded ? "loaded" : "none"));
+  if (filter.loaded) {
+    AppendField(output_, "filter_fpr",
+                std::to_string(filter.false_positive_rate));
+    AppendField(output_, "filter_bytes", std::to_string(filter.memory_bytes));
+  }
+  WriteOut(output_);
+  return kExitOk;
+}
+
+auto CLIScript::RunList() -> int {
+  output_.clear();
+  for (const DatabaseInfo& info : app_.GetDatabaseListing()) {
+    const auto modified = std::chrono::duration_cast<std::chrono::seconds>(
+        info.modified.time_since_epoch());
+    output_.append("db\t").append(info.name).append("\t");
+    output_.append(info.record_count ? std::to_string(*info.record_count)
+                                     : "-");
+    output_.append("\t").append(std::to_string(info.size_bytes));
+    output_.append("\t").append(std::to_string(modified.count()));
+    output_.append("\n");
+  }
+  WriteOut(output_);
+  return kExitOk;
+}
+
+auto CLIScript::RunCrossStats() -> int {
+  const CrossDbStats stats = app_.GetCrossDbStats();
+  output_.clear();
+  for (size_t d = 0; d < stats.databases.size(); ++d) {
+    output_.append("db\t").append(stats.databases[d]).append("\t");
+    output_.append(std::to_string(stats.counts[d])).append("\n");
+  }
+  AppendField(output_, "union", std::to_string(stats.union_count));
+  AppendField(output_, "shared", std::to_string(stats.shared_count));
+  AppendField(output_, "index_bytes", std::to_string(stats.memory_bytes));
+  WriteOut(output_);
+  return kExitOk;
+}
+
+auto CLIScript::RunSetOperation(SetOperation operation,
+                                std::span<const std::string_view> args)
+    -> int {
+  if (args.size() < 4) {
+    return ReportUsage();
+  }
+  const std::string_view option = args[args.size() - 2];
+  const std::string target(args.back());
+  if (option != "--to-db" && option != "--to-file") {
+    return ReportUsage();
+  }
+  const std::vector<std::string> inputs(args.begin(), args.end() - 2);
+
+  const SetOperationResult result =
+      option == "--to-db"
+          ? app_.PerformSetOperationToDatabase(operation, inputs, target)
+          : app_.PerformSetOperationToFile(operation, inputs, target);
+  if (app_.GetLastError() != ErrorCode::kNone) {
+    return ReportError();
+  }
+  output_.clear();
+  for (size_t i = 0; i < result.inputs.size(); ++i) {
+    output_.append("input\t").append(result.inputs[i]).append("\t");
+    output_.append(std::to_string(result.input_counts[i])).append("\n");
+  }
+  AppendField(output_, "written", std::to_string(result.output_count));
+  AppendField(output_, result.to_file ? "file" : "db", result.target);
+  WriteOut(output_);
+  return kExitOk;
+}
+
+auto CLIScript::RunServe(const std::string& socket_path) -> int {
+  if (!Service::UnixSocketServer::IsSupported()) {
+    std::fprintf(stderr, "error\t%s\n",
+                 CLIConfig::Messages::kErrorServeUnsupported.data());
+    return kExitError;
+  }
+  try {
+    Service::UnixSocketServer server(app_, socket_path);
+    server.Listen();
+    output_.clear();
+    AppendField(output_, "listening", server.GetSocketPath());
+    WriteOut(output_);
+
+    g_running_server = &server;
+    std::signal(SIGINT, StopServerOnSignal);
+    std::signal(SIGTERM, StopServerOnSignal);
+    server.Run();
+    std::signal(SIGINT, SIG_DFL);
+    std::signal(SIGTERM, SIG_DFL);
+    g_running_server = nullptr;
+
+    const Service::ServiceStats stats = server.GetStats();
+    output_.clear();
+    AppendField(output_, "connections",
+                std::to_string(stats.connections_accepted));
+    AppendField(output_, "requests", std::to_string(stats.requests));
+    AppendField(output_, "batches", std::to_string(stats.batches));
+    AppendField(output_, "ids_queried", std::to_string(stats.ids_queried));
+    AppendField(output_, "ids_added", std::to_string(stats.ids_added));
+    AppendField(output_, "errors", std::to_string(stats.errors));
+    WriteOut(output_);
+  } catch (const std::exception& ex) {
+    g_running_server = nullptr;
+    std::fprintf(stderr, "error\t%s\n", ex.what());
+    return kExitError;
+  }
+  return kExitOk;
+}
+
+auto CLIScript::ReportError() -> int {
+  std::fflush(stdout);
+  const std::string message = CLIPresenter::Format(app_);
+  std::fprintf(stderr, "error\t%s\n", message.c_str());
+  return kExitError;
+}
+
+auto CLIScript::ReportUsage() -> int {
+  std::fprintf(stderr, "%s\n%s",
+               CLIConfig::Messages::kErrorUnknownCommand.data(),
+               CLIConfig::Messages::kScriptUsage.data());
+  return kExitUsage;
+}
@@ -0,0 +1,57 @@
+// apps/cli/framework/cli_script.hpp
+#ifndef CLI_SCRIPT_HPP
+#define CLI_SCRIPT_HPP
+
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "core/app/application.hpp"
+
+// 非交互的脚本模式：
+// MyAVLib_Cmd [--db <库名>] [--memory-budget <MiB>] <命令> [参数...]
+// add/query 逐个输出 "<状态>\t<原始输入>"，按批写出并刷新，便于管道处理；
+// query-all 对命中的 ID 再追加一列以逗号分隔的库名；
+// union/intersect/difference 在库之间做集合运算，结果写入新库或文件；
+// 其余命令输出 "<键>\t<值>" 形式的摘要。错误信息写到标准错误。
+class CLIScript {
+ public:
+  // 退出码：0 成功，1 执行出错，2 用法错误
+  static constexpr int kExitOk = 0;
+  static constexpr int kExitError = 1;
+  static constexpr int kExitUsage = 2;
+
+  explicit CLIScript(Application& app);
+
+  // args 不含程序名
+  auto Run(std::span<const std::string_view> args) -> int;
+
+ private:
+  enum class IdCommand { kAdd, kQuery, kQueryAll };
+
+  auto RunIds(IdCommand command, std::span<const std::string_view> ids) -> int;
+  auto RunIdsFromStdin(IdCommand command) -> int;
+  // 处理一批 ID 并把逐行结果写到标准输出；出错时返回 false
+  auto ProcessBatch(IdCommand command, std::span<const std::string_view> ids)
+      -> bool;
+  // args 为 [--sorted] [--sort-memory <MiB>] <文件>
+  auto RunImport(std::span<const std::string_view> args) -> int;
+  // args 为 [--lookup | --merge-join] <文件> [输出目录]，输出目录默认为当前目录
+  auto RunCheck(std::span<const std::string_view> args) -> int;
+  auto RunExport(const std::string& filepath) -> int;
+  auto RunStats() -> int;
+  // 每个库一行: db\t<库名>\t<记录数>\t<字节数>\t<修改时间 (Unix 秒)>
+  auto RunList() -> int;
+  auto RunCrossStats() -> int;
+  // args 为 <库> <库> [...] (--to-db <新库名> | --to-file <文件>)
+  auto RunSetOperation(SetOperation operation,
+                       std::span<const std::string_view> args) -> int;
+  auto RunServe(const std::string& socket_path) -> int;
+  auto ReportError() -> int;
+  static auto ReportUsage() -> int;
+
+  Application& app_;
+  std::string output_;  // 按批复用的输出缓冲
+};
+
+#endif
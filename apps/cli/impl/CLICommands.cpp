@@ -1,15 +1,50 @@
 // apps/cli/impl/CLICommands.cpp
 #include "apps/cli/impl/CLICommands.hpp"
 
+#include <chrono>
 #include <filesystem>
-#include <fstream>
+#include <future>
 #include <iostream>
 #include <limits>
+#include <sstream>
 #include <utility>
 
+#include "apps/cli/cli_config.hpp"
 #include "apps/cli/input_parser.hpp"
 #include "common/version.hpp"
-#include "core/io/text_file_reader.hpp"
+#include "core/data/bloom_filter.hpp"
+#include "core/io/mapped_text_reader.hpp"
+
+namespace {
+constexpr std::chrono::milliseconds kProgressInterval{500};
+
+// 等待任务结束，期间在同一行刷新进度；任务的异常在这里重新抛出
+void WaitWithProgress(Concurrency::JobHandle<void>& handle) {
+  bool printed = false;
+  while (handle.result.wait_for(kProgressInterval) !=
+         std::future_status::ready) {
+    const Concurrency::JobProgress& progress = *handle.progress;
+    std::cout << '\r'
+              << CLIConfig::Messages::JobProgressLine(
+                     progress.Rows(), progress.RowsPerSecond(),
+                     progress.Fraction())
+              << std::flush;
+    printed = true;
+  }
+  if (printed) {
+    std::cout << std::endl;
+  }
+  handle.result.get();
+}
+
+void PrintDatabaseListing(const std::vector<DatabaseInfo>& dbs) {
+  std::cout << "可用数据库:" << std::endl;
+  for (size_t i = 0; i < dbs.size(); ++i) {
+    std::cout << i + 1 << ". " << CLIConfig::Messages::DatabaseLabel(dbs[i])
+              << std::endl;
+  }
+}
+}  // namespace
 
 CLICommands::CLICommands(Application& app) : app_(app) {}
 
@@ -18,7 +53,61 @@ void CLICommands::AddIds(const std::string& input) {
 }
 
 void CLICommands::QueryId(const std::string& input) {
-  app_.PerformQuery(input);
+  app_.PerformQuery(Adapters::SplitIds(input));
+}
+
+void CLICommands::QueryAllDatabases(const std::string& input) {
+  app_.PerformCrossQuery(Adapters::SplitIds(input));
+}
+
+void CLICommands::CombineDatabases() {
+  const std::vector<DatabaseInfo> dbs = app_.GetDatabaseListing();
+  if (dbs.size() < 2) {
+    app_.SetError(ErrorCode::kSetInputsInvalid);
+    return;
+  }
+  PrintDatabaseListing(dbs);
+
+  std::string line;
+  std::cout << "选择运算 (1 并集 / 2 交集 / 3 差集): ";
+  std::getline(std::cin, line);
+  SetOperation operation;
+  if (line == "1") {
+    operation = SetOperation::kUnion;
+  } else if (line == "2") {
+    operation = SetOperation::kIntersect;
+  } else if (line == "3") {
+    operation = SetOperation::kDifference;
+  } else {
+    app_.SetError(ErrorCode::kIdInvalid);
+    return;
+  }
+
+  std::cout << "输入参与运算的库编号 (用空格隔开, 差集为第一个减其余): ";
+  std::getline(std::cin, line);
+  std::istringstream choices(line);
+  std::vector<std::string> inputs;
+  size_t choice = 0;
+  while (choices >> choice) {
+    if (choice < 1 || choice > dbs.size()) {
+      app_.SetError(ErrorCode::kIdInvalid);
+      return;
+    }
+    inputs.push_back(dbs[choice - 1].name);
+  }
+  if (!choices.eof()) {
+    app_.SetError(ErrorCode::kIdInvalid);
+    return;
+  }
+
+  std::cout << "输出到 (.txt 文件路径或新库名): ";
+  std::string target;
+  std::getline(std::cin, target);
+  if (target.ends_with(".txt")) {
+    app_.PerformSetOperationToFile(operation, inputs, target);
+  } else {
+    app_.PerformSetOperationToDatabase(operation, inputs, target);
+  }
 }
 
 void CLICommands::CreateDatabase(const std::string& name) {
@@ -26,15 +115,12 @@ void CLICommands::CreateDatabase(const std::string& name) {
 }
 
 void CLICommands::SwitchDatabase() {
-  std::vector<std::string> dbs = app_.GetDatabaseNames();
+  const std::vector<DatabaseInfo> dbs = app_.GetDatabaseListing();
   if (dbs.empty()) {
     std::cout << "当前没有可切换的数据库。" << std::endl;
     return;
   }
-  std::cout << "可用数据库:" << std::endl;
-  for (size_t i = 0; i < dbs.size(); ++i) {
-    std::cout << i + 1 << ". " << dbs[i] << std::endl;
-  }
+  PrintDatabaseListing(dbs);
   std::cout << "选择要切换的数据库编号: ";
   int db_choice;
   std::cin >> db_choice;
@@ -46,17 +132,19 @@ void CLICommands::SwitchDatabase() {
     return;
   }
   std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-  app_.SetCurrentDatabase(dbs[db_choice - 1]);
+  app_.SetCurrentDatabase(dbs[db_choice - 1].name);
 }
 
 void CLICommands::ImportFromFile(const std::string& filepath) {
-  try {
-    IO::TextFileReader reader;
-    auto lines = reader.ReadAllLines(filepath);
-    app_.PerformImportLines(lines);
-  } catch (const std::runtime_error&) {
-    app_.SetError(ErrorCode::kFileOpenFailed);
-  }
+  auto handle = scheduler_.Submit(
+      Concurrency::JobPriority::kBulk,
+      [this, &filepath](Concurrency::JobProgress& progress) {
+        IO::MappedTextReader reader;
+        ImportOptions options;
+        options.progress = &progress;
+        app_.PerformImportFile(reader, filepath, options);
+      });
+  WaitWithProgress(handle);
 }
 
 void CLICommands::ExportToFile(const std::string& filepath) {
@@ -64,23 +152,76 @@ void CLICommands::ExportToFile(const std::string& filepath) {
   if (out_path.empty()) {
     out_path = (std::filesystem::current_path() / "output.txt").string();
   }
-  std::vector<std::string> ids;
-  if (!app_.FetchAllIds(ids)) {
-    return;
+  auto handle = scheduler_.Submit(
+      Concurrency::JobPriority::kBulk,
+      [this, &out_path](Concurrency::JobProgress& progress) {
+        app_.PerformExport(out_path, &progress);
+      });
+  WaitWithProgress(handle);
+}
+
+void CLICommands::CheckFile(const std::string& filepath) {
+  std::filesystem::path output_dir =
+      std::filesystem::path(filepath).parent_path();
+  if (output_dir.empty()) {
+    output_dir = std::filesystem::current_path();
   }
-  std::ofstream out(out_path, std::ios::out | std::ios::trunc);
-  if (!out.is_open()) {
-    app_.SetError(ErrorCode::kFileOpenFailed);
-    return;
+  auto handle = scheduler_.Submit(
+      Concurrency::JobPriority::kBulk,
+      [this, &filepath, &output_dir](Concurrency::JobProgress& progress) {
+        IO::MappedTextReader reader;
+        CheckOptions options;
+        options.progress = &progress;
+        app_.PerformCheckFile(reader, filepath, output_dir.string(), options);
+      });
+  WaitWithProgress(handle);
+}
+
+void CLICommands::MigrateToPackedLayout() {
+  std::cout << "正在迁移，大型数据库可能需要一段时间..." << std::endl;
+  app_.PerformMigrateToPackedLayout();
+}
+
+void CLICommands::ToggleQueryEngine() {
+  // 依次轮换：SQLite -> 内存哈希索引 -> 只读快照 -> SQLite
+  QueryEngine next = QueryEngine::kSqlite;
+  switch (app_.GetQueryEngine()) {
+    case QueryEngine::kSqlite:
+      next = QueryEngine::kHashIndex;
+      break;
+    case QueryEngine::kHashIndex:
+      next = QueryEngine::kSnapshot;
+      break;
+    case QueryEngine::kSnapshot:
+      next = QueryEngine::kSqlite;
+      break;
   }
-  for (const auto& id : ids) {
-    out << id << '\n';
+  app_.PerformSetQueryEngine(next);
+}
+
+void CLICommands::RebuildFilter(const std::string& rate_input) {
+  double rate = BloomFilter::kDefaultFalsePositiveRate;
+  if (!rate_input.empty()) {
+    try {
+      rate = std::stod(rate_input);
+    } catch (const std::exception&) {
+      app_.SetError(ErrorCode::kIdInvalid);
+      return;
+    }
+    if (rate <= 0.0 || rate >= 0.5) {
+      app_.SetError(ErrorCode::kIdInvalid);
+      return;
+    }
   }
-  app_.SetInfoMessage("导出完成，文件路径: " + out_path);
+  app_.PerformRebuildFilter(rate);
 }
 
 void CLICommands::ShowStatus() {
   std::cout << "当前库记录总数: " << app_.GetTotalRecords() << std::endl;
+  std::cout << CLIConfig::Messages::EngineStats(app_.GetRepositoryStats())
+            << std::endl;
+  std::cout << CLIConfig::Messages::MemoryStats(app_.GetMemoryStats())
+            << std::endl;
   std::cout << "\n按回车键返回菜单...";
   std::cin.get();
 }
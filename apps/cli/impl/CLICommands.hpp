@@ -6,6 +6,7 @@
 #include <vector>
 
 #include "core/app/application.hpp"
+#include "core/concurrency/job_scheduler.hpp"
 
 class CLICommands {
  public:
@@ -13,15 +14,26 @@ class CLICommands {
 
   void AddIds(const std::string& input);
   void QueryId(const std::string& input);
+  void QueryAllDatabases(const std::string& input);
+  // 交互选择运算与参与的库，输出以 .txt 结尾时写入文件，否则写入新库
+  void CombineDatabases();
   void CreateDatabase(const std::string& name);
   void SwitchDatabase();
+  // 导入、导出作为批量任务交给调度器，等待期间显示进度
   void ImportFromFile(const std::string& filepath);
   void ExportToFile(const std::string& filepath);
+  // 结果文件写在候选清单所在的目录
+  void CheckFile(const std::string& filepath);
+  void MigrateToPackedLayout();
+  void ToggleQueryEngine();
+  void RebuildFilter(const std::string& rate_input);
   void ShowStatus();
   static void ShowVersion();
 
  private:
   Application& app_;
+  // 与图形界面相同的执行方式；命令行一次只等一个任务
+  Concurrency::JobScheduler scheduler_;
 };
 
 #endif
@@ -2,21 +2,23 @@
 #ifndef INPUT_PARSER_HPP
 #define INPUT_PARSER_HPP
 
-#include <sstream>
-#include <string>
+#include <string_view>
 #include <vector>
 
 namespace Adapters {
-inline auto SplitIds(const std::string& input) -> std::vector<std::string> {
-  std::istringstream iss(input);
-  std::vector<std::string> ids;
-  std::string token;
-  while (iss >> token) {
-    ids.push_back(token);
+// 按空白切分输入，返回指向 input 的视图，不为单个 ID 分配内存；
+// input 必须在视图使用期间保持有效
+inline auto SplitIds(std::string_view input) -> std::vector<std::string_view> {
+  constexpr std::string_view kWhitespace = " \t\r\n\v\f";
+  std::vector<std::string_view> ids;
+  size_t pos = input.find_first_not_of(kWhitespace);
+  while (pos != std::string_view::npos) {
+    const size_t end = input.find_first_of(kWhitespace, pos);
+    ids.push_back(input.substr(pos, end - pos));
+    pos = input.find_first_not_of(kWhitespace, end);
   }
   return ids;
 }
 }  // namespace Adapters
 
 #endif
-
@@ -33,6 +33,24 @@ class ImGuiPresenter {
           return std::string(UIConfig::Messages::kErrorFileOpenFailed);
         case ErrorCode::kFileEmpty:
           return std::string(UIConfig::Messages::kErrorFileEmpty);
+        case ErrorCode::kDbMigrateFailed:
+          return std::string(UIConfig::Messages::kErrorDbMigrateFailed);
+        case ErrorCode::kEngineSwitchFailed:
+          return std::string(UIConfig::Messages::kErrorEngineSwitchFailed);
+        case ErrorCode::kFilterRebuildFailed:
+          return std::string(UIConfig::Messages::kErrorFilterRebuildFailed);
+        case ErrorCode::kDbReadOnly:
+          return std::string(UIConfig::Messages::kErrorDbReadOnly);
+        case ErrorCode::kFileWriteFailed:
+          return std::string(UIConfig::Messages::kErrorFileWriteFailed);
+        case ErrorCode::kCrossQueryFailed:
+          return std::string(UIConfig::Messages::kErrorCrossQueryFailed);
+        case ErrorCode::kSetInputsInvalid:
+          return std::string(UIConfig::Messages::kErrorSetInputsInvalid);
+        case ErrorCode::kSetOperationFailed:
+          return std::string(UIConfig::Messages::kErrorSetOperationFailed);
+        case ErrorCode::kImportFailed:
+          return UIConfig::Messages::ImportFailed(app.GetLastImportResult());
         case ErrorCode::kNone:
           return std::string(UIConfig::Messages::kUnknownError);
       }
@@ -53,8 +71,27 @@ class ImGuiPresenter {
         return UIConfig::Messages::AddCompleted(app.GetLastAddResult());
       case ResultCode::kQueryCompleted:
         return UIConfig::Messages::QueryCompleted(app.GetLastQueryResult());
+      case ResultCode::kCrossQueryCompleted:
+        return UIConfig::Messages::CrossQueryCompleted(
+            app.GetLastCrossQueryResult());
+      case ResultCode::kSetOperationCompleted:
+        return UIConfig::Messages::SetOperationCompleted(
+            app.GetLastSetOperationResult());
       case ResultCode::kImportCompleted:
         return UIConfig::Messages::ImportCompleted(app.GetLastImportResult());
+      case ResultCode::kExportCompleted:
+        return UIConfig::Messages::ExportCompleted(app.GetLastExportResult());
+      case ResultCode::kCheckCompleted:
+        return UIConfig::Messages::CheckCompleted(app.GetLastCheckResult());
+      case ResultCode::kDbMigrated:
+        return UIConfig::Messages::DbMigrated(app.GetCurrentDbName(),
+                                             app.GetLastMigrationResult());
+      case ResultCode::kEngineSwitched:
+        return UIConfig::Messages::EngineSwitched(app.GetCurrentDbName(),
+                                                 app.GetRepositoryStats());
+      case ResultCode::kFilterRebuilt:
+        return UIConfig::Messages::FilterRebuilt(app.GetCurrentDbName(),
+                                                app.GetRepositoryStats());
     }
 
     return std::string(UIConfig::Messages::kUnknownError);
@@ -0,0 +1,121 @@
+// apps/gui/imgui/impl/background_jobs.cpp
+#include "apps/gui/imgui/impl/background_jobs.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <utility>
+
+BackgroundJobs::BackgroundJobs(std::function<void()> on_finished)
+    : on_finished_(std::move(on_finished)) {}
+
+BackgroundJobs::~BackgroundJobs() {
+  // 排队的导入、导出一开始就会看到取消请求；scheduler_ 析构时等它们结束。
+  // 还没交给调度器的任务直接丢弃
+  for (Job& job : bulk_) {
+    if (job.progress) {
+      job.progress->RequestCancel();
+    }
+  }
+}
+
+void BackgroundJobs::Enqueue(std::string label, Work work) {
+  bulk_.push_back(Job{std::move(label), Wrap(std::move(work)), {}, nullptr});
+  Feed();
+}
+
+void BackgroundJobs::EnqueueInteractive(Work work) {
+  interactive_waiting_.push_back(Wrap(std::move(work)));
+  Feed();
+}
+
+auto BackgroundJobs::Poll() -> bool {
+  Feed();
+  bool finished = false;
+  // 批量任务按提交顺序执行，只需看队首
+  while (!bulk_.empty() && Reap(bulk_.front().done)) {
+    bulk_.pop_front();
+    finished = true;
+  }
+  const auto reaped = std::ranges::remove_if(
+      interactive_, [this](std::future<void>& done) { return Reap(done); });
+  finished = finished || !reaped.empty();
+  interactive_.erase(reaped.begin(), reaped.end());
+  Feed();
+  return finished;
+}
+
+void BackgroundJobs::CancelCurrent() {
+  if (!bulk_.empty() && bulk_.front().progress) {
+    bulk_.front().progress->RequestCancel();
+  }
+}
+
+auto BackgroundJobs::CurrentLabel() const -> const std::string& {
+  static const std::string kNone;
+  return bulk_.empty() ? kNone : bulk_.front().label;
+}
+
+auto BackgroundJobs::CurrentProgress() const
+    -> const Concurrency::JobProgress* {
+  return bulk_.empty() ? nullptr : bulk_.front().progress.get();
+}
+
+auto BackgroundJobs::TakeError() -> std::string {
+  return std::exchange(error_, {});
+}
+
+// 唤醒略早于 future 就绪；有任务未回收时主循环还会定时轮询，不会漏掉
+auto BackgroundJobs::Wrap(Work work) -> Work {
+  return [this, work = std::move(work)](Concurrency::JobProgress& progress) {
+    struct NotifyOnExit {
+      const std::function<void()>& notify;
+      ~NotifyOnExit() {
+        if (notify) {
+          notify();
+        }
+      }
+    } notify_on_exit{on_finished_};
+    work(progress);
+  };
+}
+
+void BackgroundJobs::Feed() {
+  while (!interactive_waiting_.empty()) {
+    auto handle = scheduler_.TrySubmit(Concurrency::JobPriority::kInteractive,
+                                       interactive_waiting_.front());
+    if (!handle) {
+      break;
+    }
+    interactive_.push_back(std::move(handle->result));
+    interactive_waiting_.pop_front();
+  }
+  for (Job& job : bulk_) {
+    if (job.progress) {
+      continue;
+    }
+    auto handle =
+        scheduler_.TrySubmit(Concurrency::JobPriority::kBulk, job.work);
+    if (!handle) {
+      break;
+    }
+    job.work = nullptr;
+    job.done = std::move(handle->result);
+    job.progress = handle->progress;
+  }
+}
+
+auto BackgroundJobs::Reap(std::future<void>& done) -> bool {
+  if (!done.valid()) {
+    return false;
+  }
+  if (done.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+    return false;
+  }
+  try {
+    done.get();
+  } catch (const std::exception& e) {
+    error_ = e.what();
+  }
+  return true;
+}
@@ -0,0 +1,79 @@
+// apps/gui/imgui/impl/background_jobs.hpp
+#ifndef BACKGROUND_JOBS_HPP
+#define BACKGROUND_JOBS_HPP
+
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+
+#include "core/concurrency/job_progress.hpp"
+#include "core/concurrency/job_scheduler.hpp"
+
+// 界面对 Application 的所有调用都经这里交给 Concurrency::JobScheduler，
+// 界面线程自己从不直接访问 Application，每帧只轮询任务是否结束。
+// 批量任务（导入、导出、切换库等）逐个执行并显示进度；交互任务（查询、
+// 添加）插在批量任务的批次之间执行，导入期间界面仍可查询。
+// 调度器的队列有界，提交时从不等待：排不进去的任务先留在这里，
+// 每次轮询时按提交顺序补交，界面线程不会因一次拖入大量文件而卡住。
+class BackgroundJobs {
+ public:
+  using Work = std::function<void(Concurrency::JobProgress& progress)>;
+
+  // on_finished 在工作线程上调用，用于唤醒等待事件的主循环
+  explicit BackgroundJobs(std::function<void()> on_finished);
+  // 请求取消所有批量任务，并等待它们在批次边界结束
+  ~BackgroundJobs();
+  BackgroundJobs(const BackgroundJobs&) = delete;
+  auto operator=(const BackgroundJobs&) -> BackgroundJobs& = delete;
+
+  // 批量任务；会切换、创建库或更换引擎的操作也必须走这里
+  void Enqueue(std::string label, Work work);
+  // 不改变库打开状态的短操作
+  void EnqueueInteractive(Work work);
+  // 回收已结束的任务；有任务在此结束时返回 true
+  auto Poll() -> bool;
+  void CancelCurrent();
+
+  [[nodiscard]] auto IsBusy() const -> bool {
+    return !bulk_.empty() || !interactive_.empty() ||
+           !interactive_waiting_.empty();
+  }
+  [[nodiscard]] auto HasBulkJob() const -> bool { return !bulk_.empty(); }
+  // 没有批量任务时为空
+  [[nodiscard]] auto CurrentLabel() const -> const std::string&;
+  // 没有批量任务时为 nullptr
+  [[nodiscard]] auto CurrentProgress() const
+      -> const Concurrency::JobProgress*;
+  [[nodiscard]] auto PendingCount() const -> size_t {
+    return bulk_.empty() ? 0 : bulk_.size() - 1;
+  }
+  // 最近一个以异常结束的任务的错误信息，取走后清空
+  auto TakeError() -> std::string;
+
+ private:
+  struct Job {
+    std::string label;
+    Work work;  // 尚未交给调度器的任务；交出后为空
+    std::future<void> done;
+    std::shared_ptr<Concurrency::JobProgress> progress;  // 交出后才有
+  };
+
+  // 任务结束时唤醒主循环，异常留给 future 带回界面线程
+  auto Wrap(Work work) -> Work;
+  // 已结束的任务取出结果并返回 true
+  auto Reap(std::future<void>& done) -> bool;
+  // 按提交顺序把等待中的任务交给调度器，直到队列满
+  void Feed();
+
+  std::function<void()> on_finished_;
+  std::deque<Job> bulk_;  // 队首即正在执行的批量任务
+  std::deque<std::future<void>> interactive_;
+  std::deque<Work> interactive_waiting_;  // 调度器队列已满、尚未交出的
+  std::string error_;
+  // 放在最后：最先析构，工作线程退出后才销毁上面的状态
+  Concurrency::JobScheduler scheduler_;
+};
+
+#endif  // BACKGROUND_JOBS_HPP
@@ -4,6 +4,7 @@
 #include <GLFW/glfw3.h>
 
 #include <iostream>
+#include <string>
 
 #include "imgui.h"
 #include "imgui_impl_glfw.h"
@@ -13,6 +14,25 @@
 
 // --- 所有主题相关的代码都已移至 ThemeManager ---
 
+namespace {
+// 每次唤醒后多画几帧，让悬停、弹出层等依赖上一帧布局的状态稳定下来
+constexpr int kFramesAfterWake = 3;
+// 文本框获得焦点时按光标闪烁的节奏定时唤醒，其余时间无事件就一直等待
+constexpr double kCaretBlinkSeconds = 0.5;
+// 后台任务执行期间刷新进度条的间隔
+constexpr double kJobProgressSeconds = 0.1;
+
+void DropCallback(GLFWwindow* window, int count, const char** paths) {
+  auto* panel = static_cast<UIPanel*>(glfwGetWindowUserPointer(window));
+  for (int i = 0; i < count; ++i) {
+    const std::string path = paths[i];
+    if (path.ends_with(".txt")) {
+      panel->EnqueueImport(path);
+    }
+  }
+}
+}  // namespace
+
 static void GlfwErrorCallback(int error, const char* description) {
   std::cerr << "Glfw Error " << error << ": " << description << std::endl;
 }
@@ -21,7 +41,8 @@ ImGuiView::ImGuiView(Application& app) : app_(app) {
   theme_manager_ = std::make_unique<ThemeManager>();
   settings_store_ = std::make_unique<ImGuiSettingsStore>(*theme_manager_);
   // 将ThemeManager的引用注入到UIPanel中
-  ui_panel_ = std::make_unique<UIPanel>(app_, *theme_manager_);
+  ui_panel_ = std::make_unique<UIPanel>(app_, *theme_manager_,
+                                        &ImGuiView::RequestRedraw);
 }
 
 auto ImGuiView::Init() -> bool {
@@ -41,6 +62,9 @@ auto ImGuiView::Init() -> bool {
   }
   glfwMakeContextCurrent(window_);
   glfwSwapInterval(1);
+  // 拖入的 .txt 文件与点击导入按钮一样进入后台导入队列
+  glfwSetWindowUserPointer(window_, ui_panel_.get());
+  glfwSetDropCallback(window_, DropCallback);
 
   IMGUI_CHECKVERSION();
   ImGui::CreateContext();
@@ -63,18 +87,41 @@ auto ImGuiView::Init() -> bool {
   return true;
 }
 
-// ... run() 和 cleanup() 函数保持不变 ...
+// 事件驱动的主循环：没有输入、定时器或 RequestRedraw 唤醒时阻塞等待，
+// 窗口空闲时不占用 CPU 与 GPU
 void ImGuiView::Run() {
   app_.LoadDatabase();
 
+  int pending_frames = kFramesAfterWake;
   while (glfwWindowShouldClose(window_) == 0) {
-    glfwPollEvents();
-    RenderFrame();
+    if (pending_frames > 0) {
+      glfwPollEvents();
+      --pending_frames;
+    } else if (ui_panel_->HasRunningJob() || ImGui::GetIO().WantTextInput) {
+      const double timeout = ui_panel_->HasRunningJob() ? kJobProgressSeconds
+                                                        : kCaretBlinkSeconds;
+      const double waited_since = glfwGetTime();
+      glfwWaitEventsTimeout(timeout);
+      // 定时唤醒只为刷新进度条或光标，画一帧即可
+      pending_frames =
+          glfwGetTime() - waited_since >= timeout ? 0 : kFramesAfterWake;
+    } else {
+      glfwWaitEvents();
+      pending_frames = kFramesAfterWake;
+    }
+    // 本帧内的操作改变了状态，接着再画几帧以显示结果
+    if (RenderFrame()) {
+      pending_frames = kFramesAfterWake;
+    }
     glfwSwapBuffers(window_);
   }
 }
 
+void ImGuiView::RequestRedraw() { glfwPostEmptyEvent(); }
+
 void ImGuiView::Cleanup() {
+  // 先取消并等待后台任务，它结束时会向窗口投递唤醒事件
+  ui_panel_.reset();
   ImGui_ImplOpenGL3_Shutdown();
   ImGui_ImplGlfw_Shutdown();
   ImGui::DestroyContext();
@@ -82,7 +129,7 @@ void ImGuiView::Cleanup() {
   glfwTerminate();
 }
 
-void ImGuiView::RenderFrame() {
+auto ImGuiView::RenderFrame() -> bool {
   ImGui_ImplOpenGL3_NewFrame();
   ImGui_ImplGlfw_NewFrame();
   ImGui::NewFrame();
@@ -93,7 +140,7 @@ void ImGuiView::RenderFrame() {
                ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoMove |
                    ImGuiWindowFlags_NoResize);
 
-  ui_panel_->Render();
+  const bool changed = ui_panel_->Render();
 
   ImGui::End();
 
@@ -105,5 +152,6 @@ void ImGuiView::RenderFrame() {
   glClearColor(0.1F, 0.1F, 0.1F, 1.0F);
   glClear(GL_COLOR_BUFFER_BIT);
   ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+  return changed;
 }
 
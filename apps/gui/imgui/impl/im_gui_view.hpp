@@ -19,9 +19,12 @@ class ImGuiView : public IGuiView {
   auto Init() -> bool override;
   void Run() override;
   void Cleanup() override;
+  // 唤醒等待中的主循环重绘一次；可在任意线程调用，供后台任务完成时使用
+  static void RequestRedraw();
 
  private:
-  void RenderFrame();
+  // 返回本帧内的操作是否改变了状态
+  auto RenderFrame() -> bool;
 
   Application& app_;
   GLFWwindow* window_{nullptr};
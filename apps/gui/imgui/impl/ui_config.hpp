@@ -2,8 +2,12 @@
 #ifndef U_I_CONFIG_HPP
 #define U_I_CONFIG_HPP
 
+#include <chrono>
+#include <cstdio>
+#include <ctime>
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include "core/app/application.hpp"  // 包含此文件以使用结果模型
 // 这个文件现在包含了所有的状态消息文本。
@@ -26,22 +30,40 @@ constexpr const char* kNewDbInputHint = "或输入新库名(如: new_db)";
 constexpr const char* kCreateNewDbButton = "创建新的库";
 
 // --- 内容查询区域 ---
-constexpr const char* kQuerySectionHeader = "内容查询 (在当前库 '%s' 中查询)";
+constexpr const char* kQuerySectionHeader =
+    "内容查询 (可批量, 在当前库 '%s' 中查询)";
 constexpr const char* kQueryButton = "查询";
 
 // --- 导入区域 ---
-constexpr const char* kImportSectionHeader = "从 .txt 文件导入到当前库";
+constexpr const char* kImportSectionHeader =
+    "从 .txt 文件导入到当前库 (也可把文件拖入窗口)";
 constexpr const char* kImportInputHint = "输入 .txt 路径";
 constexpr const char* kImportButton = "导入";
+constexpr const char* kSortedImportCheckbox = "先排序去重再写入 (大文件)";
 
 // --- 导出区域 ---
 constexpr const char* kExportSectionHeader = "导出当前库到 .txt";
 constexpr const char* kExportInputHint = "输出路径(留空则output.txt)";
 constexpr const char* kExportButton = "导出";
 
+// --- 候选清单核对区域 ---
+constexpr const char* kCheckSectionHeader =
+    "核对 .txt 候选清单 (结果写在清单所在目录)";
+constexpr const char* kCheckInputHint = "输入候选清单 .txt 路径";
+constexpr const char* kCheckButton = "核对";
+
+// --- 后台任务区域 ---
+constexpr const char* kJobRateOverlay = "%zu 行, %.0f 行/秒";
+constexpr const char* kCancelJobButton = "取消";
+constexpr const char* kJobPendingLabel = "另有 %zu 个任务排队";
+
 // --- 状态栏区域 ---
 constexpr const char* kStatusLabel = "状态: %s";
 constexpr const char* kTotalRecordsLabel = "当前库记录总数: %zu";
+constexpr const char* kQueryEngineCombo = "查询引擎";
+// 顺序与 QueryEngine 枚举一致
+constexpr const char* kQueryEngineItems =
+    "SQLite\0内存哈希索引 (适合大批量查询)\0只读快照 (.avidx)\0";
 
 // --- 新增：统一管理所有状态消息文本 ---
 namespace Messages {
@@ -60,6 +82,22 @@ inline auto DbCreated(const std::string& db_name) -> std::string {
 }
 
 // --- 批量操作结果格式化 ---
+// 列出前若干个 ID，批量结果过长时截断
+inline auto JoinIds(const IdList& ids) -> std::string {
+  constexpr size_t kMaxListed = 10;
+  std::string text;
+  for (size_t i = 0; i < ids.Size() && i < kMaxListed; ++i) {
+    if (i > 0) {
+      text += ", ";
+    }
+    text += ids[i];
+  }
+  if (ids.Size() > kMaxListed) {
+    text += " 等" + std::to_string(ids.Size()) + "个";
+  }
+  return text;
+}
+
 inline auto AddCompleted(const AddResult& result) -> std::string {
   std::string msg = "在 [" + result.target_db_name + "] 中添加完成。 ";
   msg += "成功: " + std::to_string(result.success_count) + "个。 ";
@@ -79,7 +117,13 @@ inline auto QueryCompleted(const QueryResult& result) -> std::string {
     msg += "未找到: " + std::to_string(result.not_found_count) + "个。 ";
   }
   if (result.invalid_format_count > 0) {
-    msg += "格式错误: " + std::to_string(result.invalid_format_count) + "个。";
+    msg += "格式错误: " + std::to_string(result.invalid_format_count) + "个。 ";
+  }
+  if (!result.found_ids.Empty()) {
+    msg += "命中: " + JoinIds(result.found_ids);
+  }
+  if (result.cancelled) {
+    msg += " (已取消，其余 ID 未查询)";
   }
   return msg;
 }
@@ -95,19 +139,236 @@ constexpr std::string_view kErrorQueryIdEmpty = "提示：请输入要查询的
 constexpr std::string_view kErrorIdInvalid =
     "错误：无效的选项或格式。";  // --- [ADD THIS LINE] ---
 
+inline auto CrossQueryCompleted(const CrossQueryResult& result) -> std::string {
+  std::string msg = "在 " + std::to_string(result.databases.size()) +
+                    " 个库中查询完成。 ";
+  msg += "存在: " + std::to_string(result.found_count) + "个。 ";
+  if (result.not_found_count > 0) {
+    msg += "均未找到: " + std::to_string(result.not_found_count) + "个。 ";
+  }
+  if (result.invalid_format_count > 0) {
+    msg += "格式错误: " + std::to_string(result.invalid_format_count) + "个。 ";
+  }
+  std::vector<size_t> per_db(result.databases.size(), 0);
+  for (const uint32_t db : result.hit_databases) {
+    ++per_db[db];
+  }
+  std::string hits;
+  for (size_t d = 0; d < per_db.size(); ++d) {
+    if (per_db[d] > 0) {
+      hits += (hits.empty() ? "" : ", ") + result.databases[d] + " " +
+              std::to_string(per_db[d]);
+    }
+  }
+  if (!hits.empty()) {
+    msg += "各库命中: " + hits;
+  }
+  return msg;
+}
+
+inline auto SetOperationCompleted(const SetOperationResult& result)
+    -> std::string {
+  std::string msg;
+  switch (result.operation) {
+    case SetOperation::kUnion:
+      msg = "并集";
+      break;
+    case SetOperation::kIntersect:
+      msg = "交集";
+      break;
+    case SetOperation::kDifference:
+      msg = "差集";
+      break;
+  }
+  std::string inputs;
+  for (size_t i = 0; i < result.inputs.size(); ++i) {
+    inputs += (inputs.empty() ? "" : ", ") + result.inputs[i];
+    if (i < result.input_counts.size()) {
+      inputs += " " + std::to_string(result.input_counts[i]);
+    }
+  }
+  msg += "运算完成 (" + inputs + ")。 ";
+  msg += "写入 " + std::to_string(result.output_count) + " 个 ID 到 " +
+         (result.to_file ? "文件 " : "新库 ") + result.target + "。";
+  return msg;
+}
+
 inline auto ImportCompleted(const ImportResult& result) -> std::string {
   std::string msg = "从文件导入到 [" + result.target_db_name + "] 完成。 ";
   msg += "成功: " + std::to_string(result.success_count) + "。 ";
   if (result.exist_count > 0) {
     msg += "已存在: " + std::to_string(result.exist_count) + "。 ";
   }
+  if (result.duplicate_count > 0) {
+    msg += "文件内重复: " + std::to_string(result.duplicate_count) + "。 ";
+  }
   if (result.invalid_format_count > 0) {
     msg += "格式错误: " + std::to_string(result.invalid_format_count) + "。";
   }
+  if (result.cancelled) {
+    msg += " (已取消，已导入的部分已保存)";
+  }
+  return msg;
+}
+
+// 导入中途写入失败：已提交的部分保留在库中
+inline auto ImportFailed(const ImportResult& result) -> std::string {
+  std::string msg = "错误：导入到 [" + result.target_db_name +
+                    "] 时写入数据库失败（磁盘已满、库被锁定或读写出错）。";
+  msg += " 已保存: 成功 " + std::to_string(result.success_count) + "，已存在 " +
+         std::to_string(result.exist_count) + "。";
+  return msg;
+}
+
+inline auto ExportCompleted(const ExportResult& result) -> std::string {
+  if (result.cancelled) {
+    return "已取消从 [" + result.target_db_name +
+           "] 导出，不完整的文件已删除: " + result.filepath;
+  }
+  return "已从 [" + result.target_db_name + "] 导出 " +
+         std::to_string(result.exported_count) +
+         " 条，文件路径: " + result.filepath;
+}
+
+inline auto CheckCompleted(const CheckResult& result) -> std::string {
+  std::string msg = "已对照 [" + result.target_db_name + "] 核对完成（";
+  msg += result.merge_join ? "归并连接" : "逐块查询";
+  msg += "）。 新: " + std::to_string(result.new_count) + "。 ";
+  msg += "已有: " + std::to_string(result.owned_count) + "。 ";
+  if (result.duplicate_count > 0) {
+    msg += "文件内重复: " + std::to_string(result.duplicate_count) + "。 ";
+  }
+  if (result.invalid_format_count > 0) {
+    msg += "格式错误: " + std::to_string(result.invalid_format_count) + "。 ";
+  }
+  msg += "输出目录: " + result.output_dir;
+  if (result.cancelled) {
+    msg += " (已取消，输出文件不完整)";
+  }
+  return msg;
+}
+
+inline auto DbMigrated(const std::string& db_name,
+                       const LayoutMigrationReport& result) -> std::string {
+  constexpr double kMiB = 1024.0 * 1024.0;
+  char sizes[96];
+  std::snprintf(sizes, sizeof(sizes), "%.1f MiB -> %.1f MiB",
+                static_cast<double>(result.bytes_before) / kMiB,
+                static_cast<double>(result.bytes_after) / kMiB);
+  return "已将 [" + db_name + "] 迁移为紧凑存储格式。 记录: " +
+         std::to_string(result.migrated_count) + "。 文件大小: " + sizes;
+}
+
+inline auto EngineStats(const RepositoryStats& stats) -> std::string {
+  std::string msg = "查询引擎: " + stats.engine;
+  if (stats.memory_bytes > 0) {
+    char detail[96];
+    std::snprintf(detail, sizeof(detail), " (载入 %.1f ms, 内存 %.1f MiB)",
+                  stats.load_ms,
+                  static_cast<double>(stats.memory_bytes) / (1024.0 * 1024.0));
+    msg += detail;
+  }
+  const FilterStats& filter = stats.filter;
+  if (filter.stale) {
+    msg += " | 过滤器已过期，请重建";
+  } else if (filter.loaded) {
+    char detail[160];
+    std::snprintf(detail, sizeof(detail),
+                  " | 过滤器: 误判率 %.2f%%, %.1f MiB, 查询 %llu 次, "
+                  "拦截 %llu 次, 误判 %llu 次",
+                  filter.false_positive_rate * 100.0,
+                  static_cast<double>(filter.memory_bytes) / (1024.0 * 1024.0),
+                  static_cast<unsigned long long>(filter.lookups),
+                  static_cast<unsigned long long>(filter.rejected),
+                  static_cast<unsigned long long>(filter.false_positives));
+    msg += detail;
+  }
   return msg;
 }
+
+inline auto MemoryStats(const CatalogMemoryStats& stats) -> std::string {
+  char detail[256];
+  std::snprintf(detail, sizeof(detail),
+                "连接内存: %.1f / %.1f MiB (已打开 %zu 个库, 每连接缓存 "
+                "%.1f MiB, 已回收 %llu 个连接)",
+                static_cast<double>(stats.used_bytes) / (1024.0 * 1024.0),
+                static_cast<double>(stats.budget_bytes) / (1024.0 * 1024.0),
+                stats.open_databases.size(),
+                static_cast<double>(stats.cache_bytes_per_connection) /
+                    (1024.0 * 1024.0),
+                static_cast<unsigned long long>(stats.evictions));
+  return detail;
+}
+
+// 库清单中的一项：名称、记录数、文件大小与修改时间
+inline auto DatabaseLabel(const DatabaseInfo& info) -> std::string {
+  char count[32] = "?";
+  if (info.record_count) {
+    std::snprintf(count, sizeof(count), "%zu", *info.record_count);
+  }
+  char modified[32] = "";
+  const std::time_t seconds =
+      std::chrono::system_clock::to_time_t(info.modified);
+  if (const std::tm* local = std::localtime(&seconds)) {
+    std::strftime(modified, sizeof(modified), "%Y-%m-%d %H:%M", local);
+  }
+  char detail[128];
+  std::snprintf(detail, sizeof(detail), " (%s 条, %.1f MiB, %s)", count,
+                static_cast<double>(info.size_bytes) / (1024.0 * 1024.0),
+                modified);
+  return info.name + detail;
+}
+
+inline auto ImportJobLabel(const std::string& filepath) -> std::string {
+  return "正在导入: " + filepath;
+}
+inline auto ExportJobLabel(const std::string& filepath) -> std::string {
+  return "正在导出: " + filepath;
+}
+inline auto CheckJobLabel(const std::string& filepath) -> std::string {
+  return "正在核对: " + filepath;
+}
+inline auto QueryJobLabel(size_t id_count) -> std::string {
+  return "正在查询 " + std::to_string(id_count) + " 个 ID";
+}
+inline auto SwitchJobLabel(const std::string& db_name) -> std::string {
+  return "正在切换到: " + db_name;
+}
+inline auto CreateJobLabel(const std::string& db_name) -> std::string {
+  return "正在创建: " + db_name;
+}
+inline auto EngineJobLabel() -> std::string { return "正在切换查询引擎"; }
+inline auto JobFailed(const std::string& what) -> std::string {
+  return "错误：后台任务失败: " + what;
+}
+
+inline auto FilterRebuilt(const std::string& db_name,
+                          const RepositoryStats& stats) -> std::string {
+  return "已重建 [" + db_name + "] 的负查询过滤器。 " + EngineStats(stats);
+}
+
+inline auto EngineSwitched(const std::string& db_name,
+                           const RepositoryStats& stats) -> std::string {
+  return "[" + db_name + "] " + EngineStats(stats);
+}
 constexpr std::string_view kErrorFileOpenFailed = "错误：无法打开指定的文件。";
 constexpr std::string_view kErrorFileEmpty = "提示：文件为空或只包含空行。";
+constexpr std::string_view kErrorDbMigrateFailed =
+    "错误：迁移到紧凑存储格式失败，原库未改动。";
+constexpr std::string_view kErrorEngineSwitchFailed =
+    "错误：切换查询引擎失败，已保持原引擎。";
+constexpr std::string_view kErrorFilterRebuildFailed =
+    "错误：当前库的存储格式不支持过滤器，或重建失败。";
+constexpr std::string_view kErrorDbReadOnly =
+    "错误：当前库以只读快照方式打开，请先切换回其他查询引擎再写入。";
+constexpr std::string_view kErrorFileWriteFailed =
+    "错误：写入文件失败（磁盘已满或文件被占用），导出的文件不完整。";
+constexpr std::string_view kErrorCrossQueryFailed =
+    "错误：跨库查询时读取数据库失败。";
+constexpr std::string_view kErrorSetInputsInvalid =
+    "错误：集合运算至少需要两个互不相同的库。";
+constexpr std::string_view kErrorSetOperationFailed =
+    "错误：集合运算时读取或写入数据库失败。";
 }  // namespace Messages
 }  // namespace UIConfig
 #endif
@@ -1,13 +1,14 @@
 // apps/gui/imgui/impl/ui_panel.cpp
 #include "apps/gui/imgui/impl/ui_panel.hpp"
 
+#include <cstdio>
 #include <filesystem>
-#include <fstream>
 #include <stdexcept>
+#include <utility>
 
 #include "apps/cli/input_parser.hpp"
 #include "common/version.hpp"
-#include "core/io/text_file_reader.hpp"
+#include "core/io/mapped_text_reader.hpp"
 #include "imgui.h"
 #include "imgui_internal.h"
 #include "apps/gui/imgui/im_gui_presenter.hpp"
@@ -15,25 +16,200 @@
 
 // --- 不再需要 extern 和全局函数声明 ---
 
-UIPanel::UIPanel(Application& app, ThemeManager& theme_manager)
-    : app_(app), theme_manager_(theme_manager) {
+namespace {
+// 超过这么多 ID 的查询按批量任务执行并显示进度，少量查询作为交互任务插队
+constexpr size_t kBackgroundQueryIds = 10000;
+}  // namespace
+
+UIPanel::UIPanel(Application& app, ThemeManager& theme_manager,
+                 std::function<void()> wake)
+    : app_(app), theme_manager_(theme_manager), jobs_(std::move(wake)) {
   add_buffer_[0] = '\0';
   query_buffer_[0] = '\0';
   new_db_name_buffer_[0] = '\0';
   import_path_buffer_[0] = '\0';
   export_path_buffer_[0] = '\0';
-  UpdateStatusMessage();
+  check_path_buffer_[0] = '\0';
+}
+
+void UIPanel::EnqueueImport(const std::string& filepath) {
+  jobs_.Enqueue(UIConfig::Messages::ImportJobLabel(filepath),
+                [this, filepath, sorted = sorted_import_](
+                    Concurrency::JobProgress& progress) {
+                  IO::MappedTextReader reader;
+                  ImportOptions options;
+                  options.progress = &progress;
+                  options.sorted_bulk_load = sorted;
+                  app_.PerformImportFile(reader, filepath, options);
+                  PublishState();
+                });
+}
+
+void UIPanel::EnqueueExport(const std::string& filepath) {
+  jobs_.Enqueue(UIConfig::Messages::ExportJobLabel(filepath),
+                [this, filepath](Concurrency::JobProgress& progress) {
+                  app_.PerformExport(filepath, &progress);
+                  PublishState();
+                });
+}
+
+void UIPanel::EnqueueCheck(const std::string& filepath) {
+  std::filesystem::path output_dir =
+      std::filesystem::path(filepath).parent_path();
+  if (output_dir.empty()) {
+    output_dir = std::filesystem::current_path();
+  }
+  jobs_.Enqueue(UIConfig::Messages::CheckJobLabel(filepath),
+                [this, filepath, output_dir = output_dir.string()](
+                    Concurrency::JobProgress& progress) {
+                  IO::MappedTextReader reader;
+                  CheckOptions options;
+                  options.progress = &progress;
+                  app_.PerformCheckFile(reader, filepath, output_dir, options);
+                  PublishState();
+                });
 }
 
-void UIPanel::UpdateStatusMessage() {
-  status_message_ = ImGuiPresenter::Format(app_);
+void UIPanel::RunQuery() {
+  std::string text = query_buffer_;
+  const size_t id_count = Adapters::SplitIds(text).size();
+  if (id_count <= kBackgroundQueryIds) {
+    jobs_.EnqueueInteractive(
+        [this, text = std::move(text)](Concurrency::JobProgress&) {
+          app_.PerformQuery(Adapters::SplitIds(text));
+          PublishState();
+        });
+    return;
+  }
+  jobs_.Enqueue(UIConfig::Messages::QueryJobLabel(id_count),
+                [this, text = std::move(text)](
+                    Concurrency::JobProgress& progress) {
+                  app_.PerformQuery(Adapters::SplitIds(text), &progress);
+                  PublishState();
+                });
 }
 
-void UIPanel::Render() {
-  // ... 其他UI渲染代码不变 ...
+void UIPanel::EnqueueAdd() {
+  jobs_.EnqueueInteractive(
+      [this, text = std::string(add_buffer_)](Concurrency::JobProgress&) {
+        app_.PerformAdd(Adapters::SplitIds(text));
+        PanelSnapshot snapshot;
+        snapshot.clear_add_input =
+            app_.GetLastResult() == ResultCode::kAddCompleted &&
+            app_.GetLastAddResult().success_count > 0;
+        Publish(std::move(snapshot));
+      });
+}
 
-  const std::string& current_db = app_.GetCurrentDbName();
-  if (ImGui::BeginCombo("##db_combo", current_db.c_str())) { /* ... */
+void UIPanel::Publish(PanelSnapshot snapshot) {
+  snapshot.view_model = app_.GetViewModel();
+  snapshot.status_message = ImGuiPresenter::Format(app_);
+  const std::scoped_lock lock(snapshot_mutex_);
+  if (published_) {
+    // 界面线程还没取走上一份快照，保留其中仍然有效的部分
+    if (!snapshot.listing) {
+      snapshot.listing = std::move(published_->listing);
+    }
+    snapshot.clear_add_input |= published_->clear_add_input;
+    snapshot.clear_new_db_input |= published_->clear_new_db_input;
+  }
+  published_ = std::move(snapshot);
+}
+
+auto UIPanel::ApplySnapshot() -> bool {
+  std::optional<PanelSnapshot> snapshot;
+  {
+    const std::scoped_lock lock(snapshot_mutex_);
+    snapshot.swap(published_);
+  }
+  if (!snapshot) {
+    return false;
+  }
+  status_message_ = std::move(snapshot->status_message);
+  if (snapshot->view_model.revision != view_model_.revision) {
+    view_model_ = std::move(snapshot->view_model);
+    engine_text_ =
+        UIConfig::Messages::EngineStats(view_model_.repository_stats);
+    memory_text_ = UIConfig::Messages::MemoryStats(view_model_.memory_stats);
+  }
+  if (snapshot->listing) {
+    listing_ = std::move(*snapshot->listing);
+  }
+  if (snapshot->clear_add_input) {
+    add_buffer_[0] = '\0';
+  }
+  if (snapshot->clear_new_db_input) {
+    new_db_name_buffer_[0] = '\0';
+  }
+  return true;
+}
+
+void UIPanel::RenderJobProgress() {
+  const Concurrency::JobProgress* progress = jobs_.CurrentProgress();
+  ImGui::Text("%s", jobs_.CurrentLabel().c_str());
+  char overlay[96];
+  std::snprintf(overlay, sizeof(overlay), UIConfig::kJobRateOverlay,
+                progress->Rows(), progress->RowsPerSecond());
+  const double fraction = progress->Fraction();
+  // 总量未知时画来回移动的不定进度条
+  ImGui::ProgressBar(fraction < 0.0 ? -static_cast<float>(ImGui::GetTime())
+                                    : static_cast<float>(fraction),
+                     ImVec2(ImGui::GetContentRegionAvail().x * 0.7F, 0.0F),
+                     overlay);
+  ImGui::SameLine();
+  ImGui::BeginDisabled(progress->IsCancelRequested());
+  if (ImGui::Button(UIConfig::kCancelJobButton)) {
+    jobs_.CancelCurrent();
+  }
+  ImGui::EndDisabled();
+  if (jobs_.PendingCount() > 0) {
+    ImGui::Text(UIConfig::kJobPendingLabel, jobs_.PendingCount());
+  }
+}
+
+auto UIPanel::Render() -> bool {
+  if (!started_) {
+    started_ = true;
+    jobs_.EnqueueInteractive(
+        [this](Concurrency::JobProgress&) { PublishState(); });
+  }
+  bool changed = jobs_.Poll();
+  changed = ApplySnapshot() || changed;
+  if (std::string error = jobs_.TakeError(); !error.empty()) {
+    job_error_ = UIConfig::Messages::JobFailed(error);
+  }
+  if (!job_error_.empty() && !jobs_.HasBulkJob()) {
+    status_message_ = std::exchange(job_error_, {});
+  }
+
+  // 操作都提交给调度器：导入等批量任务执行期间，查询与添加仍会在
+  // 批次之间执行，切换库等操作排在批量任务之后
+  const std::string current_db = view_model_.current_db_name;
+  if (ImGui::BeginCombo("##db_combo", current_db.c_str())) {
+    if (ImGui::IsWindowAppearing()) {
+      // 展开时取一次清单，结果到达前显示上次的清单
+      jobs_.EnqueueInteractive([this](Concurrency::JobProgress&) {
+        PanelSnapshot snapshot;
+        snapshot.listing = app_.GetDatabaseListing();
+        Publish(std::move(snapshot));
+      });
+    }
+    for (const DatabaseInfo& info : listing_) {
+      const bool selected = info.name == current_db;
+      if (ImGui::Selectable(UIConfig::Messages::DatabaseLabel(info).c_str(),
+                            selected) &&
+          !selected) {
+        jobs_.Enqueue(UIConfig::Messages::SwitchJobLabel(info.name),
+                      [this, name = info.name](Concurrency::JobProgress&) {
+                        app_.SetCurrentDatabase(name);
+                        PublishState();
+                      });
+      }
+      if (selected) {
+        ImGui::SetItemDefaultFocus();
+      }
+    }
+    ImGui::EndCombo();
   }
 
   const char* themes[] = {"默认暗色", "明亮", "经典复古"};
@@ -49,22 +225,12 @@ void UIPanel::Render() {
   ImGui::PushItemWidth(ImGui::GetContentRegionAvail().x * 0.7F);
   if (ImGui::InputText("##add_id", add_buffer_, sizeof(add_buffer_),
                        ImGuiInputTextFlags_EnterReturnsTrue)) {
-    app_.PerformAdd(Adapters::SplitIds(add_buffer_));
-    UpdateStatusMessage();
-    if (app_.GetLastResult() == ResultCode::kAddCompleted &&
-        app_.GetLastAddResult().success_count > 0) {
-      add_buffer_[0] = '\0';
-    }
+    EnqueueAdd();
   }
   ImGui::PopItemWidth();
   ImGui::SameLine();
   if (ImGui::Button(UIConfig::kAddToCurrentDbButton)) {
-    app_.PerformAdd(Adapters::SplitIds(add_buffer_));
-    UpdateStatusMessage();
-    if (app_.GetLastResult() == ResultCode::kAddCompleted &&
-        app_.GetLastAddResult().success_count > 0) {
-      add_buffer_[0] = '\0';
-    }
+    EnqueueAdd();
   }
 
   ImGui::Spacing();
@@ -74,27 +240,41 @@ void UIPanel::Render() {
   ImGui::PopItemWidth();
   ImGui::SameLine();
   if (ImGui::Button(UIConfig::kCreateNewDbButton)) {
-    app_.PerformCreateDatabase(new_db_name_buffer_);
-    UpdateStatusMessage();
-    if (app_.GetLastResult() == ResultCode::kDbCreated) {
-      new_db_name_buffer_[0] = '\0';
-    }
+    std::string name = new_db_name_buffer_;
+    jobs_.Enqueue(UIConfig::Messages::CreateJobLabel(name),
+                  [this, name](Concurrency::JobProgress&) {
+                    app_.PerformCreateDatabase(name);
+                    PanelSnapshot snapshot;
+                    snapshot.clear_new_db_input =
+                        app_.GetLastResult() == ResultCode::kDbCreated;
+                    Publish(std::move(snapshot));
+                  });
   }
 
   ImGui::Separator();
 
   ImGui::Text(UIConfig::kQuerySectionHeader, current_db.c_str());
+  int engine = static_cast<int>(view_model_.query_engine);
+  ImGui::PushItemWidth(ImGui::GetContentRegionAvail().x * 0.4F);
+  if (ImGui::Combo(UIConfig::kQueryEngineCombo, &engine,
+                   UIConfig::kQueryEngineItems)) {
+    jobs_.Enqueue(UIConfig::Messages::EngineJobLabel(),
+                  [this, engine](Concurrency::JobProgress&) {
+                    app_.PerformSetQueryEngine(
+                        static_cast<QueryEngine>(engine));
+                    PublishState();
+                  });
+  }
+  ImGui::PopItemWidth();
   ImGui::PushItemWidth(ImGui::GetContentRegionAvail().x * 0.7F);
   if (ImGui::InputText("##query_id", query_buffer_, sizeof(query_buffer_),
                        ImGuiInputTextFlags_EnterReturnsTrue)) {
-    app_.PerformQuery(query_buffer_);
-    UpdateStatusMessage();
+    RunQuery();
   }
   ImGui::PopItemWidth();
   ImGui::SameLine();
   if (ImGui::Button(UIConfig::kQueryButton)) {
-    app_.PerformQuery(query_buffer_);
-    UpdateStatusMessage();
+    RunQuery();
   }
 
   ImGui::Separator();
@@ -106,19 +286,10 @@ void UIPanel::Render() {
   ImGui::PopItemWidth();
   ImGui::SameLine();
   if (ImGui::Button(UIConfig::kImportButton)) {
-    try {
-      IO::TextFileReader reader;
-      auto lines = reader.ReadAllLines(import_path_buffer_);
-      app_.PerformImportLines(lines);
-    } catch (const std::runtime_error&) {
-      app_.SetError(ErrorCode::kFileOpenFailed);
-    }
-    UpdateStatusMessage();
-    if (app_.GetLastResult() == ResultCode::kImportCompleted &&
-        app_.GetLastImportResult().success_count > 0) {
-      import_path_buffer_[0] = '\0';
-    }
+    EnqueueImport(import_path_buffer_);
+    import_path_buffer_[0] = '\0';
   }
+  ImGui::Checkbox(UIConfig::kSortedImportCheckbox, &sorted_import_);
 
   ImGui::Separator();
 
@@ -133,25 +304,30 @@ void UIPanel::Render() {
     if (out_path.empty()) {
       out_path = (std::filesystem::current_path() / "output.txt").string();
     }
-    std::vector<std::string> ids;
-    if (app_.FetchAllIds(ids)) {
-      std::ofstream out(out_path, std::ios::out | std::ios::trunc);
-      if (!out.is_open()) {
-        app_.SetError(ErrorCode::kFileOpenFailed);
-      } else {
-        for (const auto& id : ids) {
-          out << id << '\n';
-        }
-        app_.SetInfoMessage("导出完成，文件路径: " + out_path);
-      }
-    }
-    UpdateStatusMessage();
+    EnqueueExport(out_path);
   }
 
   ImGui::Separator();
 
+  ImGui::Text(UIConfig::kCheckSectionHeader);
+  ImGui::PushItemWidth(ImGui::GetContentRegionAvail().x * 0.7F);
+  ImGui::InputTextWithHint("##check_path", UIConfig::kCheckInputHint,
+                           check_path_buffer_, sizeof(check_path_buffer_));
+  ImGui::PopItemWidth();
+  ImGui::SameLine();
+  if (ImGui::Button(UIConfig::kCheckButton) && check_path_buffer_[0] != '\0') {
+    EnqueueCheck(check_path_buffer_);
+  }
+
+  ImGui::Separator();
+  if (jobs_.HasBulkJob()) {
+    RenderJobProgress();
+  }
+
   ImGui::Text(UIConfig::kStatusLabel, status_message_.c_str());
-  ImGui::Text(UIConfig::kTotalRecordsLabel, app_.GetTotalRecords());
+  ImGui::Text(UIConfig::kTotalRecordsLabel, view_model_.total_records);
+  ImGui::Text("%s", engine_text_.c_str());
+  ImGui::Text("%s", memory_text_.c_str());
 
   auto version_text =
       std::string("Version: ") + std::string(AppVersion::kVersionString);
@@ -162,5 +338,7 @@ void UIPanel::Render() {
 
   ImGui::Separator();
   ImGui::Text("字体: %s", UIConfig::kFontPath);
+
+  return changed;
 }
 
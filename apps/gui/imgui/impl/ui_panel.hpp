@@ -2,30 +2,72 @@
 #ifndef U_I_PANEL_HPP
 #define U_I_PANEL_HPP
 
+#include <functional>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <vector>
 
+#include "apps/gui/imgui/impl/background_jobs.hpp"
 #include "core/app/application.hpp"
 #include "apps/gui/imgui/impl/theme_manager.hpp"  // 包含ThemeManager
 
 class UIPanel {
  public:
-  // 构造函数现在接收一个ThemeManager的引用
-  explicit UIPanel(Application& app, ThemeManager& theme_manager);
+  // wake 在后台任务结束时于工作线程上调用，用于唤醒主循环
+  UIPanel(Application& app, ThemeManager& theme_manager,
+          std::function<void()> wake);
 
-  void Render();
+  // 本帧取到了任务结果时返回 true，主循环据此再画几帧显示结果
+  auto Render() -> bool;
+  // 把文件加入后台导入队列，拖放文件到窗口时也走这里
+  void EnqueueImport(const std::string& filepath);
+  [[nodiscard]] auto HasRunningJob() const -> bool { return jobs_.IsBusy(); }
 
  private:
-  void UpdateStatusMessage();
+  // 任务结束时在工作线程上生成、交给界面线程的显示数据
+  struct PanelSnapshot {
+    AppViewModel view_model;
+    std::string status_message;
+    std::optional<std::vector<DatabaseInfo>> listing;  // 仅列举任务填写
+    bool clear_add_input = false;
+    bool clear_new_db_input = false;
+  };
+
+  void EnqueueExport(const std::string& filepath);
+  // 结果文件写在候选清单所在的目录
+  void EnqueueCheck(const std::string& filepath);
+  // ID 较多时按批量任务执行并显示进度，否则作为交互任务插队执行
+  void RunQuery();
+  void EnqueueAdd();
+  // 以下在工作线程上、任务持有执行权时调用
+  void Publish(PanelSnapshot snapshot);
+  void PublishState() { Publish(PanelSnapshot{}); }
+  // 有新快照时复制到界面状态并返回 true
+  auto ApplySnapshot() -> bool;
+  void RenderJobProgress();
 
   Application& app_;
   ThemeManager& theme_manager_;  // 保存对ThemeManager的引用
 
   char add_buffer_[128];
-  char query_buffer_[128];
+  char query_buffer_[65536];  // 批量查询时可粘贴整份 ID 列表
   char new_db_name_buffer_[128];
   char import_path_buffer_[256];
   char export_path_buffer_[256];
+  char check_path_buffer_[256];
   std::string status_message_;
+  std::string engine_text_;
+  std::string memory_text_;
+  std::string job_error_;  // 任务异常结束的信息，任务结束后显示在状态栏
+  AppViewModel view_model_;  // 界面显示的快照副本
+  std::vector<DatabaseInfo> listing_;
+  bool sorted_import_ = false;  // 之后加入队列的导入是否走排序导入
+  bool started_ = false;  // 首帧提交初始快照任务
+
+  std::mutex snapshot_mutex_;
+  std::optional<PanelSnapshot> published_;  // 界面线程尚未取走的快照
+  BackgroundJobs jobs_;  // 放在最后：最先析构，等任务结束后再销毁上面的状态
 };
 
 #endif  // U_I_PANEL_HPP
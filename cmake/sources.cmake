@@ -8,19 +8,46 @@ set(CMD_ENTRY_SOURCE
 
 set(CORE_SOURCES
     ${CMAKE_CURRENT_SOURCE_DIR}/src/core/app/application.cpp
+    ${CMAKE_CURRENT_SOURCE_DIR}/src/core/app/candidate_check.cpp
+    ${CMAKE_CURRENT_SOURCE_DIR}/src/core/app/import_pipeline.cpp
+    ${CMAKE_CURRENT_SOURCE_DIR}/src/core/app/set_algebra.cpp
+    ${CMAKE_CURRENT_SOURCE_DIR}/src/core/data/bloom_filter.cpp
+    ${CMAKE_CURRENT_SOURCE_DIR}/src/core/data/cross_db_index.cpp
+    ${CMAKE_CURRENT_SOURCE_DIR}/src/core/data/cross_indexed_repository.cpp
     ${CMAKE_CURRENT_SOURCE_DIR}/src/core/data/fast_query_db.cpp
+    ${CMAKE_CURRENT_SOURCE_DIR}/src/core/data/hash_index_repository.cpp
+    ${CMAKE_CURRENT_SOURCE_DIR}/src/core/data/id_hash_index.cpp
+    ${CMAKE_CURRENT_SOURCE_DIR}/src/core/data/id_snapshot.cpp
+    ${CMAKE_CURRENT_SOURCE_DIR}/src/core/data/packed_id_codec.cpp
+    ${CMAKE_CURRENT_SOURCE_DIR}/src/core/data/packed_id_db.cpp
+    ${CMAKE_CURRENT_SOURCE_DIR}/src/core/data/packed_id_migrator.cpp
+    ${CMAKE_CURRENT_SOURCE_DIR}/src/core/data/snapshot_repository.cpp
+    ${CMAKE_CURRENT_SOURCE_DIR}/src/core/infrastructure/database_directory.cpp
     ${CMAKE_CURRENT_SOURCE_DIR}/src/core/infrastructure/database_manager.cpp
+    ${CMAKE_CURRENT_SOURCE_DIR}/src/core/io/buffered_text_writer.cpp
+    ${CMAKE_CURRENT_SOURCE_DIR}/src/core/io/external_id_sorter.cpp
+    ${CMAKE_CURRENT_SOURCE_DIR}/src/core/io/mapped_text_reader.cpp
+    ${CMAKE_CURRENT_SOURCE_DIR}/src/core/io/memory_mapped_file.cpp
     ${CMAKE_CURRENT_SOURCE_DIR}/src/core/io/text_file_reader.cpp
+    ${CMAKE_CURRENT_SOURCE_DIR}/src/core/service/query_protocol.cpp
+    ${CMAKE_CURRENT_SOURCE_DIR}/src/core/service/unix_socket_server.cpp
+    ${CMAKE_CURRENT_SOURCE_DIR}/src/core/utils/batch_validator.cpp
     ${CMAKE_CURRENT_SOURCE_DIR}/src/core/utils/validator.cpp
 )
 
+set(CAPI_SOURCES
+    ${CMAKE_CURRENT_SOURCE_DIR}/src/capi/avlib.cpp
+)
+
 set(CLI_SOURCES
     ${CMAKE_CURRENT_SOURCE_DIR}/apps/cli/framework/cli_app.cpp
+    ${CMAKE_CURRENT_SOURCE_DIR}/apps/cli/framework/cli_script.cpp
     ${CMAKE_CURRENT_SOURCE_DIR}/apps/cli/impl/CLICommands.cpp
 )
 
 set(GUI_SOURCES
     ${CMAKE_CURRENT_SOURCE_DIR}/apps/gui/imgui/framework/gui_app.cpp
+    ${CMAKE_CURRENT_SOURCE_DIR}/apps/gui/imgui/impl/background_jobs.cpp
     ${CMAKE_CURRENT_SOURCE_DIR}/apps/gui/imgui/impl/imgui_settings_store.cpp
     ${CMAKE_CURRENT_SOURCE_DIR}/apps/gui/imgui/impl/im_gui_view.cpp
     ${CMAKE_CURRENT_SOURCE_DIR}/apps/gui/imgui/impl/theme_manager.cpp
@@ -29,6 +29,33 @@ endif()
 
 find_package(OpenGL REQUIRED)
 find_package(SQLite3 REQUIRED)
+find_package(Threads REQUIRED)
+
+# libavlib 是共享库：发行版的 libsqlite3.a 未以 -fPIC 编译，在 ELF 平台上
+# 无法链入共享对象，静态链接时为它单独找共享版的 SQLite
+if(AVLIB_BUILD_SHARED)
+    if(AVLIB_STATIC_LINK AND NOT WIN32)
+        set(_avlib_saved_suffixes ${CMAKE_FIND_LIBRARY_SUFFIXES})
+        set(CMAKE_FIND_LIBRARY_SUFFIXES ${CMAKE_SHARED_LIBRARY_SUFFIX})
+        find_library(AVLIB_SQLITE3_SHARED_LIBRARY NAMES sqlite3 sqlite)
+        set(CMAKE_FIND_LIBRARY_SUFFIXES ${_avlib_saved_suffixes})
+        if(NOT AVLIB_SQLITE3_SHARED_LIBRARY)
+            message(FATAL_ERROR
+                "AVLIB_BUILD_SHARED needs a shared SQLite library "
+                "(libsqlite3${CMAKE_SHARED_LIBRARY_SUFFIX}) when "
+                "AVLIB_STATIC_LINK is ON. Install it, or configure with "
+                "-DAVLIB_STATIC_LINK=OFF or -DAVLIB_BUILD_SHARED=OFF.")
+        endif()
+        add_library(avlib_sqlite3 SHARED IMPORTED GLOBAL)
+        set_target_properties(avlib_sqlite3 PROPERTIES
+            IMPORTED_LOCATION "${AVLIB_SQLITE3_SHARED_LIBRARY}"
+            INTERFACE_INCLUDE_DIRECTORIES "${SQLite3_INCLUDE_DIRS}"
+        )
+    else()
+        add_library(avlib_sqlite3 INTERFACE)
+        target_link_libraries(avlib_sqlite3 INTERFACE SQLite::SQLite3)
+    endif()
+endif()
 
 add_library(imgui ${_imgui_lib_type}
     ${CMAKE_CURRENT_SOURCE_DIR}/third_party/imgui/imgui.cpp
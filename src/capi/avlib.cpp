@@ -0,0 +1,246 @@
+// capi/avlib.cpp
+#include "capi/avlib.h"
+
+#include <algorithm>
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "core/app/application.hpp"
+#include "core/infrastructure/database_manager.hpp"
+#include "core/service/query_protocol.hpp"
+
+static_assert(AVLIB_ID_SKIPPED == static_cast<int>(IdOutcome::kSkipped));
+static_assert(AVLIB_ID_INVALID == static_cast<int>(IdOutcome::kInvalid));
+static_assert(AVLIB_ID_ADDED == static_cast<int>(IdOutcome::kAdded));
+static_assert(AVLIB_ID_EXISTS == static_cast<int>(IdOutcome::kExists));
+static_assert(AVLIB_ID_FOUND == static_cast<int>(IdOutcome::kFound));
+static_assert(AVLIB_ID_MISSING == static_cast<int>(IdOutcome::kNotFound));
+
+struct avlib_db {
+  std::mutex mutex;
+  std::unique_ptr<Application> app;
+  // 跨调用复用
+  std::vector<std::string_view> ids;
+  std::string chunk;
+};
+
+namespace {
+thread_local std::string t_last_error;
+
+auto Fail(avlib_status status, std::string_view message) -> avlib_status {
+  t_last_error.assign(message);
+  return status;
+}
+
+auto Succeed() -> avlib_status {
+  t_last_error.clear();
+  return AVLIB_OK;
+}
+
+// 异常不能穿过 C 接口
+template <typename Fn>
+auto Guarded(Fn&& fn) -> avlib_status {
+  try {
+    return fn();
+  } catch (const std::exception& ex) {
+    return Fail(AVLIB_ERROR_INTERNAL, ex.what());
+  } catch (...) {
+    return Fail(AVLIB_ERROR_INTERNAL, "unknown error");
+  }
+}
+
+auto FailFromApp(const Application& app) -> avlib_status {
+  const ErrorCode error = app.GetLastError();
+  avlib_status status = AVLIB_ERROR_INTERNAL;
+  switch (error) {
+    case ErrorCode::kDbNotExist:
+      status = AVLIB_ERROR_NOT_FOUND;
+      break;
+    case ErrorCode::kDbReadOnly:
+      status = AVLIB_ERROR_READ_ONLY;
+      break;
+    default:
+      break;
+  }
+  return Fail(status, Service::ErrorToken(error));
+}
+
+// 按 '\n' 切分调用方缓冲区，视图直接指向原内存
+void SplitLines(std::string_view input, std::vector<std::string_view>& lines) {
+  lines.clear();
+  size_t begin = 0;
+  while (begin < input.size()) {
+    size_t end = input.find('\n', begin);
+    if (end == std::string_view::npos) {
+      end = input.size();
+    }
+    std::string_view line = input.substr(begin, end - begin);
+    if (!line.empty() && line.back() == '\r') {
+      line.remove_suffix(1);
+    }
+    lines.push_back(line);
+    begin = end + 1;
+  }
+}
+
+auto RunBatch(avlib_db* db, bool add, const char* ids, size_t ids_len,
+              uint8_t* outcomes, size_t out_capacity, size_t* out_count)
+    -> avlib_status {
+  if (db == nullptr || out_count == nullptr ||
+      (ids == nullptr && ids_len > 0)) {
+    return Fail(AVLIB_ERROR_INVALID_ARGUMENT, "null argument");
+  }
+  return Guarded([&] {
+    const std::scoped_lock lock(db->mutex);
+    SplitLines(std::string_view(ids, ids_len), db->ids);
+    *out_count = db->ids.size();
+    if (db->ids.empty()) {
+      return Succeed();
+    }
+    if (out_capacity < db->ids.size()) {
+      return Fail(AVLIB_ERROR_BUFFER_TOO_SMALL, "outcome buffer too small");
+    }
+    if (outcomes == nullptr) {
+      return Fail(AVLIB_ERROR_INVALID_ARGUMENT, "null outcome buffer");
+    }
+
+    Application& app = *db->app;
+    if (add) {
+      app.PerformAdd(db->ids);
+    } else {
+      app.PerformQuery(db->ids);
+    }
+    // 应用层只在每一行都是空行时报告没有 ID，按约定逐行给出 AVLIB_ID_SKIPPED
+    const ErrorCode no_ids =
+        add ? ErrorCode::kAddIdEmpty : ErrorCode::kQueryIdEmpty;
+    if (app.GetLastError() == no_ids) {
+      std::fill_n(outcomes, db->ids.size(),
+                  static_cast<uint8_t>(AVLIB_ID_SKIPPED));
+      return Succeed();
+    }
+    if (app.GetLastError() != ErrorCode::kNone) {
+      return FailFromApp(app);
+    }
+    const std::vector<IdOutcome>& results =
+        add ? app.GetLastAddResult().outcomes : app.GetLastQueryResult().outcomes;
+    for (size_t i = 0; i < results.size(); ++i) {
+      outcomes[i] = static_cast<uint8_t>(results[i]);
+    }
+    return Succeed();
+  });
+}
+}  // namespace
+
+extern "C" {
+
+auto avlib_api_version() -> int { return AVLIB_API_VERSION; }
+
+auto avlib_last_error() -> const char* { return t_last_error.c_str(); }
+
+auto avlib_open(const char* db_path, uint32_t flags, avlib_db** out_db)
+    -> avlib_status {
+  if (db_path == nullptr || *db_path == '\0' || out_db == nullptr) {
+    return Fail(AVLIB_ERROR_INVALID_ARGUMENT, "null argument");
+  }
+  if ((flags & AVLIB_OPEN_HASH_INDEX) != 0 &&
+      (flags & AVLIB_OPEN_SNAPSHOT) != 0) {
+    return Fail(AVLIB_ERROR_INVALID_ARGUMENT, "conflicting engine flags");
+  }
+  *out_db = nullptr;
+  return Guarded([&] {
+    // 路径按 UTF-8 解释
+    const std::filesystem::path path(std::u8string_view(
+        reinterpret_cast<const char8_t*>(db_path)));
+    const std::filesystem::path directory =
+        path.has_parent_path() ? path.parent_path()
+                               : std::filesystem::path(".");
+    const std::string db_name = path.filename().string();
+
+    auto handle = std::make_unique<avlib_db>();
+    handle->app = std::make_unique<Application>(
+        std::make_unique<DatabaseManager>(directory.string()));
+    Application& app = *handle->app;
+
+    if (std::filesystem::exists(path)) {
+      app.SetCurrentDatabase(db_name);
+    } else if ((flags & AVLIB_OPEN_CREATE) != 0) {
+      app.PerformCreateDatabase(db_name);
+    } else {
+      return Fail(AVLIB_ERROR_NOT_FOUND, "database file does not exist");
+    }
+    if (app.GetLastError() != ErrorCode::kNone) {
+      return FailFromApp(app);
+    }
+
+    if ((flags & (AVLIB_OPEN_HASH_INDEX | AVLIB_OPEN_SNAPSHOT)) != 0) {
+      app.PerformSetQueryEngine((flags & AVLIB_OPEN_SNAPSHOT) != 0
+                                    ? QueryEngine::kSnapshot
+                                    : QueryEngine::kHashIndex);
+      if (app.GetLastError() != ErrorCode::kNone) {
+        return FailFromApp(app);
+      }
+    }
+    *out_db = handle.release();
+    return Succeed();
+  });
+}
+
+void avlib_close(avlib_db* db) { delete db; }
+
+auto avlib_count(avlib_db* db, uint64_t* out_count) -> avlib_status {
+  if (db == nullptr || out_count == nullptr) {
+    return Fail(AVLIB_ERROR_INVALID_ARGUMENT, "null argument");
+  }
+  return Guarded([&] {
+    const std::scoped_lock lock(db->mutex);
+    *out_count = db->app->GetTotalRecords();
+    return Succeed();
+  });
+}
+
+auto avlib_exists_many(avlib_db* db, const char* ids, size_t ids_len,
+                       uint8_t* outcomes, size_t out_capacity,
+                       size_t* out_count) -> avlib_status {
+  return RunBatch(db, false, ids, ids_len, outcomes, out_capacity, out_count);
+}
+
+auto avlib_add_many(avlib_db* db, const char* ids, size_t ids_len,
+                    uint8_t* outcomes, size_t out_capacity, size_t* out_count)
+    -> avlib_status {
+  return RunBatch(db, true, ids, ids_len, outcomes, out_capacity, out_count);
+}
+
+auto avlib_for_each_id(avlib_db* db, avlib_id_visitor visitor,
+                       void* user_data) -> avlib_status {
+  if (db == nullptr || visitor == nullptr) {
+    return Fail(AVLIB_ERROR_INVALID_ARGUMENT, "null argument");
+  }
+  return Guarded([&] {
+    const std::scoped_lock lock(db->mutex);
+    Application& app = *db->app;
+    const bool completed =
+        app.VisitIds([&](std::span<const std::string_view> chunk) {
+          db->chunk.clear();
+          for (const std::string_view id : chunk) {
+            if (!db->chunk.empty()) {
+              db->chunk.push_back('\n');
+            }
+            db->chunk.append(id);
+          }
+          return visitor(user_data, db->chunk.data(), db->chunk.size(),
+                         chunk.size()) != 0;
+        });
+    if (app.GetLastError() != ErrorCode::kNone) {
+      return FailFromApp(app);
+    }
+    return completed ? Succeed()
+                     : Fail(AVLIB_ERROR_STOPPED, "stopped by visitor");
+  });
+}
+
+}  // extern "C"
@@ -0,0 +1,107 @@
+/* capi/avlib.h
+ * libavlib 的 C 接口：在调用方进程内直接打开库并批量查询/添加，
+ * 供 Python（ctypes/cffi）等语言调用，无需启动 MyAVLib_Cmd 子进程。
+ *
+ * 约定：
+ * - ID 批量以一块缓冲区传入，ID 之间以 '\n' 分隔（末尾换行可省略，行尾 '\r'
+ *   会被忽略），库直接读取调用方内存，不做拷贝。
+ * - 每个 ID 的结果写入调用方提供的 uint8_t 数组（avlib_id_outcome），
+ *   与输入行一一对应。
+ * - 所有函数返回 avlib_status；失败时 avlib_last_error() 给出本线程最近一次
+ *   错误的说明。
+ * - 同一句柄可在多个线程中使用，调用在句柄内部串行执行。
+ */
+#ifndef AVLIB_H
+#define AVLIB_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* 直接把 avlib.cpp 编进可执行文件（如测试）时定义 AVLIB_STATIC */
+#if defined(AVLIB_STATIC)
+#define AVLIB_EXPORT
+#elif defined(_WIN32)
+#if defined(AVLIB_BUILDING)
+#define AVLIB_EXPORT __declspec(dllexport)
+#else
+#define AVLIB_EXPORT __declspec(dllimport)
+#endif
+#else
+#define AVLIB_EXPORT __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 接口不兼容地变化时递增 */
+#define AVLIB_API_VERSION 1
+
+typedef struct avlib_db avlib_db;
+
+typedef enum avlib_status {
+  AVLIB_OK = 0,
+  AVLIB_ERROR_INVALID_ARGUMENT = 1,
+  AVLIB_ERROR_NOT_FOUND = 2, /* 库文件不存在 */
+  AVLIB_ERROR_READ_ONLY = 3, /* 以只读快照打开的库不能添加 */
+  AVLIB_ERROR_BUFFER_TOO_SMALL = 4,
+  AVLIB_ERROR_STOPPED = 5, /* 遍历被回调中止 */
+  AVLIB_ERROR_INTERNAL = 6
+} avlib_status;
+
+/* 与 IdOutcome 的取值一致 */
+typedef enum avlib_id_outcome {
+  AVLIB_ID_SKIPPED = 0, /* 空行 */
+  AVLIB_ID_INVALID = 1,
+  AVLIB_ID_ADDED = 2,
+  AVLIB_ID_EXISTS = 3,
+  AVLIB_ID_FOUND = 4,
+  AVLIB_ID_MISSING = 5
+} avlib_id_outcome;
+
+/* avlib_open 的 flags，可按位组合；引擎选项至多取一个 */
+#define AVLIB_OPEN_CREATE 0x1u     /* 库文件不存在时创建 */
+#define AVLIB_OPEN_HASH_INDEX 0x2u /* 全量载入内存哈希索引 */
+#define AVLIB_OPEN_SNAPSHOT 0x4u   /* mmap 只读快照 */
+
+AVLIB_EXPORT int avlib_api_version(void);
+
+/* 本线程最近一次失败的说明（UTF-8），没有错误时为空串 */
+AVLIB_EXPORT const char* avlib_last_error(void);
+
+/* 打开 db_path 指向的 .sqlite3 库；成功时 *out_db 为新句柄 */
+AVLIB_EXPORT avlib_status avlib_open(const char* db_path, uint32_t flags,
+                                     avlib_db** out_db);
+AVLIB_EXPORT void avlib_close(avlib_db* db);
+
+AVLIB_EXPORT avlib_status avlib_count(avlib_db* db, uint64_t* out_count);
+
+/* 批量查询。ids/ids_len 为以 '\n' 分隔的 ID；*out_count 返回 ID 个数。
+ * out_capacity 小于 ID 个数时返回 AVLIB_ERROR_BUFFER_TOO_SMALL，
+ * 此时 *out_count 为所需大小，outcomes 不被写入 */
+AVLIB_EXPORT avlib_status avlib_exists_many(avlib_db* db, const char* ids,
+                                            size_t ids_len, uint8_t* outcomes,
+                                            size_t out_capacity,
+                                            size_t* out_count);
+
+/* 批量添加，参数约定同 avlib_exists_many；整批在一个事务中提交 */
+AVLIB_EXPORT avlib_status avlib_add_many(avlib_db* db, const char* ids,
+                                         size_t ids_len, uint8_t* outcomes,
+                                         size_t out_capacity,
+                                         size_t* out_count);
+
+/* 遍历回调：每次收到一块以 '\n' 分隔的规范化 ID（末尾无换行），
+ * 数据只在本次回调期间有效；返回 0 中止遍历 */
+typedef int (*avlib_id_visitor)(void* user_data, const char* ids,
+                                size_t ids_len, size_t id_count);
+
+/* 流式遍历库中全部 ID，不把整库载入内存；回调中止时返回 AVLIB_ERROR_STOPPED */
+AVLIB_EXPORT avlib_status avlib_for_each_id(avlib_db* db,
+                                            avlib_id_visitor visitor,
+                                            void* user_data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AVLIB_H */
@@ -1,22 +1,42 @@
 // core/app/application.cpp
 #include "core/app/application.hpp"
 
+#include <algorithm>
+#include <exception>
+#include <filesystem>
+#include <fstream>
 #include <stdexcept>
+#include <system_error>
 #include <vector>
 
-#include "core/utils/validator.hpp"
+#include "core/io/buffered_text_writer.hpp"
+#include "core/io/external_id_sorter.hpp"
 
-// --- create_canonical_id 辅助函数 (保持不变) ---
 namespace {
-auto CreateCanonicalId(const std::string& raw_id) -> std::string {
-  std::string canonical_id;
-  canonical_id.reserve(raw_id.length());
-  for (char c : raw_id) {
-    if (Validator::IsAlphaChar(c) || Validator::IsDigitChar(c)) {
-      canonical_id += c;
-    }
+// 导入时每批交给 AddMany 的 ID 数量
+constexpr size_t kImportBatchSize = 4096;
+// 汇报进度时每批查询的 ID 数量
+constexpr size_t kQueryProgressBatch = 8192;
+// 集合运算结果写入新库时每个事务提交的 ID 数量
+constexpr size_t kSetOutputCommitIds = 100000;
+
+// 普通文件且能以只读方式打开
+auto IsReadableFile(const std::string& filepath) -> bool {
+  std::error_code ec;
+  if (!std::filesystem::is_regular_file(filepath, ec)) {
+    return false;
+  }
+  return std::ifstream(filepath, std::ios::binary).is_open();
+}
+
+auto ReaderViews(const std::vector<std::unique_ptr<IIdRepository>>& readers)
+    -> std::vector<const IIdRepository*> {
+  std::vector<const IIdRepository*> views;
+  views.reserve(readers.size());
+  for (const auto& reader : readers) {
+    views.push_back(reader.get());
   }
-  return canonical_id;
+  return views;
 }
 }  // namespace
 
@@ -59,7 +79,16 @@ void Application::PerformCreateDatabase(const std::string& new_db_name) {
   }
 }
 
-auto Application::PerformAdd(const std::vector<std::string>& ids) -> AddResult {
+auto Application::Canonicalize(std::span<const std::string_view> ids)
+    -> std::span<const std::string_view> {
+  canonical_buffer_.Clear();
+  Validator::ValidateBatch(ids, canonical_buffer_);
+  canonical_buffer_.ids.ViewsInto(canonical_views_);
+  return canonical_views_;
+}
+
+auto Application::PerformAdd(std::span<const std::string_view> ids)
+    -> AddResult {
   AddResult result;
   SetError(ErrorCode::kNone);
   IIdRepository* current_db = db_manager_->GetCurrentDb();
@@ -75,24 +104,38 @@ auto Application::PerformAdd(const std::vector<std::string>& ids) -> AddResult {
     return result;
   }
 
+  if (current_db->IsReadOnly()) {
+    SetError(ErrorCode::kDbReadOnly);
+    last_add_result_ = result;
+    return result;
+  }
+
   result.target_db_name = db_manager_->GetCurrentDbName();
 
+  // 空串不计入格式错误
+  const std::span<const std::string_view> canonical_ids = Canonicalize(ids);
+  result.outcomes.resize(ids.size());
+  for (size_t i = 0; i < ids.size(); ++i) {
+    if (ids[i].empty()) {
+      result.outcomes[i] = IdOutcome::kSkipped;
+    } else {
+      result.outcomes[i] = IdOutcome::kInvalid;
+      result.invalid_format_count++;
+    }
+  }
+  result.invalid_format_count -= canonical_ids.size();
+
   current_db->BeginTransaction();
   try {
-    for (const auto& id : ids) {
-      if (id.empty()) {
-        continue;
-      }
-      if (!Validator::IsValidIdFormat(id)) {
-        result.invalid_format_count++;
+    const std::vector<bool> added = current_db->AddMany(canonical_ids);
+    for (size_t k = 0; k < added.size(); ++k) {
+      if (added[k]) {
+        result.success_count++;
       } else {
-        std::string canonical_id = CreateCanonicalId(id);
-        if (current_db->Add(canonical_id)) {
-          result.success_count++;
-        } else {
-          result.exist_count++;
-        }
+        result.exist_count++;
       }
+      result.outcomes[canonical_buffer_.sources[k]] =
+          added[k] ? IdOutcome::kAdded : IdOutcome::kExists;
     }
     current_db->CommitTransaction();
   } catch (...) {
@@ -112,7 +155,9 @@ auto Application::PerformAdd(const std::vector<std::string>& ids) -> AddResult {
   return result;
 }
 
-auto Application::PerformQuery(const std::string& input) -> QueryResult {
+auto Application::PerformQuery(std::span<const std::string_view> ids,
+                               Concurrency::JobProgress* progress)
+    -> QueryResult {
   QueryResult result;
   SetError(ErrorCode::kNone);
   IIdRepository* current_db = db_manager_->GetCurrentDb();
@@ -122,7 +167,7 @@ auto Application::PerformQuery(const std::string& input) -> QueryResult {
     return result;
   }
 
-  if (input.empty()) {
+  if (ids.empty()) {
     SetError(ErrorCode::kQueryIdEmpty);
     last_query_result_ = result;
     return result;
@@ -130,22 +175,119 @@ auto Application::PerformQuery(const std::string& input) -> QueryResult {
 
   result.target_db_name = db_manager_->GetCurrentDbName();
 
-  if (!Validator::IsValidIdFormat(input)) {
-    result.invalid_format_count = 1;
+  // 先统一校验，合法 ID 规范化后一次性批量查询
+  const std::span<const std::string_view> canonical_ids = Canonicalize(ids);
+  std::vector<bool> found;
+  if (progress == nullptr) {
+    found = current_db->ExistsMany(canonical_ids);
   } else {
-    std::string canonical_id = CreateCanonicalId(input);
-    if (current_db->Exists(canonical_id)) {
-      result.found_count = 1;
+    progress->SetTotalUnits(canonical_ids.size());
+    for (size_t begin = 0; begin < canonical_ids.size();
+         begin += kQueryProgressBatch) {
+      if (progress->IsCancelRequested()) {
+        result.cancelled = true;
+        break;
+      }
+      const auto batch = canonical_ids.subspan(
+          begin, std::min(kQueryProgressBatch, canonical_ids.size() - begin));
+      const std::vector<bool> batch_found = current_db->ExistsMany(batch);
+      found.insert(found.end(), batch_found.begin(), batch_found.end());
+      progress->Advance(batch.size(), batch.size());
+    }
+  }
+  const std::vector<uint32_t>& sources = canonical_buffer_.sources;
+  result.outcomes.resize(ids.size(), IdOutcome::kSkipped);
+  size_t next_valid = 0;
+  for (size_t i = 0; i < ids.size(); ++i) {
+    if (ids[i].empty()) {
+      continue;
+    }
+    // 取消后未查询的合法 ID 保持 kSkipped，仍要前进到下一个合法 ID
+    if (next_valid >= found.size() && next_valid < sources.size() &&
+        sources[next_valid] == i) {
+      ++next_valid;
+      continue;
+    }
+    if (next_valid < sources.size() && sources[next_valid] == i) {
+      const bool hit = found[next_valid];
+      (hit ? result.found_ids : result.not_found_ids).Append(ids[i]);
+      result.outcomes[i] = hit ? IdOutcome::kFound : IdOutcome::kNotFound;
+      ++next_valid;
     } else {
-      result.not_found_count = 1;
+      result.invalid_ids.Append(ids[i]);
+      result.outcomes[i] = IdOutcome::kInvalid;
     }
   }
+  result.found_count = result.found_ids.Size();
+  result.not_found_count = result.not_found_ids.Size();
+  result.invalid_format_count = result.invalid_ids.Size();
+
+  if (result.found_count == 0 && result.not_found_count == 0 &&
+      result.invalid_format_count == 0 && !result.cancelled) {
+    SetError(ErrorCode::kQueryIdEmpty);
+    last_query_result_ = result;
+    return result;
+  }
 
   SetResult(ResultCode::kQueryCompleted);
   last_query_result_ = result;
   return result;
 }
 
+auto Application::PerformCrossQuery(std::span<const std::string_view> ids)
+    -> CrossQueryResult {
+  CrossQueryResult result;
+  SetError(ErrorCode::kNone);
+  if (std::ranges::all_of(ids,
+                          [](std::string_view id) { return id.empty(); })) {
+    SetError(ErrorCode::kQueryIdEmpty);
+    last_cross_query_result_ = result;
+    return result;
+  }
+
+  // 只规范化一次，各库共用同一批视图
+  const std::span<const std::string_view> canonical = Canonicalize(ids);
+  CrossDbLookup lookup;
+  try {
+    lookup = db_manager_->ExistsInAll(canonical);
+  } catch (const std::exception&) {
+    SetError(ErrorCode::kCrossQueryFailed);
+    last_cross_query_result_ = result;
+    return result;
+  }
+  result.databases = std::move(lookup.databases);
+
+  const std::vector<uint32_t>& sources = canonical_buffer_.sources;
+  result.outcomes.resize(ids.size(), IdOutcome::kSkipped);
+  result.hit_ends.reserve(ids.size());
+  size_t next_valid = 0;
+  for (size_t i = 0; i < ids.size(); ++i) {
+    if (!ids[i].empty()) {
+      if (next_valid < sources.size() && sources[next_valid] == i) {
+        const size_t hits_before = result.hit_databases.size();
+        for (size_t d = 0; d < lookup.contains.size(); ++d) {
+          if (lookup.contains[d][next_valid]) {
+            result.hit_databases.push_back(static_cast<uint32_t>(d));
+          }
+        }
+        const bool hit = result.hit_databases.size() > hits_before;
+        result.outcomes[i] = hit ? IdOutcome::kFound : IdOutcome::kNotFound;
+        ++(hit ? result.found_count : result.not_found_count);
+        ++next_valid;
+      } else {
+        result.outcomes[i] = IdOutcome::kInvalid;
+        ++result.invalid_format_count;
+      }
+    }
+    result.hit_ends.push_back(
+        static_cast<uint32_t>(result.hit_databases.size()));
+  }
+
+  SetResult(ResultCode::kCrossQueryCompleted);
+  last_cross_query_result_ = result;
+  return result;
+}
+
 void Application::SetCurrentDatabase(const std::string& db_name) {
   SetError(ErrorCode::kNone);
   if (db_manager_->SwitchToDatabase(db_name)) {
@@ -159,10 +301,53 @@ auto Application::GetDatabaseNames() const -> std::vector<std::string> {
   return db_manager_->GetAllDbNames();
 }
 
+auto Application::GetDatabaseListing() -> std::vector<DatabaseInfo> {
+  return db_manager_->ListDatabases();
+}
+
 auto Application::GetCurrentDbName() const -> const std::string& {
   return db_manager_->GetCurrentDbName();
 }
 
+auto Application::GetQueryEngine() const -> QueryEngine {
+  return db_manager_->GetQueryEngine(db_manager_->GetCurrentDbName());
+}
+
+auto Application::GetRepositoryStats() const -> RepositoryStats {
+  IIdRepository* current_db = db_manager_->GetCurrentDb();
+  return (current_db != nullptr) ? current_db->GetStats() : RepositoryStats{};
+}
+
+auto Application::GetCrossDbStats() const -> CrossDbStats {
+  try {
+    return db_manager_->GetCrossDbStats();
+  } catch (const std::exception&) {
+    return {};
+  }
+}
+
+auto Application::GetMemoryStats() const -> CatalogMemoryStats {
+  return db_manager_->GetMemoryStats();
+}
+
+void Application::SetMemoryBudget(size_t budget_bytes) {
+  db_manager_->SetMemoryBudget(budget_bytes);
+  view_model_stale_ = true;
+}
+
+auto Application::GetViewModel() -> const AppViewModel& {
+  if (view_model_stale_) {
+    view_model_stale_ = false;
+    ++view_model_.revision;
+    view_model_.current_db_name = GetCurrentDbName();
+    view_model_.total_records = GetTotalRecords();
+    view_model_.query_engine = GetQueryEngine();
+    view_model_.repository_stats = GetRepositoryStats();
+    view_model_.memory_stats = GetMemoryStats();
+  }
+  return view_model_;
+}
+
 auto Application::GetTotalRecords() const -> size_t {
   IIdRepository* current_db = db_manager_->GetCurrentDb();
   return (current_db != nullptr) ? current_db->GetCount() : 0;
@@ -188,32 +373,60 @@ auto Application::GetLastQueryResult() const -> const QueryResult& {
   return last_query_result_;
 }
 
+auto Application::GetLastCrossQueryResult() const -> const CrossQueryResult& {
+  return last_cross_query_result_;
+}
+
 auto Application::GetLastImportResult() const -> const ImportResult& {
   return last_import_result_;
 }
 
+auto Application::GetLastExportResult() const -> const ExportResult& {
+  return last_export_result_;
+}
+
+auto Application::GetLastCheckResult() const -> const CheckResult& {
+  return last_check_result_;
+}
+
+auto Application::GetLastSetOperationResult() const
+    -> const SetOperationResult& {
+  return last_set_operation_result_;
+}
+
+auto Application::GetLastMigrationResult() const
+    -> const LayoutMigrationReport& {
+  return last_migration_result_;
+}
+
+// 每个操作都以设置结果或错误结束，快照在这里统一标记为过期
 void Application::SetError(ErrorCode error) {
   last_error_ = error;
   info_message_.clear();
+  view_model_stale_ = true;
 }
 
 void Application::SetResult(ResultCode result) {
   last_result_ = result;
   last_error_ = ErrorCode::kNone;
   info_message_.clear();
+  view_model_stale_ = true;
 }
 
 void Application::ResetState(ResultCode result) {
   last_result_ = result;
   last_error_ = ErrorCode::kNone;
   info_message_.clear();
+  view_model_stale_ = true;
 }
 
 void Application::SetInfoMessage(const std::string& message) {
   info_message_ = message;
+  view_model_stale_ = true;
 }
 
-auto Application::PerformImportLines(const std::vector<std::string>& lines)
+auto Application::PerformImportLines(std::span<const std::string_view> lines,
+                                     const ImportOptions& options)
     -> ImportResult {
   ImportResult result;
   SetError(ErrorCode::kNone);
@@ -230,16 +443,46 @@ auto Application::PerformImportLines(const std::vector<std::string>& lines)
     return result;
   }
 
+  if (current_db->IsReadOnly()) {
+    SetError(ErrorCode::kDbReadOnly);
+    last_import_result_ = result;
+    return result;
+  }
+
   result.target_db_name = db_manager_->GetCurrentDbName();
 
+  if (options.sorted_bulk_load) {
+    IO::ExternalIdSorter sorter(options.sort_memory_bytes,
+                                options.sort_temp_dir);
+    for (size_t begin = 0; begin < lines.size(); begin += kImportBatchSize) {
+      const auto batch = lines.subspan(
+          begin, std::min(kImportBatchSize, lines.size() - begin));
+      for (const std::string_view id : Canonicalize(batch)) {
+        sorter.Add(id);
+      }
+      result.invalid_format_count += canonical_buffer_.invalid_count;
+    }
+    ImportCounts counts;
+    ImportPipeline::WriteSorted(sorter, *current_db, options, 0, counts);
+    result.success_count = counts.success_count;
+    result.exist_count = counts.exist_count;
+    result.duplicate_count = counts.duplicate_count;
+    result.cancelled = counts.cancelled;
+    SetResult(ResultCode::kImportCompleted);
+    last_import_result_ = result;
+    return result;
+  }
+
   current_db->BeginTransaction();
   try {
-    for (const auto& line : lines) {
-      if (!Validator::IsValidIdFormat(line)) {
-        result.invalid_format_count++;
-      } else {
-        std::string canonical_id = CreateCanonicalId(line);
-        if (current_db->Add(canonical_id)) {
+    for (size_t begin = 0; begin < lines.size(); begin += kImportBatchSize) {
+      const auto batch = lines.subspan(
+          begin, std::min(kImportBatchSize, lines.size() - begin));
+      const std::span<const std::string_view> canonical_ids =
+          Canonicalize(batch);
+      result.invalid_format_count += canonical_buffer_.invalid_count;
+      for (const bool added : current_db->AddMany(canonical_ids)) {
+        if (added) {
           result.success_count++;
         } else {
           result.exist_count++;
@@ -257,13 +500,406 @@ auto Application::PerformImportLines(const std::vector<std::string>& lines)
   return result;
 }
 
-auto Application::FetchAllIds(std::vector<std::string>& out_ids) -> bool {
+auto Application::PerformImportFile(ITextReader& reader,
+                                    const std::string& filepath,
+                                    const ImportOptions& options)
+    -> ImportResult {
+  ImportResult result;
+  SetError(ErrorCode::kNone);
+  IIdRepository* current_db = db_manager_->GetCurrentDb();
+  if (current_db == nullptr) {
+    SetError(ErrorCode::kDbNotExist);
+    last_import_result_ = result;
+    return result;
+  }
+
+  if (current_db->IsReadOnly()) {
+    SetError(ErrorCode::kDbReadOnly);
+    last_import_result_ = result;
+    return result;
+  }
+
+  result.target_db_name = db_manager_->GetCurrentDbName();
+
+  // 先确认输入可读，流水线中的异常因此都是导入中途的失败
+  if (!IsReadableFile(filepath)) {
+    SetError(ErrorCode::kFileOpenFailed);
+    last_import_result_ = result;
+    return result;
+  }
+
+  ImportCounts counts;
+  try {
+    counts = ImportPipeline::Run(reader, filepath, *current_db, options);
+  } catch (const ImportError& error) {
+    // 已提交的事务保留在库中，如实报告这部分计数
+    const ImportCounts& committed = error.Committed();
+    result.success_count = committed.success_count;
+    result.exist_count = committed.exist_count;
+    result.invalid_format_count = committed.invalid_format_count;
+    result.duplicate_count = committed.duplicate_count;
+    SetError(ErrorCode::kImportFailed);
+    last_import_result_ = result;
+    return result;
+  }
+
+  if (counts.line_count == 0) {
+    SetError(ErrorCode::kFileEmpty);
+    last_import_result_ = result;
+    return result;
+  }
+
+  result.success_count = counts.success_count;
+  result.exist_count = counts.exist_count;
+  result.invalid_format_count = counts.invalid_format_count;
+  result.duplicate_count = counts.duplicate_count;
+  result.cancelled = counts.cancelled;
+  SetResult(ResultCode::kImportCompleted);
+  last_import_result_ = result;
+  return result;
+}
+
+auto Application::PerformCheckFile(ITextReader& reader,
+                                   const std::string& filepath,
+                                   const std::string& output_dir,
+                                   const CheckOptions& options)
+    -> CheckResult {
+  CheckResult result;
+  SetError(ErrorCode::kNone);
+  IIdRepository* current_db = db_manager_->GetCurrentDb();
+  if (current_db == nullptr) {
+    SetError(ErrorCode::kDbNotExist);
+    last_check_result_ = result;
+    return result;
+  }
+
+  result.target_db_name = db_manager_->GetCurrentDbName();
+  result.output_dir = output_dir;
+
+  // 先确认输入可读，之后的 runtime_error 都归为输出文件写入失败
+  if (!IsReadableFile(filepath)) {
+    SetError(ErrorCode::kFileOpenFailed);
+    last_check_result_ = result;
+    return result;
+  }
+
+  CheckOptions effective = options;
+  // 内存索引的点查不经过 B 树，整库扫描反而更慢
+  if (effective.strategy == CheckStrategy::kAuto &&
+      GetQueryEngine() != QueryEngine::kSqlite) {
+    effective.strategy = CheckStrategy::kLookup;
+  }
+  CheckCounts counts;
+  try {
+    counts = CandidateCheck::Run(reader, filepath, *current_db, output_dir,
+                                 effective);
+  } catch (const std::runtime_error&) {
+    SetError(ErrorCode::kFileWriteFailed);
+    last_check_result_ = result;
+    return result;
+  }
+
+  if (counts.line_count == 0) {
+    SetError(ErrorCode::kFileEmpty);
+    last_check_result_ = result;
+    return result;
+  }
+
+  result.new_count = counts.new_count;
+  result.owned_count = counts.owned_count;
+  result.invalid_format_count = counts.invalid_count;
+  result.duplicate_count = counts.duplicate_count;
+  result.merge_join = counts.merge_join;
+  result.cancelled = counts.cancelled;
+  SetResult(ResultCode::kCheckCompleted);
+  last_check_result_ = result;
+  return result;
+}
+
+auto Application::VisitIds(const IdChunkVisitor& visitor) -> bool {
+  SetError(ErrorCode::kNone);
+  IIdRepository* current_db = db_manager_->GetCurrentDb();
+  if (current_db == nullptr) {
+    SetError(ErrorCode::kDbNotExist);
+    return false;
+  }
+  return current_db->ForEachId(visitor);
+}
+
+auto Application::PerformExport(const std::string& filepath,
+                                Concurrency::JobProgress* progress)
+    -> ExportResult {
+  ExportResult result;
+  SetError(ErrorCode::kNone);
+  IIdRepository* current_db = db_manager_->GetCurrentDb();
+  if (current_db == nullptr) {
+    SetError(ErrorCode::kDbNotExist);
+    last_export_result_ = result;
+    return result;
+  }
+
+  result.target_db_name = db_manager_->GetCurrentDbName();
+  result.filepath = filepath;
+
+  std::unique_ptr<IO::BufferedTextWriter> writer;
+  try {
+    writer = std::make_unique<IO::BufferedTextWriter>(filepath);
+  } catch (const std::runtime_error&) {
+    SetError(ErrorCode::kFileOpenFailed);
+    last_export_result_ = result;
+    return result;
+  }
+
+  if (progress != nullptr) {
+    progress->SetTotalUnits(current_db->GetCount());
+  }
+  // 按块直接从仓储写入文件，内存占用与库大小无关
+  try {
+    result.cancelled = !current_db->ForEachId(
+        [&writer, progress](std::span<const std::string_view> chunk) {
+          for (const std::string_view id : chunk) {
+            writer->WriteLine(id);
+          }
+          if (progress == nullptr) {
+            return true;
+          }
+          progress->Advance(chunk.size(), chunk.size());
+          return !progress->IsCancelRequested();
+        });
+    writer->Close();
+  } catch (const std::runtime_error&) {
+    result.exported_count = writer->LinesWritten();
+    SetError(ErrorCode::kFileWriteFailed);
+    last_export_result_ = result;
+    return result;
+  }
+
+  result.exported_count = writer->LinesWritten();
+  if (result.cancelled) {
+    std::error_code ec;
+    std::filesystem::remove(filepath, ec);
+  }
+  SetResult(ResultCode::kExportCompleted);
+  last_export_result_ = result;
+  return result;
+}
+
+auto Application::PerformMigrateToPackedLayout() -> LayoutMigrationReport {
+  LayoutMigrationReport result;
+  SetError(ErrorCode::kNone);
+  if (db_manager_->GetCurrentDb() == nullptr) {
+    SetError(ErrorCode::kDbNotExist);
+    last_migration_result_ = result;
+    return result;
+  }
+
+  auto report = db_manager_->MigrateToPackedLayout(GetCurrentDbName());
+  if (!report) {
+    SetError(ErrorCode::kDbMigrateFailed);
+    last_migration_result_ = result;
+    return result;
+  }
+
+  result = *report;
+  SetResult(ResultCode::kDbMigrated);
+  last_migration_result_ = result;
+  return result;
+}
+
+void Application::PerformSetQueryEngine(QueryEngine engine) {
+  SetError(ErrorCode::kNone);
+  if (db_manager_->GetCurrentDb() == nullptr) {
+    SetError(ErrorCode::kDbNotExist);
+    return;
+  }
+  if (db_manager_->SetQueryEngine(GetCurrentDbName(), engine)) {
+    SetResult(ResultCode::kEngineSwitched);
+  } else {
+    SetError(ErrorCode::kEngineSwitchFailed);
+  }
+}
+
+void Application::PerformRebuildFilter(double false_positive_rate) {
   SetError(ErrorCode::kNone);
   IIdRepository* current_db = db_manager_->GetCurrentDb();
   if (current_db == nullptr) {
     SetError(ErrorCode::kDbNotExist);
+    return;
+  }
+  if (current_db->RebuildFilter(false_positive_rate)) {
+    SetResult(ResultCode::kFilterRebuilt);
+  } else {
+    SetError(ErrorCode::kFilterRebuildFailed);
+  }
+}
+
+auto Application::OpenSetInputs(
+    std::span<const std::string> inputs,
+    std::vector<std::unique_ptr<IIdRepository>>& readers) -> bool {
+  std::vector<std::string> sorted(inputs.begin(), inputs.end());
+  std::ranges::sort(sorted);
+  if (sorted.size() < 2 ||
+      std::ranges::adjacent_find(sorted) != sorted.end()) {
+    SetError(ErrorCode::kSetInputsInvalid);
+    return false;
+  }
+
+  // 每个输入各用一个独立连接，归并时由各自的读取线程使用
+  try {
+    for (const std::string& db_name : inputs) {
+      readers.push_back(db_manager_->OpenReader(db_name));
+      if (!readers.back()) {
+        SetError(ErrorCode::kDbNotExist);
+        return false;
+      }
+    }
+  } catch (const std::exception&) {
+    SetError(ErrorCode::kSetOperationFailed);
     return false;
   }
-  out_ids = current_db->GetAllIds();
   return true;
 }
+
+auto Application::PerformSetOperationToDatabase(
+    SetOperation operation, std::span<const std::string> inputs,
+    const std::string& new_db_name) -> SetOperationResult {
+  SetOperationResult result;
+  result.operation = operation;
+  result.inputs.assign(inputs.begin(), inputs.end());
+  SetError(ErrorCode::kNone);
+  if (new_db_name.empty()) {
+    SetError(ErrorCode::kDbNameEmpty);
+    last_set_operation_result_ = result;
+    return result;
+  }
+  result.target = new_db_name;
+  if (result.target.find(".sqlite3") == std::string::npos) {
+    result.target += ".sqlite3";
+  }
+  if (db_manager_->DatabaseExists(result.target)) {
+    SetError(ErrorCode::kDbNameExists);
+    last_set_operation_result_ = result;
+    return result;
+  }
+
+  std::vector<std::unique_ptr<IIdRepository>> readers;
+  if (!OpenSetInputs(inputs, readers)) {
+    last_set_operation_result_ = result;
+    return result;
+  }
+
+  const std::string previous_db_name = db_manager_->GetCurrentDbName();
+  if (!db_manager_->CreateDatabase(result.target)) {
+    SetError(ErrorCode::kDbCreateFailed);
+    last_set_operation_result_ = result;
+    return result;
+  }
+
+  // 结果已按字节序排好，直接顺序写入新库，分批提交控制事务大小
+  IIdRepository* output = db_manager_->GetCurrentDb();
+  bool failed = false;
+  size_t uncommitted = 0;
+  output->BeginTransaction();
+  try {
+    const SetMergeCounts counts = SetAlgebra::Merge(
+        operation, ReaderViews(readers),
+        [&](std::span<const std::string_view> chunk) {
+          (void)output->AddMany(chunk);
+          uncommitted += chunk.size();
+          if (uncommitted >= kSetOutputCommitIds) {
+            output->CommitTransaction();
+            output->BeginTransaction();
+            uncommitted = 0;
+          }
+          return true;
+        });
+    output->CommitTransaction();
+    result.input_counts = counts.input_counts;
+    result.output_count = counts.output_count;
+  } catch (const std::exception&) {
+    output->RollbackTransaction();
+    failed = true;
+  }
+
+  // 切回原来的库。原来没有库、原库已被删除或无法打开时停留在新库上：
+  // 成功时新库即当前库；失败时新库随后被删除，之后的操作报告库不存在
+  result.restored_previous = !previous_db_name.empty() &&
+                             db_manager_->DatabaseExists(previous_db_name) &&
+                             db_manager_->SwitchToDatabase(previous_db_name);
+  if (failed) {
+    // 已提交的批次无法回滚，删除写了一半的新库（删除失败时由目录输出原因）
+    (void)db_manager_->DeleteDatabase(result.target);
+    SetError(ErrorCode::kSetOperationFailed);
+  } else {
+    SetResult(ResultCode::kSetOperationCompleted);
+  }
+  last_set_operation_result_ = result;
+  return result;
+}
+
+auto Application::PerformSetOperationToFile(SetOperation operation,
+                                            std::span<const std::string> inputs,
+                                            const std::string& filepath)
+    -> SetOperationResult {
+  SetOperationResult result;
+  result.operation = operation;
+  result.inputs.assign(inputs.begin(), inputs.end());
+  result.target = filepath;
+  result.to_file = true;
+  SetError(ErrorCode::kNone);
+
+  std::vector<std::unique_ptr<IIdRepository>> readers;
+  if (!OpenSetInputs(inputs, readers)) {
+    last_set_operation_result_ = result;
+    return result;
+  }
+
+  std::unique_ptr<IO::BufferedTextWriter> writer;
+  try {
+    writer = std::make_unique<IO::BufferedTextWriter>(filepath);
+  } catch (const std::runtime_error&) {
+    SetError(ErrorCode::kFileOpenFailed);
+    last_set_operation_result_ = result;
+    return result;
+  }
+
+  // 写盘失败与读库失败分开报告：前者在访问者内截获并中止归并
+  bool write_failed = false;
+  try {
+    const SetMergeCounts counts = SetAlgebra::Merge(
+        operation, ReaderViews(readers),
+        [&](std::span<const std::string_view> chunk) {
+          try {
+            for (const std::string_view id : chunk) {
+              writer->WriteLine(id);
+            }
+          } catch (const std::runtime_error&) {
+            write_failed = true;
+            return false;
+          }
+          return true;
+        });
+    result.input_counts = counts.input_counts;
+  } catch (const std::exception&) {
+    result.output_count = writer->LinesWritten();
+    SetError(ErrorCode::kSetOperationFailed);
+    last_set_operation_result_ = result;
+    return result;
+  }
+  if (!write_failed) {
+    try {
+      writer->Close();
+    } catch (const std::runtime_error&) {
+      write_failed = true;
+    }
+  }
+
+  result.output_count = writer->LinesWritten();
+  if (write_failed) {
+    SetError(ErrorCode::kFileWriteFailed);
+  } else {
+    SetResult(ResultCode::kSetOperationCompleted);
+  }
+  last_set_operation_result_ = result;
+  return result;
+}
@@ -2,11 +2,23 @@
 #ifndef APPLICATION_HPP
 #define APPLICATION_HPP
 
+#include <concepts>
+#include <cstdint>
 #include <memory>
+#include <ranges>
+#include <span>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <vector>
 
+#include "core/app/candidate_check.hpp"
+#include "core/app/import_pipeline.hpp"
+#include "core/app/set_algebra.hpp"
 #include "core/ports/i_database_catalog.hpp"
+#include "core/ports/i_text_reader.hpp"
+#include "core/utils/batch_validator.hpp"
+#include "core/utils/id_list.hpp"
 
 enum class ResultCode {
   kIdle,
@@ -16,7 +28,14 @@ enum class ResultCode {
   kDbCreated,
   kAddCompleted,
   kQueryCompleted,
-  kImportCompleted
+  kImportCompleted,
+  kDbMigrated,
+  kEngineSwitched,
+  kFilterRebuilt,
+  kExportCompleted,
+  kCrossQueryCompleted,
+  kSetOperationCompleted,
+  kCheckCompleted
 };
 
 enum class ErrorCode {
@@ -29,13 +48,33 @@ enum class ErrorCode {
   kQueryIdEmpty,
   kIdInvalid,
   kFileOpenFailed,
-  kFileEmpty
+  kFileEmpty,
+  kDbMigrateFailed,
+  kEngineSwitchFailed,
+  kFilterRebuildFailed,
+  kDbReadOnly,
+  kFileWriteFailed,
+  kCrossQueryFailed,
+  kSetInputsInvalid,
+  kSetOperationFailed,
+  kImportFailed
+};
+
+// 单个输入 ID 的处理结果，按输入顺序逐一记录
+enum class IdOutcome : uint8_t {
+  kSkipped,  // 空串，不参与处理
+  kInvalid,
+  kAdded,
+  kExists,
+  kFound,
+  kNotFound
 };
 
 struct AddResult {
   size_t success_count = 0;
   size_t exist_count = 0;
   size_t invalid_format_count = 0;
+  std::vector<IdOutcome> outcomes;  // 与输入一一对应
   std::string target_db_name;
 };
 
@@ -43,16 +82,95 @@ struct QueryResult {
   size_t found_count = 0;
   size_t not_found_count = 0;
   size_t invalid_format_count = 0;
+  std::vector<IdOutcome> outcomes;  // 与输入一一对应
+  // 逐个 ID 的查询结果，保存用户输入的原始写法
+  IdList found_ids;
+  IdList not_found_ids;
+  IdList invalid_ids;
   std::string target_db_name;
+  bool cancelled = false;  // 被取消时只有前面的部分输入有结果
+};
+
+// 跨库查询结果：每个输入 ID 命中了哪些库
+struct CrossQueryResult {
+  size_t found_count = 0;  // 至少在一个库中存在
+  size_t not_found_count = 0;
+  size_t invalid_format_count = 0;
+  std::vector<std::string> databases;  // 参与查询的库，按名称排序
+  std::vector<IdOutcome> outcomes;     // 与输入一一对应
+  // 第 i 个输入命中的库下标为 hit_databases[hit_ends[i-1], hit_ends[i])
+  std::vector<uint32_t> hit_databases;
+  std::vector<uint32_t> hit_ends;
+
+  [[nodiscard]] auto HitsOf(size_t index) const -> std::span<const uint32_t> {
+    const size_t begin = index == 0 ? 0 : hit_ends[index - 1];
+    return std::span(hit_databases).subspan(begin, hit_ends[index] - begin);
+  }
 };
 
 struct ImportResult {
   size_t success_count = 0;
   size_t exist_count = 0;
   size_t invalid_format_count = 0;
+  size_t duplicate_count = 0;  // 排序导入时文件内的重复行
+  std::string target_db_name;
+  bool cancelled = false;  // 被取消时已写入的部分仍然保留
+};
+
+struct ExportResult {
+  size_t exported_count = 0;
+  std::string target_db_name;
+  std::string filepath;
+  bool cancelled = false;  // 被取消时不完整的文件已删除
+};
+
+// 候选清单核对结果；三个输出文件位于 output_dir
+struct CheckResult {
+  size_t new_count = 0;
+  size_t owned_count = 0;
+  size_t invalid_format_count = 0;
+  size_t duplicate_count = 0;  // 文件内重复出现的合法 ID
   std::string target_db_name;
+  std::string output_dir;
+  bool merge_join = false;  // 采用了归并连接而非逐块查询
+  bool cancelled = false;   // 被取消时输出文件不完整
 };
 
+// 库间集合运算的结果；输出到库时 target 为新库名，否则为文件路径
+struct SetOperationResult {
+  SetOperation operation = SetOperation::kUnion;
+  std::vector<std::string> inputs;
+  std::vector<size_t> input_counts;  // 各输入实际读出的 ID 数
+  size_t output_count = 0;
+  std::string target;
+  bool to_file = false;
+  // 写入新库后已切回原来的库；为 false 时当前库是新库（失败时已被删除）
+  bool restored_previous = false;
+};
+
+// 界面渲染所需的状态快照。每次操作结束后标记为过期，下一次读取时重建，
+// 因此界面逐帧读取也不会访问数据库
+struct AppViewModel {
+  uint64_t revision = 0;  // 每次重建加一，界面据此判断内容是否变化
+  std::string current_db_name;
+  size_t total_records = 0;
+  QueryEngine query_engine = QueryEngine::kSqlite;
+  RepositoryStats repository_stats;
+  CatalogMemoryStats memory_stats;
+};
+
+// 元素可视为 string_view 的任意输入区间（如 std::vector<std::string>）；
+// 元素须为左值或 string_view，保证视图在调用期间有效
+template <typename Range>
+concept IdInputRange =
+    std::ranges::input_range<Range> &&
+    std::convertible_to<std::ranges::range_reference_t<Range>,
+                        std::string_view> &&
+    (std::is_lvalue_reference_v<std::ranges::range_reference_t<Range>> ||
+     std::same_as<std::remove_cvref_t<std::ranges::range_reference_t<Range>>,
+                  std::string_view>) &&
+    !std::convertible_to<Range, std::span<const std::string_view>>;
+
 class Application {
  public:
   explicit Application(std::unique_ptr<IDatabaseCatalog> db_catalog);
@@ -60,13 +178,71 @@ class Application {
 
   // --- Business Logic ---
   void LoadDatabase();
-  auto PerformAdd(const std::vector<std::string>& ids) -> AddResult;
-  auto PerformQuery(const std::string& input) -> QueryResult;
+  // 输入为视图，规范化结果写入复用的缓冲区，稳态下不为单个 ID 分配内存
+  auto PerformAdd(std::span<const std::string_view> ids) -> AddResult;
+  // progress 非空时分批查询，汇报进度并在批次之间响应取消
+  auto PerformQuery(std::span<const std::string_view> ids,
+                    Concurrency::JobProgress* progress = nullptr)
+      -> QueryResult;
+  // 在数据目录下的全部库中并行查询，不要求已打开当前库
+  auto PerformCrossQuery(std::span<const std::string_view> ids)
+      -> CrossQueryResult;
   void PerformCreateDatabase(const std::string& new_db_name);
   void SetCurrentDatabase(const std::string& db_name);
-  auto PerformImportLines(const std::vector<std::string>& lines)
-      -> ImportResult;
-  auto FetchAllIds(std::vector<std::string>& out_ids) -> bool;
+  // options 中只有排序导入相关的选项生效
+  auto PerformImportLines(std::span<const std::string_view> lines,
+                          const ImportOptions& options = {}) -> ImportResult;
+
+  template <IdInputRange Range>
+  auto PerformAdd(Range&& ids) -> AddResult {
+    return PerformAdd(CollectViews(ids));
+  }
+  template <IdInputRange Range>
+  auto PerformQuery(Range&& ids) -> QueryResult {
+    return PerformQuery(CollectViews(ids));
+  }
+  template <IdInputRange Range>
+  auto PerformCrossQuery(Range&& ids) -> CrossQueryResult {
+    return PerformCrossQuery(CollectViews(ids));
+  }
+  template <IdInputRange Range>
+  auto PerformImportLines(Range&& lines, const ImportOptions& options = {})
+      -> ImportResult {
+    return PerformImportLines(CollectViews(lines), options);
+  }
+  // 经多线程流水线流式导入文件，文件不会整体载入内存
+  auto PerformImportFile(ITextReader& reader, const std::string& filepath,
+                         const ImportOptions& options = {}) -> ImportResult;
+  // 流式核对候选清单，把其中的 ID 分为库中没有的、已有的与格式错误的
+  // 三类，分别写入 output_dir 下的 new.txt、owned.txt 与 invalid.txt。
+  // 不修改当前库；非 SQLite 引擎下 kAuto 按逐块查询处理
+  auto PerformCheckFile(ITextReader& reader, const std::string& filepath,
+                        const std::string& output_dir,
+                        const CheckOptions& options = {}) -> CheckResult;
+  // 流式导出当前库全部 ID 到文本文件，每行一个；
+  // progress 非空时按块汇报进度，取消后删除不完整的文件
+  auto PerformExport(const std::string& filepath,
+                     Concurrency::JobProgress* progress = nullptr)
+      -> ExportResult;
+  // 流式遍历当前库全部 ID；遍历完成返回 true，
+  // 被访问者中止或没有打开的库（kDbNotExist）时返回 false
+  auto VisitIds(const IdChunkVisitor& visitor) -> bool;
+  auto PerformMigrateToPackedLayout() -> LayoutMigrationReport;
+  void PerformSetQueryEngine(QueryEngine engine);
+  void PerformRebuildFilter(double false_positive_rate);
+  // 全部打开的库共用的内存预算，超出时按 LRU 关闭当前库以外的库
+  void SetMemoryBudget(size_t budget_bytes);
+  // 对两个以上的库做流式集合运算（差集为第一个库减去其余各库），
+  // 结果写入新建的库，完成后切回原来的当前库
+  auto PerformSetOperationToDatabase(SetOperation operation,
+                                     std::span<const std::string> inputs,
+                                     const std::string& new_db_name)
+      -> SetOperationResult;
+  // 同上，结果按字节序逐行写入文本文件
+  auto PerformSetOperationToFile(SetOperation operation,
+                                 std::span<const std::string> inputs,
+                                 const std::string& filepath)
+      -> SetOperationResult;
 
   // --- Status Getters and Setters ---
   [[nodiscard]] auto GetLastResult() const -> ResultCode;
@@ -74,7 +250,15 @@ class Application {
   [[nodiscard]] auto GetInfoMessage() const -> const std::string&;
   [[nodiscard]] auto GetLastAddResult() const -> const AddResult&;
   [[nodiscard]] auto GetLastQueryResult() const -> const QueryResult&;
+  [[nodiscard]] auto GetLastCrossQueryResult() const
+      -> const CrossQueryResult&;
   [[nodiscard]] auto GetLastImportResult() const -> const ImportResult&;
+  [[nodiscard]] auto GetLastExportResult() const -> const ExportResult&;
+  [[nodiscard]] auto GetLastCheckResult() const -> const CheckResult&;
+  [[nodiscard]] auto GetLastSetOperationResult() const
+      -> const SetOperationResult&;
+  [[nodiscard]] auto GetLastMigrationResult() const
+      -> const LayoutMigrationReport&;
   void SetError(ErrorCode error);
   void SetResult(ResultCode result);
   void ResetState(ResultCode result = ResultCode::kIdle);
@@ -83,15 +267,52 @@ class Application {
   // --- Data Getters ---
   [[nodiscard]] auto GetTotalRecords() const -> size_t;
   [[nodiscard]] auto GetDatabaseNames() const -> std::vector<std::string>;
+  // 带大小、记录数与修改时间的库清单，来自内存缓存，适合每帧调用
+  auto GetDatabaseListing() -> std::vector<DatabaseInfo>;
   [[nodiscard]] auto GetCurrentDbName() const -> const std::string&;
+  [[nodiscard]] auto GetQueryEngine() const -> QueryEngine;
+  [[nodiscard]] auto GetRepositoryStats() const -> RepositoryStats;
+  // 各库数量及其并集、交集大小，首次调用时构建跨库索引
+  [[nodiscard]] auto GetCrossDbStats() const -> CrossDbStats;
+  [[nodiscard]] auto GetMemoryStats() const -> CatalogMemoryStats;
+  // 上次操作之后的状态快照，仅在快照过期时查询数据库
+  auto GetViewModel() -> const AppViewModel&;
 
  private:
+  template <typename Range>
+  auto CollectViews(Range& ids) -> std::span<const std::string_view> {
+    input_views_.clear();
+    for (const std::string_view id : ids) {
+      input_views_.push_back(id);
+    }
+    return input_views_;
+  }
+  // 校验输入库并为每个库另开读取连接，失败时设置错误码并返回 false
+  auto OpenSetInputs(std::span<const std::string> inputs,
+                     std::vector<std::unique_ptr<IIdRepository>>& readers)
+      -> bool;
+  // 校验并规范化到 canonical_buffer_，返回规范化结果的视图（下次调用前有效）
+  auto Canonicalize(std::span<const std::string_view> ids)
+      -> std::span<const std::string_view>;
+
   std::unique_ptr<IDatabaseCatalog> db_manager_;
   ResultCode last_result_;
   ErrorCode last_error_;
   std::string info_message_;
   AddResult last_add_result_;
   QueryResult last_query_result_;
+  CrossQueryResult last_cross_query_result_;
   ImportResult last_import_result_;
+  ExportResult last_export_result_;
+  CheckResult last_check_result_;
+  SetOperationResult last_set_operation_result_;
+  LayoutMigrationReport last_migration_result_;
+  AppViewModel view_model_;
+  bool view_model_stale_ = true;
+
+  // 跨调用复用的缓冲区
+  std::vector<std::string_view> input_views_;
+  Validator::CanonicalIdBuffer canonical_buffer_;
+  std::vector<std::string_view> canonical_views_;
 };
 #endif
@@ -0,0 +1,193 @@
+// core/app/candidate_check.cpp
+#include "core/app/candidate_check.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <span>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "core/app/sorted_cursor.hpp"
+#include "core/io/buffered_text_writer.hpp"
+#include "core/utils/batch_validator.hpp"
+
+namespace CandidateCheck {
+
+namespace {
+constexpr size_t kCursorQueueDepth = 4;
+
+// 比对阶段的进度：去重后的 ID 数事先未知，按已比对的 ID 占输入的比例折算
+class CompareProgress {
+ public:
+  CompareProgress(Concurrency::JobProgress* progress, size_t total_units,
+                  size_t input_count)
+      : progress_(progress),
+        total_units_(total_units),
+        input_count_(input_count) {}
+
+  // 返回 false 表示已请求取消
+  auto Advance(size_t ids) -> bool {
+    if (progress_ == nullptr) {
+      return true;
+    }
+    compared_ += ids;
+    const size_t units =
+        input_count_ == 0 ? 0 : total_units_ * compared_ / input_count_;
+    progress_->Advance(0, units - std::min(units, reported_units_));
+    reported_units_ = std::max(units, reported_units_);
+    return !progress_->IsCancelRequested();
+  }
+  // 重复的 ID 不会交给比对，结束时补齐剩余的进度
+  void Finish() {
+    if (progress_ != nullptr && reported_units_ < total_units_) {
+      progress_->Advance(0, total_units_ - reported_units_);
+      reported_units_ = total_units_;
+    }
+  }
+
+ private:
+  Concurrency::JobProgress* progress_;
+  size_t total_units_;
+  size_t input_count_;
+  size_t compared_ = 0;
+  size_t reported_units_ = 0;
+};
+
+// 读取阶段：格式错误的行直接写出，合法 ID 交给 sorter；被取消时返回 false
+auto Collect(ITextReader& reader, const std::string& filepath,
+             const CheckOptions& options, IO::BufferedTextWriter& invalid,
+             IO::ExternalIdSorter& sorter, CheckCounts& counts) -> bool {
+  Concurrency::JobProgress* progress = options.progress;
+  Validator::CanonicalIdBuffer canonical;
+  bool cancelled = false;
+  reader.ReadLineBatches(
+      filepath, std::max<size_t>(options.read_batch_lines, 1),
+      [&](LineBatch&& batch) {
+        canonical.Clear();
+        Validator::ValidateBatch(batch.lines, canonical);
+        counts.line_count += batch.lines.size();
+        // 不在 sources 中的行即格式错误；空行不算
+        size_t next_valid = 0;
+        size_t bytes = 0;
+        for (size_t i = 0; i < batch.lines.size(); ++i) {
+          const std::string_view line = batch.lines[i];
+          bytes += line.size() + 1;
+          if (next_valid < canonical.sources.size() &&
+              canonical.sources[next_valid] == i) {
+            ++next_valid;
+          } else if (!line.empty()) {
+            invalid.WriteLine(line);
+            ++counts.invalid_count;
+          }
+        }
+        for (const std::string_view id : canonical.ids) {
+          sorter.Add(id);
+        }
+        if (progress == nullptr) {
+          return true;
+        }
+        progress->Advance(batch.lines.size(), bytes);
+        // 这一阶段不访问仓储，随时可以让出执行权
+        progress->Checkpoint();
+        cancelled = progress->IsCancelRequested();
+        return !cancelled;
+      });
+  return !cancelled;
+}
+
+void WriteOutcome(bool owned, std::string_view id,
+                  IO::BufferedTextWriter& new_ids,
+                  IO::BufferedTextWriter& owned_ids, CheckCounts& counts) {
+  if (owned) {
+    owned_ids.WriteLine(id);
+    ++counts.owned_count;
+  } else {
+    new_ids.WriteLine(id);
+    ++counts.new_count;
+  }
+}
+}  // namespace
+
+auto Run(ITextReader& reader, const std::string& filepath,
+         const IIdRepository& repository, const std::string& output_dir,
+         const CheckOptions& options) -> CheckCounts {
+  const std::filesystem::path dir(output_dir);
+  std::filesystem::create_directories(dir);
+  IO::BufferedTextWriter new_ids((dir / kNewFileName).string());
+  IO::BufferedTextWriter owned_ids((dir / kOwnedFileName).string());
+  IO::BufferedTextWriter invalid((dir / kInvalidFileName).string());
+
+  std::error_code ec;
+  const auto file_size = std::filesystem::file_size(filepath, ec);
+  const size_t file_bytes = ec ? 0 : static_cast<size_t>(file_size);
+  if (options.progress != nullptr) {
+    options.progress->SetTotalUnits(file_bytes * 2);
+  }
+
+  CheckCounts counts;
+  IO::ExternalIdSorter sorter(options.sort_memory_bytes,
+                              options.sort_temp_dir);
+  if (!Collect(reader, filepath, options, invalid, sorter, counts)) {
+    counts.cancelled = true;
+    new_ids.Close();
+    owned_ids.Close();
+    invalid.Close();
+    return counts;
+  }
+
+  const size_t candidates = sorter.InputCount();
+  counts.merge_join =
+      options.strategy == CheckStrategy::kMergeJoin ||
+      (options.strategy == CheckStrategy::kAuto &&
+       candidates * kMergeJoinRatio >= repository.GetCount());
+  CompareProgress progress(options.progress, file_bytes, candidates);
+  IO::SortCounts sorted;
+  if (counts.merge_join) {
+    // 候选与库都按字节序前进，整库只顺序读一遍
+    SortedCursor cursor(repository, kCursorQueueDepth);
+    try {
+      cursor.Refill();
+      sorted = sorter.Merge([&](std::span<const std::string_view> chunk) {
+        for (const std::string_view id : chunk) {
+          while (!cursor.Exhausted() && cursor.Head() < id) {
+            cursor.Advance();
+          }
+          WriteOutcome(!cursor.Exhausted() && cursor.Head() == id, id, new_ids,
+                       owned_ids, counts);
+        }
+        counts.cancelled = !progress.Advance(chunk.size());
+        return !counts.cancelled;
+      });
+    } catch (...) {
+      cursor.Stop();
+      throw;
+    }
+    // 候选比对完时库可能还没读完，提前结束读取线程
+    cursor.Stop();
+    cursor.RethrowIfFailed();
+  } else {
+    // 有序的候选落在相邻的 B 树页上，点查的缓存命中率也更高
+    sorted = sorter.Merge([&](std::span<const std::string_view> chunk) {
+      const std::vector<bool> found = repository.ExistsMany(chunk);
+      for (size_t i = 0; i < chunk.size(); ++i) {
+        WriteOutcome(found[i], chunk[i], new_ids, owned_ids, counts);
+      }
+      counts.cancelled = !progress.Advance(chunk.size());
+      if (options.progress != nullptr && !counts.cancelled) {
+        options.progress->Checkpoint();
+      }
+      return !counts.cancelled;
+    });
+  }
+  counts.duplicate_count = sorted.duplicate_count;
+  if (!counts.cancelled) {
+    progress.Finish();
+  }
+  new_ids.Close();
+  owned_ids.Close();
+  invalid.Close();
+  return counts;
+}
+
+}  // namespace CandidateCheck
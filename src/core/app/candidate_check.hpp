@@ -0,0 +1,56 @@
+// core/app/candidate_check.hpp
+#ifndef CANDIDATE_CHECK_HPP
+#define CANDIDATE_CHECK_HPP
+
+#include <cstddef>
+#include <string>
+
+#include "core/concurrency/job_progress.hpp"
+#include "core/io/external_id_sorter.hpp"
+#include "core/ports/i_id_repository.hpp"
+#include "core/ports/i_text_reader.hpp"
+
+enum class CheckStrategy {
+  kAuto,       // 候选较多时归并连接，否则逐块查询
+  kLookup,     // 有序的候选分块 ExistsMany，适合候选远少于库或内存索引
+  kMergeJoin   // 与按主键顺序读出的库归并连接，整库只顺序扫描一遍
+};
+
+struct CheckOptions {
+  CheckStrategy strategy = CheckStrategy::kAuto;
+  size_t read_batch_lines = 8192;
+  size_t sort_memory_bytes = IO::ExternalIdSorter::kDefaultMemoryBytes;
+  std::string sort_temp_dir;  // 为空时使用系统临时目录
+  // 非空时汇报进度（读取与比对两个阶段各占一半），在批次之间检查取消请求
+  Concurrency::JobProgress* progress = nullptr;
+};
+
+struct CheckCounts {
+  size_t line_count = 0;
+  size_t new_count = 0;        // 库中没有的不重复 ID
+  size_t owned_count = 0;      // 库中已有的不重复 ID
+  size_t invalid_count = 0;    // 格式错误的行
+  size_t duplicate_count = 0;  // 文件内重复出现的合法 ID
+  bool merge_join = false;     // 实际采用的是归并连接
+  bool cancelled = false;      // 被取消时已写出的文件保持不完整
+};
+
+// 核对候选清单：流式读取文件，把规范化后的合法 ID 交给外部排序去重，
+// 再与当前库比对，按字节序写入 new.txt（库中没有）与 owned.txt（库中已有）；
+// 格式错误的原始行按输入顺序写入 invalid.txt。三个文件位于 output_dir，
+// 已存在时覆盖。文件不会整体载入，内存占用受 sort_memory_bytes 限制。
+// 归并连接期间读取线程独占仓储；文件打开、读写失败时抛出 std::runtime_error。
+namespace CandidateCheck {
+constexpr const char* kNewFileName = "new.txt";
+constexpr const char* kOwnedFileName = "owned.txt";
+constexpr const char* kInvalidFileName = "invalid.txt";
+// kAuto 下，候选数乘以该比例不小于库的记录数时改用归并连接：
+// 实测顺序扫描一行约为一次有序点查的五分之一
+constexpr size_t kMergeJoinRatio = 4;
+
+auto Run(ITextReader& reader, const std::string& filepath,
+         const IIdRepository& repository, const std::string& output_dir,
+         const CheckOptions& options) -> CheckCounts;
+}  // namespace CandidateCheck
+
+#endif
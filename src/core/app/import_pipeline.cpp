@@ -0,0 +1,290 @@
+// core/app/import_pipeline.cpp
+#include "core/app/import_pipeline.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "core/concurrency/bounded_queue.hpp"
+#include "core/utils/batch_validator.hpp"
+
+namespace ImportPipeline {
+
+namespace {
+struct CanonicalBatch {
+  Validator::CanonicalIdBuffer canonical;
+  size_t line_count = 0;
+  size_t byte_count = 0;  // 含换行符，用于按文件大小汇报进度
+};
+
+auto ResolveWorkerCount(size_t requested) -> size_t {
+  if (requested > 0) {
+    return requested;
+  }
+  // 读取与写入各占一个核，其余留给校验
+  const size_t cores = std::max(1U, std::thread::hardware_concurrency());
+  return cores > 2 ? cores - 2 : 1;
+}
+
+// 记录第一个出错阶段的异常，并关闭所有队列让其他阶段尽快退出
+class FailureState {
+ public:
+  FailureState(Concurrency::BoundedQueue<LineBatch>& lines,
+               Concurrency::BoundedQueue<CanonicalBatch>& batches)
+      : lines_(lines), batches_(batches) {}
+
+  void Fail(std::exception_ptr error) {
+    {
+      std::lock_guard lock(mutex_);
+      if (!error_) {
+        error_ = std::move(error);
+      }
+    }
+    Stop();
+  }
+
+  // 不记录错误地停止：上游阶段在下一次入队时退出
+  void Stop() {
+    lines_.Close();
+    batches_.Close();
+  }
+
+  void RethrowIfFailed() {
+    std::lock_guard lock(mutex_);
+    if (error_) {
+      std::rethrow_exception(error_);
+    }
+  }
+
+ private:
+  Concurrency::BoundedQueue<LineBatch>& lines_;
+  Concurrency::BoundedQueue<CanonicalBatch>& batches_;
+  std::mutex mutex_;
+  std::exception_ptr error_;
+};
+
+// Run 的主体；committed 在每次提交事务后更新，供出错时报告
+auto RunStages(ITextReader& reader, const std::string& filepath,
+               IIdRepository& repository, const ImportOptions& options,
+               ImportCounts& committed) -> ImportCounts {
+  const size_t worker_count = ResolveWorkerCount(options.worker_count);
+  const size_t read_batch_lines = std::max<size_t>(options.read_batch_lines, 1);
+  const size_t commit_batch_size =
+      std::max<size_t>(options.commit_batch_size, 1);
+
+  Concurrency::BoundedQueue<LineBatch> line_queue(options.queue_depth);
+  Concurrency::BoundedQueue<CanonicalBatch> batch_queue(options.queue_depth);
+  FailureState failure(line_queue, batch_queue);
+  std::error_code ec;
+  const auto file_size = std::filesystem::file_size(filepath, ec);
+  const size_t file_bytes = ec ? 0 : static_cast<size_t>(file_size);
+  std::optional<IO::ExternalIdSorter> sorter;
+  if (options.sorted_bulk_load) {
+    sorter.emplace(options.sort_memory_bytes, options.sort_temp_dir);
+  }
+  if (options.progress != nullptr) {
+    // 排序导入的读取与写入两个阶段各占一半进度
+    options.progress->SetTotalUnits(sorter ? file_bytes * 2 : file_bytes);
+  }
+
+  std::thread reader_thread([&] {
+    try {
+      reader.ReadLineBatches(filepath, read_batch_lines,
+                             [&](LineBatch&& line_batch) {
+                               return line_queue.Push(std::move(line_batch));
+                             });
+      line_queue.Close();
+    } catch (...) {
+      failure.Fail(std::current_exception());
+    }
+  });
+
+  std::atomic<size_t> running_workers{worker_count};
+  std::vector<std::thread> workers;
+  workers.reserve(worker_count);
+  for (size_t w = 0; w < worker_count; ++w) {
+    workers.emplace_back([&] {
+      try {
+        while (auto line_batch = line_queue.Pop()) {
+          CanonicalBatch batch;
+          batch.line_count = line_batch->lines.size();
+          for (const std::string_view line : line_batch->lines) {
+            batch.byte_count += line.size() + 1;
+          }
+          Validator::ValidateBatch(line_batch->lines, batch.canonical);
+          if (!batch_queue.Push(std::move(batch))) {
+            break;
+          }
+        }
+      } catch (...) {
+        failure.Fail(std::current_exception());
+      }
+      // 最后一个退出的校验线程通知写入线程没有更多数据
+      if (running_workers.fetch_sub(1) == 1) {
+        batch_queue.Close();
+      }
+    });
+  }
+
+  auto join_all = [&] {
+    reader_thread.join();
+    for (auto& worker : workers) {
+      worker.join();
+    }
+  };
+
+  // --- 写入阶段（调用线程）；排序导入时这里只收集 ID ---
+  ImportCounts counts;
+  size_t uncommitted = 0;
+  std::vector<std::string_view> ids;
+  if (!sorter) {
+    repository.BeginTransaction();
+  }
+  try {
+    while (auto batch = batch_queue.Pop()) {
+      counts.line_count += batch->line_count;
+      counts.invalid_format_count += batch->canonical.invalid_count;
+      if (sorter) {
+        for (const std::string_view id : batch->canonical.ids) {
+          sorter->Add(id);
+        }
+      } else {
+        batch->canonical.ids.ViewsInto(ids);
+        for (const bool added : repository.AddMany(ids)) {
+          if (added) {
+            counts.success_count++;
+          } else {
+            counts.exist_count++;
+          }
+        }
+        uncommitted += ids.size();
+        if (uncommitted >= commit_batch_size) {
+          repository.CommitTransaction();
+          committed = counts;
+          // 两个事务之间可以安全暂停，让调度器插入交互任务
+          if (options.progress != nullptr) {
+            options.progress->Checkpoint();
+          }
+          repository.BeginTransaction();
+          uncommitted = 0;
+        }
+      }
+      if (options.progress != nullptr) {
+        options.progress->Advance(batch->line_count, batch->byte_count);
+        if (options.progress->IsCancelRequested()) {
+          counts.cancelled = true;
+          failure.Stop();
+          break;
+        }
+      }
+    }
+  } catch (...) {
+    if (!sorter) {
+      repository.RollbackTransaction();
+    }
+    failure.Fail(std::current_exception());
+    join_all();
+    failure.RethrowIfFailed();
+    throw;
+  }
+
+  join_all();
+  // 读取或校验阶段出错时，最后一批未提交的数据一并放弃
+  try {
+    failure.RethrowIfFailed();
+  } catch (...) {
+    if (!sorter) {
+      repository.RollbackTransaction();
+    }
+    throw;
+  }
+  if (!sorter) {
+    repository.CommitTransaction();
+  } else if (!counts.cancelled) {
+    WriteSorted(*sorter, repository, options, file_bytes, counts);
+  }
+  return counts;
+}
+}  // namespace
+
+auto Run(ITextReader& reader, const std::string& filepath,
+         IIdRepository& repository, const ImportOptions& options)
+    -> ImportCounts {
+  ImportCounts committed;
+  try {
+    return RunStages(reader, filepath, repository, options, committed);
+  } catch (const ImportError&) {
+    throw;  // 排序写入阶段已带上自己的计数
+  } catch (const std::exception& ex) {
+    throw ImportError(ex.what(), committed);
+  }
+}
+
+void WriteSorted(IO::ExternalIdSorter& sorter, IIdRepository& repository,
+                 const ImportOptions& options, size_t estimated_units,
+                 ImportCounts& counts) {
+  Concurrency::JobProgress* progress = options.progress;
+  const size_t commit_batch_size =
+      std::max<size_t>(options.commit_batch_size, 1);
+  size_t uncommitted = 0;
+  size_t written = 0;
+  size_t reported_units = 0;
+  const size_t input_count = sorter.InputCount();
+  ImportCounts committed = counts;
+  repository.BeginTransaction();
+  try {
+    const IO::SortCounts sorted = sorter.Merge(
+        [&](std::span<const std::string_view> chunk) {
+          for (const bool added : repository.AddMany(chunk)) {
+            if (added) {
+              counts.success_count++;
+            } else {
+              counts.exist_count++;
+            }
+          }
+          uncommitted += chunk.size();
+          if (uncommitted >= commit_batch_size) {
+            repository.CommitTransaction();
+            committed = counts;
+            if (progress != nullptr) {
+              progress->Checkpoint();
+            }
+            repository.BeginTransaction();
+            uncommitted = 0;
+          }
+          if (progress == nullptr) {
+            return true;
+          }
+          // 去重后的 ID 数事先未知，按已写出的 ID 占输入的比例折算
+          written += chunk.size();
+          const size_t units =
+              input_count == 0 ? 0 : estimated_units * written / input_count;
+          progress->Advance(0, units - std::min(units, reported_units));
+          reported_units = std::max(units, reported_units);
+          if (progress->IsCancelRequested()) {
+            counts.cancelled = true;
+            return false;
+          }
+          return true;
+        });
+    counts.duplicate_count += sorted.duplicate_count;
+  } catch (const std::exception& ex) {
+    repository.RollbackTransaction();
+    throw ImportError(ex.what(), committed);
+  } catch (...) {
+    repository.RollbackTransaction();
+    throw;
+  }
+  repository.CommitTransaction();
+}
+
+}  // namespace ImportPipeline
@@ -0,0 +1,76 @@
+// core/app/import_pipeline.hpp
+#ifndef IMPORT_PIPELINE_HPP
+#define IMPORT_PIPELINE_HPP
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+#include "core/concurrency/job_progress.hpp"
+#include "core/io/external_id_sorter.hpp"
+#include "core/ports/i_id_repository.hpp"
+#include "core/ports/i_text_reader.hpp"
+
+struct ImportOptions {
+  size_t worker_count = 0;             // 校验线程数，0 表示按 CPU 核数自动选择
+  size_t commit_batch_size = 100000;   // 写入线程每提交一次事务写入的 ID 数
+  size_t read_batch_lines = 8192;      // 读取线程每批交给校验线程的行数
+  size_t queue_depth = 8;              // 每个队列最多积压的批次数
+  // 非空时按文件字节数汇报进度，每写完一批后检查取消请求，
+  // 每提交一次事务后调用 Checkpoint 供调度器插入交互任务
+  Concurrency::JobProgress* progress = nullptr;
+  // 排序导入：先把全部 ID 排序、去重，再按键序写入。B 树按顺序增长，
+  // 文件内的重复也不再各自执行一次插入。超出 sort_memory_bytes 的部分
+  // 分段写到 sort_temp_dir（为空时用系统临时目录）再归并
+  bool sorted_bulk_load = false;
+  size_t sort_memory_bytes = IO::ExternalIdSorter::kDefaultMemoryBytes;
+  std::string sort_temp_dir;
+};
+
+struct ImportCounts {
+  size_t line_count = 0;
+  size_t success_count = 0;
+  size_t exist_count = 0;
+  size_t invalid_format_count = 0;
+  size_t duplicate_count = 0;  // 排序导入时文件内的重复，不计入 exist_count
+  bool cancelled = false;  // 被取消时为 true，已写入的部分照常提交
+};
+
+// 导入中途失败（写入仓储、排序临时文件或读取出错）。出错前已提交的
+// 事务保留在库中，committed 为这些事务对应的计数
+class ImportError : public std::runtime_error {
+ public:
+  ImportError(const std::string& what, const ImportCounts& committed)
+      : std::runtime_error(what), committed_(committed) {}
+
+  [[nodiscard]] auto Committed() const -> const ImportCounts& {
+    return committed_;
+  }
+
+ private:
+  ImportCounts committed_;
+};
+
+// 多级并行导入流水线：
+//   读取线程 --(行批次)--> N 个校验/规范化线程 --(ID 批次)--> 写入线程
+// 两级之间都是有界队列，文件不会整体载入，积压量受 queue_depth 限制。
+// 写入只发生在调用线程上，仓储连接始终只被一个线程使用；
+// 每写满 commit_batch_size 个 ID 提交一次事务，已提交的批次在出错时保留。
+// 任一阶段出错时整条流水线停止，在调用线程上抛出 ImportError。
+// 取消时在批次边界停下，提交已写入的部分，尚在队列中的批次丢弃。
+// 排序导入时写入推迟到文件读完之后；在排序阶段取消则什么也不写入。
+namespace ImportPipeline {
+auto Run(ITextReader& reader, const std::string& filepath,
+         IIdRepository& repository, const ImportOptions& options)
+    -> ImportCounts;
+
+// 排序导入的写入阶段：把 sorter 归并出的有序 ID 分批写入仓储，
+// 计入 counts 的 success/exist/duplicate，行数与格式错误由调用方统计。
+// estimated_units 为这一阶段计入进度的总量，按写出的 ID 数均摊。
+// 出错时回滚未提交的部分并抛出 ImportError
+void WriteSorted(IO::ExternalIdSorter& sorter, IIdRepository& repository,
+                 const ImportOptions& options, size_t estimated_units,
+                 ImportCounts& counts);
+}  // namespace ImportPipeline
+
+#endif
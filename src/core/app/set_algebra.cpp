@@ -0,0 +1,102 @@
+// core/app/set_algebra.cpp
+#include "core/app/set_algebra.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "core/app/sorted_cursor.hpp"
+#include "core/data/id_chunk_buffer.hpp"
+
+namespace SetAlgebra {
+
+auto Merge(SetOperation operation, std::span<const IIdRepository* const> inputs,
+           const IdChunkVisitor& sink) -> SetMergeCounts {
+  std::vector<std::unique_ptr<SortedCursor>> cursors;
+  cursors.reserve(inputs.size());
+  auto stop_all = [&] {
+    for (auto& cursor : cursors) {
+      cursor->Stop();
+    }
+  };
+
+  SetMergeCounts counts;
+  try {
+    for (const IIdRepository* input : inputs) {
+      cursors.push_back(std::make_unique<SortedCursor>(*input, kQueueDepth));
+    }
+    for (auto& cursor : cursors) {
+      cursor->Refill();
+    }
+
+    IdChunkBuffer output(sink);
+    std::string current;  // 当前最小 ID 的副本，前进后原视图可能失效
+    bool keep_going = true;
+    while (keep_going) {
+      std::optional<std::string_view> smallest;
+      for (const auto& cursor : cursors) {
+        if (!cursor->Exhausted() && (!smallest || cursor->Head() < *smallest)) {
+          smallest = cursor->Head();
+        }
+      }
+      if (!smallest) {
+        break;
+      }
+      current.assign(*smallest);
+
+      size_t holders = 0;
+      bool in_first = false;
+      for (size_t i = 0; i < cursors.size(); ++i) {
+        SortedCursor& cursor = *cursors[i];
+        if (!cursor.Exhausted() && cursor.Head() == current) {
+          ++holders;
+          in_first |= (i == 0);
+          cursor.Advance();
+        }
+      }
+
+      bool emit = false;
+      switch (operation) {
+        case SetOperation::kUnion:
+          emit = true;
+          break;
+        case SetOperation::kIntersect:
+          emit = holders == cursors.size();
+          break;
+        case SetOperation::kDifference:
+          emit = in_first && holders == 1;
+          break;
+      }
+      if (emit) {
+        ++counts.output_count;
+        keep_going = output.Append(current);
+      }
+
+      // 交集在任一输入读完、差集在第一个输入读完后不会再有输出
+      if ((operation == SetOperation::kIntersect &&
+           std::ranges::any_of(cursors, [](const auto& cursor) {
+             return cursor->Exhausted();
+           })) ||
+          (operation == SetOperation::kDifference && cursors[0]->Exhausted())) {
+        break;
+      }
+    }
+    if (keep_going) {
+      output.Flush();
+    }
+  } catch (...) {
+    stop_all();
+    throw;
+  }
+
+  stop_all();
+  for (const auto& cursor : cursors) {
+    cursor->RethrowIfFailed();
+    counts.input_counts.push_back(cursor->Consumed());
+  }
+  return counts;
+}
+
+}  // namespace SetAlgebra
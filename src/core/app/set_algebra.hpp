@@ -0,0 +1,35 @@
+// core/app/set_algebra.hpp
+#ifndef SET_ALGEBRA_HPP
+#define SET_ALGEBRA_HPP
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include "core/ports/i_id_repository.hpp"
+
+enum class SetOperation {
+  kUnion,       // 至少在一个输入中
+  kIntersect,   // 在全部输入中
+  kDifference   // 在第一个输入中、且不在其余任何输入中
+};
+
+struct SetMergeCounts {
+  std::vector<size_t> input_counts;  // 各输入读出的 ID 数
+  size_t output_count = 0;
+};
+
+// 多个库之间的集合运算，按字节序做多路归并：
+//   每个输入一个读取线程 --(有界队列)--> 调用线程归并 --> sink
+// 输入经 ForEachIdSorted 流式读出，每个输入至多积压 kQueueDepth 块，
+// 内存占用与库大小无关。结果按字节序、无重复地分块交给 sink，
+// sink 返回 false 时提前结束。输入仓储须各自独占（读取线程会使用它们）。
+// 任一输入出错时停止全部读取，异常在调用线程上重新抛出。
+namespace SetAlgebra {
+constexpr size_t kQueueDepth = 4;
+
+auto Merge(SetOperation operation, std::span<const IIdRepository* const> inputs,
+           const IdChunkVisitor& sink) -> SetMergeCounts;
+}  // namespace SetAlgebra
+
+#endif
@@ -0,0 +1,95 @@
+// core/app/sorted_cursor.hpp
+#ifndef SORTED_CURSOR_HPP
+#define SORTED_CURSOR_HPP
+
+#include <cstddef>
+#include <exception>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <utility>
+
+#include "core/concurrency/bounded_queue.hpp"
+#include "core/ports/i_id_repository.hpp"
+#include "core/utils/id_list.hpp"
+
+// 按字节序逐个读出仓储中 ID 的游标，供归并类算法使用：读取线程经
+// ForEachIdSorted 把有序的块推入有界队列，使用方逐个 ID 前进。
+// 至多积压 queue_depth 块，内存占用与库大小无关。
+// 游标存在期间读取线程独占该仓储，使用方不得再访问它。
+// 构造后须先调用一次 Refill。
+class SortedCursor {
+ public:
+  SortedCursor(const IIdRepository& input, size_t queue_depth)
+      : queue_(queue_depth) {
+    thread_ = std::thread([this, &input] {
+      try {
+        input.ForEachIdSorted([this](std::span<const std::string_view> chunk) {
+          IdList list;
+          for (const std::string_view id : chunk) {
+            list.Append(id);
+          }
+          return queue_.Push(std::move(list));
+        });
+      } catch (...) {
+        error_ = std::current_exception();
+      }
+      queue_.Close();
+    });
+  }
+
+  ~SortedCursor() { Stop(); }
+
+  SortedCursor(const SortedCursor&) = delete;
+  auto operator=(const SortedCursor&) -> SortedCursor& = delete;
+
+  // 关闭队列让读取线程尽快退出，并等待其结束
+  void Stop() {
+    queue_.Close();
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+  }
+
+  // 须在 Stop 之后调用
+  void RethrowIfFailed() const {
+    if (error_) {
+      std::rethrow_exception(error_);
+    }
+  }
+
+  // 取下一块，跳过空块；输入读完时标记为耗尽
+  void Refill() {
+    pos_ = 0;
+    while (auto next = queue_.Pop()) {
+      if (!next->Empty()) {
+        chunk_ = std::move(*next);
+        return;
+      }
+    }
+    chunk_.Clear();
+    exhausted_ = true;
+  }
+
+  [[nodiscard]] auto Exhausted() const -> bool { return exhausted_; }
+  [[nodiscard]] auto Head() const -> std::string_view { return chunk_[pos_]; }
+  [[nodiscard]] auto Consumed() const -> size_t { return consumed_; }
+
+  void Advance() {
+    ++consumed_;
+    if (++pos_ == chunk_.Size()) {
+      Refill();
+    }
+  }
+
+ private:
+  Concurrency::BoundedQueue<IdList> queue_;
+  std::thread thread_;
+  std::exception_ptr error_;
+  IdList chunk_;
+  size_t pos_ = 0;
+  size_t consumed_ = 0;
+  bool exhausted_ = false;
+};
+
+#endif  // SORTED_CURSOR_HPP
@@ -0,0 +1,75 @@
+// core/concurrency/job_progress.hpp
+#ifndef JOB_PROGRESS_HPP
+#define JOB_PROGRESS_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <utility>
+
+namespace Concurrency {
+// 长时间操作的进度与取消请求：执行线程汇报，界面线程读取并可请求取消。
+// 进度以 units 计（导入为字节，导出与查询为 ID 数），rows 为已处理的行数，
+// 用于计算吞吐。执行方只在批次之间检查取消请求。
+class JobProgress {
+ public:
+  JobProgress() : started_(std::chrono::steady_clock::now()) {}
+
+  // 总量未知时保持为 0
+  void SetTotalUnits(size_t total) {
+    total_units_.store(total, std::memory_order_relaxed);
+  }
+  void Advance(size_t rows, size_t units) {
+    rows_.fetch_add(rows, std::memory_order_relaxed);
+    done_units_.fetch_add(units, std::memory_order_relaxed);
+  }
+
+  void RequestCancel() { cancel_.store(true, std::memory_order_relaxed); }
+  [[nodiscard]] auto IsCancelRequested() const -> bool {
+    return cancel_.load(std::memory_order_relaxed);
+  }
+
+  // 执行方在可以安全暂停的批次边界（没有打开的事务、没有进行中的遍历）
+  // 调用 Checkpoint；调度器借此把执行权暂时让给交互任务。未设置时不做任何事
+  void SetCheckpoint(std::function<void()> checkpoint) {
+    checkpoint_ = std::move(checkpoint);
+  }
+  void Checkpoint() const {
+    if (checkpoint_) {
+      checkpoint_();
+    }
+  }
+
+  [[nodiscard]] auto Rows() const -> size_t {
+    return rows_.load(std::memory_order_relaxed);
+  }
+  // [0, 1]；总量未知时返回负数
+  [[nodiscard]] auto Fraction() const -> double {
+    const size_t total = total_units_.load(std::memory_order_relaxed);
+    if (total == 0) {
+      return -1.0;
+    }
+    const size_t done = done_units_.load(std::memory_order_relaxed);
+    return done >= total ? 1.0
+                         : static_cast<double>(done) /
+                               static_cast<double>(total);
+  }
+  [[nodiscard]] auto RowsPerSecond() const -> double {
+    const double seconds = std::chrono::duration<double>(
+                               std::chrono::steady_clock::now() - started_)
+                               .count();
+    return seconds > 0.0 ? static_cast<double>(Rows()) / seconds : 0.0;
+  }
+
+ private:
+  std::chrono::steady_clock::time_point started_;
+  std::atomic<size_t> rows_{0};
+  std::atomic<size_t> done_units_{0};
+  std::atomic<size_t> total_units_{0};
+  std::atomic<bool> cancel_{false};
+  std::function<void()> checkpoint_;  // 任务开始前设置，之后只读
+};
+}  // namespace Concurrency
+
+#endif
@@ -0,0 +1,201 @@
+// core/concurrency/job_scheduler.hpp
+#ifndef JOB_SCHEDULER_HPP
+#define JOB_SCHEDULER_HPP
+
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "core/concurrency/job_progress.hpp"
+
+namespace Concurrency {
+enum class JobPriority {
+  // 查询、添加等短操作：优先执行，可以插入暂停中的批量任务
+  kInteractive,
+  // 导入、导出等长操作，以及切换、创建、迁移库或更换引擎这类
+  // 改变库打开状态的操作
+  kBulk
+};
+
+template <typename Result>
+struct JobHandle {
+  std::future<Result> result;  // 任务抛出的异常在 get() 时重新抛出
+  std::shared_ptr<JobProgress> progress;  // 读取进度、请求取消
+};
+
+// 为不能并发访问的对象（Application）调度任务，任一时刻只有一个任务持有
+// 执行权。两个优先级各有一个有界队列和一个工作线程；队列满时 Submit 阻塞，
+// 以此向提交方施加背压，TrySubmit 则直接返回 std::nullopt。
+// 交互任务先于尚未开始的批量任务执行；正在执行的批量任务每到
+// JobProgress::Checkpoint 就把执行权让给排队的交互任务，随后继续。
+// 因此交互任务不得改变库的打开状态，这类操作须按批量任务提交。
+// 析构时执行完已排队的任务再回收线程。
+class JobScheduler {
+ public:
+  static constexpr size_t kDefaultInteractiveDepth = 64;
+  static constexpr size_t kDefaultBulkDepth = 8;
+
+  explicit JobScheduler(size_t interactive_depth = kDefaultInteractiveDepth,
+                        size_t bulk_depth = kDefaultBulkDepth) {
+    lanes_[kInteractiveLane].capacity = std::max<size_t>(interactive_depth, 1);
+    lanes_[kBulkLane].capacity = std::max<size_t>(bulk_depth, 1);
+    interactive_worker_ = std::thread([this] { WorkerLoop(kInteractiveLane); });
+    bulk_worker_ = std::thread([this] { WorkerLoop(kBulkLane); });
+  }
+
+  ~JobScheduler() {
+    {
+      std::lock_guard lock(mutex_);
+      stopping_ = true;
+    }
+    changed_.notify_all();
+    interactive_worker_.join();
+    bulk_worker_.join();
+  }
+
+  JobScheduler(const JobScheduler&) = delete;
+  auto operator=(const JobScheduler&) -> JobScheduler& = delete;
+
+  // fn 以 JobProgress& 为参数；队列已满时阻塞到有空位
+  template <typename Fn>
+  auto Submit(JobPriority priority, Fn&& fn)
+      -> JobHandle<std::invoke_result_t<Fn, JobProgress&>> {
+    return *Enqueue(priority, std::forward<Fn>(fn), true);
+  }
+
+  // 队列已满时不等待，返回 std::nullopt
+  template <typename Fn>
+  auto TrySubmit(JobPriority priority, Fn&& fn)
+      -> std::optional<JobHandle<std::invoke_result_t<Fn, JobProgress&>>> {
+    return Enqueue(priority, std::forward<Fn>(fn), false);
+  }
+
+  // 尚未开始执行的任务数
+  [[nodiscard]] auto PendingCount(JobPriority priority) const -> size_t {
+    std::lock_guard lock(mutex_);
+    return lanes_[LaneOf(priority)].tasks.size();
+  }
+
+ private:
+  static constexpr size_t kInteractiveLane = 0;
+  static constexpr size_t kBulkLane = 1;
+
+  struct Lane {
+    std::deque<std::function<void()>> tasks;
+    size_t capacity = 0;
+  };
+
+  static auto LaneOf(JobPriority priority) -> size_t {
+    return priority == JobPriority::kInteractive ? kInteractiveLane
+                                                 : kBulkLane;
+  }
+
+  template <typename Fn>
+  auto Enqueue(JobPriority priority, Fn&& fn, bool wait)
+      -> std::optional<JobHandle<std::invoke_result_t<Fn, JobProgress&>>> {
+    using Result = std::invoke_result_t<Fn, JobProgress&>;
+    auto progress = std::make_shared<JobProgress>();
+    if (priority == JobPriority::kBulk) {
+      progress->SetCheckpoint([this] { YieldToInteractive(); });
+    }
+    // packaged_task 不可复制，包一层 shared_ptr 以放入 std::function
+    auto task = std::make_shared<std::packaged_task<Result()>>(
+        [fn = std::forward<Fn>(fn), progress]() mutable {
+          return fn(*progress);
+        });
+    JobHandle<Result> handle{task->get_future(), progress};
+
+    Lane& lane = lanes_[LaneOf(priority)];
+    {
+      std::unique_lock lock(mutex_);
+      if (wait) {
+        changed_.wait(lock, [&] {
+          return stopping_ || lane.tasks.size() < lane.capacity;
+        });
+      } else if (lane.tasks.size() >= lane.capacity) {
+        return std::nullopt;
+      }
+      if (stopping_) {
+        throw std::runtime_error("任务调度器已停止");
+      }
+      lane.tasks.emplace_back([task] { (*task)(); });
+    }
+    changed_.notify_all();
+    return handle;
+  }
+
+  // 调用时已持有 mutex_
+  [[nodiscard]] auto InteractivePending() const -> bool {
+    return interactive_active_ || !lanes_[kInteractiveLane].tasks.empty();
+  }
+
+  void WorkerLoop(size_t lane_index) {
+    Lane& lane = lanes_[lane_index];
+    const bool interactive = lane_index == kInteractiveLane;
+    while (true) {
+      std::function<void()> task;
+      {
+        std::unique_lock lock(mutex_);
+        changed_.wait(lock, [&] { return stopping_ || !lane.tasks.empty(); });
+        if (lane.tasks.empty()) {
+          return;
+        }
+        task = std::move(lane.tasks.front());
+        lane.tasks.pop_front();
+        if (interactive) {
+          interactive_active_ = true;
+        }
+        changed_.notify_all();  // 队列腾出了空位
+        // 批量任务还要等交互任务全部执行完
+        changed_.wait(lock, [&] {
+          return !token_held_ && (interactive || !InteractivePending());
+        });
+        token_held_ = true;
+      }
+      task();
+      {
+        std::lock_guard lock(mutex_);
+        token_held_ = false;
+        if (interactive) {
+          interactive_active_ = false;
+        }
+      }
+      changed_.notify_all();
+    }
+  }
+
+  // 在批量任务的线程上、持有执行权时调用
+  void YieldToInteractive() {
+    std::unique_lock lock(mutex_);
+    if (!InteractivePending()) {
+      return;
+    }
+    token_held_ = false;
+    changed_.notify_all();
+    changed_.wait(lock, [&] { return !token_held_ && !InteractivePending(); });
+    token_held_ = true;
+  }
+
+  mutable std::mutex mutex_;
+  std::condition_variable changed_;
+  std::array<Lane, 2> lanes_;
+  bool token_held_ = false;          // 是否有任务正在执行
+  bool interactive_active_ = false;  // 交互线程已取出任务，等待或正在执行
+  bool stopping_ = false;
+  std::thread interactive_worker_;
+  std::thread bulk_worker_;
+};
+}  // namespace Concurrency
+
+#endif  // JOB_SCHEDULER_HPP
@@ -0,0 +1,56 @@
+// core/data/batch_dedup.hpp
+#ifndef BATCH_DEDUP_HPP
+#define BATCH_DEDUP_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+#include <utility>
+#include <vector>
+
+// 批量写入的批内去重：按 (键, 下标) 排序后每组保留第一项，
+// 即该键首次出现的位置；之后可按键二分查回原下标。
+// 不逐个分配节点，对象由仓储持有并跨批复用，稳态下不再分配内存。
+template <typename Key>
+class BatchDedup {
+ public:
+  void Clear() {
+    entries_.clear();
+    keys_.clear();
+  }
+
+  void Add(const Key& key, size_t index) { entries_.emplace_back(key, index); }
+
+  // 排序去重，完成后 Keys() 按键序给出不重复的键
+  void Finish() {
+    std::sort(entries_.begin(), entries_.end());
+    entries_.erase(std::unique(entries_.begin(), entries_.end(),
+                               [](const auto& lhs, const auto& rhs) {
+                                 return lhs.first == rhs.first;
+                               }),
+                   entries_.end());
+    keys_.clear();
+    for (const auto& entry : entries_) {
+      keys_.push_back(entry.first);
+    }
+  }
+
+  [[nodiscard]] auto Keys() const -> const std::vector<Key>& { return keys_; }
+
+  // 键首次出现时的下标；不在本批中时返回 std::nullopt
+  template <typename Probe>
+  [[nodiscard]] auto FirstIndexOf(const Probe& key) const
+      -> std::optional<size_t> {
+    const auto it = std::lower_bound(keys_.begin(), keys_.end(), key);
+    if (it == keys_.end() || !(*it == key)) {
+      return std::nullopt;
+    }
+    return entries_[static_cast<size_t>(it - keys_.begin())].second;
+  }
+
+ private:
+  std::vector<std::pair<Key, size_t>> entries_;
+  std::vector<Key> keys_;
+};
+
+#endif
@@ -0,0 +1,143 @@
+// core/data/bloom_filter.cpp
+#include "core/data/bloom_filter.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+#include "core/data/id_hash.hpp"
+
+namespace {
+constexpr char kMagic[4] = {'A', 'V', 'B', 'F'};
+constexpr uint32_t kFormatVersion = 1;
+constexpr size_t kBitsPerBlock = 512;
+
+struct FileHeader {
+  char magic[4];
+  uint32_t version;
+  uint64_t generation;
+  uint64_t block_count;
+  uint64_t inserted;
+  double false_positive_rate;
+  uint32_t hash_count;
+  uint32_t reserved;
+};
+
+// 块内第 i 个位置：双重哈希 a + i*b，取低 9 位
+inline auto BitPosition(uint64_t hash, uint32_t i) -> uint32_t {
+  const auto a = static_cast<uint32_t>(hash);
+  const auto b = static_cast<uint32_t>(hash >> 32) | 1U;
+  return (a + i * b) & (kBitsPerBlock - 1);
+}
+}  // namespace
+
+BloomFilter::BloomFilter(size_t expected_count, double false_positive_rate)
+    : false_positive_rate_(std::clamp(false_positive_rate, 1e-6, 0.5)) {
+  // 经典公式 m/n = -ln(p)/ln(2)^2；分块带来的额外误判用 1.1 倍位数补偿
+  const double bits_per_key = -std::log(false_positive_rate_) /
+                              (std::log(2.0) * std::log(2.0)) * 1.1;
+  hash_count_ = static_cast<uint32_t>(
+      std::clamp(std::lround(bits_per_key * std::log(2.0)), 1L, 16L));
+  const double total_bits =
+      std::max(1.0, static_cast<double>(expected_count) * bits_per_key);
+  const auto block_count =
+      static_cast<size_t>(std::ceil(total_bits / kBitsPerBlock));
+  blocks_.assign(std::max<size_t>(1, block_count), Block{});
+}
+
+auto BloomFilter::BlockIndex(uint64_t hash) const -> size_t {
+  // 用高 32 位做区间映射，避免取模
+  return static_cast<size_t>(((hash >> 32) * blocks_.size()) >> 32);
+}
+
+void BloomFilter::Insert(std::string_view id) {
+  const uint64_t hash = IdHash::Hash(id);
+  Block& block = blocks_[BlockIndex(hash)];
+  const uint64_t bits = hash * 0x9E3779B97F4A7C15ULL;
+  for (uint32_t i = 0; i < hash_count_; ++i) {
+    const uint32_t bit = BitPosition(bits, i);
+    block[bit >> 6] |= uint64_t{1} << (bit & 63);
+  }
+  ++inserted_;
+}
+
+auto BloomFilter::MayContain(std::string_view id) const -> bool {
+  const uint64_t hash = IdHash::Hash(id);
+  const Block& block = blocks_[BlockIndex(hash)];
+  const uint64_t bits = hash * 0x9E3779B97F4A7C15ULL;
+  for (uint32_t i = 0; i < hash_count_; ++i) {
+    const uint32_t bit = BitPosition(bits, i);
+    if ((block[bit >> 6] & (uint64_t{1} << (bit & 63))) == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+auto BloomFilter::MemoryBytes() const -> size_t {
+  return blocks_.size() * sizeof(Block);
+}
+
+void BloomFilter::Save(const std::string& filepath,
+                       uint64_t generation) const {
+  FileHeader header{};
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kFormatVersion;
+  header.generation = generation;
+  header.block_count = blocks_.size();
+  header.inserted = inserted_;
+  header.false_positive_rate = false_positive_rate_;
+  header.hash_count = hash_count_;
+
+  // 先写临时文件再替换，避免留下半个过滤器
+  const std::string temp_path = filepath + ".tmp";
+  {
+    std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+      throw std::runtime_error("无法写入过滤器文件: " + temp_path);
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(blocks_.data()),
+              static_cast<std::streamsize>(MemoryBytes()));
+    if (!out) {
+      throw std::runtime_error("写入过滤器文件失败: " + temp_path);
+    }
+  }
+  std::error_code ec;
+  std::filesystem::rename(temp_path, filepath, ec);
+  if (ec) {
+    std::filesystem::remove(temp_path, ec);
+    throw std::runtime_error("替换过滤器文件失败: " + filepath);
+  }
+}
+
+auto BloomFilter::Load(const std::string& filepath, uint64_t& generation)
+    -> std::optional<BloomFilter> {
+  std::ifstream in(filepath, std::ios::binary);
+  if (!in.is_open()) {
+    return std::nullopt;
+  }
+  FileHeader header{};
+  in.read(reinterpret_cast<char*>(&header), sizeof(header));
+  if (!in || std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+      header.version != kFormatVersion || header.block_count == 0 ||
+      header.hash_count == 0 || header.hash_count > 16) {
+    return std::nullopt;
+  }
+
+  BloomFilter filter;
+  filter.blocks_.resize(header.block_count);
+  in.read(reinterpret_cast<char*>(filter.blocks_.data()),
+          static_cast<std::streamsize>(filter.MemoryBytes()));
+  if (!in) {
+    return std::nullopt;
+  }
+  filter.hash_count_ = header.hash_count;
+  filter.inserted_ = header.inserted;
+  filter.false_positive_rate_ = header.false_positive_rate;
+  generation = header.generation;
+  return filter;
+}
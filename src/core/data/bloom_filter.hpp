@@ -0,0 +1,49 @@
+// core/data/bloom_filter.hpp
+#ifndef BLOOM_FILTER_HPP
+#define BLOOM_FILTER_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// 分块布隆过滤器：每个键只落在一个 64 字节块（一条缓存行）内，
+// 一次查询最多访问一条缓存行。用于在访问 SQLite 之前排除不存在的 ID。
+class BloomFilter {
+ public:
+  static constexpr double kDefaultFalsePositiveRate = 0.01;
+
+  // 按预期容量与目标误判率确定块数与哈希次数
+  BloomFilter(size_t expected_count, double false_positive_rate);
+
+  void Insert(std::string_view id);
+  [[nodiscard]] auto MayContain(std::string_view id) const -> bool;
+
+  [[nodiscard]] auto MemoryBytes() const -> size_t;
+  [[nodiscard]] auto InsertedCount() const -> uint64_t { return inserted_; }
+  [[nodiscard]] auto FalsePositiveRate() const -> double {
+    return false_positive_rate_;
+  }
+
+  // 文件中记录过滤器同步到的库版本号（generation），
+  // 读取时由调用方判断过滤器是否仍然覆盖库中全部 ID
+  void Save(const std::string& filepath, uint64_t generation) const;
+  static auto Load(const std::string& filepath, uint64_t& generation)
+      -> std::optional<BloomFilter>;
+
+ private:
+  using Block = std::array<uint64_t, 8>;  // 512 位
+
+  BloomFilter() = default;
+  [[nodiscard]] auto BlockIndex(uint64_t hash) const -> size_t;
+
+  std::vector<Block> blocks_;
+  uint32_t hash_count_ = 0;
+  uint64_t inserted_ = 0;
+  double false_positive_rate_ = kDefaultFalsePositiveRate;
+};
+
+#endif
@@ -0,0 +1,237 @@
+// core/data/cross_db_index.cpp
+#include "core/data/cross_db_index.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+#include "core/data/packed_id_codec.hpp"
+
+namespace {
+constexpr uint32_t kNoLabel = std::numeric_limits<uint32_t>::max();
+
+auto HighOf(uint64_t key) -> uint64_t { return key >> 16; }
+auto LowOf(uint64_t key) -> uint16_t {
+  return static_cast<uint16_t>(key & 0xFFFF);
+}
+}  // namespace
+
+// --- Container ---
+
+auto CrossDbIndex::Container::Find(uint16_t low) const -> const DbMask* {
+  if (presence.empty()) {
+    const auto it = std::ranges::lower_bound(lows, low);
+    if (it == lows.end() || *it != low) {
+      return nullptr;
+    }
+    return &masks[static_cast<size_t>(it - lows.begin())];
+  }
+  const size_t word = low >> 6;
+  const uint64_t bit = uint64_t{1} << (low & 63);
+  if ((presence[word] & bit) == 0) {
+    return nullptr;
+  }
+  return &masks[rank[word] + std::popcount(presence[word] & (bit - 1))];
+}
+
+auto CrossDbIndex::Container::Upsert(uint16_t low, DbMask bits) -> bool {
+  if (presence.empty()) {
+    const auto it = std::ranges::lower_bound(lows, low);
+    const auto pos = it - lows.begin();
+    if (it != lows.end() && *it == low) {
+      masks[static_cast<size_t>(pos)] |= bits;
+      return false;
+    }
+    lows.insert(it, low);
+    masks.insert(masks.begin() + pos, bits);
+    if (lows.size() > kArrayMaxSize) {
+      ConvertToBitmap();
+    }
+    return true;
+  }
+
+  const size_t word = low >> 6;
+  const uint64_t bit = uint64_t{1} << (low & 63);
+  const size_t index = rank[word] + std::popcount(presence[word] & (bit - 1));
+  if ((presence[word] & bit) != 0) {
+    masks[index] |= bits;
+    return false;
+  }
+  presence[word] |= bit;
+  masks.insert(masks.begin() + static_cast<std::ptrdiff_t>(index), bits);
+  for (size_t w = word + 1; w < kBitmapWords; ++w) {
+    ++rank[w];
+  }
+  return true;
+}
+
+void CrossDbIndex::Container::ConvertToBitmap() {
+  presence.assign(kBitmapWords, 0);
+  for (const uint16_t low : lows) {
+    presence[low >> 6] |= uint64_t{1} << (low & 63);
+  }
+  rank.assign(kBitmapWords, 0);
+  for (size_t w = 1; w < kBitmapWords; ++w) {
+    rank[w] = rank[w - 1] + std::popcount(presence[w - 1]);
+  }
+  // 有序数组与按秩存放的顺序相同，masks 无需重排
+  std::vector<uint16_t>().swap(lows);
+}
+
+auto CrossDbIndex::Container::MemoryBytes() const -> size_t {
+  return lows.capacity() * sizeof(uint16_t) +
+         presence.capacity() * sizeof(uint64_t) +
+         rank.capacity() * sizeof(uint32_t) + masks.capacity() * sizeof(DbMask);
+}
+
+// --- CrossDbIndex ---
+
+auto CrossDbIndex::FindLabel(std::string_view label) const -> const uint32_t* {
+  const auto it = label_ids_.find(label);
+  return it == label_ids_.end() ? nullptr : &it->second;
+}
+
+auto CrossDbIndex::InternLabel(std::string_view label) -> uint32_t {
+  if (const uint32_t* existing = FindLabel(label)) {
+    return *existing;
+  }
+  // 标签字典已满时由调用方改按文本存放
+  if (labels_.size() > PackedIdCodec::kMaxLabelId) {
+    return kNoLabel;
+  }
+  const auto label_id = static_cast<uint32_t>(labels_.size());
+  labels_.emplace_back(label);
+  label_ids_.emplace(labels_.back(), label_id);
+  return label_id;
+}
+
+void CrossDbIndex::InsertKey(uint64_t key, DbMask bits) {
+  if (containers_[HighOf(key)].Upsert(LowOf(key), bits)) {
+    ++size_;
+  }
+}
+
+void CrossDbIndex::InsertText(std::string_view id, DbMask bits) {
+  if (const auto it = text_masks_.find(id); it != text_masks_.end()) {
+    it->second |= bits;
+    return;
+  }
+  text_masks_.emplace(std::string(id), bits);
+  ++size_;
+}
+
+void CrossDbIndex::Insert(std::string_view canonical_id, size_t db_index) {
+  const DbMask bits = DbMask{1} << db_index;
+  if (const auto parts = PackedIdCodec::Split(canonical_id)) {
+    const uint32_t label_id = InternLabel(parts->label);
+    if (label_id != kNoLabel) {
+      InsertKey(PackedIdCodec::Encode(label_id, parts->digits), bits);
+      return;
+    }
+  }
+  InsertText(canonical_id, bits);
+}
+
+auto CrossDbIndex::Lookup(std::string_view canonical_id) const -> DbMask {
+  if (const auto parts = PackedIdCodec::Split(canonical_id)) {
+    if (const uint32_t* label_id = FindLabel(parts->label)) {
+      const uint64_t key = PackedIdCodec::Encode(*label_id, parts->digits);
+      const auto it = containers_.find(HighOf(key));
+      if (it == containers_.end()) {
+        return 0;
+      }
+      const DbMask* mask = it->second.Find(LowOf(key));
+      return mask == nullptr ? 0 : *mask;
+    }
+  }
+  const auto it = text_masks_.find(canonical_id);
+  return it == text_masks_.end() ? 0 : it->second;
+}
+
+void CrossDbIndex::Merge(const CrossDbIndex& other) {
+  std::vector<uint32_t> relabel(other.labels_.size());
+  for (size_t i = 0; i < other.labels_.size(); ++i) {
+    relabel[i] = InternLabel(other.labels_[i]);
+  }
+
+  auto merge_key = [&](uint64_t key, DbMask bits) {
+    const uint32_t label_id = PackedIdCodec::LabelIdOf(key);
+    if (relabel[label_id] != kNoLabel) {
+      InsertKey(PackedIdCodec::WithLabelId(key, relabel[label_id]), bits);
+      return;
+    }
+    std::string id = other.labels_[label_id];
+    PackedIdCodec::AppendDigits(key, id);
+    InsertText(id, bits);
+  };
+
+  for (const auto& [high, container] : other.containers_) {
+    const uint64_t base = high << 16;
+    if (container.presence.empty()) {
+      for (size_t i = 0; i < container.lows.size(); ++i) {
+        merge_key(base | container.lows[i], container.masks[i]);
+      }
+      continue;
+    }
+    size_t index = 0;
+    for (size_t w = 0; w < kBitmapWords; ++w) {
+      for (uint64_t word = container.presence[w]; word != 0;
+           word &= word - 1) {
+        const auto low = static_cast<uint64_t>(w * 64 + std::countr_zero(word));
+        merge_key(base | low, container.masks[index++]);
+      }
+    }
+  }
+  for (const auto& [id, bits] : other.text_masks_) {
+    InsertText(id, bits);
+  }
+}
+
+void CrossDbIndex::Clear() {
+  label_ids_.clear();
+  labels_.clear();
+  containers_.clear();
+  text_masks_.clear();
+  size_ = 0;
+}
+
+auto CrossDbIndex::MemoryBytes() const -> size_t {
+  // 哈希表节点按键值大小加两个指针估算
+  size_t bytes = containers_.size() * (sizeof(uint64_t) + sizeof(Container) +
+                                       2 * sizeof(void*));
+  for (const auto& [high, container] : containers_) {
+    bytes += container.MemoryBytes();
+  }
+  for (const std::string& label : labels_) {
+    bytes += 2 * (sizeof(std::string) + label.capacity()) + sizeof(uint32_t);
+  }
+  for (const auto& [id, bits] : text_masks_) {
+    bytes += sizeof(std::string) + id.capacity() + sizeof(DbMask) +
+             2 * sizeof(void*);
+  }
+  return bytes;
+}
+
+template <typename Fn>
+void CrossDbIndex::ForEachMask(Fn&& fn) const {
+  for (const auto& [high, container] : containers_) {
+    for (const DbMask mask : container.masks) {
+      fn(mask);
+    }
+  }
+  for (const auto& [id, mask] : text_masks_) {
+    fn(mask);
+  }
+}
+
+auto CrossDbIndex::CountAny(DbMask mask) const -> size_t {
+  size_t count = 0;
+  ForEachMask([&](DbMask bits) { count += (bits & mask) != 0 ? 1 : 0; });
+  return count;
+}
+
+auto CrossDbIndex::CountAll(DbMask mask) const -> size_t {
+  size_t count = 0;
+  ForEachMask([&](DbMask bits) { count += (bits & mask) == mask ? 1 : 0; });
+  return count;
+}
@@ -0,0 +1,81 @@
+// core/data/cross_db_index.hpp
+#ifndef CROSS_DB_INDEX_HPP
+#define CROSS_DB_INDEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "core/data/id_hash.hpp"
+
+// 跨库成员索引：每个规范化 ID 对应一个库位图，第 d 位表示第 d 个库包含它。
+// 采用 roaring 风格的两级布局，以 PackedIdCodec 的 64 位键定位：
+// 键的高 48 位选出容器，容器内只存低 16 位。容器元素不多时是有序的
+// uint16 数组；超过 kArrayMaxSize 后改为 65536 位的存在位图，
+// 库位图按秩（该位之前置位的个数）存放，查找只需一次位测试加 popcount。
+// 无法打包的 ID（没有末尾数字或数字段过长）单独存入哈希表。
+// 本类不加锁，并发访问由调用方负责。
+class CrossDbIndex {
+ public:
+  using DbMask = uint64_t;
+  static constexpr size_t kMaxDatabases = 64;
+
+  // db_index 须小于 kMaxDatabases
+  void Insert(std::string_view canonical_id, size_t db_index);
+  [[nodiscard]] auto Lookup(std::string_view canonical_id) const -> DbMask;
+  // 按位或并入另一个索引（通常是并行构建的单库索引），标签按名称重新映射
+  void Merge(const CrossDbIndex& other);
+  void Clear();
+
+  [[nodiscard]] auto Size() const -> size_t { return size_; }
+  [[nodiscard]] auto MemoryBytes() const -> size_t;
+  // 库位图与 mask 有交集的 ID 数（并集大小）
+  [[nodiscard]] auto CountAny(DbMask mask) const -> size_t;
+  // 库位图包含 mask 全部位的 ID 数（交集大小）
+  [[nodiscard]] auto CountAll(DbMask mask) const -> size_t;
+
+ private:
+  static constexpr size_t kArrayMaxSize = 4096;
+  static constexpr size_t kBitmapWords = 65536 / 64;
+
+  struct Container {
+    std::vector<uint16_t> lows;      // 数组形态：有序的低 16 位
+    std::vector<uint64_t> presence;  // 位图形态：非空即为位图形态
+    std::vector<uint32_t> rank;      // 位图形态：每个字之前的置位数
+    std::vector<DbMask> masks;       // 与元素按序一一对应
+
+    [[nodiscard]] auto Find(uint16_t low) const -> const DbMask*;
+    // 返回 true 表示新元素
+    auto Upsert(uint16_t low, DbMask bits) -> bool;
+    void ConvertToBitmap();
+    [[nodiscard]] auto MemoryBytes() const -> size_t;
+  };
+
+  struct TextHash {
+    using is_transparent = void;
+    auto operator()(std::string_view id) const -> size_t {
+      return IdHash::Hash(id);
+    }
+  };
+
+  [[nodiscard]] auto FindLabel(std::string_view label) const
+      -> const uint32_t*;
+  auto InternLabel(std::string_view label) -> uint32_t;
+  void InsertKey(uint64_t key, DbMask bits);
+  void InsertText(std::string_view id, DbMask bits);
+  template <typename Fn>
+  void ForEachMask(Fn&& fn) const;
+
+  std::unordered_map<std::string, uint32_t, TextHash, std::equal_to<>>
+      label_ids_;
+  std::vector<std::string> labels_;  // label_id -> 前缀
+  std::unordered_map<uint64_t, Container> containers_;  // 键 >> 16
+  std::unordered_map<std::string, DbMask, TextHash, std::equal_to<>>
+      text_masks_;
+  size_t size_ = 0;
+};
+
+#endif
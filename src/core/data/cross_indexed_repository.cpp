@@ -0,0 +1,114 @@
+// core/data/cross_indexed_repository.cpp
+#include "core/data/cross_indexed_repository.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+
+auto SharedCrossDbIndex::BitFor(const std::string& db_name)
+    -> std::optional<size_t> {
+  const auto it = std::ranges::find(databases, db_name);
+  if (it != databases.end()) {
+    return static_cast<size_t>(it - databases.begin());
+  }
+  if (databases.size() >= CrossDbIndex::kMaxDatabases) {
+    return std::nullopt;
+  }
+  databases.push_back(db_name);
+  return databases.size() - 1;
+}
+
+CrossIndexedRepository::CrossIndexedRepository(
+    std::unique_ptr<IIdRepository> store, SharedCrossDbIndex& shared,
+    std::string db_name, std::string filepath)
+    : store_(std::move(store)),
+      shared_(shared),
+      db_name_(std::move(db_name)),
+      filepath_(std::move(filepath)) {
+  if (!store_) {
+    throw std::invalid_argument("store");
+  }
+}
+
+auto CrossIndexedRepository::Add(const std::string& id) -> bool {
+  const bool added = store_->Add(id);
+  const std::string_view view = id;
+  Record(std::span(&view, 1), added);
+  return added;
+}
+
+auto CrossIndexedRepository::AddMany(std::span<const std::string_view> ids)
+    -> std::vector<bool> {
+  std::vector<bool> added = store_->AddMany(ids);
+  // 与 HashIndexRepository 相同：写入成功后整批 ID 都在库中
+  Record(ids, std::ranges::find(added, true) != added.end());
+  return added;
+}
+
+void CrossIndexedRepository::BeginTransaction() {
+  store_->BeginTransaction();
+  in_transaction_ = true;
+}
+
+void CrossIndexedRepository::CommitTransaction() {
+  store_->CommitTransaction();
+  in_transaction_ = false;
+  Restamp();
+}
+
+void CrossIndexedRepository::RollbackTransaction() {
+  store_->RollbackTransaction();
+  in_transaction_ = false;
+  inserted_ = false;
+  missed_ = false;
+  recorded_generation_.reset();
+  const std::unique_lock lock(shared_.mutex);
+  shared_.ready = false;
+}
+
+void CrossIndexedRepository::Record(std::span<const std::string_view> ids,
+                                    bool inserted) {
+  {
+    const std::unique_lock lock(shared_.mutex);
+    inserted_ |= inserted;
+    // 同一次提交的写入须全部进入同一份索引，期间换过索引也算漏记
+    if (!shared_.ready || (recorded_generation_ &&
+                           *recorded_generation_ != shared_.generation)) {
+      missed_ = true;
+    } else if (const std::optional<size_t> bit = shared_.BitFor(db_name_)) {
+      recorded_generation_ = shared_.generation;
+      for (const std::string_view id : ids) {
+        shared_.index.Insert(id, *bit);
+      }
+    } else {
+      shared_.ready = false;
+      missed_ = true;
+    }
+  }
+  // 事务外的写入各自提交
+  if (!in_transaction_) {
+    Restamp();
+  }
+}
+
+void CrossIndexedRepository::Restamp() {
+  const bool inserted = std::exchange(inserted_, false);
+  const bool missed = std::exchange(missed_, false);
+  const std::optional<uint64_t> generation =
+      std::exchange(recorded_generation_, std::nullopt);
+  const std::optional<IdSnapshot::SourceStamp> current =
+      IdSnapshot::StampOf(filepath_);
+  const std::unique_lock lock(shared_.mutex);
+  const auto it = shared_.files.find(db_name_);
+  if (missed || !current || !shared_.ready || it == shared_.files.end() ||
+      !it->second || (generation && *generation != shared_.generation)) {
+    return;
+  }
+  // 有新增时本次提交让修改计数恰好前进 1，没有新增时不变；
+  // 计数多走了说明其间还有其他连接提交，库仍视为已变化
+  const uint32_t expected = it->second->change_counter + (inserted ? 1U : 0U);
+  if (current->change_counter == expected) {
+    it->second = current;
+  }
+}
@@ -0,0 +1,94 @@
+// core/data/cross_indexed_repository.hpp
+#ifndef CROSS_INDEXED_REPOSITORY_HPP
+#define CROSS_INDEXED_REPOSITORY_HPP
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+#include "core/data/cross_db_index.hpp"
+#include "core/data/id_snapshot.hpp"
+#include "core/ports/i_id_repository.hpp"
+
+// 由数据库目录持有、各库的 CrossIndexedRepository 共享的跨库索引。
+// ready 为 false 时索引需要重建，写入不再同步到索引。
+struct SharedCrossDbIndex {
+  mutable std::shared_mutex mutex;
+  CrossDbIndex index;
+  std::vector<std::string> databases;  // 位序号 -> 库名
+  bool ready = false;
+  // 构建索引时各库文件的标记，之后由各库自己提交的写入推进；
+  // 标记与文件不符的库视为被其他连接改过。std::nullopt 表示读不到标记
+  std::map<std::string, std::optional<IdSnapshot::SourceStamp>> files;
+  uint64_t generation = 0;  // 每换上一份重建的索引递增一次
+
+  // 返回库对应的位序号，未登记时分配新位；位已用尽时返回 std::nullopt
+  auto BitFor(const std::string& db_name) -> std::optional<size_t>;
+};
+
+// 写入成功后把 ID 同步到跨库索引的装饰器，其余操作直接转发。
+// 事务回滚后索引可能多出未提交的 ID，此时把索引标记为需要重建；
+// 提交后若写入都已同步，把新的文件标记记入索引，库不会因此被视为已变化。
+class CrossIndexedRepository : public IIdRepository {
+ public:
+  CrossIndexedRepository(std::unique_ptr<IIdRepository> store,
+                         SharedCrossDbIndex& shared, std::string db_name,
+                         std::string filepath);
+
+  auto Add(const std::string& id) -> bool override;
+  [[nodiscard]] auto Exists(const std::string& id) const -> bool override {
+    return store_->Exists(id);
+  }
+  [[nodiscard]] auto GetCount() const -> size_t override {
+    return store_->GetCount();
+  }
+  [[nodiscard]] auto GetAllIds() const -> std::vector<std::string> override {
+    return store_->GetAllIds();
+  }
+  auto ForEachId(const IdChunkVisitor& visitor) const -> bool override {
+    return store_->ForEachId(visitor);
+  }
+  auto ForEachIdSorted(const IdChunkVisitor& visitor) const -> bool override {
+    return store_->ForEachIdSorted(visitor);
+  }
+  [[nodiscard]] auto ExistsMany(std::span<const std::string_view> ids) const
+      -> std::vector<bool> override {
+    return store_->ExistsMany(ids);
+  }
+  auto AddMany(std::span<const std::string_view> ids)
+      -> std::vector<bool> override;
+  [[nodiscard]] auto GetStats() const -> RepositoryStats override {
+    return store_->GetStats();
+  }
+  auto RebuildFilter(double false_positive_rate) -> bool override {
+    return store_->RebuildFilter(false_positive_rate);
+  }
+  [[nodiscard]] auto IsReadOnly() const -> bool override {
+    return store_->IsReadOnly();
+  }
+
+  void BeginTransaction() override;
+  void CommitTransaction() override;
+  void RollbackTransaction() override;
+
+ private:
+  void Record(std::span<const std::string_view> ids, bool inserted);
+  // 本连接的一次提交之后推进索引记下的文件标记
+  void Restamp();
+
+  std::unique_ptr<IIdRepository> store_;
+  SharedCrossDbIndex& shared_;
+  std::string db_name_;
+  std::string filepath_;
+  bool in_transaction_ = false;
+  // 自上次提交以来的写入：是否新增过 ID、是否有 ID 没能同步到同一份索引
+  bool inserted_ = false;
+  bool missed_ = false;
+  std::optional<uint64_t> recorded_generation_;
+};
+
+#endif
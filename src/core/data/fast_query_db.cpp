@@ -3,10 +3,15 @@
 
 #include <iostream>
 #include <stdexcept>  // for std::runtime_error
+#include <string_view>
+
+#include "core/data/id_chunk_buffer.hpp"
+#include "core/data/sqlite_batch_binding.hpp"
+#include "core/data/sqlite_cache_size.hpp"
 
 // --- FastQueryDB 实现 ---
 
-FastQueryDB::FastQueryDB(std::string filepath)
+FastQueryDB::FastQueryDB(std::string filepath, size_t cache_bytes)
     : db_filepath_(std::move(filepath)) {
   if (sqlite3_open(db_filepath_.c_str(), &db_) != SQLITE_OK) {
     std::string err_msg = "无法打开数据库: ";
@@ -14,10 +19,19 @@ FastQueryDB::FastQueryDB(std::string filepath)
     sqlite3_close(db_);
     throw std::runtime_error(err_msg);
   }
+  SqliteCacheSize::Apply(db_, cache_bytes);
   InitializeDb();
 }
 
 FastQueryDB::~FastQueryDB() {
+  try {
+    SaveFilter();
+  } catch (const std::exception& e) {
+    std::cerr << "保存过滤器失败: " << e.what() << std::endl;
+  }
+  if (generation_stmt_) {
+    sqlite3_finalize(generation_stmt_);
+  }
   if (add_stmt_) {
     sqlite3_finalize(add_stmt_);
   }
@@ -27,6 +41,15 @@ FastQueryDB::~FastQueryDB() {
   if (count_stmt_) {
     sqlite3_finalize(count_stmt_);
   }
+  if (exists_many_stmt_) {
+    sqlite3_finalize(exists_many_stmt_);
+  }
+  if (scan_stmt_) {
+    sqlite3_finalize(scan_stmt_);
+  }
+  if (add_many_stmt_) {
+    sqlite3_finalize(add_many_stmt_);
+  }
   if (db_) {
     sqlite3_close(db_);
   }
@@ -47,6 +70,8 @@ void FastQueryDB::InitializeDb() {
     throw std::runtime_error(error);
   }
 
+  EnsureCountMetadata();
+
   const char* insert_sql = "INSERT OR IGNORE INTO ids (id) VALUES (?);";
   if (sqlite3_prepare_v2(db_, insert_sql, -1, &add_stmt_, nullptr) !=
       SQLITE_OK) {
@@ -59,11 +84,138 @@ void FastQueryDB::InitializeDb() {
     throw std::runtime_error("准备 SELECT 语句失败");
   }
 
-  const char* count_sql = "SELECT COUNT(*) FROM ids;";
+  // 记录数由触发器维护在 id_meta 中，读取是一次单行主键查找
+  const char* count_sql = "SELECT value FROM id_meta WHERE key = 'id_count';";
   if (sqlite3_prepare_v2(db_, count_sql, -1, &count_stmt_, nullptr) !=
       SQLITE_OK) {
     throw std::runtime_error("准备 COUNT 语句失败");
   }
+
+  // key 为数组下标，用于把结果映射回输入位置
+  const char* exists_many_sql =
+      "SELECT batch.key FROM json_each(?) AS batch"
+      " JOIN ids ON ids.id = batch.value;";
+  if (sqlite3_prepare_v2(db_, exists_many_sql, -1, &exists_many_stmt_,
+                         nullptr) != SQLITE_OK) {
+    throw std::runtime_error("准备批量 SELECT 语句失败");
+  }
+
+  // RETURNING 只返回真正插入的行，被 IGNORE 的已存在 ID 不会出现
+  const char* add_many_sql =
+      "INSERT OR IGNORE INTO ids (id) SELECT value FROM json_each(?)"
+      " RETURNING id;";
+  if (sqlite3_prepare_v2(db_, add_many_sql, -1, &add_many_stmt_, nullptr) !=
+      SQLITE_OK) {
+    throw std::runtime_error("准备批量 INSERT 语句失败");
+  }
+
+  const char* scan_sql = "SELECT id FROM ids;";
+  if (sqlite3_prepare_v2(db_, scan_sql, -1, &scan_stmt_, nullptr) !=
+      SQLITE_OK) {
+    throw std::runtime_error("准备遍历语句失败");
+  }
+
+  const char* generation_sql =
+      "SELECT value FROM id_meta WHERE key = 'insert_generation';";
+  if (sqlite3_prepare_v2(db_, generation_sql, -1, &generation_stmt_,
+                         nullptr) != SQLITE_OK) {
+    throw std::runtime_error("准备版本号查询语句失败");
+  }
+
+  LoadFilter();
+}
+
+void FastQueryDB::LoadFilter() {
+  uint64_t generation = 0;
+  filter_ = BloomFilter::Load(db_filepath_ + ".bloom", generation);
+  if (!filter_) {
+    return;
+  }
+  filter_generation_ = generation;
+  filter_stale_ = ReadGeneration() != filter_generation_;
+}
+
+void FastQueryDB::SaveFilter() {
+  if (filter_ && filter_dirty_ && !filter_stale_) {
+    filter_->Save(db_filepath_ + ".bloom", filter_generation_);
+    filter_dirty_ = false;
+  }
+}
+
+auto FastQueryDB::ReadGeneration() const -> uint64_t {
+  uint64_t generation = 0;
+  if (sqlite3_step(generation_stmt_) == SQLITE_ROW) {
+    generation = static_cast<uint64_t>(sqlite3_column_int64(generation_stmt_, 0));
+  }
+  sqlite3_reset(generation_stmt_);
+  return generation;
+}
+
+auto FastQueryDB::FilterUsable() const -> bool {
+  if (!filter_ || filter_stale_) {
+    return false;
+  }
+  // 其他连接写入后 generation 会前进；id_meta 只有几行，
+  // 这次读取远比在大表的 B 树中查找便宜
+  if (ReadGeneration() != filter_generation_) {
+    filter_stale_ = true;
+  }
+  return !filter_stale_;
+}
+
+void FastQueryDB::RecordInserted(std::string_view id) {
+  if (filter_ && !filter_stale_) {
+    filter_->Insert(id);
+    ++filter_generation_;  // 与插入触发器同步递增
+    filter_dirty_ = true;
+  }
+}
+
+void FastQueryDB::EnsureCountMetadata() {
+  // 触发器存在说明计数行已初始化，避免每次打开都抢写锁
+  const char* probe_sql =
+      "SELECT 1 FROM sqlite_master"
+      " WHERE type = 'trigger' AND name = 'ids_generation_insert';";
+  sqlite3_stmt* probe = nullptr;
+  if (sqlite3_prepare_v2(db_, probe_sql, -1, &probe, nullptr) != SQLITE_OK) {
+    throw std::runtime_error("检查计数元数据失败");
+  }
+  const bool initialized = sqlite3_step(probe) == SQLITE_ROW;
+  sqlite3_finalize(probe);
+  if (initialized) {
+    return;
+  }
+
+  // 旧库升级：在同一个写事务里统计一次现有行数并安装触发器，
+  // 已有计数行时 INSERT OR REPLACE 会按实际行数重新校准；
+  // 之后任何连接（包括其他进程）的插入/删除都会在各自事务内同步计数
+  const char* setup_sql =
+      "BEGIN IMMEDIATE;"
+      "CREATE TABLE IF NOT EXISTS id_meta ("
+      " key TEXT PRIMARY KEY NOT NULL,"
+      " value INTEGER NOT NULL"
+      ") WITHOUT ROWID;"
+      "INSERT OR REPLACE INTO id_meta (key, value)"
+      " SELECT 'id_count', COUNT(*) FROM ids;"
+      "CREATE TRIGGER IF NOT EXISTS ids_count_insert AFTER INSERT ON ids"
+      " BEGIN UPDATE id_meta SET value = value + 1 WHERE key = 'id_count'; END;"
+      "CREATE TRIGGER IF NOT EXISTS ids_count_delete AFTER DELETE ON ids"
+      " BEGIN UPDATE id_meta SET value = value - 1 WHERE key = 'id_count'; END;"
+      // 只增不减的插入版本号，用于判断过滤器是否覆盖了全部写入
+      "INSERT OR IGNORE INTO id_meta (key, value)"
+      " VALUES ('insert_generation', 0);"
+      "CREATE TRIGGER IF NOT EXISTS ids_generation_insert AFTER INSERT ON ids"
+      " BEGIN UPDATE id_meta SET value = value + 1"
+      " WHERE key = 'insert_generation'; END;"
+      "COMMIT;";
+  char* err_msg = nullptr;
+  if (sqlite3_exec(db_, setup_sql, nullptr, nullptr, &err_msg) != SQLITE_OK) {
+    std::string error = "初始化计数元数据失败: ";
+    error += err_msg != nullptr ? err_msg : "";
+    sqlite3_free(err_msg);
+    sqlite3_exec(db_, "ROLLBACK;", nullptr, nullptr, nullptr);
+    throw std::runtime_error(error);
+  }
 }
 
 auto FastQueryDB::Add(const std::string& id) -> bool {
@@ -77,10 +229,22 @@ auto FastQueryDB::Add(const std::string& id) -> bool {
   }
 
   sqlite3_reset(add_stmt_);
+  if (success) {
+    RecordInserted(id);
+  }
   return success;
 }
 
 auto FastQueryDB::Exists(const std::string& id) const -> bool {
+  const bool filtered = FilterUsable();
+  if (filtered) {
+    ++filter_lookups_;
+    if (!filter_->MayContain(id)) {
+      ++filter_rejected_;
+      return false;
+    }
+  }
+
   sqlite3_bind_text(exists_stmt_, 1, id.c_str(), -1, SQLITE_STATIC);
 
   bool found = false;
@@ -89,13 +253,16 @@ auto FastQueryDB::Exists(const std::string& id) const -> bool {
   }
 
   sqlite3_reset(exists_stmt_);
+  if (filtered && !found) {
+    ++filter_false_positives_;
+  }
   return found;
 }
 
 auto FastQueryDB::GetCount() const -> size_t {
   size_t count = 0;
   if (sqlite3_step(count_stmt_) == SQLITE_ROW) {
-    count = sqlite3_column_int(count_stmt_, 0);
+    count = static_cast<size_t>(sqlite3_column_int64(count_stmt_, 0));
   }
   sqlite3_reset(count_stmt_);
   return count;
@@ -103,21 +270,207 @@ auto FastQueryDB::GetCount() const -> size_t {
 
 auto FastQueryDB::GetAllIds() const -> std::vector<std::string> {
   std::vector<std::string> ids;
-  const char* select_all_sql = "SELECT id FROM ids;";
+  ids.reserve(GetCount());
+  ForEachId([&ids](std::span<const std::string_view> chunk) {
+    ids.insert(ids.end(), chunk.begin(), chunk.end());
+    return true;
+  });
+  return ids;
+}
+
+auto FastQueryDB::ForEachId(const IdChunkVisitor& visitor) const -> bool {
+  // 逐行从 SQLite 取出，按块交付；语句在结束或中止时复位
+  IdChunkBuffer chunk(visitor);
+  bool completed = true;
+  int rc = SQLITE_ROW;
+  while ((rc = sqlite3_step(scan_stmt_)) == SQLITE_ROW) {
+    const auto* text =
+        reinterpret_cast<const char*>(sqlite3_column_text(scan_stmt_, 0));
+    if (text == nullptr) {
+      continue;
+    }
+    if (!chunk.Append(std::string_view(
+            text, static_cast<size_t>(sqlite3_column_bytes(scan_stmt_, 0))))) {
+      completed = false;
+      break;
+    }
+  }
+  // 中途出错时抛出，不把残缺的遍历当作导出完成
+  const std::string error =
+      completed && rc != SQLITE_DONE ? sqlite3_errmsg(db_) : "";
+  sqlite3_reset(scan_stmt_);
+  if (!error.empty()) {
+    throw std::runtime_error("遍历失败: " + error);
+  }
+  return completed && chunk.Flush();
+}
+
+auto FastQueryDB::ForEachIdSorted(const IdChunkVisitor& visitor) const
+    -> bool {
+  // 主键索引本身有序，按索引顺序读出即可，无需排序
   sqlite3_stmt* stmt = nullptr;
-  if (sqlite3_prepare_v2(db_, select_all_sql, -1, &stmt, nullptr) !=
-      SQLITE_OK) {
-    return ids;
+  if (sqlite3_prepare_v2(db_, "SELECT id FROM ids ORDER BY id;", -1, &stmt,
+                         nullptr) != SQLITE_OK) {
+    throw std::runtime_error("准备有序遍历语句失败");
+  }
+  IdChunkBuffer chunk(visitor);
+  bool completed = true;
+  int rc = SQLITE_ROW;
+  while (completed && (rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+    completed = chunk.Append(std::string_view(
+        reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0)),
+        static_cast<size_t>(sqlite3_column_bytes(stmt, 0))));
+  }
+  // 中途出错（库被锁定、页损坏）不能当作遍历完成，否则归并结果残缺
+  const std::string error =
+      completed && rc != SQLITE_DONE ? sqlite3_errmsg(db_) : "";
+  sqlite3_finalize(stmt);
+  if (!error.empty()) {
+    throw std::runtime_error("有序遍历失败: " + error);
+  }
+  return completed && chunk.Flush();
+}
+
+auto FastQueryDB::ExistsMany(std::span<const std::string_view> ids) const
+    -> std::vector<bool> {
+  std::vector<bool> found(ids.size(), false);
+  if (ids.empty()) {
+    return found;
+  }
+
+  // 过滤器先剔除必然不存在的 ID，只把可能存在的部分交给数据库
+  std::vector<std::string_view>& candidates = candidate_scratch_;
+  std::vector<size_t>& positions = position_scratch_;
+  candidates.clear();
+  positions.clear();
+  const bool filtered = FilterUsable();
+  for (size_t i = 0; i < ids.size(); ++i) {
+    if (filtered) {
+      ++filter_lookups_;
+      if (!filter_->MayContain(ids[i])) {
+        ++filter_rejected_;
+        continue;
+      }
+    }
+    candidates.emplace_back(ids[i]);
+    positions.push_back(i);
+  }
+  if (candidates.empty()) {
+    return found;
   }
 
-  while (sqlite3_step(stmt) == SQLITE_ROW) {
-    const unsigned char* text = sqlite3_column_text(stmt, 0);
-    if (text != nullptr) {
-      ids.emplace_back(reinterpret_cast<const char*>(text));
+  SqliteBatchBinding::BuildJsonStringArray(candidates, batch_json_);
+  sqlite3_bind_text(exists_many_stmt_, 1, batch_json_.data(),
+                    static_cast<int>(batch_json_.size()), SQLITE_STATIC);
+  size_t hits = 0;
+  int rc = SQLITE_OK;
+  while ((rc = sqlite3_step(exists_many_stmt_)) == SQLITE_ROW) {
+    const sqlite3_int64 index = sqlite3_column_int64(exists_many_stmt_, 0);
+    if (index >= 0 && static_cast<size_t>(index) < positions.size()) {
+      found[positions[static_cast<size_t>(index)]] = true;
+      ++hits;
     }
   }
+  SqliteBatchBinding::FinishOrThrow(db_, exists_many_stmt_, rc,
+                                    "批量查询失败");
+  if (filtered) {
+    filter_false_positives_ += candidates.size() - hits;
+  }
+  return found;
+}
+
+auto FastQueryDB::AddMany(std::span<const std::string_view> ids)
+    -> std::vector<bool> {
+  std::vector<bool> added(ids.size(), false);
+  if (ids.empty()) {
+    return added;
+  }
+
+  // 批内去重：同一 ID 只有首次出现的位置可能被标记为新增
+  dedup_.Clear();
+  for (size_t i = 0; i < ids.size(); ++i) {
+    dedup_.Add(ids[i], i);
+  }
+  dedup_.Finish();
+
+  SqliteBatchBinding::BuildJsonStringArray(dedup_.Keys(), batch_json_);
+  sqlite3_bind_text(add_many_stmt_, 1, batch_json_.data(),
+                    static_cast<int>(batch_json_.size()), SQLITE_STATIC);
+  int rc = SQLITE_OK;
+  while ((rc = sqlite3_step(add_many_stmt_)) == SQLITE_ROW) {
+    const auto* text = reinterpret_cast<const char*>(
+        sqlite3_column_text(add_many_stmt_, 0));
+    if (text == nullptr) {
+      continue;
+    }
+    const std::string_view id(
+        text, static_cast<size_t>(sqlite3_column_bytes(add_many_stmt_, 0)));
+    if (const auto index = dedup_.FirstIndexOf(id)) {
+      added[*index] = true;
+      RecordInserted(id);
+    }
+  }
+  SqliteBatchBinding::FinishOrThrow(db_, add_many_stmt_, rc, "批量插入失败");
+  return added;
+}
+
+auto FastQueryDB::GetStats() const -> RepositoryStats {
+  RepositoryStats stats;
+  stats.engine = "SQLite (文本布局)";
+  if (filter_) {
+    stats.filter.loaded = true;
+    stats.filter.stale = filter_stale_;
+    stats.filter.false_positive_rate = filter_->FalsePositiveRate();
+    stats.filter.memory_bytes = filter_->MemoryBytes();
+    stats.filter.lookups = filter_lookups_;
+    stats.filter.rejected = filter_rejected_;
+    stats.filter.false_positives = filter_false_positives_;
+  }
+  return stats;
+}
+
+auto FastQueryDB::RebuildFilter(double false_positive_rate) -> bool {
+  // 在同一个读事务内读取版本号和全部 ID，保证两者对应同一快照
+  if (sqlite3_exec(db_, "BEGIN;", nullptr, nullptr, nullptr) != SQLITE_OK) {
+    return false;
+  }
+  const uint64_t generation = ReadGeneration();
+  // 预留 25% 余量给后续新增
+  BloomFilter filter(GetCount() + GetCount() / 4 + 1024, false_positive_rate);
+  sqlite3_stmt* stmt = nullptr;
+  if (sqlite3_prepare_v2(db_, "SELECT id FROM ids;", -1, &stmt, nullptr) !=
+      SQLITE_OK) {
+    sqlite3_exec(db_, "COMMIT;", nullptr, nullptr, nullptr);
+    return false;
+  }
+  int rc = SQLITE_ROW;
+  while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+    filter.Insert(std::string_view(
+        reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0)),
+        static_cast<size_t>(sqlite3_column_bytes(stmt, 0))));
+  }
   sqlite3_finalize(stmt);
-  return ids;
+  sqlite3_exec(db_, "COMMIT;", nullptr, nullptr, nullptr);
+  // 扫描中途出错（库被锁定、读写错误）时过滤器缺了一部分 ID，
+  // 保存后会把库中已有的 ID 判为必然不存在
+  if (rc != SQLITE_DONE) {
+    return false;
+  }
+
+  try {
+    filter.Save(db_filepath_ + ".bloom", generation);
+  } catch (const std::exception& e) {
+    std::cerr << "保存过滤器失败: " << e.what() << std::endl;
+    return false;
+  }
+  filter_ = std::move(filter);
+  filter_generation_ = generation;
+  filter_dirty_ = false;
+  filter_stale_ = false;
+  filter_lookups_ = 0;
+  filter_rejected_ = 0;
+  filter_false_positives_ = 0;
+  return true;
 }
 
 void FastQueryDB::BeginTransaction() {
@@ -130,4 +483,8 @@ void FastQueryDB::CommitTransaction() {
 
 void FastQueryDB::RollbackTransaction() {
   sqlite3_exec(db_, "ROLLBACK;", nullptr, nullptr, nullptr);
+  // 回滚后库的版本号倒退，过滤器仍是超集但无法再与版本号对齐，停用待重建
+  if (filter_) {
+    filter_stale_ = true;
+  }
 }
@@ -3,14 +3,20 @@
 #define FAST_QUERY_D_B_HPP
 
 #include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <vector>
 
+#include "core/data/batch_dedup.hpp"
+#include "core/data/bloom_filter.hpp"
 #include "core/ports/i_id_repository.hpp"
 #include "sqlite3.h"
 
 class FastQueryDB : public IIdRepository {
  public:
-  explicit FastQueryDB(std::string filepath);
+  // cache_bytes 为该连接的页缓存上限，0 使用 SQLite 默认值
+  explicit FastQueryDB(std::string filepath, size_t cache_bytes = 0);
   ~FastQueryDB() override;
 
   FastQueryDB(const FastQueryDB&) = delete;
@@ -20,6 +26,14 @@ class FastQueryDB : public IIdRepository {
   [[nodiscard]] auto Exists(const std::string& id) const -> bool override;
   [[nodiscard]] auto GetCount() const -> size_t override;
   [[nodiscard]] auto GetAllIds() const -> std::vector<std::string> override;
+  auto ForEachId(const IdChunkVisitor& visitor) const -> bool override;
+  auto ForEachIdSorted(const IdChunkVisitor& visitor) const -> bool override;
+  [[nodiscard]] auto ExistsMany(std::span<const std::string_view> ids) const
+      -> std::vector<bool> override;
+  auto AddMany(std::span<const std::string_view> ids) -> std::vector<bool> override;
+  [[nodiscard]] auto GetStats() const -> RepositoryStats override;
+  auto RebuildFilter(double false_positive_rate) -> bool override;
+  [[nodiscard]] auto IsReadOnly() const -> bool override { return false; }
 
   // --- Add these new methods for transaction control ---
   void BeginTransaction() override;
@@ -28,11 +42,38 @@ class FastQueryDB : public IIdRepository {
 
  private:
   void InitializeDb();
+  void EnsureCountMetadata();
+  void LoadFilter();
+  void SaveFilter();
+  [[nodiscard]] auto ReadGeneration() const -> uint64_t;
+  [[nodiscard]] auto FilterUsable() const -> bool;
+  void RecordInserted(std::string_view id);
 
   std::string db_filepath_;
   sqlite3* db_ = nullptr;
   sqlite3_stmt* add_stmt_ = nullptr;
   sqlite3_stmt* exists_stmt_ = nullptr;
   sqlite3_stmt* count_stmt_ = nullptr;
+  // 批量语句：整批 ID 以 JSON 数组绑定，由 json_each 展开为集合一次执行
+  sqlite3_stmt* exists_many_stmt_ = nullptr;
+  sqlite3_stmt* add_many_stmt_ = nullptr;
+  sqlite3_stmt* scan_stmt_ = nullptr;  // ForEachId 全表遍历
+  mutable std::string batch_json_;  // 复用的批量参数缓冲区
+  // 批量操作的复用缓冲区，稳态下不随 ID 分配内存
+  mutable std::vector<std::string_view> candidate_scratch_;
+  mutable std::vector<size_t> position_scratch_;
+  BatchDedup<std::string_view> dedup_;
+
+  // --- 负查询过滤器 (<库文件>.bloom) ---
+  // 不变式：过滤器包含库中 generation <= filter_generation_ 时的全部 ID。
+  // 每次使用前读取库的 generation，若被其他连接推进则过滤器停用。
+  sqlite3_stmt* generation_stmt_ = nullptr;
+  std::optional<BloomFilter> filter_;
+  uint64_t filter_generation_ = 0;
+  bool filter_dirty_ = false;
+  mutable bool filter_stale_ = false;
+  mutable uint64_t filter_lookups_ = 0;
+  mutable uint64_t filter_rejected_ = 0;
+  mutable uint64_t filter_false_positives_ = 0;
 };
 #endif
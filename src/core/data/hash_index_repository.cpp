@@ -0,0 +1,99 @@
+// core/data/hash_index_repository.cpp
+#include "core/data/hash_index_repository.hpp"
+
+#include <chrono>
+#include <stdexcept>
+
+HashIndexRepository::HashIndexRepository(std::unique_ptr<IIdRepository> store)
+    : store_(std::move(store)) {
+  if (!store_) {
+    throw std::invalid_argument("store");
+  }
+  Reload();
+}
+
+void HashIndexRepository::Reload() {
+  const auto start = std::chrono::steady_clock::now();
+  index_.Clear();
+  index_.Reserve(store_->GetCount());
+  store_->ForEachId([this](std::span<const std::string_view> chunk) {
+    for (const std::string_view id : chunk) {
+      index_.Insert(id);
+    }
+    return true;
+  });
+  load_ms_ = std::chrono::duration<double, std::milli>(
+                 std::chrono::steady_clock::now() - start)
+                 .count();
+}
+
+auto HashIndexRepository::Add(const std::string& id) -> bool {
+  const bool added = store_->Add(id);
+  index_.Insert(id);
+  return added;
+}
+
+auto HashIndexRepository::Exists(const std::string& id) const -> bool {
+  return index_.Contains(id);
+}
+
+auto HashIndexRepository::GetCount() const -> size_t {
+  return store_->GetCount();
+}
+
+auto HashIndexRepository::GetAllIds() const -> std::vector<std::string> {
+  return store_->GetAllIds();
+}
+
+auto HashIndexRepository::ForEachId(const IdChunkVisitor& visitor) const
+    -> bool {
+  return store_->ForEachId(visitor);
+}
+
+auto HashIndexRepository::ForEachIdSorted(const IdChunkVisitor& visitor) const
+    -> bool {
+  return store_->ForEachIdSorted(visitor);
+}
+
+auto HashIndexRepository::ExistsMany(std::span<const std::string_view> ids) const
+    -> std::vector<bool> {
+  std::vector<bool> found(ids.size(), false);
+  for (size_t i = 0; i < ids.size(); ++i) {
+    found[i] = index_.Contains(ids[i]);
+  }
+  return found;
+}
+
+auto HashIndexRepository::AddMany(std::span<const std::string_view> ids)
+    -> std::vector<bool> {
+  std::vector<bool> added = store_->AddMany(ids);
+  // 无论新增还是已存在，写穿成功后这些 ID 都在库中
+  for (const auto& id : ids) {
+    index_.Insert(id);
+  }
+  return added;
+}
+
+auto HashIndexRepository::GetStats() const -> RepositoryStats {
+  RepositoryStats stats;
+  stats.engine = "内存哈希索引 / " + store_->GetStats().engine;
+  stats.load_ms = load_ms_;
+  stats.memory_bytes = index_.MemoryBytes();
+  stats.filter = store_->GetStats().filter;
+  return stats;
+}
+
+auto HashIndexRepository::RebuildFilter(double false_positive_rate) -> bool {
+  // 内存索引本身不查 SQLite；过滤器留给以 SQLite 引擎打开时使用
+  return store_->RebuildFilter(false_positive_rate);
+}
+
+void HashIndexRepository::BeginTransaction() { store_->BeginTransaction(); }
+
+void HashIndexRepository::CommitTransaction() { store_->CommitTransaction(); }
+
+void HashIndexRepository::RollbackTransaction() {
+  store_->RollbackTransaction();
+  // 回滚撤销的写入已进入索引，按持久化仓储重建
+  Reload();
+}
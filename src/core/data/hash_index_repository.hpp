@@ -0,0 +1,45 @@
+// core/data/hash_index_repository.hpp
+#ifndef HASH_INDEX_REPOSITORY_HPP
+#define HASH_INDEX_REPOSITORY_HPP
+
+#include <memory>
+#include <string>
+
+#include "core/data/id_hash_index.hpp"
+#include "core/ports/i_id_repository.hpp"
+
+// 内存哈希索引引擎：打开时把全部 ID 载入 IdHashIndex，查询完全在内存中完成；
+// 写操作先写穿到底层持久化仓储（SQLite），成功后再同步到索引。
+// 索引是打开时刻的快照，其他进程之后的写入需 Reload 才可见。
+class HashIndexRepository : public IIdRepository {
+ public:
+  explicit HashIndexRepository(std::unique_ptr<IIdRepository> store);
+
+  void Reload();
+
+  auto Add(const std::string& id) -> bool override;
+  [[nodiscard]] auto Exists(const std::string& id) const -> bool override;
+  [[nodiscard]] auto GetCount() const -> size_t override;
+  [[nodiscard]] auto GetAllIds() const -> std::vector<std::string> override;
+  auto ForEachId(const IdChunkVisitor& visitor) const -> bool override;
+  auto ForEachIdSorted(const IdChunkVisitor& visitor) const -> bool override;
+  [[nodiscard]] auto ExistsMany(std::span<const std::string_view> ids) const
+      -> std::vector<bool> override;
+  auto AddMany(std::span<const std::string_view> ids) -> std::vector<bool> override;
+  [[nodiscard]] auto GetStats() const -> RepositoryStats override;
+  auto RebuildFilter(double false_positive_rate) -> bool override;
+  [[nodiscard]] auto IsReadOnly() const -> bool override {
+    return store_->IsReadOnly();
+  }
+
+  void BeginTransaction() override;
+  void CommitTransaction() override;
+  void RollbackTransaction() override;
+
+ private:
+  std::unique_ptr<IIdRepository> store_;
+  IdHashIndex index_;
+  double load_ms_ = 0.0;
+};
+
+#endif
@@ -0,0 +1,53 @@
+// core/data/id_chunk_buffer.hpp
+#ifndef ID_CHUNK_BUFFER_HPP
+#define ID_CHUNK_BUFFER_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "core/ports/i_id_repository.hpp"
+#include "core/utils/id_list.hpp"
+
+// ForEachId 的实现辅助：把逐行取出的 ID 拷进一块复用的缓冲区，
+// 攒满一块后以 string_view 数组交给访问者。内存占用与库大小无关。
+class IdChunkBuffer {
+ public:
+  static constexpr size_t kChunkIds = 1024;
+
+  explicit IdChunkBuffer(const IdChunkVisitor& visitor) : visitor_(visitor) {
+    ids_.Reserve(kChunkIds, kChunkIds * 16);
+    views_.reserve(kChunkIds);
+  }
+
+  // 返回 false 表示访问者要求停止
+  auto Append(std::string_view id) -> bool {
+    ids_.Append(id);
+    return ids_.Size() < kChunkIds || Flush();
+  }
+
+  // 拼接型 ID（前缀 + 数字等）直接写入缓冲区，写完后调用 EndId
+  [[nodiscard]] auto Bytes() -> std::string& { return ids_.Bytes(); }
+  auto EndId() -> bool {
+    ids_.EndId();
+    return ids_.Size() < kChunkIds || Flush();
+  }
+
+  auto Flush() -> bool {
+    if (ids_.Empty()) {
+      return true;
+    }
+    // 缓冲区追加期间可能重新分配，视图只能在交付前统一生成
+    ids_.ViewsInto(views_);
+    const bool keep_going = visitor_(views_);
+    ids_.Clear();
+    return keep_going;
+  }
+
+ private:
+  const IdChunkVisitor& visitor_;
+  IdList ids_;
+  std::vector<std::string_view> views_;
+};
+
+#endif
@@ -0,0 +1,25 @@
+// core/data/id_hash.hpp
+#ifndef ID_HASH_HPP
+#define ID_HASH_HPP
+
+#include <cstdint>
+#include <string_view>
+
+namespace IdHash {
+
+// FNV-1a + murmur3 末尾混合，保证高低位都分布均匀；结果永不为 0
+inline auto Hash(std::string_view id) -> uint64_t {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (const char c : id) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 0x100000001b3ULL;
+  }
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  return hash == 0 ? 1 : hash;
+}
+
+}  // namespace IdHash
+
+#endif
@@ -0,0 +1,107 @@
+// core/data/id_hash_index.cpp
+#include "core/data/id_hash_index.hpp"
+
+#include <bit>
+#include <cstring>
+
+#include "core/data/id_hash.hpp"
+
+namespace {
+constexpr size_t kInitialCapacity = 16;
+}  // namespace
+
+IdHashIndex::IdHashIndex() { Rehash(kInitialCapacity); }
+
+auto IdHashIndex::SlotEquals(const Slot& slot, uint64_t hash,
+                             std::string_view id) const -> bool {
+  if (slot.hash != hash) {
+    return false;
+  }
+  if (slot.length != kArenaMarker) {
+    return slot.length == id.size() &&
+           std::memcmp(slot.bytes, id.data(), id.size()) == 0;
+  }
+  uint32_t offset = 0;
+  uint32_t length = 0;
+  std::memcpy(&offset, slot.bytes, sizeof(offset));
+  std::memcpy(&length, slot.bytes + sizeof(offset), sizeof(length));
+  return length == id.size() &&
+         std::memcmp(arena_.data() + offset, id.data(), id.size()) == 0;
+}
+
+void IdHashIndex::Reserve(size_t expected_count) {
+  // 负载因子上限 0.75
+  const size_t needed = std::bit_ceil(expected_count + expected_count / 3 + 1);
+  if (needed > slots_.size()) {
+    Rehash(needed);
+  }
+}
+
+void IdHashIndex::Clear() {
+  arena_.clear();
+  size_ = 0;
+  slots_.assign(kInitialCapacity, Slot{});
+  mask_ = kInitialCapacity - 1;
+}
+
+void IdHashIndex::Rehash(size_t new_capacity) {
+  std::vector<Slot> old_slots(new_capacity);
+  old_slots.swap(slots_);
+  mask_ = new_capacity - 1;
+  for (const Slot& slot : old_slots) {
+    if (slot.hash == 0) {
+      continue;
+    }
+    size_t pos = slot.hash & mask_;
+    while (slots_[pos].hash != 0) {
+      pos = (pos + 1) & mask_;
+    }
+    slots_[pos] = slot;
+  }
+}
+
+auto IdHashIndex::Insert(std::string_view id) -> bool {
+  if ((size_ + 1) * 4 > slots_.size() * 3) {
+    Rehash(slots_.size() * 2);
+  }
+  const uint64_t hash = IdHash::Hash(id);
+  size_t pos = hash & mask_;
+  while (slots_[pos].hash != 0) {
+    if (SlotEquals(slots_[pos], hash, id)) {
+      return false;
+    }
+    pos = (pos + 1) & mask_;
+  }
+
+  Slot& slot = slots_[pos];
+  slot.hash = hash;
+  if (id.size() <= kMaxInlineLength) {
+    slot.length = static_cast<uint8_t>(id.size());
+    std::memcpy(slot.bytes, id.data(), id.size());
+  } else {
+    const auto offset = static_cast<uint32_t>(arena_.size());
+    const auto length = static_cast<uint32_t>(id.size());
+    arena_.append(id);
+    slot.length = kArenaMarker;
+    std::memcpy(slot.bytes, &offset, sizeof(offset));
+    std::memcpy(slot.bytes + sizeof(offset), &length, sizeof(length));
+  }
+  ++size_;
+  return true;
+}
+
+auto IdHashIndex::Contains(std::string_view id) const -> bool {
+  const uint64_t hash = IdHash::Hash(id);
+  size_t pos = hash & mask_;
+  while (slots_[pos].hash != 0) {
+    if (SlotEquals(slots_[pos], hash, id)) {
+      return true;
+    }
+    pos = (pos + 1) & mask_;
+  }
+  return false;
+}
+
+auto IdHashIndex::MemoryBytes() const -> size_t {
+  return slots_.capacity() * sizeof(Slot) + arena_.capacity();
+}
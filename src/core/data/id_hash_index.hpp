@@ -0,0 +1,50 @@
+// core/data/id_hash_index.hpp
+#ifndef ID_HASH_INDEX_HPP
+#define ID_HASH_INDEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// 规范化 ID 的开放寻址哈希集合（线性探测）。
+// 槽位定长 24 字节：8 字节哈希 + 16 字节负载。不超过 15 字节的 ID
+// 直接内联在槽位里；更长的 ID 存入连续的 arena，槽位只记偏移和长度。
+// 整个集合只有两块连续内存，不存在逐节点分配。
+class IdHashIndex {
+ public:
+  IdHashIndex();
+
+  void Reserve(size_t expected_count);
+  void Clear();
+
+  // 返回 true 表示新插入
+  auto Insert(std::string_view id) -> bool;
+  [[nodiscard]] auto Contains(std::string_view id) const -> bool;
+
+  [[nodiscard]] auto Size() const -> size_t { return size_; }
+  [[nodiscard]] auto MemoryBytes() const -> size_t;
+
+ private:
+  static constexpr uint8_t kMaxInlineLength = 15;
+  static constexpr uint8_t kArenaMarker = 0xFF;
+
+  struct Slot {
+    uint64_t hash = 0;  // 0 表示空槽
+    uint8_t length = 0;  // kArenaMarker 表示 ID 存在 arena 中
+    char bytes[15] = {};
+  };
+  static_assert(sizeof(Slot) == 24);
+
+  [[nodiscard]] auto SlotEquals(const Slot& slot, uint64_t hash,
+                                std::string_view id) const -> bool;
+  void Rehash(size_t new_capacity);
+
+  std::vector<Slot> slots_;
+  std::string arena_;
+  size_t size_ = 0;
+  size_t mask_ = 0;
+};
+
+#endif
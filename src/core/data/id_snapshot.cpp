@@ -0,0 +1,179 @@
+// core/data/id_snapshot.cpp
+#include "core/data/id_snapshot.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+namespace IdSnapshot {
+
+namespace {
+void AppendVarint(std::string& out, uint64_t value) {
+  while (value >= 0x80) {
+    out += static_cast<char>((value & 0x7F) | 0x80);
+    value >>= 7;
+  }
+  out += static_cast<char>(value);
+}
+
+auto AlignTo8(uint64_t offset) -> uint64_t { return (offset + 7) & ~7ULL; }
+
+// 把有序的块首依次填入 Eytzinger 布局：中序遍历隐式完全二叉树
+void FillEytzinger(const std::vector<uint64_t>& sorted_prefixes,
+                   std::vector<TreeNode>& tree, size_t& next, size_t k) {
+  if (k >= tree.size()) {
+    return;
+  }
+  FillEytzinger(sorted_prefixes, tree, next, 2 * k);
+  tree[k] = TreeNode{sorted_prefixes[next], next};
+  ++next;
+  FillEytzinger(sorted_prefixes, tree, next, 2 * k + 1);
+}
+}  // namespace
+
+auto PrefixKey(const char* data, size_t length) -> uint64_t {
+  uint64_t key = 0;
+  const size_t n = std::min<size_t>(length, 8);
+  for (size_t i = 0; i < 8; ++i) {
+    key <<= 8;
+    if (i < n) {
+      key |= static_cast<unsigned char>(data[i]);
+    }
+  }
+  return key;
+}
+
+auto StampOf(const std::string& filepath) -> std::optional<SourceStamp> {
+  std::error_code ec;
+  const auto size = std::filesystem::file_size(filepath, ec);
+  if (ec) {
+    return std::nullopt;
+  }
+  const auto mtime = std::filesystem::last_write_time(filepath, ec);
+  if (ec) {
+    return std::nullopt;
+  }
+  SourceStamp stamp;
+  stamp.size = size;
+  stamp.mtime_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       mtime.time_since_epoch())
+                       .count();
+  stamp.change_counter = ChangeCounterOf(filepath).value_or(0);
+  return stamp;
+}
+
+auto ChangeCounterOf(const std::string& filepath) -> std::optional<uint32_t> {
+  constexpr char kSqliteMagic[16] = "SQLite format 3";
+  constexpr size_t kCounterOffset = 24;
+  std::ifstream in(filepath, std::ios::binary);
+  unsigned char header[kCounterOffset + 4] = {};
+  in.read(reinterpret_cast<char*>(header), sizeof(header));
+  if (!in || std::memcmp(header, kSqliteMagic, sizeof(kSqliteMagic)) != 0) {
+    return std::nullopt;
+  }
+  // 按大端存储
+  uint32_t counter = 0;
+  for (size_t i = 0; i < 4; ++i) {
+    counter = (counter << 8) | header[kCounterOffset + i];
+  }
+  return counter;
+}
+
+auto ReadSourceStamp(const std::string& snapshot_path)
+    -> std::optional<SourceStamp> {
+  std::ifstream in(snapshot_path, std::ios::binary);
+  if (!in.is_open()) {
+    return std::nullopt;
+  }
+  FileHeader header{};
+  in.read(reinterpret_cast<char*>(&header), sizeof(header));
+  if (!in || std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+      header.version != kFormatVersion) {
+    return std::nullopt;
+  }
+  return SourceStamp{header.source_size, header.source_mtime_ns,
+                     header.source_change_counter};
+}
+
+void Write(const std::string& snapshot_path, std::vector<std::string> ids,
+           const SourceStamp& source) {
+  std::sort(ids.begin(), ids.end());
+  ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+  const size_t block_count = (ids.size() + kBlockSize - 1) / kBlockSize;
+  std::string data;
+  std::vector<uint64_t> block_offsets;
+  std::vector<uint64_t> head_prefixes;
+  block_offsets.reserve(block_count + 1);
+  head_prefixes.reserve(block_count);
+  for (size_t i = 0; i < ids.size(); ++i) {
+    const std::string& id = ids[i];
+    size_t shared = 0;
+    if (i % kBlockSize == 0) {
+      block_offsets.push_back(data.size());
+      head_prefixes.push_back(PrefixKey(id.data(), id.size()));
+    } else {
+      const std::string& prev = ids[i - 1];
+      const size_t limit = std::min(prev.size(), id.size());
+      while (shared < limit && prev[shared] == id[shared]) {
+        ++shared;
+      }
+    }
+    AppendVarint(data, shared);
+    AppendVarint(data, id.size() - shared);
+    data.append(id, shared, std::string::npos);
+  }
+  block_offsets.push_back(data.size());
+
+  std::vector<TreeNode> tree(block_count + 1, TreeNode{0, 0});
+  size_t next = 0;
+  FillEytzinger(head_prefixes, tree, next, 1);
+
+  FileHeader header{};
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kFormatVersion;
+  header.id_count = ids.size();
+  header.block_count = block_count;
+  header.source_size = source.size;
+  header.source_mtime_ns = source.mtime_ns;
+  header.source_change_counter = source.change_counter;
+  header.tree_offset = sizeof(FileHeader);
+  header.block_offsets_offset =
+      header.tree_offset + tree.size() * sizeof(TreeNode);
+  header.data_offset = AlignTo8(header.block_offsets_offset +
+                                block_offsets.size() * sizeof(uint64_t));
+
+  const std::string temp_path = snapshot_path + ".tmp";
+  {
+    std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+      throw std::runtime_error("无法写入快照文件: " + temp_path);
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(tree.data()),
+              static_cast<std::streamsize>(tree.size() * sizeof(TreeNode)));
+    out.write(reinterpret_cast<const char*>(block_offsets.data()),
+              static_cast<std::streamsize>(block_offsets.size() *
+                                           sizeof(uint64_t)));
+    const uint64_t written = header.block_offsets_offset +
+                             block_offsets.size() * sizeof(uint64_t);
+    const char padding[8] = {};
+    out.write(padding, static_cast<std::streamsize>(header.data_offset - written));
+    out.write(data.data(), static_cast<std::streamsize>(data.size()));
+    if (!out) {
+      throw std::runtime_error("写入快照文件失败: " + temp_path);
+    }
+  }
+  // 替换是原子的：已映射旧快照的进程继续读旧文件，新打开的读到新文件
+  std::error_code ec;
+  std::filesystem::rename(temp_path, snapshot_path, ec);
+  if (ec) {
+    std::filesystem::remove(temp_path, ec);
+    throw std::runtime_error("替换快照文件失败: " + snapshot_path);
+  }
+}
+
+}  // namespace IdSnapshot
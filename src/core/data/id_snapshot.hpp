@@ -0,0 +1,77 @@
+// core/data/id_snapshot.hpp
+#ifndef ID_SNAPSHOT_HPP
+#define ID_SNAPSHOT_HPP
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+// .avidx 只读快照文件格式（所有整数按本机字节序）：
+//
+//   FileHeader (72 字节)
+//   搜索树: (block_count + 1) 个 TreeNode，按 Eytzinger (BFS) 顺序排列
+//           各块首个 ID，下标 0 不使用
+//   块偏移: (block_count + 1) 个 uint64，相对数据区起点
+//   数据区: 按字节序排好的 ID，每 kBlockSize 个一块，块内前缀压缩：
+//           varint(与上一个 ID 的公共前缀长度) varint(后缀长度) 后缀字节
+//           每块第一个 ID 的公共前缀长度为 0，即完整存储
+//
+// 查询先在搜索树中找到目标所在的块，再在块内顺序比较，全程直接读映射内存。
+namespace IdSnapshot {
+
+constexpr char kMagic[4] = {'A', 'V', 'I', 'X'};
+constexpr uint32_t kFormatVersion = 2;
+constexpr size_t kBlockSize = 32;
+
+struct FileHeader {
+  char magic[4];
+  uint32_t version;
+  uint64_t id_count;
+  uint64_t block_count;
+  uint64_t source_size;      // 生成快照时源 .sqlite3 文件的大小
+  int64_t source_mtime_ns;   // 生成快照时源 .sqlite3 文件的修改时间
+  uint32_t source_change_counter;  // 生成快照时源文件头中的修改计数
+  uint32_t reserved;
+  uint64_t tree_offset;
+  uint64_t block_offsets_offset;
+  uint64_t data_offset;
+};
+static_assert(sizeof(FileHeader) == 72);
+
+struct TreeNode {
+  uint64_t prefix;  // 块首 ID 的前 8 字节，按大端拼成整数，不足补 0
+  uint64_t block;   // 块序号
+};
+
+// 源数据库文件的大小、修改时间与 SQLite 文件头的修改计数，用来判断快照
+// 是否落后于数据库。修改计数每次提交都会递增，同一时间粒度内、不改变
+// 文件大小的提交也能看出来
+struct SourceStamp {
+  uint64_t size = 0;
+  int64_t mtime_ns = 0;
+  uint32_t change_counter = 0;
+  auto operator==(const SourceStamp&) const -> bool = default;
+};
+
+// 文件不存在时返回 std::nullopt；不是 SQLite 库时修改计数记为 0
+auto StampOf(const std::string& filepath) -> std::optional<SourceStamp>;
+
+// SQLite 文件头偏移 24 处的修改计数，库文件每次提交时递增；
+// 文件读不到或不是 SQLite 库时返回 std::nullopt
+auto ChangeCounterOf(const std::string& filepath) -> std::optional<uint32_t>;
+
+// 读取快照头中记录的源文件标记；快照不存在或格式不符时返回 std::nullopt
+auto ReadSourceStamp(const std::string& snapshot_path)
+    -> std::optional<SourceStamp>;
+
+// 排序、去重后写出快照（先写临时文件再替换），失败时抛出 std::runtime_error
+void Write(const std::string& snapshot_path, std::vector<std::string> ids,
+           const SourceStamp& source);
+
+// 按字节序比较用的 8 字节前缀
+[[nodiscard]] auto PrefixKey(const char* data, size_t length) -> uint64_t;
+
+}  // namespace IdSnapshot
+
+#endif
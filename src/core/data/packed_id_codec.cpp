@@ -0,0 +1,58 @@
+// core/data/packed_id_codec.cpp
+#include "core/data/packed_id_codec.hpp"
+
+#include "core/utils/validator.hpp"
+
+namespace {
+constexpr int kLabelShift = 39;
+constexpr int kLengthShift = 35;
+constexpr uint64_t kValueMask = (uint64_t{1} << kLengthShift) - 1;
+constexpr uint64_t kLengthMask = 0xF;
+}  // namespace
+
+namespace PackedIdCodec {
+
+auto Split(std::string_view canonical_id) -> std::optional<IdParts> {
+  size_t digit_start = canonical_id.size();
+  while (digit_start > 0 &&
+         Validator::IsDigitChar(canonical_id[digit_start - 1])) {
+    --digit_start;
+  }
+  const size_t digit_count = canonical_id.size() - digit_start;
+  if (digit_count == 0 || digit_count > kMaxDigits) {
+    return std::nullopt;
+  }
+  return IdParts{canonical_id.substr(0, digit_start),
+                 canonical_id.substr(digit_start)};
+}
+
+auto Encode(uint32_t label_id, std::string_view digits) -> uint64_t {
+  uint64_t value = 0;
+  for (const char c : digits) {
+    value = value * 10 + static_cast<uint64_t>(c - '0');
+  }
+  return (static_cast<uint64_t>(label_id) << kLabelShift) |
+         (static_cast<uint64_t>(digits.size()) << kLengthShift) | value;
+}
+
+auto LabelIdOf(uint64_t key) -> uint32_t {
+  return static_cast<uint32_t>(key >> kLabelShift);
+}
+
+auto WithLabelId(uint64_t key, uint32_t label_id) -> uint64_t {
+  const uint64_t digits_mask = (uint64_t{1} << kLabelShift) - 1;
+  return (static_cast<uint64_t>(label_id) << kLabelShift) | (key & digits_mask);
+}
+
+void AppendDigits(uint64_t key, std::string& out) {
+  const size_t length = (key >> kLengthShift) & kLengthMask;
+  uint64_t value = key & kValueMask;
+  const size_t start = out.size();
+  out.append(length, '0');
+  for (size_t i = 0; i < length && value != 0; ++i) {
+    out[start + length - 1 - i] = static_cast<char>('0' + value % 10);
+    value /= 10;
+  }
+}
+
+}  // namespace PackedIdCodec
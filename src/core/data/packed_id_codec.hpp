@@ -0,0 +1,46 @@
+// core/data/packed_id_codec.hpp
+#ifndef PACKED_ID_CODEC_HPP
+#define PACKED_ID_CODEC_HPP
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+// 规范化 ID 的 64 位整数键编码。
+// 规范化 ID 拆成 "前缀 + 末尾数字段"（如 ABC00123 -> ABC / 00123），
+// 前缀经标签字典映射为 label_id，数字段连同位数一起打包：
+//
+//   bit 63      : 0（保持 SQLite INTEGER 为正数）
+//   bit 62..39  : label_id（24 位）
+//   bit 38..35  : 数字段位数（1..10，保留前导零信息）
+//   bit 34..0   : 数字段数值（35 位，可容纳 10 位十进制数）
+//
+// 键的大小顺序为 (label_id, 位数, 数值)。
+// 数字段为空或超过 10 位的 ID 无法编码，由调用方按文本存储。
+namespace PackedIdCodec {
+
+constexpr uint32_t kMaxLabelId = (1U << 24) - 1;
+constexpr size_t kMaxDigits = 10;
+
+struct IdParts {
+  std::string_view label;
+  std::string_view digits;
+};
+
+// 拆分出末尾数字段；数字段为空或过长时返回 std::nullopt
+auto Split(std::string_view canonical_id) -> std::optional<IdParts>;
+
+auto Encode(uint32_t label_id, std::string_view digits) -> uint64_t;
+
+auto LabelIdOf(uint64_t key) -> uint32_t;
+
+// 保留数字段，只替换 label_id（在不同标签字典之间转换键时使用）
+auto WithLabelId(uint64_t key, uint32_t label_id) -> uint64_t;
+
+// 按原始位数（含前导零）把数字段追加到 out
+void AppendDigits(uint64_t key, std::string& out);
+
+}  // namespace PackedIdCodec
+
+#endif
@@ -0,0 +1,552 @@
+// core/data/packed_id_db.cpp
+#include "core/data/packed_id_db.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#include "core/data/id_chunk_buffer.hpp"
+#include "core/data/packed_id_codec.hpp"
+#include "core/data/sqlite_batch_binding.hpp"
+#include "core/data/sqlite_cache_size.hpp"
+
+namespace {
+auto TableExists(sqlite3* db, const char* table_name) -> bool {
+  sqlite3_stmt* stmt = nullptr;
+  const char* sql =
+      "SELECT 1 FROM sqlite_master WHERE type = 'table' AND name = ?;";
+  if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+    return false;
+  }
+  sqlite3_bind_text(stmt, 1, table_name, -1, SQLITE_STATIC);
+  const bool exists = sqlite3_step(stmt) == SQLITE_ROW;
+  sqlite3_finalize(stmt);
+  return exists;
+}
+
+void ExecOrThrow(sqlite3* db, const char* sql, const char* what) {
+  char* err_msg = nullptr;
+  if (sqlite3_exec(db, sql, nullptr, nullptr, &err_msg) != SQLITE_OK) {
+    std::string error = what;
+    error += ": ";
+    error += err_msg != nullptr ? err_msg : "";
+    sqlite3_free(err_msg);
+    throw std::runtime_error(error);
+  }
+}
+
+// 库中的 label_id 超出编码范围时不能用于编码，否则键会越过符号位
+auto IsUsableLabelId(sqlite3_int64 label_id) -> bool {
+  return label_id > 0 && label_id <= PackedIdCodec::kMaxLabelId;
+}
+
+auto ColumnText(sqlite3_stmt* stmt, int column) -> std::string_view {
+  const auto* text =
+      reinterpret_cast<const char*>(sqlite3_column_text(stmt, column));
+  if (text == nullptr) {
+    return {};
+  }
+  return {text, static_cast<size_t>(sqlite3_column_bytes(stmt, column))};
+}
+}  // namespace
+
+// --- PackedIdDB 实现 ---
+
+PackedIdDB::PackedIdDB(std::string filepath, size_t cache_bytes)
+    : db_filepath_(std::move(filepath)) {
+  if (sqlite3_open(db_filepath_.c_str(), &db_) != SQLITE_OK) {
+    std::string err_msg = "无法打开数据库: ";
+    err_msg += sqlite3_errmsg(db_);
+    sqlite3_close(db_);
+    throw std::runtime_error(err_msg);
+  }
+  SqliteCacheSize::Apply(db_, cache_bytes);
+  try {
+    InitializeDb();
+  } catch (...) {
+    sqlite3_close_v2(db_);
+    throw;
+  }
+}
+
+PackedIdDB::~PackedIdDB() {
+  for (sqlite3_stmt* stmt :
+       {add_key_stmt_, exists_key_stmt_, add_overflow_stmt_,
+        exists_overflow_stmt_, count_stmt_, find_label_stmt_,
+        insert_label_stmt_, exists_many_keys_stmt_, add_many_keys_stmt_,
+        exists_many_overflow_stmt_, add_many_overflow_stmt_}) {
+    if (stmt) {
+      sqlite3_finalize(stmt);
+    }
+  }
+  if (db_) {
+    sqlite3_close(db_);
+  }
+}
+
+auto PackedIdDB::IsPackedLayout(const std::string& filepath) -> bool {
+  sqlite3* db = nullptr;
+  if (sqlite3_open_v2(filepath.c_str(), &db, SQLITE_OPEN_READONLY, nullptr) !=
+      SQLITE_OK) {
+    sqlite3_close(db);
+    return false;
+  }
+  // 迁移中途中断的文件仍以文本表 ids 为准
+  const bool packed =
+      TableExists(db, "packed_ids") && !TableExists(db, "ids");
+  sqlite3_close(db);
+  return packed;
+}
+
+void PackedIdDB::CreateTables(sqlite3* db) {
+  // INTEGER PRIMARY KEY 即 rowid，键本身就是 B 树的键，无需第二棵索引树
+  ExecOrThrow(db,
+              "CREATE TABLE IF NOT EXISTS id_labels ("
+              " label_id INTEGER PRIMARY KEY,"
+              " label TEXT UNIQUE NOT NULL"
+              ");"
+              "CREATE TABLE IF NOT EXISTS packed_ids ("
+              " key INTEGER PRIMARY KEY"
+              ");"
+              "CREATE TABLE IF NOT EXISTS ids_overflow ("
+              " id TEXT PRIMARY KEY NOT NULL"
+              ") WITHOUT ROWID;"
+              "CREATE TABLE IF NOT EXISTS id_meta ("
+              " key TEXT PRIMARY KEY NOT NULL,"
+              " value INTEGER NOT NULL"
+              ") WITHOUT ROWID;",
+              "创建紧凑布局表失败");
+}
+
+void PackedIdDB::InstallCountTriggers(sqlite3* db) {
+  ExecOrThrow(
+      db,
+      "CREATE TRIGGER IF NOT EXISTS packed_ids_count_insert"
+      " AFTER INSERT ON packed_ids"
+      " BEGIN UPDATE id_meta SET value = value + 1 WHERE key = 'id_count'; END;"
+      "CREATE TRIGGER IF NOT EXISTS packed_ids_count_delete"
+      " AFTER DELETE ON packed_ids"
+      " BEGIN UPDATE id_meta SET value = value - 1 WHERE key = 'id_count'; END;"
+      "CREATE TRIGGER IF NOT EXISTS ids_overflow_count_insert"
+      " AFTER INSERT ON ids_overflow"
+      " BEGIN UPDATE id_meta SET value = value + 1 WHERE key = 'id_count'; END;"
+      "CREATE TRIGGER IF NOT EXISTS ids_overflow_count_delete"
+      " AFTER DELETE ON ids_overflow"
+      " BEGIN UPDATE id_meta SET value = value - 1 WHERE key = 'id_count'; END;",
+      "创建计数触发器失败");
+}
+
+void PackedIdDB::InitializeDb() {
+  if (!TableExists(db_, "packed_ids")) {
+    ExecOrThrow(db_, "BEGIN IMMEDIATE;", "初始化紧凑布局失败");
+    try {
+      CreateTables(db_);
+      ExecOrThrow(db_,
+                  "INSERT OR IGNORE INTO id_meta (key, value)"
+                  " VALUES ('id_count', 0);",
+                  "初始化计数元数据失败");
+      InstallCountTriggers(db_);
+      ExecOrThrow(db_, "COMMIT;", "初始化紧凑布局失败");
+    } catch (...) {
+      sqlite3_exec(db_, "ROLLBACK;", nullptr, nullptr, nullptr);
+      throw;
+    }
+  }
+
+  Prepare("INSERT OR IGNORE INTO packed_ids (key) VALUES (?);",
+          &add_key_stmt_);
+  Prepare("SELECT 1 FROM packed_ids WHERE key = ?;", &exists_key_stmt_);
+  Prepare("INSERT OR IGNORE INTO ids_overflow (id) VALUES (?);",
+          &add_overflow_stmt_);
+  Prepare("SELECT 1 FROM ids_overflow WHERE id = ?;", &exists_overflow_stmt_);
+  Prepare("SELECT value FROM id_meta WHERE key = 'id_count';", &count_stmt_);
+  Prepare("SELECT label_id FROM id_labels WHERE label = ?;",
+          &find_label_stmt_);
+  Prepare(
+      "INSERT INTO id_labels (label) SELECT ?1"
+      " WHERE (SELECT IFNULL(MAX(label_id), 0) FROM id_labels) < ?2;",
+      &insert_label_stmt_);
+  Prepare(
+      "SELECT batch.key FROM json_each(?) AS batch"
+      " JOIN packed_ids ON packed_ids.key = batch.value;",
+      &exists_many_keys_stmt_);
+  Prepare(
+      "INSERT OR IGNORE INTO packed_ids (key) SELECT value FROM json_each(?)"
+      " RETURNING key;",
+      &add_many_keys_stmt_);
+  Prepare(
+      "SELECT batch.key FROM json_each(?) AS batch"
+      " JOIN ids_overflow ON ids_overflow.id = batch.value;",
+      &exists_many_overflow_stmt_);
+  Prepare(
+      "INSERT OR IGNORE INTO ids_overflow (id) SELECT value FROM json_each(?)"
+      " RETURNING id;",
+      &add_many_overflow_stmt_);
+
+  LoadLabels();
+}
+
+void PackedIdDB::Prepare(const char* sql, sqlite3_stmt** stmt) const {
+  if (sqlite3_prepare_v2(db_, sql, -1, stmt, nullptr) != SQLITE_OK) {
+    std::string error = "准备语句失败: ";
+    error += sqlite3_errmsg(db_);
+    throw std::runtime_error(error);
+  }
+}
+
+void PackedIdDB::LoadLabels() const {
+  label_ids_.clear();
+  labels_by_id_.clear();
+  sqlite3_stmt* stmt = nullptr;
+  Prepare("SELECT label_id, label FROM id_labels;", &stmt);
+  while (sqlite3_step(stmt) == SQLITE_ROW) {
+    const sqlite3_int64 rowid = sqlite3_column_int64(stmt, 0);
+    if (!IsUsableLabelId(rowid)) {
+      continue;  // 旧版本在字典已满时留下的标签，不能用于编码
+    }
+    const auto label_id = static_cast<uint32_t>(rowid);
+    std::string label(ColumnText(stmt, 1));
+    labels_by_id_.emplace(label_id, label);
+    label_ids_.emplace(std::move(label), label_id);
+  }
+  sqlite3_finalize(stmt);
+}
+
+auto PackedIdDB::FindLabelId(std::string_view label) const
+    -> std::optional<uint32_t> {
+  if (auto it = label_ids_.find(label); it != label_ids_.end()) {
+    return it->second;
+  }
+  // 缓存未命中时回库确认：标签可能由其他连接新建
+  sqlite3_bind_text(find_label_stmt_, 1, label.data(),
+                    static_cast<int>(label.size()), SQLITE_STATIC);
+  std::optional<uint32_t> label_id;
+  if (sqlite3_step(find_label_stmt_) == SQLITE_ROW) {
+    const sqlite3_int64 rowid = sqlite3_column_int64(find_label_stmt_, 0);
+    if (IsUsableLabelId(rowid)) {
+      label_id = static_cast<uint32_t>(rowid);
+    }
+  }
+  sqlite3_reset(find_label_stmt_);
+  if (label_id) {
+    label_ids_.emplace(std::string(label), *label_id);
+    labels_by_id_.emplace(*label_id, std::string(label));
+  }
+  return label_id;
+}
+
+auto PackedIdDB::GetOrCreateLabelId(std::string_view label)
+    -> std::optional<uint32_t> {
+  if (auto label_id = FindLabelId(label)) {
+    return label_id;
+  }
+  // 只在字典未满时插入，超出编码范围的标签行从不写入库中
+  sqlite3_bind_text(insert_label_stmt_, 1, label.data(),
+                    static_cast<int>(label.size()), SQLITE_STATIC);
+  sqlite3_bind_int64(insert_label_stmt_, 2, PackedIdCodec::kMaxLabelId);
+  const int rc = sqlite3_step(insert_label_stmt_);
+  const bool inserted = rc == SQLITE_DONE && sqlite3_changes(db_) > 0;
+  const sqlite3_int64 rowid = sqlite3_last_insert_rowid(db_);
+  std::string error;
+  if (rc != SQLITE_DONE) {
+    error = "新建标签失败: ";
+    error += sqlite3_errmsg(db_);
+  }
+  sqlite3_reset(insert_label_stmt_);
+  if (rc != SQLITE_DONE) {
+    // 不能退回文本存储：标签稍后可能建成，同一 ID 会分处两张表
+    throw std::runtime_error(error);
+  }
+  if (!inserted || !IsUsableLabelId(rowid)) {
+    // 字典已满：该标签下的 ID 退回文本存储
+    return std::nullopt;
+  }
+  const auto label_id = static_cast<uint32_t>(rowid);
+  label_ids_.emplace(std::string(label), label_id);
+  labels_by_id_.emplace(label_id, std::string(label));
+  return label_id;
+}
+
+auto PackedIdDB::FindKey(std::string_view id) const
+    -> std::optional<uint64_t> {
+  const auto parts = PackedIdCodec::Split(id);
+  if (!parts) {
+    return std::nullopt;
+  }
+  const auto label_id = FindLabelId(parts->label);
+  if (!label_id) {
+    return std::nullopt;
+  }
+  return PackedIdCodec::Encode(*label_id, parts->digits);
+}
+
+auto PackedIdDB::DecodeKey(uint64_t key) const -> std::string {
+  std::string id;
+  AppendDecodedKey(key, id);
+  return id;
+}
+
+void PackedIdDB::AppendDecodedKey(uint64_t key, std::string& out) const {
+  const uint32_t label_id = PackedIdCodec::LabelIdOf(key);
+  auto it = labels_by_id_.find(label_id);
+  if (it == labels_by_id_.end()) {
+    LoadLabels();
+    it = labels_by_id_.find(label_id);
+  }
+  if (it != labels_by_id_.end()) {
+    out += it->second;
+  }
+  PackedIdCodec::AppendDigits(key, out);
+}
+
+auto PackedIdDB::Add(const std::string& id) -> bool {
+  const auto parts = PackedIdCodec::Split(id);
+  const auto label_id =
+      parts ? GetOrCreateLabelId(parts->label) : std::nullopt;
+
+  sqlite3_stmt* stmt = nullptr;
+  if (label_id) {
+    stmt = add_key_stmt_;
+    sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(PackedIdCodec::Encode(
+                                    *label_id, parts->digits)));
+  } else {
+    stmt = add_overflow_stmt_;
+    sqlite3_bind_text(stmt, 1, id.c_str(), -1, SQLITE_STATIC);
+  }
+
+  bool success = false;
+  if (sqlite3_step(stmt) == SQLITE_DONE) {
+    if (sqlite3_changes(db_) > 0) {
+      success = true;
+    }
+  }
+  sqlite3_reset(stmt);
+  return success;
+}
+
+auto PackedIdDB::Exists(const std::string& id) const -> bool {
+  sqlite3_stmt* stmt = nullptr;
+  // 没有可用标签的 ID 只可能在字典已满时存进了文本表
+  if (const auto key = FindKey(id)) {
+    stmt = exists_key_stmt_;
+    sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(*key));
+  } else {
+    stmt = exists_overflow_stmt_;
+    sqlite3_bind_text(stmt, 1, id.c_str(), -1, SQLITE_STATIC);
+  }
+
+  const bool found = sqlite3_step(stmt) == SQLITE_ROW;
+  sqlite3_reset(stmt);
+  return found;
+}
+
+auto PackedIdDB::GetCount() const -> size_t {
+  size_t count = 0;
+  if (sqlite3_step(count_stmt_) == SQLITE_ROW) {
+    count = static_cast<size_t>(sqlite3_column_int64(count_stmt_, 0));
+  }
+  sqlite3_reset(count_stmt_);
+  return count;
+}
+
+auto PackedIdDB::GetAllIds() const -> std::vector<std::string> {
+  std::vector<std::string> ids;
+  ids.reserve(GetCount());
+  ForEachId([&ids](std::span<const std::string_view> chunk) {
+    ids.insert(ids.end(), chunk.begin(), chunk.end());
+    return true;
+  });
+  return ids;
+}
+
+auto PackedIdDB::ForEachId(const IdChunkVisitor& visitor) const -> bool {
+  IdChunkBuffer chunk(visitor);
+  sqlite3_stmt* stmt = nullptr;
+  bool completed = true;
+  // 中途出错时抛出，不把残缺的遍历当作导出完成
+  auto finish = [this, &stmt, &completed](int rc) {
+    const std::string error =
+        completed && rc != SQLITE_DONE ? sqlite3_errmsg(db_) : "";
+    sqlite3_finalize(stmt);
+    if (!error.empty()) {
+      throw std::runtime_error("遍历失败: " + error);
+    }
+  };
+  int rc = SQLITE_ROW;
+  Prepare("SELECT key FROM packed_ids;", &stmt);
+  while (completed && (rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+    // 直接解码进块缓冲区，不为每行构造 std::string
+    AppendDecodedKey(static_cast<uint64_t>(sqlite3_column_int64(stmt, 0)),
+                     chunk.Bytes());
+    completed = chunk.EndId();
+  }
+  finish(rc);
+  if (!completed) {
+    return false;
+  }
+
+  Prepare("SELECT id FROM ids_overflow;", &stmt);
+  while (completed && (rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+    completed = chunk.Append(ColumnText(stmt, 0));
+  }
+  finish(rc);
+  return completed && chunk.Flush();
+}
+
+auto PackedIdDB::ForEachIdSorted(const IdChunkVisitor& visitor) const
+    -> bool {
+  // 整数键的顺序与文本字节序不同，在 SQL 中还原文本后交给 SQLite 排序；
+  // 排序器超出缓存时溢写临时文件，进程内存不随库大小增长
+  IdChunkBuffer chunk(visitor);
+  sqlite3_stmt* stmt = nullptr;
+  bool completed = true;
+  Prepare(
+      "SELECT l.label || substr('0000000000' || (p.key & 34359738367),"
+      "                         -((p.key >> 35) & 15)) AS id"
+      " FROM packed_ids AS p JOIN id_labels AS l ON l.label_id = p.key >> 39"
+      " UNION ALL SELECT id FROM ids_overflow"
+      " ORDER BY id;",
+      &stmt);
+  int rc = SQLITE_ROW;
+  while (completed && (rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+    completed = chunk.Append(ColumnText(stmt, 0));
+  }
+  // 中途出错（库被锁定、页损坏）不能当作遍历完成，否则归并结果残缺
+  const std::string error =
+      completed && rc != SQLITE_DONE ? sqlite3_errmsg(db_) : "";
+  sqlite3_finalize(stmt);
+  if (!error.empty()) {
+    throw std::runtime_error("有序遍历失败: " + error);
+  }
+  return completed && chunk.Flush();
+}
+
+auto PackedIdDB::ExistsMany(std::span<const std::string_view> ids) const
+    -> std::vector<bool> {
+  std::vector<bool> found(ids.size(), false);
+  if (ids.empty()) {
+    return found;
+  }
+
+  // 按编码方式分流，两路各执行一条集合语句；结果中的 key 为分流后的下标
+  std::vector<uint64_t>& keys = key_scratch_;
+  std::vector<size_t>& key_positions = key_position_scratch_;
+  std::vector<std::string_view>& overflow_ids = overflow_scratch_;
+  std::vector<size_t>& overflow_positions = overflow_position_scratch_;
+  keys.clear();
+  key_positions.clear();
+  overflow_ids.clear();
+  overflow_positions.clear();
+  for (size_t i = 0; i < ids.size(); ++i) {
+    if (const auto key = FindKey(ids[i])) {
+      keys.push_back(*key);
+      key_positions.push_back(i);
+    } else {
+      overflow_ids.emplace_back(ids[i]);
+      overflow_positions.push_back(i);
+    }
+  }
+
+  auto run = [&](sqlite3_stmt* stmt, const std::vector<size_t>& positions) {
+    sqlite3_bind_text(stmt, 1, batch_json_.data(),
+                      static_cast<int>(batch_json_.size()), SQLITE_STATIC);
+    int rc = SQLITE_OK;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+      const sqlite3_int64 index = sqlite3_column_int64(stmt, 0);
+      if (index >= 0 && static_cast<size_t>(index) < positions.size()) {
+        found[positions[static_cast<size_t>(index)]] = true;
+      }
+    }
+    SqliteBatchBinding::FinishOrThrow(db_, stmt, rc, "批量查询失败");
+  };
+  if (!keys.empty()) {
+    SqliteBatchBinding::BuildJsonIntegerArray(keys, batch_json_);
+    run(exists_many_keys_stmt_, key_positions);
+  }
+  if (!overflow_ids.empty()) {
+    SqliteBatchBinding::BuildJsonStringArray(overflow_ids, batch_json_);
+    run(exists_many_overflow_stmt_, overflow_positions);
+  }
+  return found;
+}
+
+auto PackedIdDB::AddMany(std::span<const std::string_view> ids)
+    -> std::vector<bool> {
+  std::vector<bool> added(ids.size(), false);
+  if (ids.empty()) {
+    return added;
+  }
+
+  // 批内去重后分流；整数键按键序插入，减少 B 树页分裂
+  key_dedup_.Clear();
+  overflow_dedup_.Clear();
+  for (size_t i = 0; i < ids.size(); ++i) {
+    const auto parts = PackedIdCodec::Split(ids[i]);
+    const auto label_id =
+        parts ? GetOrCreateLabelId(parts->label) : std::nullopt;
+    if (label_id) {
+      key_dedup_.Add(PackedIdCodec::Encode(*label_id, parts->digits), i);
+    } else {
+      overflow_dedup_.Add(ids[i], i);
+    }
+  }
+  key_dedup_.Finish();
+  overflow_dedup_.Finish();
+  const std::vector<uint64_t>& keys = key_dedup_.Keys();
+  const std::vector<std::string_view>& overflow_ids = overflow_dedup_.Keys();
+
+  if (!keys.empty()) {
+    SqliteBatchBinding::BuildJsonIntegerArray(keys, batch_json_);
+    sqlite3_bind_text(add_many_keys_stmt_, 1, batch_json_.data(),
+                      static_cast<int>(batch_json_.size()), SQLITE_STATIC);
+    int rc = SQLITE_OK;
+    while ((rc = sqlite3_step(add_many_keys_stmt_)) == SQLITE_ROW) {
+      const auto key =
+          static_cast<uint64_t>(sqlite3_column_int64(add_many_keys_stmt_, 0));
+      if (const auto index = key_dedup_.FirstIndexOf(key)) {
+        added[*index] = true;
+      }
+    }
+    SqliteBatchBinding::FinishOrThrow(db_, add_many_keys_stmt_, rc,
+                                      "批量插入失败");
+  }
+  if (!overflow_ids.empty()) {
+    SqliteBatchBinding::BuildJsonStringArray(overflow_ids, batch_json_);
+    sqlite3_bind_text(add_many_overflow_stmt_, 1, batch_json_.data(),
+                      static_cast<int>(batch_json_.size()), SQLITE_STATIC);
+    int rc = SQLITE_OK;
+    while ((rc = sqlite3_step(add_many_overflow_stmt_)) == SQLITE_ROW) {
+      if (const auto index = overflow_dedup_.FirstIndexOf(
+              ColumnText(add_many_overflow_stmt_, 0))) {
+        added[*index] = true;
+      }
+    }
+    SqliteBatchBinding::FinishOrThrow(db_, add_many_overflow_stmt_, rc,
+                                      "批量插入失败");
+  }
+  return added;
+}
+
+auto PackedIdDB::GetStats() const -> RepositoryStats {
+  RepositoryStats stats;
+  stats.engine = "SQLite (紧凑布局)";
+  return stats;
+}
+
+auto PackedIdDB::RebuildFilter(double /*false_positive_rate*/) -> bool {
+  return false;  // 紧凑布局的点查已足够廉价，不配备负查询过滤器
+}
+
+void PackedIdDB::BeginTransaction() {
+  sqlite3_exec(db_, "BEGIN TRANSACTION;", nullptr, nullptr, nullptr);
+}
+
+void PackedIdDB::CommitTransaction() {
+  sqlite3_exec(db_, "COMMIT;", nullptr, nullptr, nullptr);
+}
+
+void PackedIdDB::RollbackTransaction() {
+  sqlite3_exec(db_, "ROLLBACK;", nullptr, nullptr, nullptr);
+  // 回滚可能撤销了本事务内新建的标签，缓存必须与库重新对齐
+  LoadLabels();
+}
@@ -0,0 +1,100 @@
+// core/data/packed_id_db.hpp
+#ifndef PACKED_ID_DB_HPP
+#define PACKED_ID_DB_HPP
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "core/data/batch_dedup.hpp"
+#include "core/ports/i_id_repository.hpp"
+#include "sqlite3.h"
+
+// 紧凑存储布局：规范化 ID 编码为 64 位整数键（见 PackedIdCodec），
+// 存在以键为 rowid 的单 B 树表 packed_ids 中；前缀经 id_labels 字典映射。
+// 无法编码的 ID（无末尾数字或数字过长）以及标签字典已满后出现的新标签下的
+// ID 按文本存入 ids_overflow；查询时没有可用标签的 ID 一律查 ids_overflow。
+class PackedIdDB : public IIdRepository {
+ public:
+  // cache_bytes 为该连接的页缓存上限，0 使用 SQLite 默认值
+  explicit PackedIdDB(std::string filepath, size_t cache_bytes = 0);
+  ~PackedIdDB() override;
+
+  PackedIdDB(const PackedIdDB&) = delete;
+  auto operator=(const PackedIdDB&) -> PackedIdDB& = delete;
+
+  // 文件是否为紧凑布局（存在 packed_ids 且已无文本表 ids）
+  static auto IsPackedLayout(const std::string& filepath) -> bool;
+
+  // 布局 DDL，供迁移器在同一文件中建表
+  static void CreateTables(sqlite3* db);
+  static void InstallCountTriggers(sqlite3* db);
+
+  auto Add(const std::string& id) -> bool override;
+  [[nodiscard]] auto Exists(const std::string& id) const -> bool override;
+  [[nodiscard]] auto GetCount() const -> size_t override;
+  [[nodiscard]] auto GetAllIds() const -> std::vector<std::string> override;
+  auto ForEachId(const IdChunkVisitor& visitor) const -> bool override;
+  auto ForEachIdSorted(const IdChunkVisitor& visitor) const -> bool override;
+  [[nodiscard]] auto ExistsMany(std::span<const std::string_view> ids) const
+      -> std::vector<bool> override;
+  auto AddMany(std::span<const std::string_view> ids) -> std::vector<bool> override;
+  [[nodiscard]] auto GetStats() const -> RepositoryStats override;
+  auto RebuildFilter(double false_positive_rate) -> bool override;
+  [[nodiscard]] auto IsReadOnly() const -> bool override { return false; }
+
+  void BeginTransaction() override;
+  void CommitTransaction() override;
+  void RollbackTransaction() override;
+
+ private:
+  void InitializeDb();
+  void Prepare(const char* sql, sqlite3_stmt** stmt) const;
+  void LoadLabels() const;
+  [[nodiscard]] auto FindLabelId(std::string_view label) const
+      -> std::optional<uint32_t>;
+  auto GetOrCreateLabelId(std::string_view label) -> std::optional<uint32_t>;
+  [[nodiscard]] auto FindKey(std::string_view id) const
+      -> std::optional<uint64_t>;
+  [[nodiscard]] auto DecodeKey(uint64_t key) const -> std::string;
+  void AppendDecodedKey(uint64_t key, std::string& out) const;
+
+  std::string db_filepath_;
+  sqlite3* db_ = nullptr;
+  sqlite3_stmt* add_key_stmt_ = nullptr;
+  sqlite3_stmt* exists_key_stmt_ = nullptr;
+  sqlite3_stmt* add_overflow_stmt_ = nullptr;
+  sqlite3_stmt* exists_overflow_stmt_ = nullptr;
+  sqlite3_stmt* count_stmt_ = nullptr;
+  sqlite3_stmt* find_label_stmt_ = nullptr;
+  sqlite3_stmt* insert_label_stmt_ = nullptr;
+  sqlite3_stmt* exists_many_keys_stmt_ = nullptr;
+  sqlite3_stmt* add_many_keys_stmt_ = nullptr;
+  sqlite3_stmt* exists_many_overflow_stmt_ = nullptr;
+  sqlite3_stmt* add_many_overflow_stmt_ = nullptr;
+
+  struct LabelHash {
+    using is_transparent = void;
+    auto operator()(std::string_view text) const -> size_t {
+      return std::hash<std::string_view>{}(text);
+    }
+  };
+
+  // 标签字典缓存：只缓存已在库中确认存在的标签，回滚时整体重载
+  mutable std::unordered_map<std::string, uint32_t, LabelHash,
+                             std::equal_to<>>
+      label_ids_;
+  mutable std::unordered_map<uint32_t, std::string> labels_by_id_;
+  mutable std::string batch_json_;
+  // 批量操作的复用缓冲区，稳态下不随 ID 分配内存
+  mutable std::vector<uint64_t> key_scratch_;
+  mutable std::vector<size_t> key_position_scratch_;
+  mutable std::vector<std::string_view> overflow_scratch_;
+  mutable std::vector<size_t> overflow_position_scratch_;
+  BatchDedup<uint64_t> key_dedup_;
+  BatchDedup<std::string_view> overflow_dedup_;
+};
+#endif
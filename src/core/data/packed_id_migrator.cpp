@@ -0,0 +1,304 @@
+// core/data/packed_id_migrator.cpp
+#include "core/data/packed_id_migrator.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include "core/data/packed_id_codec.hpp"
+#include "core/data/packed_id_db.hpp"
+
+namespace {
+constexpr int kCopyBatchSize = 65536;
+
+void ExecOrThrow(sqlite3* db, const char* sql) {
+  char* err_msg = nullptr;
+  if (sqlite3_exec(db, sql, nullptr, nullptr, &err_msg) != SQLITE_OK) {
+    std::string error = "迁移失败: ";
+    error += err_msg != nullptr ? err_msg : "";
+    sqlite3_free(err_msg);
+    throw std::runtime_error(error);
+  }
+}
+
+auto QueryInt64(sqlite3* db, const char* sql) -> sqlite3_int64 {
+  sqlite3_stmt* stmt = nullptr;
+  sqlite3_int64 value = 0;
+  if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) == SQLITE_OK &&
+      sqlite3_step(stmt) == SQLITE_ROW) {
+    value = sqlite3_column_int64(stmt, 0);
+  }
+  sqlite3_finalize(stmt);
+  return value;
+}
+
+// 持写锁时确认紧凑表与文本表内容一致。只比行数看不出 rowid 复用：
+// 已复制的最大 rowid 行被删除、新 ID 又用了这个 rowid 时行数不变，
+// 增量复制却会跳过新 ID。因此先比行数，再把解码后的紧凑表与文本表
+// 做双向 EXCEPT
+auto MatchesSource(sqlite3* db) -> bool {
+  const sqlite3_int64 source_count =
+      QueryInt64(db, "SELECT COUNT(*) FROM ids;");
+  const sqlite3_int64 target_count =
+      QueryInt64(db,
+                 "SELECT (SELECT COUNT(*) FROM packed_ids)"
+                 " + (SELECT COUNT(*) FROM ids_overflow);");
+  if (source_count != target_count) {
+    return false;
+  }
+  // 查询失败时 QueryInt64 返回 0，按不一致处理
+  return QueryInt64(
+             db,
+             "WITH migrated(id) AS ("
+             " SELECT l.label || substr('0000000000' || (p.key & 34359738367),"
+             "                          -((p.key >> 35) & 15))"
+             " FROM packed_ids AS p"
+             " JOIN id_labels AS l ON l.label_id = p.key >> 39"
+             " UNION ALL SELECT id FROM ids_overflow)"
+             " SELECT NOT ("
+             " EXISTS (SELECT id FROM ids EXCEPT SELECT id FROM migrated) OR"
+             " EXISTS (SELECT id FROM migrated EXCEPT SELECT id FROM ids));") ==
+         1;
+}
+
+class Copier {
+ public:
+  explicit Copier(sqlite3* db) : db_(db) {
+    Prepare("SELECT rowid, id FROM ids WHERE rowid > ? ORDER BY rowid"
+            " LIMIT ?;",
+            &select_stmt_);
+    Prepare("SELECT label_id FROM id_labels WHERE label = ?;",
+            &find_label_stmt_);
+    Prepare(
+        "INSERT INTO id_labels (label) SELECT ?1"
+        " WHERE (SELECT IFNULL(MAX(label_id), 0) FROM id_labels) < ?2;",
+        &insert_label_stmt_);
+    Prepare("INSERT OR IGNORE INTO packed_ids (key) VALUES (?);",
+            &insert_key_stmt_);
+    Prepare("INSERT OR IGNORE INTO ids_overflow (id) VALUES (?);",
+            &insert_overflow_stmt_);
+  }
+
+  ~Copier() {
+    for (sqlite3_stmt* stmt : {select_stmt_, find_label_stmt_,
+                               insert_label_stmt_, insert_key_stmt_,
+                               insert_overflow_stmt_}) {
+      sqlite3_finalize(stmt);
+    }
+  }
+
+  Copier(const Copier&) = delete;
+  auto operator=(const Copier&) -> Copier& = delete;
+
+  // 复制 rowid 大于 last_rowid 的下一批，返回本批行数
+  auto CopyNextBatch(sqlite3_int64& last_rowid) -> size_t {
+    keys_.clear();
+    size_t rows = 0;
+    sqlite3_bind_int64(select_stmt_, 1, last_rowid);
+    sqlite3_bind_int(select_stmt_, 2, kCopyBatchSize);
+    while (sqlite3_step(select_stmt_) == SQLITE_ROW) {
+      ++rows;
+      last_rowid = sqlite3_column_int64(select_stmt_, 0);
+      const auto* text = reinterpret_cast<const char*>(
+          sqlite3_column_text(select_stmt_, 1));
+      if (text == nullptr) {
+        continue;
+      }
+      const std::string_view id(
+          text, static_cast<size_t>(sqlite3_column_bytes(select_stmt_, 1)));
+      const auto parts = PackedIdCodec::Split(id);
+      const auto label_id = parts ? LabelIdFor(parts->label) : 0;
+      if (label_id != 0) {
+        keys_.push_back(PackedIdCodec::Encode(label_id, parts->digits));
+      } else {
+        Step(insert_overflow_stmt_, id);
+      }
+    }
+    sqlite3_reset(select_stmt_);
+
+    // 批内按键序插入
+    std::sort(keys_.begin(), keys_.end());
+    for (const uint64_t key : keys_) {
+      sqlite3_bind_int64(insert_key_stmt_, 1,
+                         static_cast<sqlite3_int64>(key));
+      StepOrThrow(insert_key_stmt_);
+    }
+    return rows;
+  }
+
+ private:
+  void Prepare(const char* sql, sqlite3_stmt** stmt) {
+    if (sqlite3_prepare_v2(db_, sql, -1, stmt, nullptr) != SQLITE_OK) {
+      std::string error = "迁移准备语句失败: ";
+      error += sqlite3_errmsg(db_);
+      throw std::runtime_error(error);
+    }
+  }
+
+  void StepOrThrow(sqlite3_stmt* stmt) {
+    const int rc = sqlite3_step(stmt);
+    sqlite3_reset(stmt);
+    if (rc != SQLITE_DONE) {
+      std::string error = "迁移写入失败: ";
+      error += sqlite3_errmsg(db_);
+      throw std::runtime_error(error);
+    }
+  }
+
+  void Step(sqlite3_stmt* stmt, std::string_view text) {
+    sqlite3_bind_text(stmt, 1, text.data(), static_cast<int>(text.size()),
+                      SQLITE_TRANSIENT);
+    StepOrThrow(stmt);
+  }
+
+  // 返回 0 表示字典已满，调用方改走文本存储
+  auto LabelIdFor(std::string_view label) -> uint32_t {
+    std::string key(label);
+    if (auto it = label_ids_.find(key); it != label_ids_.end()) {
+      return it->second;
+    }
+    sqlite3_int64 rowid = 0;
+    bool found = false;
+    sqlite3_bind_text(find_label_stmt_, 1, key.data(),
+                      static_cast<int>(key.size()), SQLITE_STATIC);
+    if (sqlite3_step(find_label_stmt_) == SQLITE_ROW) {
+      rowid = sqlite3_column_int64(find_label_stmt_, 0);
+      found = true;
+    }
+    sqlite3_reset(find_label_stmt_);
+    if (!found) {
+      // 只在字典未满时插入，超出编码范围的标签行从不写入库中
+      sqlite3_bind_text(insert_label_stmt_, 1, key.data(),
+                        static_cast<int>(key.size()), SQLITE_TRANSIENT);
+      sqlite3_bind_int64(insert_label_stmt_, 2, PackedIdCodec::kMaxLabelId);
+      StepOrThrow(insert_label_stmt_);
+      rowid = sqlite3_changes(db_) > 0 ? sqlite3_last_insert_rowid(db_) : 0;
+    }
+    // 无法编码的标签同样缓存为 0，之后不再回库
+    const uint32_t label_id =
+        rowid > 0 && rowid <= PackedIdCodec::kMaxLabelId
+            ? static_cast<uint32_t>(rowid)
+            : 0;
+    label_ids_.emplace(std::move(key), label_id);
+    return label_id;
+  }
+
+  sqlite3* db_;
+  sqlite3_stmt* select_stmt_ = nullptr;
+  sqlite3_stmt* find_label_stmt_ = nullptr;
+  sqlite3_stmt* insert_label_stmt_ = nullptr;
+  sqlite3_stmt* insert_key_stmt_ = nullptr;
+  sqlite3_stmt* insert_overflow_stmt_ = nullptr;
+  std::unordered_map<std::string, uint32_t> label_ids_;
+  std::vector<uint64_t> keys_;
+};
+
+void RunMigration(sqlite3* db, LayoutMigrationReport& report) {
+  // 清理上次中断留下的半成品，再建紧凑布局表（此时还不装计数触发器）
+  ExecOrThrow(db,
+              "BEGIN IMMEDIATE;"
+              "DROP TABLE IF EXISTS packed_ids;"
+              "DROP TABLE IF EXISTS ids_overflow;"
+              "DROP TABLE IF EXISTS id_labels;");
+  try {
+    PackedIdDB::CreateTables(db);
+    ExecOrThrow(db, "COMMIT;");
+  } catch (...) {
+    sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+    throw;
+  }
+
+  Copier copier(db);
+  sqlite3_int64 last_rowid = 0;
+
+  // 阶段一：逐批短事务复制，批间释放写锁
+  for (;;) {
+    ExecOrThrow(db, "BEGIN IMMEDIATE;");
+    size_t rows = 0;
+    try {
+      rows = copier.CopyNextBatch(last_rowid);
+      ExecOrThrow(db, "COMMIT;");
+    } catch (...) {
+      sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+      throw;
+    }
+    if (rows == 0) {
+      break;
+    }
+  }
+
+  // 阶段二：持写锁补齐增量并切换布局
+  ExecOrThrow(db, "BEGIN IMMEDIATE;");
+  try {
+    while (copier.CopyNextBatch(last_rowid) > 0) {
+    }
+    if (!MatchesSource(db)) {
+      // 迁移期间有删除或 rowid 复用，增量不可靠：在锁内整表重抄
+      ExecOrThrow(db,
+                  "DELETE FROM packed_ids;"
+                  "DELETE FROM ids_overflow;");
+      last_rowid = 0;
+      while (copier.CopyNextBatch(last_rowid) > 0) {
+      }
+    }
+
+    ExecOrThrow(db,
+                "DROP TRIGGER IF EXISTS ids_count_insert;"
+                "DROP TRIGGER IF EXISTS ids_count_delete;"
+                "DROP TABLE ids;"
+                "INSERT OR REPLACE INTO id_meta (key, value)"
+                " SELECT 'id_count', (SELECT COUNT(*) FROM packed_ids)"
+                " + (SELECT COUNT(*) FROM ids_overflow);");
+    PackedIdDB::InstallCountTriggers(db);
+    report.migrated_count = static_cast<size_t>(
+        QueryInt64(db, "SELECT value FROM id_meta WHERE key = 'id_count';"));
+    ExecOrThrow(db, "COMMIT;");
+  } catch (...) {
+    sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+    throw;
+  }
+
+  ExecOrThrow(db, "VACUUM;");
+}
+}  // namespace
+
+namespace PackedIdMigrator {
+
+auto MigrateInPlace(const std::string& filepath) -> LayoutMigrationReport {
+  if (!std::filesystem::exists(filepath)) {
+    throw std::runtime_error("迁移失败: 数据库文件不存在");
+  }
+  if (PackedIdDB::IsPackedLayout(filepath)) {
+    throw std::runtime_error("迁移失败: 数据库已是紧凑布局");
+  }
+
+  LayoutMigrationReport report;
+  report.bytes_before = std::filesystem::file_size(filepath);
+
+  sqlite3* db = nullptr;
+  if (sqlite3_open(filepath.c_str(), &db) != SQLITE_OK) {
+    std::string error = "无法打开数据库: ";
+    error += sqlite3_errmsg(db);
+    sqlite3_close(db);
+    throw std::runtime_error(error);
+  }
+  sqlite3_busy_timeout(db, 5000);
+  try {
+    RunMigration(db, report);
+  } catch (...) {
+    sqlite3_close(db);
+    throw;
+  }
+  sqlite3_close(db);
+
+  // 文本布局的负查询过滤器已无对应的表，留下只会占用磁盘
+  std::error_code ec;
+  std::filesystem::remove(filepath + ".bloom", ec);
+
+  report.bytes_after = std::filesystem::file_size(filepath);
+  return report;
+}
+
+}  // namespace PackedIdMigrator
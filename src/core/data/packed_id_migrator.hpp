@@ -0,0 +1,19 @@
+// core/data/packed_id_migrator.hpp
+#ifndef PACKED_ID_MIGRATOR_HPP
+#define PACKED_ID_MIGRATOR_HPP
+
+#include <string>
+
+#include "core/ports/i_database_catalog.hpp"
+
+// 文本布局 -> 紧凑布局的原地迁移。
+// 按 rowid 分批复制，每批一个短写事务，期间其他连接仍可读写原表；
+// 最后一个写事务补齐增量、校验行数并删除文本表，随后 VACUUM 回收空间。
+namespace PackedIdMigrator {
+
+// 失败时抛出 std::runtime_error，原表保持不变
+auto MigrateInPlace(const std::string& filepath) -> LayoutMigrationReport;
+
+}  // namespace PackedIdMigrator
+
+#endif
@@ -0,0 +1,237 @@
+// core/data/snapshot_repository.cpp
+#include "core/data/snapshot_repository.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+#include "core/data/id_chunk_buffer.hpp"
+
+namespace {
+// 读取一个 varint；越界时返回 false
+auto ReadVarint(const char*& pos, const char* end, uint64_t& value) -> bool {
+  value = 0;
+  for (int shift = 0; pos < end && shift < 64; shift += 7) {
+    const auto byte = static_cast<unsigned char>(*pos++);
+    value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+    if ((byte & 0x80) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+auto ToView(const char* data, uint64_t length) -> std::string_view {
+  return {data, static_cast<size_t>(length)};
+}
+}  // namespace
+
+SnapshotRepository::SnapshotRepository(const std::string& snapshot_path)
+    : file_(snapshot_path) {
+  const auto start = std::chrono::steady_clock::now();
+  using IdSnapshot::FileHeader;
+  using IdSnapshot::TreeNode;
+  const char* base = file_.Data();
+  const uint64_t size = file_.Size();
+  if (size < sizeof(FileHeader)) {
+    throw std::runtime_error("快照文件已损坏: " + snapshot_path);
+  }
+  header_ = reinterpret_cast<const FileHeader*>(base);
+  const uint64_t blocks = header_->block_count;
+  if (std::memcmp(header_->magic, IdSnapshot::kMagic,
+                  sizeof(IdSnapshot::kMagic)) != 0 ||
+      header_->version != IdSnapshot::kFormatVersion ||
+      header_->tree_offset + (blocks + 1) * sizeof(TreeNode) > size ||
+      header_->block_offsets_offset + (blocks + 1) * sizeof(uint64_t) > size ||
+      header_->data_offset > size || header_->tree_offset % 8 != 0 ||
+      header_->block_offsets_offset % 8 != 0) {
+    throw std::runtime_error("快照文件格式不符: " + snapshot_path);
+  }
+  tree_ = reinterpret_cast<const TreeNode*>(base + header_->tree_offset);
+  block_offsets_ =
+      reinterpret_cast<const uint64_t*>(base + header_->block_offsets_offset);
+  data_ = base + header_->data_offset;
+  for (uint64_t b = 0; b < blocks; ++b) {
+    if (block_offsets_[b] > block_offsets_[b + 1]) {
+      throw std::runtime_error("快照文件已损坏: " + snapshot_path);
+    }
+  }
+  if (block_offsets_[blocks] > size - header_->data_offset) {
+    throw std::runtime_error("快照文件已损坏: " + snapshot_path);
+  }
+  load_ms_ = std::chrono::duration<double, std::milli>(
+                 std::chrono::steady_clock::now() - start)
+                 .count();
+}
+
+auto SnapshotRepository::SourceStamp() const -> IdSnapshot::SourceStamp {
+  return {header_->source_size, header_->source_mtime_ns,
+          header_->source_change_counter};
+}
+
+auto SnapshotRepository::CompareHead(uint64_t block, std::string_view id) const
+    -> int {
+  const char* pos = data_ + block_offsets_[block];
+  const char* end = data_ + block_offsets_[block + 1];
+  uint64_t shared = 0;
+  uint64_t length = 0;
+  if (!ReadVarint(pos, end, shared) || !ReadVarint(pos, end, length) ||
+      length > static_cast<uint64_t>(end - pos)) {
+    return 1;
+  }
+  return ToView(pos, length).compare(id);
+}
+
+auto SnapshotRepository::ContainsInBlock(uint64_t block,
+                                         std::string_view id) const -> bool {
+  // 不解压：matched 是上一个 ID 与 id 的公共前缀长度。
+  // 当前 ID 与上一个的公共前缀 shared 大于 matched 时它仍小于 id，
+  // 小于 matched 时它已大于 id；只有相等时才需要比较后缀。
+  const char* pos = data_ + block_offsets_[block];
+  const char* end = data_ + block_offsets_[block + 1];
+  uint64_t matched = 0;
+  while (pos < end) {
+    uint64_t shared = 0;
+    uint64_t length = 0;
+    if (!ReadVarint(pos, end, shared) || !ReadVarint(pos, end, length) ||
+        length > static_cast<uint64_t>(end - pos)) {
+      return false;
+    }
+    const char* suffix = pos;
+    pos += length;
+    if (shared > matched) {
+      continue;
+    }
+    if (shared < matched) {
+      return false;
+    }
+    size_t j = 0;
+    while (j < length && matched + j < id.size() &&
+           suffix[j] == id[matched + j]) {
+      ++j;
+    }
+    if (j == length && matched + j == id.size()) {
+      return true;
+    }
+    const bool entry_less =
+        j == length || (matched + j < id.size() &&
+                        static_cast<unsigned char>(suffix[j]) <
+                            static_cast<unsigned char>(id[matched + j]));
+    if (!entry_less) {
+      return false;
+    }
+    matched += j;
+  }
+  return false;
+}
+
+auto SnapshotRepository::Contains(std::string_view id) const -> bool {
+  const uint64_t n = header_->block_count;
+  if (n == 0) {
+    return false;
+  }
+  // Eytzinger 下降：k 最终编码了"第一个块首大于 id"的结点
+  const uint64_t key = IdSnapshot::PrefixKey(id.data(), id.size());
+  uint64_t k = 1;
+  while (k <= n) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(tree_ + std::min(16 * k, n));
+#endif
+    const IdSnapshot::TreeNode& node = tree_[k];
+    const bool head_le =
+        node.prefix < key ||
+        (node.prefix == key && CompareHead(node.block, id) <= 0);
+    k = 2 * k + (head_le ? 1 : 0);
+  }
+  k >>= std::countr_one(k) + 1;
+  // 块首不大于 id 的块数；id 只可能落在其中最后一块
+  const uint64_t upper = (k == 0) ? n : tree_[k].block;
+  if (upper == 0) {
+    return false;
+  }
+  return ContainsInBlock(upper - 1, id);
+}
+
+auto SnapshotRepository::Add(const std::string& /*id*/) -> bool {
+  throw std::logic_error("只读快照不支持写入");
+}
+
+auto SnapshotRepository::AddMany(std::span<const std::string_view> /*ids*/)
+    -> std::vector<bool> {
+  throw std::logic_error("只读快照不支持写入");
+}
+
+auto SnapshotRepository::Exists(const std::string& id) const -> bool {
+  return Contains(id);
+}
+
+auto SnapshotRepository::ForEachIdSorted(const IdChunkVisitor& visitor) const
+    -> bool {
+  // 快照本身按字节序存放
+  return ForEachId(visitor);
+}
+
+auto SnapshotRepository::ExistsMany(std::span<const std::string_view> ids) const
+    -> std::vector<bool> {
+  std::vector<bool> found(ids.size(), false);
+  for (size_t i = 0; i < ids.size(); ++i) {
+    found[i] = Contains(ids[i]);
+  }
+  return found;
+}
+
+auto SnapshotRepository::GetCount() const -> size_t {
+  return static_cast<size_t>(header_->id_count);
+}
+
+auto SnapshotRepository::GetAllIds() const -> std::vector<std::string> {
+  std::vector<std::string> ids;
+  ids.reserve(GetCount());
+  ForEachId([&ids](std::span<const std::string_view> chunk) {
+    ids.insert(ids.end(), chunk.begin(), chunk.end());
+    return true;
+  });
+  return ids;
+}
+
+auto SnapshotRepository::ForEachId(const IdChunkVisitor& visitor) const
+    -> bool {
+  // 块内前缀压缩，需要逐个还原；还原结果直接写入块缓冲区
+  IdChunkBuffer chunk(visitor);
+  std::string current;
+  for (uint64_t b = 0; b < header_->block_count; ++b) {
+    const char* pos = data_ + block_offsets_[b];
+    const char* end = data_ + block_offsets_[b + 1];
+    while (pos < end) {
+      uint64_t shared = 0;
+      uint64_t length = 0;
+      if (!ReadVarint(pos, end, shared) || !ReadVarint(pos, end, length) ||
+          length > static_cast<uint64_t>(end - pos) ||
+          shared > current.size()) {
+        return chunk.Flush();
+      }
+      current.resize(shared);
+      current.append(pos, length);
+      pos += length;
+      if (!chunk.Append(current)) {
+        return false;
+      }
+    }
+  }
+  return chunk.Flush();
+}
+
+auto SnapshotRepository::GetStats() const -> RepositoryStats {
+  RepositoryStats stats;
+  stats.engine = "只读快照 (.avidx)";
+  stats.load_ms = load_ms_;
+  stats.memory_bytes = file_.Size();
+  return stats;
+}
+
+auto SnapshotRepository::RebuildFilter(double /*false_positive_rate*/)
+    -> bool {
+  return false;
+}
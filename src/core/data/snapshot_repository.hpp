@@ -0,0 +1,55 @@
+// core/data/snapshot_repository.hpp
+#ifndef SNAPSHOT_REPOSITORY_HPP
+#define SNAPSHOT_REPOSITORY_HPP
+
+#include <string>
+#include <string_view>
+
+#include "core/data/id_snapshot.hpp"
+#include "core/io/memory_mapped_file.hpp"
+#include "core/ports/i_id_repository.hpp"
+
+// 只读快照引擎：mmap 打开 .avidx 文件，查询直接读映射内存，不打开 SQLite。
+// 打开几乎不需要时间，多个进程共享同一份页缓存；
+// 写操作一律拒绝（IsReadOnly 为 true，直接调用会抛出 std::logic_error）。
+class SnapshotRepository : public IIdRepository {
+ public:
+  // 文件缺失或格式不符时抛出 std::runtime_error
+  explicit SnapshotRepository(const std::string& snapshot_path);
+
+  [[nodiscard]] auto SourceStamp() const -> IdSnapshot::SourceStamp;
+
+  auto Add(const std::string& id) -> bool override;
+  [[nodiscard]] auto Exists(const std::string& id) const -> bool override;
+  [[nodiscard]] auto GetCount() const -> size_t override;
+  [[nodiscard]] auto GetAllIds() const -> std::vector<std::string> override;
+  auto ForEachId(const IdChunkVisitor& visitor) const -> bool override;
+  auto ForEachIdSorted(const IdChunkVisitor& visitor) const -> bool override;
+  [[nodiscard]] auto ExistsMany(std::span<const std::string_view> ids) const
+      -> std::vector<bool> override;
+  auto AddMany(std::span<const std::string_view> ids) -> std::vector<bool> override;
+  [[nodiscard]] auto GetStats() const -> RepositoryStats override;
+  auto RebuildFilter(double false_positive_rate) -> bool override;
+  [[nodiscard]] auto IsReadOnly() const -> bool override { return true; }
+
+  void BeginTransaction() override {}
+  void CommitTransaction() override {}
+  void RollbackTransaction() override {}
+
+ private:
+  [[nodiscard]] auto Contains(std::string_view id) const -> bool;
+  // 块首 ID 与 id 比较，返回值含义同 std::string_view::compare
+  [[nodiscard]] auto CompareHead(uint64_t block, std::string_view id) const
+      -> int;
+  [[nodiscard]] auto ContainsInBlock(uint64_t block, std::string_view id) const
+      -> bool;
+
+  IO::MemoryMappedFile file_;
+  const IdSnapshot::FileHeader* header_ = nullptr;
+  const IdSnapshot::TreeNode* tree_ = nullptr;
+  const uint64_t* block_offsets_ = nullptr;
+  const char* data_ = nullptr;
+  double load_ms_ = 0.0;
+};
+
+#endif
@@ -0,0 +1,87 @@
+// core/data/sqlite_batch_binding.hpp
+#ifndef SQLITE_BATCH_BINDING_HPP
+#define SQLITE_BATCH_BINDING_HPP
+
+#include <charconv>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "sqlite3.h"
+
+// 批量语句的参数编码：整批值编码为一个 JSON 数组，
+// 在 SQL 中用 json_each(?) 展开为集合，一次执行完成整批操作。
+namespace SqliteBatchBinding {
+
+template <typename Range>
+void BuildJsonStringArray(const Range& values, std::string& out) {
+  out.clear();
+  out += '[';
+  bool first = true;
+  for (const auto& value : values) {
+    if (!first) {
+      out += ',';
+    }
+    first = false;
+    out += '"';
+    for (const char c : std::string_view(value)) {
+      if (c == '"' || c == '\\') {
+        out += '\\';
+        out += c;
+      } else if (static_cast<unsigned char>(c) < 0x20) {
+        static constexpr char kHex[] = "0123456789abcdef";
+        out += "\\u00";
+        out += kHex[(c >> 4) & 0xF];
+        out += kHex[c & 0xF];
+      } else {
+        out += c;
+      }
+    }
+    out += '"';
+  }
+  out += ']';
+}
+
+template <typename Range>
+void BuildJsonIntegerArray(const Range& values, std::string& out) {
+  out.clear();
+  out += '[';
+  bool first = true;
+  for (const auto value : values) {
+    if (!first) {
+      out += ',';
+    }
+    first = false;
+    // to_chars 写入栈上缓冲区，避免每个值构造一个临时字符串
+    char digits[24];
+    const auto result = std::to_chars(std::begin(digits), std::end(digits),
+                                      static_cast<int64_t>(value));
+    out.append(digits, result.ptr);
+  }
+  out += ']';
+}
+
+// 结束一次批量语句：rc 为最后一次 sqlite3_step 的返回值。
+// 复位语句并清除绑定；未以 SQLITE_DONE 结束（中途 SQLITE_FULL、
+// SQLITE_BUSY、SQLITE_IOERR 等）时抛出 std::runtime_error，
+// 避免把未处理的剩余 ID 当作"已存在"或"不存在"
+inline void FinishOrThrow(sqlite3* db, sqlite3_stmt* stmt, int rc,
+                          const char* what) {
+  std::string error;
+  if (rc != SQLITE_DONE) {
+    error = what;
+    error += ": ";
+    error += sqlite3_errmsg(db);
+  }
+  sqlite3_reset(stmt);
+  sqlite3_clear_bindings(stmt);
+  if (rc != SQLITE_DONE) {
+    throw std::runtime_error(error);
+  }
+}
+
+}  // namespace SqliteBatchBinding
+
+#endif
@@ -0,0 +1,25 @@
+// core/data/sqlite_cache_size.hpp
+#ifndef SQLITE_CACHE_SIZE_HPP
+#define SQLITE_CACHE_SIZE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+
+#include "sqlite3.h"
+
+namespace SqliteCacheSize {
+// 按字节设置连接的页缓存上限（cache_size 取负值时以 KiB 计）；
+// 0 表示保持 SQLite 的默认值
+inline void Apply(sqlite3* db, size_t cache_bytes) {
+  if (cache_bytes == 0) {
+    return;
+  }
+  const std::string sql =
+      "PRAGMA cache_size = -" +
+      std::to_string(std::max<size_t>(1, cache_bytes / 1024)) + ";";
+  sqlite3_exec(db, sql.c_str(), nullptr, nullptr, nullptr);
+}
+}  // namespace SqliteCacheSize
+
+#endif
@@ -0,0 +1,278 @@
+// core/infrastructure/database_directory.cpp
+#include "core/infrastructure/database_directory.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <optional>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <sys/vfs.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#endif
+
+namespace {
+constexpr std::string_view kDbExtension = ".sqlite3";
+
+auto IsDbFileName(std::string_view name) -> bool {
+  return name.size() > kDbExtension.size() && name.ends_with(kDbExtension);
+}
+
+// 取文件的大小与修改时间；不是普通文件或已被删除时返回 std::nullopt
+auto StatDb(const std::filesystem::path& path) -> std::optional<DatabaseInfo> {
+  std::error_code ec;
+  if (!std::filesystem::is_regular_file(path, ec)) {
+    return std::nullopt;
+  }
+  DatabaseInfo info;
+  info.name = path.filename().string();
+  info.size_bytes = std::filesystem::file_size(path, ec);
+  if (ec) {
+    return std::nullopt;
+  }
+  const auto modified = std::filesystem::last_write_time(path, ec);
+  if (ec) {
+    return std::nullopt;
+  }
+  info.modified = std::chrono::time_point_cast<
+      std::chrono::system_clock::duration>(
+      std::chrono::file_clock::to_sys(modified));
+  return info;
+}
+
+// 文件未变化时沿用之前记下的记录数
+void KeepRecordCount(const DatabaseInfo& previous, DatabaseInfo& current) {
+  if (previous.size_bytes == current.size_bytes &&
+      previous.modified == current.modified) {
+    current.record_count = previous.record_count;
+  }
+}
+
+#ifdef __linux__
+// 网络与用户态文件系统上，inotify 只能看到本机发起的修改
+auto IsRemoteFileSystem(const std::string& path) -> bool {
+  struct statfs info {};
+  if (statfs(path.c_str(), &info) != 0) {
+    return true;
+  }
+  constexpr std::array<unsigned long, 6> kRemoteMagic = {
+      0x6969,      // NFS
+      0x517B,      // SMB
+      0xFF534D42,  // CIFS
+      0xFE534D42,  // SMB2
+      0x65735546,  // FUSE
+      0x01021997,  // 9P
+  };
+  return std::ranges::find(kRemoteMagic,
+                           static_cast<unsigned long>(info.f_type)) !=
+         kRemoteMagic.end();
+}
+
+constexpr uint32_t kWatchMask = IN_CREATE | IN_DELETE | IN_MOVED_FROM |
+                                IN_MOVED_TO | IN_MODIFY | IN_CLOSE_WRITE |
+                                IN_ATTRIB | IN_DELETE_SELF | IN_MOVE_SELF |
+                                IN_ONLYDIR;
+#endif
+}  // namespace
+
+DatabaseDirectory::DatabaseDirectory(std::string directory_path,
+                                     std::chrono::milliseconds poll_interval,
+                                     bool allow_notify)
+    : directory_path_(std::move(directory_path)),
+      poll_interval_(poll_interval),
+      allow_notify_(allow_notify) {}
+
+DatabaseDirectory::~DatabaseDirectory() {
+#ifdef __linux__
+  if (notify_fd_ >= 0) {
+    close(notify_fd_);
+  }
+#endif
+}
+
+auto DatabaseDirectory::List() -> std::vector<DatabaseInfo> {
+  const std::scoped_lock lock(mutex_);
+  Refresh();
+  return entries_;
+}
+
+auto DatabaseDirectory::Names() -> std::vector<std::string> {
+  const std::scoped_lock lock(mutex_);
+  Refresh();
+  std::vector<std::string> names;
+  names.reserve(entries_.size());
+  for (const DatabaseInfo& info : entries_) {
+    names.push_back(info.name);
+  }
+  return names;
+}
+
+auto DatabaseDirectory::Contains(const std::string& db_name) -> bool {
+  const std::scoped_lock lock(mutex_);
+  Refresh();
+  return Find(db_name) != nullptr;
+}
+
+void DatabaseDirectory::Touch(const std::string& db_name) {
+  const std::scoped_lock lock(mutex_);
+  if (started_) {
+    Restat(db_name);
+  }
+}
+
+void DatabaseDirectory::SetRecordCount(const std::string& db_name,
+                                       size_t record_count) {
+  const std::scoped_lock lock(mutex_);
+  Refresh();
+  if (DatabaseInfo* info = Find(db_name)) {
+    info->record_count = record_count;
+  }
+}
+
+auto DatabaseDirectory::IsNotifying() -> bool {
+  const std::scoped_lock lock(mutex_);
+  return notify_fd_ >= 0;
+}
+
+auto DatabaseDirectory::ScanCount() -> uint64_t {
+  const std::scoped_lock lock(mutex_);
+  return scan_count_;
+}
+
+void DatabaseDirectory::Refresh() {
+  if (!started_) {
+    started_ = true;
+    // 先开始监视再扫描，扫描期间发生的变化会留在事件队列里
+    StartWatching();
+    Rescan();
+    return;
+  }
+  if (notify_fd_ >= 0) {
+    if (!DrainEvents()) {
+      Rescan();
+    }
+    return;
+  }
+  if (std::chrono::steady_clock::now() - last_scan_ >= poll_interval_) {
+    Rescan();
+  }
+}
+
+void DatabaseDirectory::StartWatching() {
+#ifdef __linux__
+  if (!allow_notify_ || IsRemoteFileSystem(directory_path_)) {
+    return;
+  }
+  notify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (notify_fd_ < 0) {
+    return;
+  }
+  if (inotify_add_watch(notify_fd_, directory_path_.c_str(), kWatchMask) < 0) {
+    close(notify_fd_);
+    notify_fd_ = -1;
+  }
+#endif
+}
+
+auto DatabaseDirectory::DrainEvents() -> bool {
+#ifdef __linux__
+  alignas(inotify_event) std::array<char, 16 * 1024> buffer{};
+  std::vector<std::string> changed;
+  bool rescan = false;
+  while (true) {
+    const ssize_t length = read(notify_fd_, buffer.data(), buffer.size());
+    if (length < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      break;  // EAGAIN：队列已空
+    }
+    for (ssize_t offset = 0; offset < length;) {
+      const auto* event =
+          reinterpret_cast<const inotify_event*>(buffer.data() + offset);
+      offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+      if ((event->mask & IN_Q_OVERFLOW) != 0u) {
+        rescan = true;
+        continue;
+      }
+      if ((event->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED)) !=
+          0u) {
+        // 目录本身被删除或移走，监视已失效，此后改为轮询
+        close(notify_fd_);
+        notify_fd_ = -1;
+        return false;
+      }
+      if (event->len == 0) {
+        continue;
+      }
+      const std::string_view name(event->name);
+      // 日志文件（-journal、-wal）的事件与清单无关；
+      // 库文件本身的写入会产生自己的事件
+      if (IsDbFileName(name) && std::ranges::find(changed, name) ==
+                                    changed.end()) {
+        changed.emplace_back(name);
+      }
+    }
+  }
+  if (rescan) {
+    return false;
+  }
+  for (const std::string& name : changed) {
+    Restat(name);
+  }
+#endif
+  return true;
+}
+
+void DatabaseDirectory::Rescan() {
+  ++scan_count_;
+  last_scan_ = std::chrono::steady_clock::now();
+  std::vector<DatabaseInfo> scanned;
+  std::error_code ec;
+  for (std::filesystem::directory_iterator it(directory_path_, ec), end;
+       !ec && it != end; it.increment(ec)) {
+    const std::string name = it->path().filename().string();
+    if (!IsDbFileName(name)) {
+      continue;
+    }
+    if (auto info = StatDb(it->path())) {
+      if (const DatabaseInfo* previous = Find(name)) {
+        KeepRecordCount(*previous, *info);
+      }
+      scanned.push_back(std::move(*info));
+    }
+  }
+  std::ranges::sort(scanned, {}, &DatabaseInfo::name);
+  entries_ = std::move(scanned);
+}
+
+void DatabaseDirectory::Restat(const std::string& db_name) {
+  auto it = std::ranges::lower_bound(entries_, db_name, {},
+                                     &DatabaseInfo::name);
+  const bool listed = it != entries_.end() && it->name == db_name;
+  auto info = StatDb(std::filesystem::path(directory_path_) / db_name);
+  if (!info) {
+    if (listed) {
+      entries_.erase(it);
+    }
+    return;
+  }
+  if (listed) {
+    KeepRecordCount(*it, *info);
+    *it = std::move(*info);
+  } else {
+    entries_.insert(it, std::move(*info));
+  }
+}
+
+auto DatabaseDirectory::Find(const std::string& db_name) -> DatabaseInfo* {
+  auto it = std::ranges::lower_bound(entries_, db_name, {},
+                                     &DatabaseInfo::name);
+  return (it != entries_.end() && it->name == db_name) ? &*it : nullptr;
+}
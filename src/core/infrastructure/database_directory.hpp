@@ -0,0 +1,67 @@
+// core/infrastructure/database_directory.hpp
+#ifndef DATABASE_DIRECTORY_HPP
+#define DATABASE_DIRECTORY_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "core/ports/i_database_catalog.hpp"
+
+// 数据目录下 .sqlite3 库文件的内存清单，列举与存在性判断不再访问文件系统。
+// Linux 本地文件系统上由 inotify 通知增删改，每次访问时非阻塞地取出积压的
+// 事件，只重新读取变化过的文件；inotify 不可用、或目录位于网络文件系统
+// （其他主机上的修改不会产生事件）时退化为轮询：距上次扫描超过
+// poll_interval 才重新扫描整个目录。
+// 首次访问时才开始监视，因此目录可以在构造之后再创建。线程安全。
+class DatabaseDirectory {
+ public:
+  static constexpr std::chrono::milliseconds kDefaultPollInterval{2000};
+
+  explicit DatabaseDirectory(
+      std::string directory_path,
+      std::chrono::milliseconds poll_interval = kDefaultPollInterval,
+      bool allow_notify = true);
+  ~DatabaseDirectory();
+  DatabaseDirectory(const DatabaseDirectory&) = delete;
+  auto operator=(const DatabaseDirectory&) -> DatabaseDirectory& = delete;
+
+  // 按名称排序的清单；record_count 为上次记录、且文件此后未变化的记录数
+  [[nodiscard]] auto List() -> std::vector<DatabaseInfo>;
+  [[nodiscard]] auto Names() -> std::vector<std::string>;
+  [[nodiscard]] auto Contains(const std::string& db_name) -> bool;
+  // 本进程刚创建或改写了某个库：立即重新读取它的文件信息，
+  // 不必等待事件或下一次轮询
+  void Touch(const std::string& db_name);
+  // 记下某个库的记录数，文件大小或修改时间变化后自动失效
+  void SetRecordCount(const std::string& db_name, size_t record_count);
+
+  // 是否由 inotify 驱动（首次访问之前为 false）
+  [[nodiscard]] auto IsNotifying() -> bool;
+  // 全量扫描目录的次数，供诊断与测试
+  [[nodiscard]] auto ScanCount() -> uint64_t;
+
+ private:
+  void Refresh();  // 调用时已持有 mutex_
+  void StartWatching();
+  // 取出积压的事件；返回 false 表示需要全量重新扫描
+  auto DrainEvents() -> bool;
+  void Rescan();
+  void Restat(const std::string& db_name);
+  auto Find(const std::string& db_name) -> DatabaseInfo*;
+
+  std::mutex mutex_;
+  std::string directory_path_;
+  std::chrono::milliseconds poll_interval_;
+  bool allow_notify_;
+  bool started_ = false;
+  int notify_fd_ = -1;
+  std::vector<DatabaseInfo> entries_;  // 按名称排序
+  std::chrono::steady_clock::time_point last_scan_;
+  uint64_t scan_count_ = 0;
+};
+
+#endif
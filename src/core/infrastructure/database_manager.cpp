@@ -1,10 +1,27 @@
 // core/infrastructure/database_manager.cpp
 #include "core/infrastructure/database_manager.hpp"
 
+#include <algorithm>
 #include <filesystem>
+#include <functional>
+#include <future>
+#include <bit>
 #include <iostream>  // 用于错误输出
+#include <mutex>
+#include <numeric>
+#include <ranges>
+#include <shared_mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
 
 #include "core/data/fast_query_db.hpp"
+#include "core/data/hash_index_repository.hpp"
+#include "core/data/id_snapshot.hpp"
+#include "core/data/packed_id_db.hpp"
+#include "core/data/packed_id_migrator.hpp"
+#include "core/data/snapshot_repository.hpp"
+#include "sqlite3.h"
 
 // --- 平台相关的头文件，用于获取可执行文件路径 ---
 #ifdef _WIN32
@@ -26,17 +43,142 @@ auto GetExecutableDirectory() -> std::string {
 #endif
   return std::filesystem::path(path).parent_path().string();
 }
+
+// 跨库查询时每段至少这么多 ID 才值得再为同一个库多开一个连接
+constexpr size_t kMinIdsPerFanOutSlice = 2048;
+
+// 每个连接的页缓存取内存预算的 1/kCacheShare，并限制在上下限之间
+constexpr size_t kCacheShare = 32;
+constexpr size_t kMinCacheBytes = size_t{1} << 20;
+constexpr size_t kMaxCacheBytes = size_t{64} << 20;
+
+auto CacheBytesFor(size_t budget_bytes) -> size_t {
+  return std::clamp(budget_bytes / kCacheShare, kMinCacheBytes,
+                    kMaxCacheBytes);
+}
+
+// 存储布局由文件自身的表结构决定
+auto OpenStore(const std::string& full_path, size_t cache_bytes = 0)
+    -> std::unique_ptr<IIdRepository> {
+  if (PackedIdDB::IsPackedLayout(full_path)) {
+    return std::make_unique<PackedIdDB>(full_path, cache_bytes);
+  }
+  return std::make_unique<FastQueryDB>(full_path, cache_bytes);
+}
+
+// 取单个整数结果；语句无法准备（如表不存在）或没有结果行时返回 std::nullopt
+auto QueryInt64(sqlite3* db, const char* sql) -> std::optional<int64_t> {
+  sqlite3_stmt* stmt = nullptr;
+  if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+    sqlite3_finalize(stmt);
+    return std::nullopt;
+  }
+  std::optional<int64_t> value;
+  const int rc = sqlite3_step(stmt);
+  if (rc == SQLITE_ROW) {
+    value = sqlite3_column_int64(stmt, 0);
+  }
+  const std::string error =
+      rc == SQLITE_ROW || rc == SQLITE_DONE ? "" : sqlite3_errmsg(db);
+  sqlite3_finalize(stmt);
+  if (!error.empty()) {
+    throw std::runtime_error("读取记录数失败: " + error);
+  }
+  return value;
+}
+
+// 列举用的记录数：只读打开，不升级旧库、不与其他进程争写锁。
+// 计数触发器已安装时 id_meta 中的计数可信，否则逐行统计
+auto ReadRecordCount(const std::string& full_path) -> size_t {
+  sqlite3* db = nullptr;
+  if (sqlite3_open_v2(full_path.c_str(), &db, SQLITE_OPEN_READONLY,
+                      nullptr) != SQLITE_OK) {
+    std::string error = "无法打开数据库: ";
+    error += sqlite3_errmsg(db);
+    sqlite3_close(db);
+    throw std::runtime_error(error);
+  }
+  std::optional<int64_t> count;
+  try {
+    // 与 PackedIdDB::IsPackedLayout 相同：迁移中断的文件以文本表为准
+    const bool packed =
+        QueryInt64(db,
+                   "SELECT EXISTS (SELECT 1 FROM sqlite_master"
+                   "  WHERE type = 'table' AND name = 'packed_ids')"
+                   " AND NOT EXISTS (SELECT 1 FROM sqlite_master"
+                   "  WHERE type = 'table' AND name = 'ids');")
+            .value_or(0) != 0;
+    const bool counted =
+        QueryInt64(db, packed ? "SELECT EXISTS (SELECT 1 FROM sqlite_master"
+                                "  WHERE type = 'trigger'"
+                                "  AND name = 'packed_ids_count_insert');"
+                              : "SELECT EXISTS (SELECT 1 FROM sqlite_master"
+                                "  WHERE type = 'trigger'"
+                                "  AND name = 'ids_count_insert');")
+            .value_or(0) != 0;
+    if (counted) {
+      count = QueryInt64(db,
+                         "SELECT value FROM id_meta WHERE key = 'id_count';");
+    }
+    if (!count) {
+      count = QueryInt64(db, packed ? "SELECT (SELECT COUNT(*) FROM packed_ids)"
+                                      " + (SELECT COUNT(*) FROM ids_overflow);"
+                                    : "SELECT COUNT(*) FROM ids;");
+    }
+  } catch (...) {
+    sqlite3_close(db);
+    throw;
+  }
+  sqlite3_close(db);
+  // 还没有建表的空文件记为 0
+  return static_cast<size_t>(std::max<int64_t>(count.value_or(0), 0));
+}
+
+// 快照头记录了生成时库文件的大小、修改时间与文件头的修改计数，任一变化
+// 即重新生成；修改计数每次提交都会前进，不受文件时间粒度影响。
+// 库文件缺失时（例如只分发了快照的查询终端）照常使用现有快照。
+void RefreshSnapshot(const std::string& full_path,
+                     const std::string& snapshot_path) {
+  const auto recorded = IdSnapshot::ReadSourceStamp(snapshot_path);
+  const auto current = IdSnapshot::StampOf(full_path);
+  if (recorded && (!current || *recorded == *current)) {
+    return;
+  }
+
+  auto store = OpenStore(full_path);
+  store->BeginTransaction();
+  try {
+    // 先读一次让连接持有共享锁，导出期间其他进程无法提交，
+    // 此时记下的文件标记与导出的内容一致
+    (void)store->GetCount();
+    const auto stamp = IdSnapshot::StampOf(full_path);
+    std::vector<std::string> ids = store->GetAllIds();
+    store->CommitTransaction();
+    IdSnapshot::Write(snapshot_path, std::move(ids),
+                      stamp.value_or(IdSnapshot::SourceStamp{}));
+  } catch (...) {
+    store->RollbackTransaction();
+    throw;
+  }
+}
 }  // namespace
 
-DatabaseManager::DatabaseManager() {
-  // 1. 获取可执行文件目录，并构建data目录的路径
-  data_directory_path_ = GetExecutableDirectory() + "/data";
+DatabaseManager::DatabaseManager()
+    // 数据目录位于可执行文件所在目录下
+    : DatabaseManager(GetExecutableDirectory() + "/data") {}
 
-  // 2. 确保这个data目录存在
+DatabaseManager::DatabaseManager(std::string data_directory_path)
+    : data_directory_path_(std::move(data_directory_path)),
+      directory_(data_directory_path_) {
+  // 确保数据目录存在
   EnsureDataDirectoryExists();
 
-  // 3. 设置默认数据库名称 (只是名字，不含路径)
+  // 设置默认数据库名称 (只是名字，不含路径)
   current_db_name_ = "database.sqlite3";
+
+  memory_budget_bytes_ = kDefaultMemoryBudgetBytes;
+  cache_bytes_ = CacheBytesFor(memory_budget_bytes_);
+  sqlite3_soft_heap_limit64(static_cast<sqlite3_int64>(memory_budget_bytes_));
 }
 
 void DatabaseManager::EnsureDataDirectoryExists() {
@@ -50,9 +192,127 @@ auto DatabaseManager::GetDbFilepath(const std::string& db_name) const
   return data_directory_path_ + "/" + db_name;
 }
 
+auto DatabaseManager::OpenRepository(const std::string& db_name)
+    -> std::unique_ptr<IIdRepository> {
+  std::string full_path = GetDbFilepath(db_name);
+  std::unique_ptr<IIdRepository> repository;
+  switch (GetQueryEngine(db_name)) {
+    case QueryEngine::kSnapshot: {
+      const std::string snapshot_path = full_path + ".avidx";
+      RefreshSnapshot(full_path, snapshot_path);
+      repository = std::make_unique<SnapshotRepository>(snapshot_path);
+      break;
+    }
+    case QueryEngine::kHashIndex:
+      repository = std::make_unique<HashIndexRepository>(
+          OpenStore(full_path, cache_bytes_));
+      break;
+    case QueryEngine::kSqlite:
+      repository = OpenStore(full_path, cache_bytes_);
+      break;
+  }
+  return std::make_unique<CrossIndexedRepository>(
+      std::move(repository), cross_index_, db_name, std::move(full_path));
+}
+
 void DatabaseManager::LoadDefaultDatabase() {
-  std::string full_path = GetDbFilepath(current_db_name_);
-  dbs_[current_db_name_] = std::make_unique<FastQueryDB>(full_path);
+  Admit(current_db_name_, OpenRepository(current_db_name_));
+}
+
+void DatabaseManager::Admit(const std::string& db_name,
+                            std::unique_ptr<IIdRepository> repository) {
+  dbs_[db_name] = std::move(repository);
+  last_used_[db_name] = ++use_clock_;
+  EnforceMemoryBudget(db_name);
+}
+
+auto DatabaseManager::ChargeOf(const IIdRepository& repository,
+                               QueryEngine engine) const -> size_t {
+  const RepositoryStats stats = repository.GetStats();
+  size_t bytes = stats.memory_bytes + stats.filter.memory_bytes;
+  // 快照直接映射文件，不经过 SQLite 页缓存
+  if (engine != QueryEngine::kSnapshot) {
+    bytes += cache_bytes_;
+  }
+  return bytes;
+}
+
+auto DatabaseManager::UsedBytes() const -> size_t {
+  size_t used = 0;
+  for (const auto& [name, repository] : dbs_) {
+    used += ChargeOf(*repository, GetQueryEngine(name));
+  }
+  for (const auto& [name, readers] : fanout_readers_) {
+    for (const auto& reader : readers) {
+      used += ChargeOf(*reader, QueryEngine::kSqlite);
+    }
+  }
+  const std::shared_lock lock(cross_index_.mutex);
+  return used + cross_index_.index.MemoryBytes();
+}
+
+void DatabaseManager::EnforceMemoryBudget(const std::string& keep) {
+  size_t used = UsedBytes();
+  if (used <= memory_budget_bytes_) {
+    return;
+  }
+  // 额外的只读连接随时可以重开，先于库本身释放
+  for (const auto& [name, readers] : fanout_readers_) {
+    evictions_ += readers.size();
+  }
+  fanout_readers_.clear();
+  used = UsedBytes();
+
+  while (used > memory_budget_bytes_) {
+    auto victim = dbs_.end();
+    uint64_t victim_used = 0;
+    for (auto it = dbs_.begin(); it != dbs_.end(); ++it) {
+      if (it->first == current_db_name_ || it->first == keep) {
+        continue;
+      }
+      const uint64_t tick = last_used_[it->first];
+      if (victim == dbs_.end() || tick < victim_used) {
+        victim = it;
+        victim_used = tick;
+      }
+    }
+    if (victim == dbs_.end()) {
+      break;  // 只剩当前库，预算只能由它独占
+    }
+    used -= std::min(used, ChargeOf(*victim->second,
+                                    GetQueryEngine(victim->first)));
+    last_used_.erase(victim->first);
+    dbs_.erase(victim);
+    ++evictions_;
+  }
+}
+
+void DatabaseManager::SetMemoryBudget(size_t budget_bytes) {
+  memory_budget_bytes_ = budget_bytes;
+  cache_bytes_ = CacheBytesFor(budget_bytes);
+  // 软上限是进程级的：超出后 SQLite 会先回收各连接的页缓存
+  sqlite3_soft_heap_limit64(static_cast<sqlite3_int64>(budget_bytes));
+  EnforceMemoryBudget();
+}
+
+auto DatabaseManager::GetMemoryStats() const -> CatalogMemoryStats {
+  CatalogMemoryStats stats;
+  stats.budget_bytes = memory_budget_bytes_;
+  stats.used_bytes = UsedBytes();
+  stats.cache_bytes_per_connection = cache_bytes_;
+  for (const auto& [name, repository] : dbs_) {
+    stats.open_databases.push_back(name);
+  }
+  std::ranges::sort(stats.open_databases, std::greater<>(),
+                    [this](const std::string& name) {
+                      const auto it = last_used_.find(name);
+                      return it != last_used_.end() ? it->second : 0;
+                    });
+  for (const auto& [name, readers] : fanout_readers_) {
+    stats.extra_connections += readers.size();
+  }
+  stats.evictions = evictions_;
+  return stats;
 }
 
 auto DatabaseManager::CreateDatabase(const std::string& db_name_raw) -> bool {
@@ -61,15 +321,25 @@ auto DatabaseManager::CreateDatabase(const std::string& db_name_raw) -> bool {
     new_db_name += ".sqlite3";
   }
 
-  if (DatabaseExists(new_db_name)) {
+  // 创建前直接检查文件：轮询模式下清单可能还没看到其他进程刚建的库
+  if (std::filesystem::exists(GetDbFilepath(new_db_name))) {
     return false;
   }
 
   try {
     std::string full_path = GetDbFilepath(new_db_name);
-    auto db = std::make_unique<FastQueryDB>(full_path);
-    dbs_[new_db_name] = std::move(db);
+    Admit(new_db_name, std::make_unique<CrossIndexedRepository>(
+                           std::make_unique<FastQueryDB>(full_path,
+                                                         cache_bytes_),
+                           cross_index_, new_db_name, full_path));
     current_db_name_ = new_db_name;
+    directory_.Touch(new_db_name);
+    // 新库为空，直接登记到跨库索引，不必重建
+    const std::unique_lock lock(cross_index_.mutex);
+    if (cross_index_.ready) {
+      cross_index_.ready = cross_index_.BitFor(new_db_name).has_value();
+      cross_index_.files[new_db_name] = IdSnapshot::StampOf(full_path);
+    }
     return true;
   } catch (const std::exception& e) {
     std::cerr << "创建数据库失败: " << e.what() << std::endl;
@@ -79,13 +349,19 @@ auto DatabaseManager::CreateDatabase(const std::string& db_name_raw) -> bool {
 
 auto DatabaseManager::SwitchToDatabase(const std::string& db_name) -> bool {
   std::string full_path = GetDbFilepath(db_name);
+  // 快照模式每次切换都重新打开：库文件变化过则在此重新生成，否则只是重新映射
+  if (dbs_.contains(db_name) != 0u &&
+      GetQueryEngine(db_name) == QueryEngine::kSnapshot) {
+    dbs_.erase(db_name);
+  }
   if (dbs_.contains(db_name) != 0u) {
     current_db_name_ = db_name;
+    last_used_[db_name] = ++use_clock_;
     return true;
   }
   if (std::filesystem::exists(full_path)) {
     try {
-      dbs_[db_name] = std::make_unique<FastQueryDB>(full_path);
+      Admit(db_name, OpenRepository(db_name));
       current_db_name_ = db_name;
       return true;
     } catch (const std::exception& e) {
@@ -96,8 +372,364 @@ auto DatabaseManager::SwitchToDatabase(const std::string& db_name) -> bool {
   return false;
 }
 
+auto DatabaseManager::DeleteDatabase(const std::string& db_name) -> bool {
+  // 先关闭本进程的连接，否则 Windows 上无法删除文件
+  fanout_readers_.erase(db_name);
+  dbs_.erase(db_name);
+  last_used_.erase(db_name);
+  engines_.erase(db_name);
+
+  const std::string full_path = GetDbFilepath(db_name);
+  std::error_code ec;
+  std::filesystem::remove(full_path + ".avidx", ec);
+  std::filesystem::remove(full_path, ec);
+  directory_.Touch(db_name);
+  // 跨库索引的库清单随之不同，下次查询时自动重建
+  if (ec) {
+    std::cerr << "删除数据库失败: " << ec.message() << std::endl;
+    return false;
+  }
+  return true;
+}
+
+auto DatabaseManager::MigrateToPackedLayout(const std::string& db_name)
+    -> std::optional<LayoutMigrationReport> {
+  std::string full_path = GetDbFilepath(db_name);
+  if (!std::filesystem::exists(full_path)) {
+    return std::nullopt;
+  }
+
+  // 迁移会删除文本表，先释放本进程持有的连接及其预编译语句
+  fanout_readers_.erase(db_name);
+  const bool was_open = dbs_.erase(db_name) != 0u;
+  std::optional<LayoutMigrationReport> report;
+  try {
+    report = PackedIdMigrator::MigrateInPlace(full_path);
+  } catch (const std::exception& e) {
+    std::cerr << "迁移数据库失败: " << e.what() << std::endl;
+  }
+  directory_.Touch(db_name);
+
+  if (was_open) {
+    try {
+      Admit(db_name, OpenRepository(db_name));
+    } catch (const std::exception& e) {
+      std::cerr << "重新加载数据库失败: " << e.what() << std::endl;
+      return std::nullopt;
+    }
+  }
+  return report;
+}
+
+auto DatabaseManager::SetQueryEngine(const std::string& db_name,
+                                     QueryEngine engine) -> bool {
+  if (!DatabaseExists(db_name)) {
+    return false;
+  }
+  const QueryEngine previous = GetQueryEngine(db_name);
+  engines_[db_name] = engine;
+  fanout_readers_.erase(db_name);
+  if (dbs_.contains(db_name) == 0u || previous == engine) {
+    return true;
+  }
+  try {
+    // 先释放旧连接，避免同一文件同时挂着两份预编译语句
+    dbs_.erase(db_name);
+    Admit(db_name, OpenRepository(db_name));
+    return true;
+  } catch (const std::exception& e) {
+    std::cerr << "切换查询引擎失败: " << e.what() << std::endl;
+    engines_[db_name] = previous;
+    try {
+      Admit(db_name, OpenRepository(db_name));
+    } catch (const std::exception&) {
+      dbs_.erase(db_name);
+    }
+    return false;
+  }
+}
+
+auto DatabaseManager::GetQueryEngine(const std::string& db_name) const
+    -> QueryEngine {
+  auto it = engines_.find(db_name);
+  return it != engines_.end() ? it->second : QueryEngine::kSqlite;
+}
+
+auto DatabaseManager::FanOutReaders(const std::string& db_name, size_t wanted)
+    -> std::vector<IIdRepository*> {
+  std::vector<IIdRepository*> readers;
+  if (auto it = dbs_.find(db_name); it != dbs_.end()) {
+    readers.push_back(it->second.get());
+    // 内存类引擎本身足够快，也不宜多载入几份
+    if (GetQueryEngine(db_name) != QueryEngine::kSqlite) {
+      return readers;
+    }
+  }
+  // 未打开的库只开轻量的 SQLite 连接，不为一次跨库查询载入整个引擎
+  auto& extra = fanout_readers_[db_name];
+  while (readers.size() + extra.size() < wanted) {
+    extra.push_back(OpenStore(GetDbFilepath(db_name), cache_bytes_));
+  }
+  for (size_t i = 0; readers.size() < wanted; ++i) {
+    readers.push_back(extra[i].get());
+  }
+  return readers;
+}
+
+auto DatabaseManager::FanOutPool() -> Concurrency::ThreadPool& {
+  if (!fanout_pool_) {
+    fanout_pool_ = std::make_unique<Concurrency::ThreadPool>(
+        std::max(1U, std::thread::hardware_concurrency()));
+  }
+  return *fanout_pool_;
+}
+
+auto DatabaseManager::EnsureCrossIndex() -> bool {
+  std::vector<std::string> names = GetAllDbNames();
+  std::ranges::sort(names);
+  {
+    const std::shared_lock lock(cross_index_.mutex);
+    if (cross_index_.ready &&
+        std::ranges::equal(names, cross_index_.files | std::views::keys)) {
+      return true;
+    }
+  }
+  {
+    // 重建期间的写入不必同步，重建会从库文件读到它们
+    const std::unique_lock lock(cross_index_.mutex);
+    cross_index_.ready = false;
+  }
+  if (names.size() > CrossDbIndex::kMaxDatabases) {
+    return false;
+  }
+
+  // 每个库一个任务，各自构建单库索引，再在当前线程合并
+  std::vector<std::string> indexed;
+  std::vector<std::future<CrossDbIndex>> parts;
+  std::map<std::string, std::optional<IdSnapshot::SourceStamp>> files;
+  for (const std::string& name : names) {
+    IIdRepository* reader = nullptr;
+    try {
+      reader = FanOutReaders(name, 1).front();
+    } catch (const std::exception& e) {
+      std::cerr << "构建跨库索引时打开数据库失败 [" << name << "]: " << e.what()
+                << std::endl;
+    }
+    // 打开（可能顺带升级表结构）之后、读取之前记下文件标记，
+    // 构建期间的写入会让对应的库被视为已变化
+    files[name] = IdSnapshot::StampOf(GetDbFilepath(name));
+    if (reader == nullptr) {
+      continue;
+    }
+    const size_t bit = indexed.size();
+    indexed.push_back(name);
+    parts.push_back(FanOutPool().Submit([reader, bit] {
+      CrossDbIndex part;
+      reader->ForEachId([&part, bit](std::span<const std::string_view> chunk) {
+        for (const std::string_view id : chunk) {
+          part.Insert(id, bit);
+        }
+        return true;
+      });
+      return part;
+    }));
+  }
+  for (auto& part : parts) {
+    part.wait();
+  }
+  CrossDbIndex merged;
+  for (size_t i = 0; i < parts.size(); ++i) {
+    if (i == 0) {
+      merged = parts[i].get();
+    } else {
+      merged.Merge(parts[i].get());
+    }
+  }
+
+  {
+    const std::unique_lock lock(cross_index_.mutex);
+    cross_index_.index = std::move(merged);
+    cross_index_.databases = std::move(indexed);
+    cross_index_.ready = true;
+    cross_index_.files = std::move(files);
+    ++cross_index_.generation;
+  }
+  // 构建时为每个库开过连接，全部任务结束后再按预算回收
+  EnforceMemoryBudget();
+  return true;
+}
+
+auto DatabaseManager::ChangedSinceCrossIndex() const
+    -> std::vector<std::string> {
+  std::map<std::string, std::optional<IdSnapshot::SourceStamp>> files;
+  {
+    const std::shared_lock lock(cross_index_.mutex);
+    files = cross_index_.files;
+  }
+  std::vector<std::string> changed;
+  for (const auto& [name, stamp] : files) {
+    if (!stamp || IdSnapshot::StampOf(GetDbFilepath(name)) != stamp) {
+      changed.push_back(name);
+    }
+  }
+  return changed;
+}
+
+auto DatabaseManager::ExistsInAll(std::span<const std::string_view> ids)
+    -> CrossDbLookup {
+  if (!EnsureCrossIndex()) {
+    std::vector<std::string> names = GetAllDbNames();
+    std::ranges::sort(names);
+    return ExistsInAllByFanOut(ids, names);
+  }
+  // 文件变化过的库直接查库，其余的取自索引
+  const std::vector<std::string> changed = ChangedSinceCrossIndex();
+  CrossDbLookup live;
+  if (!changed.empty()) {
+    live = ExistsInAllByFanOut(ids, changed);
+  }
+
+  const std::shared_lock lock(cross_index_.mutex);
+  const std::vector<std::string>& databases = cross_index_.databases;
+  std::vector<size_t> order(databases.size());
+  std::iota(order.begin(), order.end(), size_t{0});
+  std::ranges::sort(order, {}, [&](size_t bit) -> const std::string& {
+    return databases[bit];
+  });
+  std::vector<size_t> position_of_bit(databases.size());
+  CrossDbLookup lookup;
+  for (size_t d = 0; d < order.size(); ++d) {
+    position_of_bit[order[d]] = d;
+    lookup.databases.push_back(databases[order[d]]);
+  }
+
+  // 每个 ID 一次查找即得到全部命中的库
+  lookup.contains.assign(databases.size(),
+                         std::vector<bool>(ids.size(), false));
+  for (size_t k = 0; k < ids.size(); ++k) {
+    for (CrossDbIndex::DbMask mask = cross_index_.index.Lookup(ids[k]);
+         mask != 0; mask &= mask - 1) {
+      lookup.contains[position_of_bit[std::countr_zero(mask)]][k] = true;
+    }
+  }
+  for (size_t d = 0; d < live.databases.size(); ++d) {
+    const auto it = std::ranges::find(lookup.databases, live.databases[d]);
+    if (it != lookup.databases.end()) {
+      lookup.contains[static_cast<size_t>(it - lookup.databases.begin())] =
+          std::move(live.contains[d]);
+    }
+  }
+  return lookup;
+}
+
+auto DatabaseManager::GetCrossDbStats() -> CrossDbStats {
+  CrossDbStats stats;
+  // 并集与交集只能由索引给出，有库文件变化过时整体重建
+  if (!ChangedSinceCrossIndex().empty()) {
+    const std::unique_lock lock(cross_index_.mutex);
+    cross_index_.ready = false;
+  }
+  if (!EnsureCrossIndex()) {
+    // 库太多、无法建索引时只给出各库数量
+    stats.databases = GetAllDbNames();
+    std::ranges::sort(stats.databases);
+    for (const std::string& name : stats.databases) {
+      try {
+        stats.counts.push_back(FanOutReaders(name, 1).front()->GetCount());
+      } catch (const std::exception&) {
+        stats.counts.push_back(0);
+      }
+    }
+    EnforceMemoryBudget();
+    return stats;
+  }
+
+  const std::shared_lock lock(cross_index_.mutex);
+  const CrossDbIndex& index = cross_index_.index;
+  std::vector<size_t> order(cross_index_.databases.size());
+  std::iota(order.begin(), order.end(), size_t{0});
+  std::ranges::sort(order, {}, [&](size_t bit) -> const std::string& {
+    return cross_index_.databases[bit];
+  });
+  CrossDbIndex::DbMask all = 0;
+  for (const size_t bit : order) {
+    stats.databases.push_back(cross_index_.databases[bit]);
+    stats.counts.push_back(index.CountAny(CrossDbIndex::DbMask{1} << bit));
+    all |= CrossDbIndex::DbMask{1} << bit;
+  }
+  stats.union_count = index.CountAny(all);
+  stats.shared_count = all == 0 ? 0 : index.CountAll(all);
+  stats.memory_bytes = index.MemoryBytes();
+  return stats;
+}
+
+auto DatabaseManager::ExistsInAllByFanOut(
+    std::span<const std::string_view> ids,
+    const std::vector<std::string>& names) -> CrossDbLookup {
+  CrossDbLookup lookup;
+  Concurrency::ThreadPool& pool = FanOutPool();
+
+  // 库少而批量大时，把同一个库的查询切成几段分给各自的连接，让所有核心都有活干
+  const size_t max_slices = std::max<size_t>(
+      1, pool.Size() / std::max<size_t>(1, names.size()));
+  const size_t slices_per_db =
+      std::clamp<size_t>(ids.size() / kMinIdsPerFanOutSlice, 1, max_slices);
+
+  struct Slice {
+    size_t db_index;
+    size_t begin;
+    std::future<std::vector<bool>> found;
+  };
+  std::vector<Slice> slices;
+  for (const std::string& name : names) {
+    std::vector<IIdRepository*> readers;
+    try {
+      readers = FanOutReaders(name, slices_per_db);
+    } catch (const std::exception& e) {
+      std::cerr << "跨库查询时打开数据库失败 [" << name << "]: " << e.what()
+                << std::endl;
+      continue;
+    }
+    const size_t db_index = lookup.databases.size();
+    lookup.databases.push_back(name);
+    for (size_t r = 0; r < readers.size() && !ids.empty(); ++r) {
+      const size_t begin = ids.size() * r / readers.size();
+      const size_t end = ids.size() * (r + 1) / readers.size();
+      const std::span<const std::string_view> part =
+          ids.subspan(begin, end - begin);
+      IIdRepository* reader = readers[r];
+      slices.push_back({db_index, begin, pool.Submit([reader, part] {
+                          return reader->ExistsMany(part);
+                        })});
+    }
+  }
+
+  // 先等全部任务结束再取结果，某个库出错时其余任务也不会再引用 ids
+  for (Slice& slice : slices) {
+    slice.found.wait();
+  }
+  lookup.contains.assign(lookup.databases.size(),
+                         std::vector<bool>(ids.size(), false));
+  for (Slice& slice : slices) {
+    const std::vector<bool> found = slice.found.get();
+    std::copy(found.begin(), found.end(),
+              lookup.contains[slice.db_index].begin() +
+                  static_cast<std::ptrdiff_t>(slice.begin));
+  }
+  EnforceMemoryBudget();
+  return lookup;
+}
+
+auto DatabaseManager::OpenReader(const std::string& db_name)
+    -> std::unique_ptr<IIdRepository> {
+  if (!DatabaseExists(db_name)) {
+    return nullptr;
+  }
+  return OpenStore(GetDbFilepath(db_name), cache_bytes_);
+}
+
 auto DatabaseManager::DatabaseExists(const std::string& db_name) const -> bool {
-  return std::filesystem::exists(GetDbFilepath(db_name));
+  return directory_.Contains(db_name);
 }
 
 auto DatabaseManager::GetCurrentDb() const -> IIdRepository* {
@@ -112,15 +744,27 @@ auto DatabaseManager::GetCurrentDbName() const -> const std::string& {
 }
 
 auto DatabaseManager::GetAllDbNames() const -> std::vector<std::string> {
-  std::vector<std::string> names;
-  if (!std::filesystem::exists(data_directory_path_)) {
-    return names;
-  }
-  for (const auto& entry :
-       std::filesystem::directory_iterator(data_directory_path_)) {
-    if (entry.is_regular_file() && entry.path().extension() == ".sqlite3") {
-      names.push_back(entry.path().filename().string());
+  return directory_.Names();
+}
+
+auto DatabaseManager::ListDatabases() -> std::vector<DatabaseInfo> {
+  std::vector<DatabaseInfo> listing = directory_.List();
+  for (DatabaseInfo& info : listing) {
+    // 已打开的库直接取实时数量；其余的临时打开一次，记下的数量在文件
+    // 变化前一直有效，之后的列举不再访问库文件
+    if (const auto it = dbs_.find(info.name); it != dbs_.end()) {
+      info.record_count = it->second->GetCount();
+      continue;
+    }
+    if (info.record_count) {
+      continue;
+    }
+    try {
+      info.record_count = ReadRecordCount(GetDbFilepath(info.name));
+      directory_.SetRecordCount(info.name, *info.record_count);
+    } catch (const std::exception& e) {
+      std::cerr << "读取数据库记录数失败: " << e.what() << std::endl;
     }
   }
-  return names;
+  return listing;
 }
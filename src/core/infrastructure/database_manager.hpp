@@ -4,35 +4,100 @@
 
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
+#include "core/concurrency/thread_pool.hpp"
+#include "core/data/cross_indexed_repository.hpp"
+#include "core/infrastructure/database_directory.hpp"
 #include "core/ports/i_database_catalog.hpp"
 
 class DatabaseManager : public IDatabaseCatalog {
  public:
+  static constexpr size_t kDefaultMemoryBudgetBytes = size_t{256} << 20;
+
   DatabaseManager();
+  // 使用指定的数据目录（不存在时创建），供嵌入到其他进程时使用
+  explicit DatabaseManager(std::string data_directory_path);
 
   // --- 数据库生命周期管理 ---
   void LoadDefaultDatabase() override;
   auto CreateDatabase(const std::string& db_name_raw) -> bool override;
   auto SwitchToDatabase(const std::string& db_name) -> bool override;
+  auto DeleteDatabase(const std::string& db_name) -> bool override;
   [[nodiscard]] auto DatabaseExists(const std::string& db_name) const
       -> bool override;
+  auto MigrateToPackedLayout(const std::string& db_name)
+      -> std::optional<LayoutMigrationReport> override;
+  auto SetQueryEngine(const std::string& db_name, QueryEngine engine)
+      -> bool override;
+  [[nodiscard]] auto GetQueryEngine(const std::string& db_name) const
+      -> QueryEngine override;
+  auto ExistsInAll(std::span<const std::string_view> ids)
+      -> CrossDbLookup override;
+  auto GetCrossDbStats() -> CrossDbStats override;
+  auto OpenReader(const std::string& db_name)
+      -> std::unique_ptr<IIdRepository> override;
+  void SetMemoryBudget(size_t budget_bytes) override;
+  [[nodiscard]] auto GetMemoryStats() const -> CatalogMemoryStats override;
 
   // --- 数据访问 ---
   [[nodiscard]] auto GetCurrentDb() const -> IIdRepository* override;
   [[nodiscard]] auto GetCurrentDbName() const -> const std::string& override;
   [[nodiscard]] auto GetAllDbNames() const -> std::vector<std::string> override;
+  auto ListDatabases() -> std::vector<DatabaseInfo> override;
+
+  // 库文件在跨库索引记下标记之后被其他连接改过的库（其他进程、或未经
+  // CrossIndexedRepository 的写入），按名称排序；这些库的结果不能取自索引
+  [[nodiscard]] auto ChangedSinceCrossIndex() const
+      -> std::vector<std::string>;
 
  private:
   void EnsureDataDirectoryExists();  // 确保数据目录存在
   [[nodiscard]] auto GetDbFilepath(const std::string& db_name) const
       -> std::string;  // 获取数据库文件的完整路径
+  // 按布局与引擎设置打开，并接入跨库索引
+  auto OpenRepository(const std::string& db_name)
+      -> std::unique_ptr<IIdRepository>;
+  // 放入连接池并记为最近使用，随后按预算淘汰其他库
+  void Admit(const std::string& db_name,
+             std::unique_ptr<IIdRepository> repository);
+  // 按页缓存上限与引擎内存估算一个连接的占用
+  [[nodiscard]] auto ChargeOf(const IIdRepository& repository,
+                              QueryEngine engine) const -> size_t;
+  [[nodiscard]] auto UsedBytes() const -> size_t;
+  // 超出预算时先关闭跨库查询的额外连接，再按 LRU 关闭当前库与 keep
+  // 以外的库。调用时不能有线程仍在使用池中的连接
+  void EnforceMemoryBudget(const std::string& keep = {});
+  // 跨库查询时某个库可用的连接，至多 wanted 个、各自独立使用：
+  // 库已在池中时第一个为池中的实例（内存类引擎只用它），
+  // 其余为按需额外打开、不进入连接池的 SQLite 连接
+  auto FanOutReaders(const std::string& db_name, size_t wanted)
+      -> std::vector<IIdRepository*>;
+  auto FanOutPool() -> Concurrency::ThreadPool&;
+  // 跨库索引缺失或目录下的库文件有增减时并行重建；
+  // 库数超过 CrossDbIndex::kMaxDatabases 时返回 false
+  auto EnsureCrossIndex() -> bool;
+  auto ExistsInAllByFanOut(std::span<const std::string_view> ids,
+                           const std::vector<std::string>& names)
+      -> CrossDbLookup;
 
+  SharedCrossDbIndex cross_index_;  // 须先于 dbs_ 构造、晚于其析构
   std::map<std::string, std::unique_ptr<IIdRepository>> dbs_;
+  std::map<std::string, QueryEngine> engines_;  // 未设置的库使用 kSqlite
+  std::map<std::string, uint64_t> last_used_;   // dbs_ 中各库最近使用的时刻
+  uint64_t use_clock_ = 0;
+  size_t memory_budget_bytes_ = 0;
+  size_t cache_bytes_ = 0;  // 新连接的页缓存上限，由预算推出
+  uint64_t evictions_ = 0;
   std::string current_db_name_;
   std::string data_directory_path_;  // 保存数据目录的路径
+  // 库文件清单的缓存；只读的查询也可能据事件刷新它
+  mutable DatabaseDirectory directory_;
+  std::map<std::string, std::vector<std::unique_ptr<IIdRepository>>>
+      fanout_readers_;
+  std::unique_ptr<Concurrency::ThreadPool> fanout_pool_;  // 首次跨库查询时创建
 };
 
 #endif
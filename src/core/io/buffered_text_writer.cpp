@@ -0,0 +1,72 @@
+// core/io/buffered_text_writer.cpp
+#include "core/io/buffered_text_writer.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+namespace IO {
+
+BufferedTextWriter::BufferedTextWriter(const std::string& filepath,
+                                       size_t buffer_bytes)
+    : filepath_(filepath), buffer_(buffer_bytes > 0 ? buffer_bytes : 1) {
+  file_ = std::fopen(filepath_.c_str(), "wb");
+  if (file_ == nullptr) {
+    throw std::runtime_error("无法打开文件: " + filepath_);
+  }
+  // 自己管理缓冲区，关闭 stdio 的二次缓冲
+  std::setvbuf(file_, nullptr, _IONBF, 0);
+}
+
+BufferedTextWriter::~BufferedTextWriter() {
+  if (file_ != nullptr) {
+    try {
+      FlushBuffer();
+    } catch (const std::exception&) {
+      // 析构中无法报告错误；需要确认结果的调用方应显式 Close
+    }
+    std::fclose(file_);
+  }
+}
+
+void BufferedTextWriter::WriteLine(std::string_view line) {
+  if (used_ + line.size() + 1 > buffer_.size()) {
+    FlushBuffer();
+  }
+  if (line.size() + 1 > buffer_.size()) {
+    // 超长行直接写出，不经过缓冲区
+    if (std::fwrite(line.data(), 1, line.size(), file_) != line.size() ||
+        std::fputc('\n', file_) == EOF) {
+      throw std::runtime_error("写入文件失败: " + filepath_);
+    }
+  } else {
+    std::memcpy(buffer_.data() + used_, line.data(), line.size());
+    used_ += line.size();
+    buffer_[used_++] = '\n';
+  }
+  ++lines_;
+}
+
+void BufferedTextWriter::Close() {
+  if (file_ == nullptr) {
+    return;
+  }
+  FlushBuffer();
+  const int result = std::fclose(file_);
+  file_ = nullptr;
+  if (result != 0) {
+    throw std::runtime_error("关闭文件失败: " + filepath_);
+  }
+}
+
+void BufferedTextWriter::FlushBuffer() {
+  if (used_ == 0) {
+    return;
+  }
+  const size_t pending = used_;
+  used_ = 0;
+  if (std::fwrite(buffer_.data(), 1, pending, file_) != pending) {
+    throw std::runtime_error("写入文件失败: " + filepath_);
+  }
+}
+
+}  // namespace IO
@@ -0,0 +1,43 @@
+// core/io/buffered_text_writer.hpp
+#ifndef BUFFERED_TEXT_WRITER_HPP
+#define BUFFERED_TEXT_WRITER_HPP
+
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace IO {
+// 按行写文本文件：行先拼进一块大缓冲区，满了才整块写盘，
+// 导出时的系统调用次数与行数无关，吞吐只受磁盘限制。
+class BufferedTextWriter {
+ public:
+  static constexpr size_t kDefaultBufferBytes = 4 * 1024 * 1024;
+
+  // 打开（截断）文件，失败时抛出 std::runtime_error
+  explicit BufferedTextWriter(const std::string& filepath,
+                              size_t buffer_bytes = kDefaultBufferBytes);
+  ~BufferedTextWriter();
+
+  BufferedTextWriter(const BufferedTextWriter&) = delete;
+  auto operator=(const BufferedTextWriter&) -> BufferedTextWriter& = delete;
+
+  // 写入一行并追加 '\n'；写盘失败时抛出 std::runtime_error
+  void WriteLine(std::string_view line);
+  // 写出剩余数据并关闭文件；析构时未调用则尽力写出但不报告错误
+  void Close();
+
+  [[nodiscard]] auto LinesWritten() const -> size_t { return lines_; }
+
+ private:
+  void FlushBuffer();
+
+  std::string filepath_;
+  std::FILE* file_ = nullptr;
+  std::vector<char> buffer_;
+  size_t used_ = 0;
+  size_t lines_ = 0;
+};
+}  // namespace IO
+
+#endif  // BUFFERED_TEXT_WRITER_HPP
@@ -0,0 +1,188 @@
+// core/io/external_id_sorter.cpp
+#include "core/io/external_id_sorter.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <queue>
+#include <random>
+#include <span>
+#include <system_error>
+#include <utility>
+
+#include "core/data/id_chunk_buffer.hpp"
+#include "core/io/buffered_text_writer.hpp"
+#include "core/io/memory_mapped_file.hpp"
+
+namespace IO {
+
+namespace {
+// 每个 ID 除自身字节外的内存开销：IdList 的结束位置与排序用的视图
+constexpr size_t kPerIdOverhead = sizeof(size_t) + sizeof(std::string_view);
+constexpr size_t kRunWriterBytes = 1024 * 1024;
+
+// 顺序读取一个有序段，每行一个 ID；视图在映射期间一直有效
+class RunCursor {
+ public:
+  explicit RunCursor(const std::string& filepath) : file_(filepath) {
+    file_.AdviseSequential();
+    pos_ = file_.Data();
+    end_ = pos_ + file_.Size();
+  }
+
+  // 前进到下一行，段读完时返回 false
+  auto Advance() -> bool {
+    if (pos_ == end_) {
+      return false;
+    }
+    const auto* newline = static_cast<const char*>(
+        std::memchr(pos_, '\n', static_cast<size_t>(end_ - pos_)));
+    const char* line_end = newline != nullptr ? newline : end_;
+    head_ = std::string_view(pos_, static_cast<size_t>(line_end - pos_));
+    pos_ = newline != nullptr ? newline + 1 : end_;
+    return true;
+  }
+  [[nodiscard]] auto Head() const -> std::string_view { return head_; }
+
+ private:
+  MemoryMappedFile file_;
+  const char* pos_ = nullptr;
+  const char* end_ = nullptr;
+  std::string_view head_;
+};
+
+auto RandomRunPrefix() -> std::string {
+  std::random_device device;
+  char prefix[40];
+  std::snprintf(prefix, sizeof(prefix), "avlib-sort-%08x%08x-", device(),
+                device());
+  return prefix;
+}
+}  // namespace
+
+ExternalIdSorter::ExternalIdSorter(size_t memory_budget_bytes,
+                                   std::filesystem::path temp_dir)
+    : memory_budget_bytes_(std::max<size_t>(memory_budget_bytes, 1)),
+      temp_dir_(temp_dir.empty() ? std::filesystem::temp_directory_path()
+                                 : std::move(temp_dir)),
+      run_prefix_(RandomRunPrefix()) {}
+
+ExternalIdSorter::~ExternalIdSorter() {
+  std::error_code ec;
+  for (const auto& run : runs_) {
+    std::filesystem::remove(run, ec);
+  }
+}
+
+void ExternalIdSorter::Add(std::string_view id) {
+  pending_.Append(id);
+  ++input_count_;
+  if (pending_.Bytes().size() + pending_.Size() * kPerIdOverhead >=
+      memory_budget_bytes_) {
+    SpillRun();
+  }
+}
+
+auto ExternalIdSorter::Merge(const IdChunkVisitor& sink) -> SortCounts {
+  SortCounts counts;
+  counts.input_count = input_count_;
+  if (runs_.empty()) {
+    EmitPending(sink, counts);
+    return counts;
+  }
+  if (!pending_.Empty()) {
+    SpillRun();
+  }
+  // 归并期间只需要各段的读取位置，先归还排序缓冲
+  pending_ = IdList();
+  sorted_ = std::vector<std::string_view>();
+  counts.run_count = runs_.size();
+  counts.duplicate_count = run_duplicates_;
+  MergeRuns(sink, counts);
+  return counts;
+}
+
+void ExternalIdSorter::SortPending() {
+  pending_.ViewsInto(sorted_);
+  std::ranges::sort(sorted_);
+  const auto duplicates = std::ranges::unique(sorted_);
+  run_duplicates_ += duplicates.size();
+  sorted_.erase(duplicates.begin(), duplicates.end());
+}
+
+void ExternalIdSorter::SpillRun() {
+  SortPending();
+  const std::filesystem::path run =
+      temp_dir_ / (run_prefix_ + std::to_string(runs_.size()) + ".run");
+  // 先登记再写，写到一半失败时析构也会删除它
+  runs_.push_back(run);
+  BufferedTextWriter writer(run.string(), kRunWriterBytes);
+  for (const std::string_view id : sorted_) {
+    writer.WriteLine(id);
+  }
+  writer.Close();
+  pending_.Clear();
+  sorted_.clear();
+}
+
+auto ExternalIdSorter::EmitPending(const IdChunkVisitor& sink,
+                                   SortCounts& counts) -> bool {
+  SortPending();
+  counts.duplicate_count = run_duplicates_;
+  const std::span<const std::string_view> sorted(sorted_);
+  for (size_t begin = 0; begin < sorted.size();
+       begin += IdChunkBuffer::kChunkIds) {
+    const auto chunk = sorted.subspan(
+        begin, std::min(IdChunkBuffer::kChunkIds, sorted.size() - begin));
+    counts.unique_count += chunk.size();
+    if (!sink(chunk)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+auto ExternalIdSorter::MergeRuns(const IdChunkVisitor& sink,
+                                 SortCounts& counts) -> bool {
+  std::vector<RunCursor> cursors;
+  cursors.reserve(runs_.size());
+  for (const auto& run : runs_) {
+    cursors.emplace_back(run.string());
+  }
+  // 以各段当前行为键的最小堆，k 路归并每输出一个 ID 为 O(log k)
+  auto greater = [&cursors](size_t a, size_t b) {
+    return cursors[a].Head() > cursors[b].Head();
+  };
+  std::priority_queue<size_t, std::vector<size_t>, decltype(greater)> heap(
+      greater);
+  for (size_t i = 0; i < cursors.size(); ++i) {
+    if (cursors[i].Advance()) {
+      heap.push(i);
+    }
+  }
+
+  IdChunkBuffer output(sink);
+  std::string_view last;  // 指向映射中的行，归并结束前一直有效
+  bool has_last = false;
+  while (!heap.empty()) {
+    const size_t i = heap.top();
+    heap.pop();
+    const std::string_view id = cursors[i].Head();
+    if (has_last && id == last) {
+      ++counts.duplicate_count;  // 各段内部已去重，这里是跨段的重复
+    } else {
+      last = id;
+      has_last = true;
+      ++counts.unique_count;
+      if (!output.Append(id)) {
+        return false;
+      }
+    }
+    if (cursors[i].Advance()) {
+      heap.push(i);
+    }
+  }
+  return output.Flush();
+}
+
+}  // namespace IO
@@ -0,0 +1,66 @@
+// core/io/external_id_sorter.hpp
+#ifndef EXTERNAL_ID_SORTER_HPP
+#define EXTERNAL_ID_SORTER_HPP
+
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "core/ports/i_id_repository.hpp"
+#include "core/utils/id_list.hpp"
+
+namespace IO {
+struct SortCounts {
+  size_t input_count = 0;      // Add 收到的 ID 数
+  size_t unique_count = 0;     // 交给 sink 的不重复 ID 数
+  size_t duplicate_count = 0;  // 被去掉的重复 ID 数
+  size_t run_count = 0;        // 写到磁盘的有序段数，0 表示全程在内存中
+};
+
+// 外部归并排序并去重。ID 先攒在内存中，超过 memory_budget_bytes 时排序、
+// 去重后写成一个有序的临时文件（一段）；Merge 对所有段做 k 路归并，
+// 按字节序、无重复地分块交给 sink。常驻内存约为 memory_budget_bytes，
+// 与输入规模无关；段文件经内存映射顺序读取，占用的是可回收的页缓存。
+// ID 中不得含有换行符（规范化后的 ID 满足这一点）。
+// temp_dir 应位于磁盘上：若系统临时目录是 tmpfs，段文件仍会占用内存。
+// 临时文件在析构时删除。
+class ExternalIdSorter {
+ public:
+  static constexpr size_t kDefaultMemoryBytes = 256 * 1024 * 1024;
+
+  // temp_dir 为空时使用系统临时目录
+  explicit ExternalIdSorter(size_t memory_budget_bytes = kDefaultMemoryBytes,
+                            std::filesystem::path temp_dir = {});
+  ~ExternalIdSorter();
+
+  ExternalIdSorter(const ExternalIdSorter&) = delete;
+  auto operator=(const ExternalIdSorter&) -> ExternalIdSorter& = delete;
+
+  // 写段失败时抛出 std::runtime_error
+  void Add(std::string_view id);
+  [[nodiscard]] auto InputCount() const -> size_t { return input_count_; }
+  // 只能调用一次；sink 返回 false 时提前结束，此时计数只含已交付的部分
+  auto Merge(const IdChunkVisitor& sink) -> SortCounts;
+
+ private:
+  // 把内存中的 ID 排序去重，结果写入 sorted_
+  void SortPending();
+  void SpillRun();
+  // 内存中的 ID 直接交给 sink，不经过磁盘
+  auto EmitPending(const IdChunkVisitor& sink, SortCounts& counts) -> bool;
+  auto MergeRuns(const IdChunkVisitor& sink, SortCounts& counts) -> bool;
+
+  size_t memory_budget_bytes_;
+  std::filesystem::path temp_dir_;
+  std::string run_prefix_;
+  IdList pending_;
+  std::vector<std::string_view> sorted_;  // 指向 pending_，排序时复用
+  std::vector<std::filesystem::path> runs_;
+  size_t input_count_ = 0;
+  size_t run_duplicates_ = 0;  // 排序各段时段内去掉的重复
+};
+}  // namespace IO
+
+#endif  // EXTERNAL_ID_SORTER_HPP
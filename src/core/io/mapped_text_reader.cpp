@@ -0,0 +1,65 @@
+// core/io/mapped_text_reader.cpp
+#include "core/io/mapped_text_reader.hpp"
+
+#include <cstring>
+#include <utility>
+
+namespace IO {
+
+MappedTextFile::MappedTextFile(const std::string& filepath) : file_(filepath) {
+  file_.AdviseSequential();
+  cursor_ = file_.Data();
+  end_ = cursor_ + file_.Size();
+}
+
+auto MappedTextFile::NextLine(std::string_view& line) -> bool {
+  if (cursor_ == end_) {
+    return false;
+  }
+  const auto* newline = static_cast<const char*>(
+      std::memchr(cursor_, '\n', static_cast<size_t>(end_ - cursor_)));
+  const char* line_end = (newline != nullptr) ? newline : end_;
+  line = std::string_view(cursor_, static_cast<size_t>(line_end - cursor_));
+  if (!line.empty() && line.back() == '\r') {
+    line.remove_suffix(1);
+  }
+  cursor_ = (newline != nullptr) ? newline + 1 : end_;
+  return true;
+}
+
+auto MappedTextReader::ReadAllLines(const std::string& filepath)
+    -> std::vector<std::string> {
+  MappedTextFile file(filepath);
+  std::vector<std::string> lines;
+  std::string_view line;
+  while (file.NextLine(line)) {
+    lines.emplace_back(line);
+  }
+  return lines;
+}
+
+void MappedTextReader::ReadLineBatches(const std::string& filepath,
+                                       size_t batch_lines,
+                                       const LineBatchSink& sink) {
+  // 每个批次共享映射的所有权，最后一个批次被释放时才解除映射
+  auto file = std::make_shared<MappedTextFile>(filepath);
+  LineBatch batch;
+  batch.lines.reserve(batch_lines);
+  std::string_view line;
+  while (file->NextLine(line)) {
+    batch.lines.push_back(line);
+    if (batch.lines.size() >= batch_lines) {
+      batch.owner = file;
+      if (!sink(std::exchange(batch, LineBatch{}))) {
+        return;
+      }
+      batch.lines.reserve(batch_lines);
+    }
+  }
+  if (!batch.lines.empty()) {
+    batch.owner = file;
+    sink(std::move(batch));
+  }
+}
+
+}  // namespace IO
@@ -0,0 +1,42 @@
+// core/io/mapped_text_reader.hpp
+#ifndef MAPPED_TEXT_READER_HPP
+#define MAPPED_TEXT_READER_HPP
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "core/io/memory_mapped_file.hpp"
+#include "core/ports/i_text_reader.hpp"
+
+namespace IO {
+// 映射后的文本文件：按 '\n' 切分（memchr 由 libc 向量化实现），
+// 行尾的 '\r' 被去掉；返回的视图在对象存活期间一直有效。
+class MappedTextFile {
+ public:
+  // 打开失败时抛出 std::runtime_error
+  explicit MappedTextFile(const std::string& filepath);
+
+  // 读取下一行，文件结束时返回 false
+  auto NextLine(std::string_view& line) -> bool;
+  [[nodiscard]] auto Size() const -> size_t { return file_.Size(); }
+
+ private:
+  MemoryMappedFile file_;
+  const char* cursor_ = nullptr;
+  const char* end_ = nullptr;
+};
+
+// 基于内存映射的 ITextReader：不逐行分配内存，
+// 流式读取交付的批次直接指向映射区，批次本身持有映射。
+class MappedTextReader : public ITextReader {
+ public:
+  auto ReadAllLines(const std::string& filepath)
+      -> std::vector<std::string> override;
+  void ReadLineBatches(const std::string& filepath, size_t batch_lines,
+                       const LineBatchSink& sink) override;
+};
+}  // namespace IO
+
+#endif  // MAPPED_TEXT_READER_HPP
@@ -0,0 +1,136 @@
+// core/io/memory_mapped_file.cpp
+#include "core/io/memory_mapped_file.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace IO {
+
+#ifdef _WIN32
+MemoryMappedFile::MemoryMappedFile(const std::string& filepath) {
+  HANDLE file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                            nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                            nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    throw std::runtime_error("无法打开文件: " + filepath);
+  }
+  LARGE_INTEGER file_size;
+  if (GetFileSizeEx(file, &file_size) == 0) {
+    CloseHandle(file);
+    throw std::runtime_error("无法获取文件大小: " + filepath);
+  }
+  file_handle_ = file;
+  size_ = static_cast<size_t>(file_size.QuadPart);
+  if (size_ == 0) {
+    return;
+  }
+  HANDLE mapping =
+      CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (mapping == nullptr) {
+    Unmap();
+    throw std::runtime_error("无法映射文件: " + filepath);
+  }
+  mapping_handle_ = mapping;
+  data_ = static_cast<const char*>(
+      MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+  if (data_ == nullptr) {
+    Unmap();
+    throw std::runtime_error("无法映射文件: " + filepath);
+  }
+}
+
+void MemoryMappedFile::AdviseSequential() const {}
+
+void MemoryMappedFile::Unmap() {
+  if (data_ != nullptr) {
+    UnmapViewOfFile(data_);
+  }
+  if (mapping_handle_ != nullptr) {
+    CloseHandle(static_cast<HANDLE>(mapping_handle_));
+  }
+  if (file_handle_ != nullptr) {
+    CloseHandle(static_cast<HANDLE>(file_handle_));
+  }
+  data_ = nullptr;
+  size_ = 0;
+  mapping_handle_ = nullptr;
+  file_handle_ = nullptr;
+}
+#else
+MemoryMappedFile::MemoryMappedFile(const std::string& filepath) {
+  const int fd = ::open(filepath.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    throw std::runtime_error("无法打开文件: " + filepath);
+  }
+  struct stat st {};
+  if (::fstat(fd, &st) != 0) {
+    ::close(fd);
+    throw std::runtime_error("无法获取文件大小: " + filepath);
+  }
+  size_ = static_cast<size_t>(st.st_size);
+  if (size_ == 0) {
+    ::close(fd);
+    return;
+  }
+  void* addr = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+  // 映射建立后即可关闭描述符，映射本身持有对文件的引用
+  ::close(fd);
+  if (addr == MAP_FAILED) {
+    size_ = 0;
+    throw std::runtime_error("无法映射文件: " + filepath);
+  }
+  data_ = static_cast<const char*>(addr);
+}
+
+void MemoryMappedFile::AdviseSequential() const {
+  if (data_ != nullptr) {
+    ::madvise(const_cast<char*>(data_), size_, MADV_SEQUENTIAL);
+  }
+}
+
+void MemoryMappedFile::Unmap() {
+  if (data_ != nullptr) {
+    ::munmap(const_cast<char*>(data_), size_);
+  }
+  data_ = nullptr;
+  size_ = 0;
+}
+#endif
+
+MemoryMappedFile::~MemoryMappedFile() { Unmap(); }
+
+MemoryMappedFile::MemoryMappedFile(MemoryMappedFile&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0))
+#ifdef _WIN32
+      ,
+      file_handle_(std::exchange(other.file_handle_, nullptr)),
+      mapping_handle_(std::exchange(other.mapping_handle_, nullptr))
+#endif
+{
+}
+
+auto MemoryMappedFile::operator=(MemoryMappedFile&& other) noexcept
+    -> MemoryMappedFile& {
+  if (this != &other) {
+    Unmap();
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+#ifdef _WIN32
+    file_handle_ = std::exchange(other.file_handle_, nullptr);
+    mapping_handle_ = std::exchange(other.mapping_handle_, nullptr);
+#endif
+  }
+  return *this;
+}
+
+}  // namespace IO
@@ -0,0 +1,40 @@
+// core/io/memory_mapped_file.hpp
+#ifndef MEMORY_MAPPED_FILE_HPP
+#define MEMORY_MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <string>
+
+namespace IO {
+// 只读内存映射文件。映射页由操作系统的页缓存提供，
+// 多个进程映射同一文件时共享同一份物理内存。
+class MemoryMappedFile {
+ public:
+  // 打开并映射整个文件，失败时抛出 std::runtime_error
+  explicit MemoryMappedFile(const std::string& filepath);
+  ~MemoryMappedFile();
+
+  MemoryMappedFile(const MemoryMappedFile&) = delete;
+  auto operator=(const MemoryMappedFile&) -> MemoryMappedFile& = delete;
+  MemoryMappedFile(MemoryMappedFile&& other) noexcept;
+  auto operator=(MemoryMappedFile&& other) noexcept -> MemoryMappedFile&;
+
+  [[nodiscard]] auto Data() const -> const char* { return data_; }
+  [[nodiscard]] auto Size() const -> size_t { return size_; }
+
+  // 提示内核将按顺序读取，提前预读并尽快回收读过的页；不支持的平台上无操作
+  void AdviseSequential() const;
+
+ private:
+  void Unmap();
+
+  const char* data_ = nullptr;
+  size_t size_ = 0;
+#ifdef _WIN32
+  void* file_handle_ = nullptr;
+  void* mapping_handle_ = nullptr;
+#endif
+};
+}  // namespace IO
+
+#endif  // MEMORY_MAPPED_FILE_HPP
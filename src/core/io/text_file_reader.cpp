@@ -2,7 +2,9 @@
 #include "core/io/text_file_reader.hpp"
 
 #include <fstream>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace IO {
@@ -27,4 +29,46 @@ auto TextFileReader::ReadAllLines(const std::string& filepath)
   return lines;
 }
 
+void TextFileReader::ReadLineBatches(const std::string& filepath,
+                                     size_t batch_lines,
+                                     const LineBatchSink& sink) {
+  std::ifstream file(filepath);
+  if (!file.is_open()) {
+    throw std::runtime_error("无法打开文件: " + filepath);
+  }
+
+  // 一批行拼在同一块缓冲区里，视图在交付前统一生成
+  auto buffer = std::make_shared<std::string>();
+  std::vector<size_t> ends;
+  ends.reserve(batch_lines);
+  auto deliver = [&]() -> bool {
+    LineBatch batch;
+    batch.lines.reserve(ends.size());
+    size_t begin = 0;
+    for (const size_t end : ends) {
+      batch.lines.emplace_back(buffer->data() + begin, end - begin);
+      begin = end;
+    }
+    batch.owner = buffer;
+    buffer = std::make_shared<std::string>();
+    ends.clear();
+    return sink(std::move(batch));
+  };
+
+  std::string line;
+  while (std::getline(file, line)) {
+    if (!line.empty() && line.back() == '\r') {
+      line.pop_back();
+    }
+    buffer->append(line);
+    ends.push_back(buffer->size());
+    if (ends.size() >= batch_lines && !deliver()) {
+      return;
+    }
+  }
+  if (!ends.empty()) {
+    deliver();
+  }
+}
+
 }  // namespace IO
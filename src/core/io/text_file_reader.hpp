@@ -13,6 +13,8 @@ class TextFileReader : public ITextReader {
   // 读取文件所有行，如果失败则抛出异常
   auto ReadAllLines(const std::string& filepath)
       -> std::vector<std::string> override;
+  void ReadLineBatches(const std::string& filepath, size_t batch_lines,
+                       const LineBatchSink& sink) override;
 };
 }  // namespace IO
 
@@ -2,12 +2,65 @@
 #ifndef I_DATABASE_CATALOG_HPP
 #define I_DATABASE_CATALOG_HPP
 
+#include <chrono>
+#include <cstdint>
 #include <memory>
+#include <optional>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "core/ports/i_id_repository.hpp"
 
+struct LayoutMigrationReport {
+  size_t migrated_count = 0;
+  uintmax_t bytes_before = 0;
+  uintmax_t bytes_after = 0;
+};
+
+// 跨库查询结果：databases 按库名排序，
+// contains[d][k] 表示第 d 个库是否包含第 k 个 ID
+struct CrossDbLookup {
+  std::vector<std::string> databases;
+  std::vector<std::vector<bool>> contains;
+};
+
+// 各库之间的重叠统计：databases 按库名排序，counts 与之一一对应
+struct CrossDbStats {
+  std::vector<std::string> databases;
+  std::vector<size_t> counts;
+  size_t union_count = 0;   // 至少在一个库中的 ID 数
+  size_t shared_count = 0;  // 在全部库中都存在的 ID 数
+  size_t memory_bytes = 0;  // 跨库索引的内存占用，未使用索引时为 0
+};
+
+// 已打开连接的内存占用：每个连接按页缓存上限与引擎自身的内存计入，
+// 超出预算时按最近最少使用的顺序关闭当前库以外的连接
+struct CatalogMemoryStats {
+  size_t budget_bytes = 0;
+  size_t used_bytes = 0;
+  size_t cache_bytes_per_connection = 0;
+  std::vector<std::string> open_databases;  // 最近使用的在前
+  size_t extra_connections = 0;  // 跨库查询额外打开的只读连接
+  uint64_t evictions = 0;
+};
+
+// 数据目录下一个库文件的概要，来自内存中的目录清单
+struct DatabaseInfo {
+  std::string name;
+  uintmax_t size_bytes = 0;
+  std::chrono::system_clock::time_point modified;
+  std::optional<size_t> record_count;  // 无法打开的库为空
+};
+
+// 每个数据库可独立选择的查询引擎
+enum class QueryEngine {
+  kSqlite,    // 直接查询 SQLite
+  kHashIndex,  // 全量载入内存哈希索引，SQLite 作为写穿的持久化存储
+  kSnapshot    // mmap 只读快照 (<库文件>.avidx)，库文件变化后打开时自动重新生成
+};
+
 class IDatabaseCatalog {
  public:
   virtual ~IDatabaseCatalog() = default;
@@ -15,13 +68,40 @@ class IDatabaseCatalog {
   virtual void LoadDefaultDatabase() = 0;
   virtual auto CreateDatabase(const std::string& db_name_raw) -> bool = 0;
   virtual auto SwitchToDatabase(const std::string& db_name) -> bool = 0;
+  // 关闭库的全部连接并删除库文件（可以是当前库，此后 GetCurrentDb 为空）；
+  // 文件删除失败时返回 false
+  virtual auto DeleteDatabase(const std::string& db_name) -> bool = 0;
   [[nodiscard]] virtual auto DatabaseExists(const std::string& db_name) const
       -> bool = 0;
+  // 将文本布局的库原地迁移为紧凑整数键布局，失败返回 std::nullopt
+  virtual auto MigrateToPackedLayout(const std::string& db_name)
+      -> std::optional<LayoutMigrationReport> = 0;
+  // 切换指定库的查询引擎；库已打开时立即按新引擎重新加载
+  virtual auto SetQueryEngine(const std::string& db_name, QueryEngine engine)
+      -> bool = 0;
+  [[nodiscard]] virtual auto GetQueryEngine(const std::string& db_name) const
+      -> QueryEngine = 0;
+  // 在数据目录下的全部库中查询已规范化的 ID，各库并发执行；
+  // 无法打开的库不出现在结果中
+  virtual auto ExistsInAll(std::span<const std::string_view> ids)
+      -> CrossDbLookup = 0;
+  virtual auto GetCrossDbStats() -> CrossDbStats = 0;
+  // 为后台流式读取另开一个独立连接，与当前打开的实例互不影响；
+  // 库不存在时返回 nullptr
+  virtual auto OpenReader(const std::string& db_name)
+      -> std::unique_ptr<IIdRepository> = 0;
+
+  // 设置全部连接共用的内存预算，同时决定新连接的页缓存大小与
+  // SQLite 的软堆上限；超出预算的连接立即按 LRU 关闭
+  virtual void SetMemoryBudget(size_t budget_bytes) = 0;
+  [[nodiscard]] virtual auto GetMemoryStats() const -> CatalogMemoryStats = 0;
 
   [[nodiscard]] virtual auto GetCurrentDb() const -> IIdRepository* = 0;
   [[nodiscard]] virtual auto GetCurrentDbName() const -> const std::string& = 0;
   [[nodiscard]] virtual auto GetAllDbNames() const
       -> std::vector<std::string> = 0;
+  // 按名称排序的库清单；记录数在文件变化后首次列举时重新读取
+  virtual auto ListDatabases() -> std::vector<DatabaseInfo> = 0;
 };
 
 #endif
@@ -3,9 +3,37 @@
 #define I_ID_REPOSITORY_HPP
 
 #include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
+// 负查询过滤器的状态与命中计数
+struct FilterStats {
+  bool loaded = false;
+  bool stale = false;  // 库被其他写入者修改过，过滤器已停用，需重建
+  double false_positive_rate = 0.0;
+  size_t memory_bytes = 0;
+  uint64_t lookups = 0;
+  uint64_t rejected = 0;  // 被过滤器直接判定不存在、未访问数据库的次数
+  uint64_t false_positives = 0;
+};
+
+// 状态输出用的引擎信息；内存类引擎额外报告加载耗时与内存占用
+struct RepositoryStats {
+  std::string engine;
+  double load_ms = 0.0;
+  size_t memory_bytes = 0;
+  FilterStats filter;
+};
+
+// ForEachId 的访问者：每次收到一块 ID，视图只在本次调用期间有效；
+// 返回 false 时提前结束遍历
+using IdChunkVisitor =
+    std::function<bool(std::span<const std::string_view> chunk)>;
+
 class IIdRepository {
  public:
   virtual ~IIdRepository() = default;
@@ -14,6 +42,27 @@ class IIdRepository {
   [[nodiscard]] virtual auto Exists(const std::string& id) const -> bool = 0;
   [[nodiscard]] virtual auto GetCount() const -> size_t = 0;
   [[nodiscard]] virtual auto GetAllIds() const -> std::vector<std::string> = 0;
+  // 流式遍历全部 ID（顺序不保证），不把整库物化到内存；
+  // 遍历完成返回 true，被访问者中止返回 false
+  virtual auto ForEachId(const IdChunkVisitor& visitor) const -> bool = 0;
+  // 同 ForEachId，但按字节序升序交付，供多路归并使用
+  virtual auto ForEachIdSorted(const IdChunkVisitor& visitor) const
+      -> bool = 0;
+
+  // Batch operations: one status per input ID, in input order.
+  // ExistsMany: true if the ID is stored.
+  // AddMany: true if the ID was newly inserted (repeats within the batch
+  // report false after their first occurrence).
+  [[nodiscard]] virtual auto ExistsMany(std::span<const std::string_view> ids) const
+      -> std::vector<bool> = 0;
+  virtual auto AddMany(std::span<const std::string_view> ids)
+      -> std::vector<bool> = 0;
+
+  [[nodiscard]] virtual auto GetStats() const -> RepositoryStats = 0;
+  // 按目标误判率重建负查询过滤器；不支持过滤器的实现返回 false
+  virtual auto RebuildFilter(double false_positive_rate) -> bool = 0;
+  // 只读实现（如快照）拒绝一切写入，调用方应先检查
+  [[nodiscard]] virtual auto IsReadOnly() const -> bool = 0;
 
   // Transaction control for bulk operations.
   virtual void BeginTransaction() = 0;
@@ -2,8 +2,11 @@
 #ifndef I_TEXT_READER_HPP
 #define I_TEXT_READER_HPP
 
+#include <functional>
+#include <memory>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <vector>
 
 class FileOpenException : public std::runtime_error {
@@ -12,11 +15,24 @@ class FileOpenException : public std::runtime_error {
       : std::runtime_error(message) {}
 };
 
+// 一批行：lines 指向 owner 持有的内存（映射的文件或读取缓冲区），
+// 只要还持有该批次，视图就一直有效，可以跨线程传递
+struct LineBatch {
+  std::vector<std::string_view> lines;
+  std::shared_ptr<const void> owner;
+};
+
 class ITextReader {
  public:
   virtual ~ITextReader() = default;
   virtual auto ReadAllLines(const std::string& filepath)
       -> std::vector<std::string> = 0;
+
+  // 流式读取：每攒满 batch_lines 行交给 sink 一次（最后一批可能不足），
+  // 行尾的 \r 已去掉。sink 返回 false 时停止读取。打开失败时抛出异常
+  using LineBatchSink = std::function<bool(LineBatch&& batch)>;
+  virtual void ReadLineBatches(const std::string& filepath, size_t batch_lines,
+                               const LineBatchSink& sink) = 0;
 };
 
 #endif
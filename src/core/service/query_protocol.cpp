@@ -0,0 +1,388 @@
+// core/service/query_protocol.cpp
+#include "core/service/query_protocol.hpp"
+
+#include <string>
+
+namespace Service {
+
+namespace {
+constexpr std::string_view kErrorRequestTooLarge = "request_too_large";
+constexpr std::string_view kErrorUnknownCommand = "unknown_command";
+constexpr std::string_view kErrorNoIds = "no_ids";
+
+auto OutcomeLabel(IdOutcome outcome) -> std::string_view {
+  switch (outcome) {
+    case IdOutcome::kSkipped:
+      return "skipped";
+    case IdOutcome::kInvalid:
+      return "invalid";
+    case IdOutcome::kAdded:
+      return "added";
+    case IdOutcome::kExists:
+      return "exists";
+    case IdOutcome::kFound:
+      return "found";
+    case IdOutcome::kNotFound:
+      return "missing";
+  }
+  return "invalid";
+}
+
+auto ReadUint32Le(std::string_view bytes) -> uint32_t {
+  uint32_t value = 0;
+  for (size_t i = 0; i < 4; ++i) {
+    value |= static_cast<uint32_t>(static_cast<unsigned char>(bytes[i]))
+             << (8 * i);
+  }
+  return value;
+}
+
+void AppendBinaryHeader(std::string& output, uint8_t status, size_t length) {
+  output.push_back(QueryProtocol::kBinaryMarker);
+  output.push_back(static_cast<char>(status));
+  for (size_t i = 0; i < 4; ++i) {
+    output.push_back(static_cast<char>((length >> (8 * i)) & 0xFF));
+  }
+}
+
+auto IsIdOpcode(QueryProtocol::Opcode opcode) -> bool {
+  return opcode == QueryProtocol::Opcode::kQuery ||
+         opcode == QueryProtocol::Opcode::kAdd;
+}
+
+void AppendStat(std::string& text, std::string_view key,
+                std::string_view value) {
+  if (!text.empty()) {
+    text += '\t';
+  }
+  text.append(key).append("=").append(value);
+}
+}  // namespace
+
+auto ServiceCounters::Snapshot() const -> ServiceStats {
+  ServiceStats stats;
+  stats.connections_accepted = connections_accepted.load();
+  stats.connections_open = connections_open.load();
+  stats.loop_wakeups = loop_wakeups.load();
+  stats.requests = requests.load();
+  stats.batches = batches.load();
+  stats.ids_queried = ids_queried.load();
+  stats.ids_added = ids_added.load();
+  stats.errors = errors.load();
+  stats.bytes_in = bytes_in.load();
+  stats.bytes_out = bytes_out.load();
+  return stats;
+}
+
+auto ErrorToken(ErrorCode error) -> std::string_view {
+  switch (error) {
+    case ErrorCode::kNone:
+      return "none";
+    case ErrorCode::kDbNotExist:
+      return "db_not_exist";
+    case ErrorCode::kDbCreateFailed:
+      return "db_create_failed";
+    case ErrorCode::kDbNameExists:
+      return "db_name_exists";
+    case ErrorCode::kDbNameEmpty:
+      return "db_name_empty";
+    case ErrorCode::kAddIdEmpty:
+    case ErrorCode::kQueryIdEmpty:
+      return kErrorNoIds;
+    case ErrorCode::kIdInvalid:
+      return "id_invalid";
+    case ErrorCode::kFileOpenFailed:
+      return "file_open_failed";
+    case ErrorCode::kFileEmpty:
+      return "file_empty";
+    case ErrorCode::kDbMigrateFailed:
+      return "db_migrate_failed";
+    case ErrorCode::kEngineSwitchFailed:
+      return "engine_switch_failed";
+    case ErrorCode::kFilterRebuildFailed:
+      return "filter_rebuild_failed";
+    case ErrorCode::kDbReadOnly:
+      return "db_read_only";
+    case ErrorCode::kFileWriteFailed:
+      return "file_write_failed";
+    case ErrorCode::kCrossQueryFailed:
+      return "cross_query_failed";
+    case ErrorCode::kSetInputsInvalid:
+      return "set_inputs_invalid";
+    case ErrorCode::kSetOperationFailed:
+      return "set_operation_failed";
+    case ErrorCode::kImportFailed:
+      return "import_failed";
+  }
+  return "unknown";
+}
+
+QueryProtocol::QueryProtocol(Application& app, ServiceCounters& counters)
+    : app_(app), counters_(counters) {}
+
+auto QueryProtocol::Consume(std::string_view input, std::string& output)
+    -> std::optional<size_t> {
+  requests_.clear();
+  ids_.clear();
+
+  size_t pos = 0;
+  bool too_large = false;
+  while (pos < input.size()) {
+    if (input[pos] == kBinaryMarker) {
+      if (input.size() - pos < kBinaryHeaderBytes) {
+        break;
+      }
+      const auto opcode = static_cast<Opcode>(input[pos + 1]);
+      const size_t length = ReadUint32Le(input.substr(pos + 2, 4));
+      if (length > kMaxFrameBytes) {
+        too_large = true;
+        break;
+      }
+      if (input.size() - pos - kBinaryHeaderBytes < length) {
+        break;
+      }
+      ParseFrame(opcode, input.substr(pos + kBinaryHeaderBytes, length));
+      pos += kBinaryHeaderBytes + length;
+      continue;
+    }
+
+    const size_t newline = input.find('\n', pos);
+    if (newline == std::string_view::npos) {
+      too_large = input.size() - pos > kMaxLineBytes;
+      break;
+    }
+    std::string_view line = input.substr(pos, newline - pos);
+    pos = newline + 1;
+    if (!line.empty() && line.back() == '\r') {
+      line.remove_suffix(1);
+    }
+    if (!line.empty()) {
+      ParseLine(line);
+    }
+  }
+
+  Execute(output);
+  if (too_large) {
+    counters_.errors.fetch_add(1, std::memory_order_relaxed);
+    output.append("error\t").append(kErrorRequestTooLarge).append("\n");
+    return std::nullopt;
+  }
+  return pos;
+}
+
+void QueryProtocol::ParseLine(std::string_view line) {
+  const size_t tab = line.find('\t');
+  const std::string_view verb = line.substr(0, tab);
+  const std::string_view rest = (tab == std::string_view::npos)
+                                    ? std::string_view{}
+                                    : line.substr(tab + 1);
+
+  Request request;
+  if (verb == "query" || verb == "add") {
+    request.opcode = (verb == "query") ? Opcode::kQuery : Opcode::kAdd;
+    request.first_id = ids_.size();
+    if (tab != std::string_view::npos) {
+      size_t begin = 0;
+      while (true) {
+        const size_t end = rest.find('\t', begin);
+        ids_.push_back(rest.substr(begin, end - begin));
+        if (end == std::string_view::npos) {
+          break;
+        }
+        begin = end + 1;
+      }
+    }
+    request.id_count = ids_.size() - request.first_id;
+  } else if (verb == "use") {
+    request.opcode = Opcode::kUse;
+    request.argument = rest;
+  } else if (verb == "stats") {
+    request.opcode = Opcode::kStats;
+  } else if (verb == "ping") {
+    request.opcode = Opcode::kPing;
+  } else {
+    request.malformed = true;
+  }
+  requests_.push_back(request);
+}
+
+void QueryProtocol::ParseFrame(Opcode opcode, std::string_view payload) {
+  Request request;
+  request.opcode = opcode;
+  request.binary = true;
+  switch (opcode) {
+    case Opcode::kQuery:
+    case Opcode::kAdd: {
+      request.first_id = ids_.size();
+      size_t begin = 0;
+      while (begin < payload.size()) {
+        size_t end = payload.find('\n', begin);
+        if (end == std::string_view::npos) {
+          end = payload.size();
+        }
+        std::string_view id = payload.substr(begin, end - begin);
+        if (!id.empty() && id.back() == '\r') {
+          id.remove_suffix(1);
+        }
+        ids_.push_back(id);
+        begin = end + 1;
+      }
+      request.id_count = ids_.size() - request.first_id;
+      break;
+    }
+    case Opcode::kUse:
+      request.argument = payload;
+      break;
+    case Opcode::kStats:
+    case Opcode::kPing:
+      break;
+    default:
+      request.malformed = true;
+      break;
+  }
+  requests_.push_back(request);
+}
+
+void QueryProtocol::Execute(std::string& output) {
+  counters_.requests.fetch_add(requests_.size(), std::memory_order_relaxed);
+  size_t i = 0;
+  while (i < requests_.size()) {
+    const Request& request = requests_[i];
+    if (request.malformed) {
+      WriteError(request, kErrorUnknownCommand, output);
+      ++i;
+      continue;
+    }
+    if (IsIdOpcode(request.opcode)) {
+      if (request.id_count == 0) {
+        WriteError(request, kErrorNoIds, output);
+        ++i;
+        continue;
+      }
+      // 相邻的查询帧合并成一批交给 Application，
+      // 逐个 ID 发送的流水线请求也能批量查库；添加仍逐帧执行，每帧一个事务
+      size_t end = i + 1;
+      if (request.opcode == Opcode::kQuery) {
+        while (end < requests_.size() && !requests_[end].malformed &&
+               requests_[end].opcode == Opcode::kQuery &&
+               requests_[end].id_count > 0) {
+          ++end;
+        }
+      }
+      ExecuteIdRun(i, end, output);
+      i = end;
+      continue;
+    }
+
+    switch (request.opcode) {
+      case Opcode::kUse:
+        app_.SetCurrentDatabase(std::string(request.argument));
+        if (app_.GetLastError() != ErrorCode::kNone) {
+          WriteError(request, ErrorToken(app_.GetLastError()), output);
+        } else {
+          WriteText(request, true, {}, output);
+        }
+        break;
+      case Opcode::kStats:
+        WriteText(request, true, StatsText(), output);
+        break;
+      default:
+        WriteText(request, true, {}, output);
+        break;
+    }
+    ++i;
+  }
+}
+
+void QueryProtocol::ExecuteIdRun(size_t begin, size_t end,
+                                 std::string& output) {
+  const size_t first_id = requests_[begin].first_id;
+  const Request& last = requests_[end - 1];
+  const std::span<const std::string_view> ids(
+      ids_.data() + first_id, last.first_id + last.id_count - first_id);
+
+  const bool is_query = requests_[begin].opcode == Opcode::kQuery;
+  counters_.batches.fetch_add(1, std::memory_order_relaxed);
+  (is_query ? counters_.ids_queried : counters_.ids_added)
+      .fetch_add(ids.size(), std::memory_order_relaxed);
+  if (is_query) {
+    app_.PerformQuery(ids);
+  } else {
+    app_.PerformAdd(ids);
+  }
+  const std::vector<IdOutcome>& outcomes =
+      is_query ? app_.GetLastQueryResult().outcomes
+               : app_.GetLastAddResult().outcomes;
+
+  const ErrorCode error = app_.GetLastError();
+  for (size_t i = begin; i < end; ++i) {
+    const Request& request = requests_[i];
+    if (error != ErrorCode::kNone) {
+      WriteError(request, ErrorToken(error), output);
+    } else {
+      WriteOutcomes(request,
+                    std::span(outcomes).subspan(request.first_id - first_id,
+                                                request.id_count),
+                    output);
+    }
+  }
+}
+
+void QueryProtocol::WriteOutcomes(const Request& request,
+                                  std::span<const IdOutcome> outcomes,
+                                  std::string& output) {
+  if (request.binary) {
+    AppendBinaryHeader(output, 0, outcomes.size());
+    for (const IdOutcome outcome : outcomes) {
+      output.push_back(static_cast<char>(outcome));
+    }
+    return;
+  }
+  output.append("ok");
+  for (const IdOutcome outcome : outcomes) {
+    output.append("\t").append(OutcomeLabel(outcome));
+  }
+  output.push_back('\n');
+}
+
+void QueryProtocol::WriteText(const Request& request, bool ok,
+                              std::string_view text, std::string& output) {
+  if (request.binary) {
+    AppendBinaryHeader(output, ok ? 0 : 1, text.size());
+    output.append(text);
+    return;
+  }
+  output.append(ok ? "ok" : "error");
+  if (!text.empty()) {
+    output.append("\t").append(text);
+  }
+  output.push_back('\n');
+}
+
+void QueryProtocol::WriteError(const Request& request, std::string_view reason,
+                               std::string& output) {
+  counters_.errors.fetch_add(1, std::memory_order_relaxed);
+  WriteText(request, false, reason, output);
+}
+
+auto QueryProtocol::StatsText() const -> std::string {
+  const RepositoryStats repo = app_.GetRepositoryStats();
+  const ServiceStats service = counters_.Snapshot();
+  std::string text;
+  AppendStat(text, "db", app_.GetCurrentDbName());
+  AppendStat(text, "records", std::to_string(app_.GetTotalRecords()));
+  AppendStat(text, "engine", repo.engine);
+  AppendStat(text, "connections", std::to_string(service.connections_open));
+  AppendStat(text, "accepted", std::to_string(service.connections_accepted));
+  AppendStat(text, "wakeups", std::to_string(service.loop_wakeups));
+  AppendStat(text, "requests", std::to_string(service.requests));
+  AppendStat(text, "batches", std::to_string(service.batches));
+  AppendStat(text, "ids_queried", std::to_string(service.ids_queried));
+  AppendStat(text, "ids_added", std::to_string(service.ids_added));
+  AppendStat(text, "errors", std::to_string(service.errors));
+  AppendStat(text, "bytes_in", std::to_string(service.bytes_in));
+  AppendStat(text, "bytes_out", std::to_string(service.bytes_out));
+  return text;
+}
+
+}  // namespace Service
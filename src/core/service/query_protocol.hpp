@@ -0,0 +1,122 @@
+// core/service/query_protocol.hpp
+#ifndef QUERY_PROTOCOL_HPP
+#define QUERY_PROTOCOL_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "core/app/application.hpp"
+
+namespace Service {
+
+// 常驻服务的请求计数，可在其他线程读取快照
+struct ServiceStats {
+  uint64_t connections_accepted = 0;
+  uint64_t connections_open = 0;
+  uint64_t loop_wakeups = 0;  // 事件循环被唤醒的次数
+  uint64_t requests = 0;      // 请求帧数（文本行或二进制帧）
+  uint64_t batches = 0;  // 实际交给 Application 的批次数，连续的查询帧会合并
+  uint64_t ids_queried = 0;
+  uint64_t ids_added = 0;
+  uint64_t errors = 0;  // 协议错误或执行失败的请求
+  uint64_t bytes_in = 0;
+  uint64_t bytes_out = 0;
+};
+
+class ServiceCounters {
+ public:
+  std::atomic<uint64_t> connections_accepted{0};
+  std::atomic<uint64_t> connections_open{0};
+  std::atomic<uint64_t> loop_wakeups{0};
+  std::atomic<uint64_t> requests{0};
+  std::atomic<uint64_t> batches{0};
+  std::atomic<uint64_t> ids_queried{0};
+  std::atomic<uint64_t> ids_added{0};
+  std::atomic<uint64_t> errors{0};
+  std::atomic<uint64_t> bytes_in{0};
+  std::atomic<uint64_t> bytes_out{0};
+
+  [[nodiscard]] auto Snapshot() const -> ServiceStats;
+};
+
+// 流水线式请求协议。一个连接上可以连续发送任意多个请求，响应按请求顺序返回。
+// 两种帧可以混用：
+//
+// 文本行：字段以制表符分隔，以 \n 结尾（\r\n 亦可）
+//   query\t<ID>\t<ID>...   -> ok\t<found|missing|invalid>...
+//   add\t<ID>\t<ID>...     -> ok\t<added|exists|invalid>...
+//   use\t<库名>            -> ok
+//   stats                  -> ok\t<键>=<值>...
+//   ping                   -> ok
+//   空字段对应 skipped；出错时返回 error\t<原因>
+//
+// 二进制帧：0x00, 操作码(1 字节), 负载长度(4 字节小端), 负载
+//   查询/添加的负载为以 \n 分隔的 ID；其余操作的负载为参数文本。
+//   响应：0x00, 状态(0 成功/1 失败), 负载长度(4 字节小端), 负载；
+//   查询/添加成功时负载为每个 ID 一个字节的 IdOutcome 值，
+//   其余情况为与文本响应相同格式的文本（不含 ok/error 前缀）。
+class QueryProtocol {
+ public:
+  static constexpr char kBinaryMarker = '\0';
+  static constexpr size_t kBinaryHeaderBytes = 6;
+  static constexpr size_t kMaxLineBytes = size_t{1} << 20;
+  static constexpr size_t kMaxFrameBytes = size_t{16} << 20;
+
+  enum class Opcode : uint8_t {
+    kQuery = 1,
+    kAdd = 2,
+    kUse = 3,
+    kStats = 4,
+    kPing = 5
+  };
+
+  QueryProtocol(Application& app, ServiceCounters& counters);
+
+  // 处理 input 中所有完整的请求，响应追加到 output，返回已消费的字节数；
+  // 末尾不完整的请求留待下次。请求超长等无法恢复的错误返回 std::nullopt，
+  // 调用方应在写出 output 后断开连接
+  auto Consume(std::string_view input, std::string& output)
+      -> std::optional<size_t>;
+
+ private:
+  struct Request {
+    Opcode opcode = Opcode::kPing;
+    bool binary = false;
+    bool malformed = false;
+    size_t first_id = 0;  // ids_ 中的区间
+    size_t id_count = 0;
+    std::string_view argument;
+  };
+
+  void ParseLine(std::string_view line);
+  void ParseFrame(Opcode opcode, std::string_view payload);
+  void Execute(std::string& output);
+  void ExecuteIdRun(size_t begin, size_t end, std::string& output);
+  void WriteOutcomes(const Request& request,
+                     std::span<const IdOutcome> outcomes,
+                     std::string& output);
+  void WriteText(const Request& request, bool ok, std::string_view text,
+                 std::string& output);
+  void WriteError(const Request& request, std::string_view reason,
+                  std::string& output);
+  [[nodiscard]] auto StatsText() const -> std::string;
+
+  Application& app_;
+  ServiceCounters& counters_;
+  // 跨调用复用
+  std::vector<Request> requests_;
+  std::vector<std::string_view> ids_;
+};
+
+// Application 错误码对应的稳定英文标识，供协议响应使用
+[[nodiscard]] auto ErrorToken(ErrorCode error) -> std::string_view;
+
+}  // namespace Service
+
+#endif  // QUERY_PROTOCOL_HPP
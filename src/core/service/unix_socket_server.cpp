@@ -0,0 +1,311 @@
+// core/service/unix_socket_server.cpp
+#include "core/service/unix_socket_server.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace Service {
+
+#ifdef __linux__
+namespace {
+constexpr size_t kReadChunkBytes = 64 * 1024;
+// 单次唤醒最多从一个连接读入的字节数，避免一个连接饿死其他连接
+constexpr size_t kMaxReadPerWakeup = 1024 * 1024;
+// 待写出的响应超过该值时暂停读取该连接，为客户端提供背压
+constexpr size_t kMaxPendingOutput = 8 * 1024 * 1024;
+constexpr int kMaxEvents = 64;
+
+auto SystemError(const std::string& what) -> std::runtime_error {
+  return std::runtime_error(what + ": " + std::strerror(errno));
+}
+}  // namespace
+
+UnixSocketServer::UnixSocketServer(Application& app, std::string socket_path)
+    : socket_path_(std::move(socket_path)), protocol_(app, counters_) {
+  stop_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (stop_fd_ < 0) {
+    throw SystemError("无法创建事件通知句柄");
+  }
+}
+
+UnixSocketServer::~UnixSocketServer() {
+  for (auto& [fd, connection] : connections_) {
+    close(fd);
+  }
+  if (listen_fd_ >= 0) {
+    close(listen_fd_);
+    unlink(socket_path_.c_str());
+  }
+  if (epoll_fd_ >= 0) {
+    close(epoll_fd_);
+  }
+  close(stop_fd_);
+}
+
+auto UnixSocketServer::IsSupported() -> bool { return true; }
+
+void UnixSocketServer::Listen() {
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  if (socket_path_.empty() || socket_path_.size() >= sizeof(address.sun_path)) {
+    throw std::runtime_error("套接字路径为空或过长: " + socket_path_);
+  }
+  std::memcpy(address.sun_path, socket_path_.c_str(), socket_path_.size() + 1);
+
+  listen_fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (listen_fd_ < 0) {
+    throw SystemError("无法创建套接字");
+  }
+  // 只替换残留的套接字文件，不误删普通文件
+  struct stat existing{};
+  if (lstat(socket_path_.c_str(), &existing) == 0 &&
+      S_ISSOCK(existing.st_mode)) {
+    unlink(socket_path_.c_str());
+  }
+  if (bind(listen_fd_, reinterpret_cast<const sockaddr*>(&address),
+           sizeof(address)) != 0) {
+    const std::runtime_error error =
+        SystemError("无法绑定套接字 " + socket_path_);
+    close(listen_fd_);
+    listen_fd_ = -1;
+    throw error;
+  }
+  // 库内容属于个人数据，只允许当前用户连接
+  chmod(socket_path_.c_str(), S_IRUSR | S_IWUSR);
+  if (listen(listen_fd_, SOMAXCONN) != 0) {
+    throw SystemError("无法监听套接字 " + socket_path_);
+  }
+
+  epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+  if (epoll_fd_ < 0) {
+    throw SystemError("无法创建 epoll 实例");
+  }
+  for (const int fd : {listen_fd_, stop_fd_}) {
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) != 0) {
+      throw SystemError("无法注册 epoll 事件");
+    }
+  }
+}
+
+void UnixSocketServer::Run() {
+  if (epoll_fd_ < 0) {
+    throw std::runtime_error("服务尚未开始监听");
+  }
+  std::array<epoll_event, kMaxEvents> events{};
+  bool running = true;
+  while (running) {
+    const int ready = epoll_wait(epoll_fd_, events.data(), kMaxEvents, -1);
+    if (ready < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw SystemError("epoll_wait 失败");
+    }
+    counters_.loop_wakeups.fetch_add(1, std::memory_order_relaxed);
+
+    for (int i = 0; i < ready; ++i) {
+      const int fd = events[i].data.fd;
+      const uint32_t flags = events[i].events;
+      if (fd == stop_fd_) {
+        uint64_t value = 0;
+        (void)read(stop_fd_, &value, sizeof(value));
+        running = false;
+        continue;
+      }
+      if (fd == listen_fd_) {
+        AcceptConnections();
+        continue;
+      }
+      const auto it = connections_.find(fd);
+      if (it == connections_.end()) {
+        continue;
+      }
+      Connection& connection = *it->second;
+      if ((flags & EPOLLERR) != 0) {
+        CloseConnection(fd);
+        continue;
+      }
+      if ((flags & (EPOLLIN | EPOLLHUP)) != 0) {
+        HandleReadable(connection);
+      }
+      FlushOutput(connection);
+      if (connection.closing &&
+          connection.output_pos == connection.output.size()) {
+        CloseConnection(fd);
+      } else {
+        UpdateInterest(connection);
+      }
+    }
+  }
+
+  while (!connections_.empty()) {
+    CloseConnection(connections_.begin()->first);
+  }
+}
+
+void UnixSocketServer::Stop() noexcept {
+  const uint64_t one = 1;
+  (void)write(stop_fd_, &one, sizeof(one));
+}
+
+void UnixSocketServer::AcceptConnections() {
+  while (true) {
+    const int fd = accept4(listen_fd_, nullptr, nullptr,
+                           SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0) {
+      // EAGAIN 表示已取完；其他错误（如文件描述符耗尽）留到下次唤醒再试
+      return;
+    }
+    auto connection = std::make_unique<Connection>();
+    connection->fd = fd;
+    connection->events = EPOLLIN;
+    epoll_event event{};
+    event.events = connection->events;
+    event.data.fd = fd;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) != 0) {
+      close(fd);
+      continue;
+    }
+    connections_.emplace(fd, std::move(connection));
+    counters_.connections_accepted.fetch_add(1, std::memory_order_relaxed);
+    counters_.connections_open.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void UnixSocketServer::HandleReadable(Connection& connection) {
+  if (connection.input_pos > 0) {
+    connection.input.erase(0, connection.input_pos);
+    connection.input_pos = 0;
+  }
+
+  size_t total_read = 0;
+  while (total_read < kMaxReadPerWakeup) {
+    const size_t old_size = connection.input.size();
+    connection.input.resize(old_size + kReadChunkBytes);
+    const ssize_t received = recv(
+        connection.fd, connection.input.data() + old_size, kReadChunkBytes, 0);
+    connection.input.resize(old_size + (received > 0 ? received : 0));
+    if (received > 0) {
+      total_read += static_cast<size_t>(received);
+      continue;
+    }
+    if (received < 0 && errno == EINTR) {
+      continue;
+    }
+    if (received == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+      connection.closing = true;
+    }
+    break;
+  }
+  counters_.bytes_in.fetch_add(total_read, std::memory_order_relaxed);
+
+  const std::optional<size_t> consumed =
+      protocol_.Consume(connection.input, connection.output);
+  if (!consumed) {
+    connection.closing = true;
+    connection.input.clear();
+    return;
+  }
+  connection.input_pos = *consumed;
+}
+
+void UnixSocketServer::FlushOutput(Connection& connection) {
+  while (connection.output_pos < connection.output.size()) {
+    const ssize_t sent = send(connection.fd,
+                              connection.output.data() + connection.output_pos,
+                              connection.output.size() - connection.output_pos,
+                              MSG_NOSIGNAL | MSG_DONTWAIT);
+    if (sent > 0) {
+      connection.output_pos += static_cast<size_t>(sent);
+      counters_.bytes_out.fetch_add(static_cast<uint64_t>(sent),
+                                    std::memory_order_relaxed);
+      continue;
+    }
+    if (sent < 0 && errno == EINTR) {
+      continue;
+    }
+    if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      return;
+    }
+    // 对端已断开，丢弃未写出的响应
+    connection.closing = true;
+    connection.output_pos = connection.output.size();
+    break;
+  }
+  connection.output.clear();
+  connection.output_pos = 0;
+}
+
+void UnixSocketServer::UpdateInterest(Connection& connection) {
+  const size_t pending = connection.output.size() - connection.output_pos;
+  uint32_t wanted = 0;
+  if (!connection.closing && pending < kMaxPendingOutput) {
+    wanted |= EPOLLIN;
+  }
+  if (pending > 0) {
+    wanted |= EPOLLOUT;
+  }
+  if (wanted == connection.events) {
+    return;
+  }
+  epoll_event event{};
+  event.events = wanted;
+  event.data.fd = connection.fd;
+  if (epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, connection.fd, &event) == 0) {
+    connection.events = wanted;
+  }
+}
+
+void UnixSocketServer::CloseConnection(int fd) {
+  epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+  close(fd);
+  connections_.erase(fd);
+  counters_.connections_open.fetch_sub(1, std::memory_order_relaxed);
+}
+
+#else  // !__linux__
+
+UnixSocketServer::UnixSocketServer(Application& app, std::string socket_path)
+    : socket_path_(std::move(socket_path)), protocol_(app, counters_) {}
+
+UnixSocketServer::~UnixSocketServer() = default;
+
+auto UnixSocketServer::IsSupported() -> bool { return false; }
+
+void UnixSocketServer::Listen() {
+  throw std::runtime_error("当前平台不支持常驻服务模式");
+}
+
+void UnixSocketServer::Run() {
+  throw std::runtime_error("当前平台不支持常驻服务模式");
+}
+
+void UnixSocketServer::Stop() noexcept {}
+
+#endif  // __linux__
+
+auto UnixSocketServer::GetStats() const -> ServiceStats {
+  return counters_.Snapshot();
+}
+
+auto UnixSocketServer::GetSocketPath() const -> const std::string& {
+  return socket_path_;
+}
+
+}  // namespace Service
@@ -0,0 +1,67 @@
+// core/service/unix_socket_server.hpp
+#ifndef UNIX_SOCKET_SERVER_HPP
+#define UNIX_SOCKET_SERVER_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "core/app/application.hpp"
+#include "core/service/query_protocol.hpp"
+
+namespace Service {
+
+// 在 Unix 域套接字上常驻提供 QueryProtocol 服务。
+// 单线程 epoll 事件循环，Application 与已打开的库在进程内常驻；
+// 每次唤醒处理连接缓冲区中的全部完整请求，响应合并后一次写出。
+// 仅 Linux 可用，其他平台上 Listen 抛出 std::runtime_error。
+class UnixSocketServer {
+ public:
+  UnixSocketServer(Application& app, std::string socket_path);
+  ~UnixSocketServer();
+
+  UnixSocketServer(const UnixSocketServer&) = delete;
+  auto operator=(const UnixSocketServer&) -> UnixSocketServer& = delete;
+
+  [[nodiscard]] static auto IsSupported() -> bool;
+
+  // 绑定并开始监听；路径上残留的旧套接字文件会被替换。失败时抛出异常
+  void Listen();
+  // 运行事件循环直到 Stop 被调用
+  void Run();
+  // 线程安全，也可在信号处理函数中调用
+  void Stop() noexcept;
+
+  [[nodiscard]] auto GetStats() const -> ServiceStats;
+  [[nodiscard]] auto GetSocketPath() const -> const std::string&;
+
+ private:
+  struct Connection {
+    int fd = -1;
+    std::string input;
+    size_t input_pos = 0;
+    std::string output;
+    size_t output_pos = 0;
+    uint32_t events = 0;  // 当前向 epoll 登记的事件
+    bool closing = false;  // 对端已关闭或协议错误，写完剩余响应后断开
+  };
+
+  void AcceptConnections();
+  void HandleReadable(Connection& connection);
+  void FlushOutput(Connection& connection);
+  void UpdateInterest(Connection& connection);
+  void CloseConnection(int fd);
+
+  std::string socket_path_;
+  ServiceCounters counters_;
+  QueryProtocol protocol_;
+  int listen_fd_ = -1;
+  int epoll_fd_ = -1;
+  int stop_fd_ = -1;
+  std::unordered_map<int, std::unique_ptr<Connection>> connections_;
+};
+
+}  // namespace Service
+
+#endif  // UNIX_SOCKET_SERVER_HPP
@@ -0,0 +1,265 @@
+// core/utils/batch_validator.cpp
+#include "core/utils/batch_validator.hpp"
+
+#include <bit>
+#include <cstring>
+
+#include "core/utils/validator.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || \
+    defined(_M_IX86)
+#define AVLIB_BATCH_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define AVLIB_TARGET(isa) __attribute__((target(isa)))
+#else
+#define AVLIB_TARGET(isa)
+#endif
+
+namespace Validator {
+
+namespace {
+// 合法 ID 的形状：字母段 [0, alpha_end) + 分隔段 + 数字段 [digit_begin, len)
+struct IdShape {
+  uint32_t alpha_end = 0;
+  uint32_t digit_begin = 0;
+};
+
+// 由四类字符的位掩码判断是否符合通用文法：
+// 字母段必须从第 0 位开始连续，数字段必须连续到结尾，
+// 中间只能是空格/制表符且最多一个 '-'，不允许出现其他字符。
+// 不符合时交给 DFA 检查各厂商的专有格式。
+auto ShapeFromMasks(uint64_t alpha, uint64_t digit, uint64_t space,
+                    uint64_t hyphen, size_t len, IdShape& shape) -> bool {
+  if (len == 0) {
+    return false;
+  }
+  const uint64_t all = (len == 64) ? ~0ULL : ((1ULL << len) - 1);
+  alpha &= all;
+  digit &= all;
+  space &= all;
+  hyphen &= all;
+  if ((alpha | digit | space | hyphen) != all || (alpha & 1) == 0 ||
+      digit == 0 || (hyphen & (hyphen - 1)) != 0) {
+    return false;
+  }
+  const int alpha_end = std::countr_one(alpha);
+  if ((alpha >> alpha_end) != 0) {
+    return false;
+  }
+  const int digit_begin = std::countr_zero(digit);
+  if ((digit | ((1ULL << digit_begin) - 1)) != all) {
+    return false;
+  }
+  shape.alpha_end = static_cast<uint32_t>(alpha_end);
+  shape.digit_begin = static_cast<uint32_t>(digit_begin);
+  return true;
+}
+
+void AppendCanonical(std::string_view line, const IdShape& shape,
+                     uint32_t source, CanonicalIdBuffer& out) {
+  std::string& bytes = out.ids.Bytes();
+  bytes.append(line.data(), shape.alpha_end);
+  bytes.append(line.data() + shape.digit_begin,
+               line.size() - shape.digit_begin);
+  out.ids.EndId();
+  out.sources.push_back(source);
+}
+
+void ScalarOne(std::string_view line, uint32_t source, CanonicalIdBuffer& out) {
+  if (AppendCanonicalId(line, out.ids.Bytes()) == IdVendor::kNone) {
+    out.invalid_count++;
+    return;
+  }
+  out.ids.EndId();
+  out.sources.push_back(source);
+}
+
+void ScalarBatch(std::span<const std::string_view> lines,
+                 CanonicalIdBuffer& out) {
+  for (size_t i = 0; i < lines.size(); ++i) {
+    ScalarOne(lines[i], static_cast<uint32_t>(i), out);
+  }
+}
+
+#ifdef AVLIB_BATCH_X86
+// 读取 width 字节；行末附近若会跨入下一页，先拷到栈上再读，避免越界访问
+template <size_t Width>
+auto SafeSource(std::string_view line, char (&scratch)[Width]) -> const char* {
+  const auto address = reinterpret_cast<uintptr_t>(line.data());
+  if ((address & 4095) <= 4096 - Width) {
+    return line.data();
+  }
+  std::memset(scratch, 0, Width);
+  std::memcpy(scratch, line.data(), line.size());
+  return scratch;
+}
+
+AVLIB_TARGET("sse2")
+auto InRange16(__m128i v, char lo, char hi) -> __m128i {
+  const __m128i low = _mm_set1_epi8(lo);
+  const __m128i high = _mm_set1_epi8(hi);
+  return _mm_and_si128(_mm_cmpeq_epi8(_mm_max_epu8(v, low), v),
+                       _mm_cmpeq_epi8(_mm_min_epu8(v, high), v));
+}
+
+AVLIB_TARGET("sse2")
+void Sse2Batch(std::span<const std::string_view> lines,
+               CanonicalIdBuffer& out) {
+  constexpr size_t kWidth = 16;
+  char scratch[kWidth];
+  for (size_t i = 0; i < lines.size(); ++i) {
+    const std::string_view line = lines[i];
+    const auto source = static_cast<uint32_t>(i);
+    if (line.empty() || line.size() > kWidth) {
+      ScalarOne(line, source, out);
+      continue;
+    }
+    const __m128i v = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(SafeSource(line, scratch)));
+    const __m128i lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+    const auto alpha = static_cast<uint32_t>(
+        _mm_movemask_epi8(InRange16(lower, 'a', 'z')));
+    const auto digit =
+        static_cast<uint32_t>(_mm_movemask_epi8(InRange16(v, '0', '9')));
+    const auto space = static_cast<uint32_t>(_mm_movemask_epi8(
+        _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')),
+                     _mm_cmpeq_epi8(v, _mm_set1_epi8('\t')))));
+    const auto hyphen = static_cast<uint32_t>(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('-'))));
+    IdShape shape;
+    if (ShapeFromMasks(alpha, digit, space, hyphen, line.size(), shape)) {
+      AppendCanonical(line, shape, source, out);
+    } else {
+      ScalarOne(line, source, out);
+    }
+  }
+}
+
+AVLIB_TARGET("avx2")
+auto InRange32(__m256i v, char lo, char hi) -> __m256i {
+  const __m256i low = _mm256_set1_epi8(lo);
+  const __m256i high = _mm256_set1_epi8(hi);
+  return _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_max_epu8(v, low), v),
+                          _mm256_cmpeq_epi8(_mm256_min_epu8(v, high), v));
+}
+
+AVLIB_TARGET("avx2")
+void Avx2Batch(std::span<const std::string_view> lines,
+               CanonicalIdBuffer& out) {
+  constexpr size_t kWidth = 32;
+  char scratch[kWidth];
+  for (size_t i = 0; i < lines.size(); ++i) {
+    const std::string_view line = lines[i];
+    const auto source = static_cast<uint32_t>(i);
+    if (line.empty() || line.size() > kWidth) {
+      ScalarOne(line, source, out);
+      continue;
+    }
+    const __m256i v = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(SafeSource(line, scratch)));
+    const __m256i lower = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+    const auto alpha = static_cast<uint32_t>(
+        _mm256_movemask_epi8(InRange32(lower, 'a', 'z')));
+    const auto digit =
+        static_cast<uint32_t>(_mm256_movemask_epi8(InRange32(v, '0', '9')));
+    const auto space = static_cast<uint32_t>(_mm256_movemask_epi8(
+        _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')),
+                        _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t')))));
+    const auto hyphen = static_cast<uint32_t>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('-'))));
+    IdShape shape;
+    if (ShapeFromMasks(alpha, digit, space, hyphen, line.size(), shape)) {
+      AppendCanonical(line, shape, source, out);
+    } else {
+      ScalarOne(line, source, out);
+    }
+  }
+}
+
+auto CpuHasAvx2() -> bool {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_cpu_supports("avx2") != 0;
+#elif defined(_MSC_VER)
+  int info[4] = {};
+  __cpuid(info, 0);
+  if (info[0] < 7) {
+    return false;
+  }
+  __cpuid(info, 1);
+  const bool os_saves_ymm =
+      (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+  __cpuidex(info, 7, 0);
+  return os_saves_ymm && (info[1] & (1 << 5)) != 0;
+#else
+  return false;
+#endif
+}
+#endif  // AVLIB_BATCH_X86
+}  // namespace
+
+auto IsBatchKernelSupported(BatchKernel kernel) -> bool {
+  switch (kernel) {
+    case BatchKernel::kScalar:
+      return true;
+#ifdef AVLIB_BATCH_X86
+    case BatchKernel::kSse2:
+      return true;  // x86-64 的基线指令集
+    case BatchKernel::kAvx2: {
+      static const bool kHasAvx2 = CpuHasAvx2();
+      return kHasAvx2;
+    }
+#else
+    case BatchKernel::kSse2:
+    case BatchKernel::kAvx2:
+      return false;
+#endif
+  }
+  return false;
+}
+
+auto ActiveBatchKernel() -> BatchKernel {
+  static const BatchKernel kActive = [] {
+    if (IsBatchKernelSupported(BatchKernel::kAvx2)) {
+      return BatchKernel::kAvx2;
+    }
+    if (IsBatchKernelSupported(BatchKernel::kSse2)) {
+      return BatchKernel::kSse2;
+    }
+    return BatchKernel::kScalar;
+  }();
+  return kActive;
+}
+
+void ValidateBatch(std::span<const std::string_view> lines,
+                   CanonicalIdBuffer& out) {
+  ValidateBatch(lines, out, ActiveBatchKernel());
+}
+
+void ValidateBatch(std::span<const std::string_view> lines,
+                   CanonicalIdBuffer& out, BatchKernel kernel) {
+  out.sources.reserve(out.sources.size() + lines.size());
+  if (!IsBatchKernelSupported(kernel)) {
+    kernel = BatchKernel::kScalar;
+  }
+  switch (kernel) {
+#ifdef AVLIB_BATCH_X86
+    case BatchKernel::kAvx2:
+      Avx2Batch(lines, out);
+      return;
+    case BatchKernel::kSse2:
+      Sse2Batch(lines, out);
+      return;
+#endif
+    default:
+      ScalarBatch(lines, out);
+      return;
+  }
+}
+
+}  // namespace Validator
@@ -0,0 +1,51 @@
+// core/utils/batch_validator.hpp
+#ifndef BATCH_VALIDATOR_HPP
+#define BATCH_VALIDATOR_HPP
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "core/utils/id_list.hpp"
+
+namespace Validator {
+
+// 批量校验的结果：合法 ID 的规范化形式存放在同一块缓冲区中
+struct CanonicalIdBuffer {
+  IdList ids;
+  std::vector<uint32_t> sources;  // 第 i 个合法 ID 对应的输入行下标
+  size_t invalid_count = 0;
+
+  [[nodiscard]] auto Size() const -> size_t { return ids.Size(); }
+  [[nodiscard]] auto operator[](size_t i) const -> std::string_view {
+    return ids[i];
+  }
+  void Clear() {
+    ids.Clear();
+    sources.clear();
+    invalid_count = 0;
+  }
+};
+
+enum class BatchKernel {
+  kScalar,  // 逐字节查表 DFA（AppendCanonicalId）
+  kSse2,    // 16 字节向量分类
+  kAvx2     // 32 字节向量分类
+};
+
+// 当前 CPU 支持的最快内核，首次调用时检测
+[[nodiscard]] auto ActiveBatchKernel() -> BatchKernel;
+[[nodiscard]] auto IsBatchKernelSupported(BatchKernel kernel) -> bool;
+
+// 校验并规范化一批行，结果追加到 out；与逐个调用
+// IsValidIdFormat / CanonicalizeId 的结果完全一致。
+// 向量内核只识别通用文法，超出向量宽度或不符合通用文法的行由 DFA 处理。
+void ValidateBatch(std::span<const std::string_view> lines,
+                   CanonicalIdBuffer& out);
+void ValidateBatch(std::span<const std::string_view> lines,
+                   CanonicalIdBuffer& out, BatchKernel kernel);
+
+}  // namespace Validator
+
+#endif
@@ -0,0 +1,386 @@
+// core/utils/id_grammar.hpp
+#ifndef ID_GRAMMAR_HPP
+#define ID_GRAMMAR_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+
+// 编译期 ID 文法编译器。
+// 每条文法是一串原子（字符集合 + 重复方式 + 是否写入规范化结果），
+// 多条文法在编译期合并为一个 NFA，再经子集构造得到查表式 DFA：
+// 字节先映射为等价类，每次转移同时给出下一状态与 "是否保留该字符"，
+// 因此校验与规范化在同一趟循环内完成，循环体内没有分支。
+// 同一输入命中多条文法时，取列表中靠前的文法的标签。
+namespace IdGrammar {
+
+inline constexpr size_t kUnbounded = std::numeric_limits<size_t>::max();
+inline constexpr size_t kMaxAtoms = 32;
+inline constexpr size_t kMaxNfaStates = 256;
+inline constexpr size_t kMaxDfaStates = 128;
+inline constexpr size_t kMaxClasses = 64;
+
+inline constexpr uint8_t kDeadState = 0;
+inline constexpr uint8_t kStartState = 1;
+inline constexpr uint8_t kKeepBit = 0x80;
+inline constexpr uint8_t kStateMask = 0x7F;
+
+class CharSet {
+ public:
+  constexpr void Add(char c) {
+    const auto byte = static_cast<unsigned char>(c);
+    bits_[byte >> 6] |= uint64_t{1} << (byte & 63);
+  }
+  constexpr void AddRange(char lo, char hi) {
+    for (char c = lo; c <= hi; ++c) {
+      Add(c);
+    }
+  }
+  [[nodiscard]] constexpr auto Contains(unsigned char byte) const -> bool {
+    return ((bits_[byte >> 6] >> (byte & 63)) & 1) != 0;
+  }
+
+ private:
+  std::array<uint64_t, 4> bits_{};
+};
+
+enum class Repeat : uint8_t {
+  kOne,       // 恰好一次
+  kOptional,  // 零或一次
+  kPlus,      // 一次或多次
+  kStar       // 零或多次
+};
+
+struct Atom {
+  CharSet chars;
+  Repeat repeat = Repeat::kOne;
+  bool keep = true;  // 匹配到的字符是否写入规范化结果
+};
+
+class Pattern {
+ public:
+  constexpr void Push(const Atom& atom) {
+    if (size_ == kMaxAtoms) {
+      throw std::length_error("ID 文法过长");
+    }
+    atoms_[size_++] = atom;
+  }
+  [[nodiscard]] constexpr auto Atoms() const -> std::span<const Atom> {
+    return {atoms_.data(), size_};
+  }
+  constexpr auto operator+(const Pattern& rhs) const -> Pattern {
+    Pattern joined = *this;
+    for (const Atom& atom : rhs.Atoms()) {
+      joined.Push(atom);
+    }
+    return joined;
+  }
+
+ private:
+  std::array<Atom, kMaxAtoms> atoms_{};
+  size_t size_ = 0;
+};
+
+// --- 文法构件 ---
+
+// chars 重复 [min, max] 次；max 为 kUnbounded 时不设上限
+constexpr auto Repeated(const CharSet& chars, size_t min, size_t max,
+                        bool keep = true) -> Pattern {
+  Pattern pattern;
+  for (size_t i = 0; i + 1 < min; ++i) {
+    pattern.Push({chars, Repeat::kOne, keep});
+  }
+  if (max == kUnbounded) {
+    pattern.Push({chars, min == 0 ? Repeat::kStar : Repeat::kPlus, keep});
+    return pattern;
+  }
+  if (min > 0) {
+    pattern.Push({chars, Repeat::kOne, keep});
+  }
+  for (size_t i = min; i < max; ++i) {
+    pattern.Push({chars, Repeat::kOptional, keep});
+  }
+  return pattern;
+}
+
+constexpr auto Letters(size_t min, size_t max = kUnbounded) -> Pattern {
+  CharSet letters;
+  letters.AddRange('a', 'z');
+  letters.AddRange('A', 'Z');
+  return Repeated(letters, min, max);
+}
+
+constexpr auto Digits(size_t min, size_t max = kUnbounded) -> Pattern {
+  CharSet digits;
+  digits.AddRange('0', '9');
+  return Repeated(digits, min, max);
+}
+
+// 单个字符，原样匹配
+constexpr auto Char(char c, bool keep = true) -> Pattern {
+  CharSet chars;
+  chars.Add(c);
+  return Repeated(chars, 1, 1, keep);
+}
+
+// 固定文本，字母不区分大小写；规范化结果保留原文大小写
+constexpr auto Literal(std::string_view text) -> Pattern {
+  Pattern pattern;
+  for (const char c : text) {
+    CharSet chars;
+    chars.Add(c);
+    if (c >= 'a' && c <= 'z') {
+      chars.Add(static_cast<char>(c - 'a' + 'A'));
+    } else if (c >= 'A' && c <= 'Z') {
+      chars.Add(static_cast<char>(c - 'A' + 'a'));
+    }
+    pattern.Push({chars, Repeat::kOne, true});
+  }
+  return pattern;
+}
+
+// 可省略的分隔段：任意个空格/制表符，其中最多一个 '-'，不写入规范化结果
+constexpr auto Separator() -> Pattern {
+  CharSet spaces;
+  spaces.Add(' ');
+  spaces.Add('\t');
+  CharSet hyphen;
+  hyphen.Add('-');
+  Pattern pattern;
+  pattern.Push({spaces, Repeat::kStar, false});
+  pattern.Push({hyphen, Repeat::kOptional, false});
+  pattern.Push({spaces, Repeat::kStar, false});
+  return pattern;
+}
+
+template <typename Tag>
+struct Grammar {
+  Tag tag;
+  Pattern pattern;
+};
+
+// 查表式 DFA；状态 0 为死状态，状态 1 为初始状态。
+// Tag{} 表示不接受，因此各文法的标签不能取 Tag{}。
+template <typename Tag, size_t States, size_t Classes>
+struct Dfa {
+  std::array<uint8_t, 256> byte_class{};
+  // 低 7 位为下一状态，最高位表示保留当前字符
+  std::array<std::array<uint8_t, Classes>, States> next{};
+  std::array<Tag, States> accept{};
+  size_t state_count = States;
+  size_t class_count = Classes;
+
+  // 单趟匹配：规范化结果写入 out（容量不少于 input.size()），
+  // 返回命中的文法标签；不接受时返回 Tag{}，out 的内容无意义
+  constexpr auto Run(std::string_view input, char* out,
+                     size_t& out_size) const -> Tag {
+    uint8_t state = kStartState;
+    size_t written = 0;
+    for (const char c : input) {
+      const uint8_t entry =
+          next[state][byte_class[static_cast<unsigned char>(c)]];
+      out[written] = c;
+      written += entry >> 7;
+      state = entry & kStateMask;
+    }
+    out_size = written;
+    return accept[state];
+  }
+};
+
+namespace Detail {
+using StateSet = std::array<uint64_t, kMaxNfaStates / 64>;
+
+constexpr void Insert(StateSet& set, size_t state) {
+  set[state >> 6] |= uint64_t{1} << (state & 63);
+}
+
+constexpr auto Has(const StateSet& set, size_t state) -> bool {
+  return ((set[state >> 6] >> (state & 63)) & 1) != 0;
+}
+
+constexpr auto IsEmpty(const StateSet& set) -> bool {
+  for (const uint64_t word : set) {
+    if (word != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// 所有文法首尾相接排成一条线：第 g 条文法占用状态 [base, base + n]，
+// 状态 base + i 表示已匹配前 i 个原子，同一下标处存放第 i 个原子。
+struct Nfa {
+  std::array<Atom, kMaxNfaStates> atoms{};
+  std::array<bool, kMaxNfaStates> is_end{};
+  std::array<bool, kMaxNfaStates> is_first{};
+  std::array<size_t, kMaxNfaStates> grammar{};
+  size_t size = 0;
+};
+
+constexpr auto IsSkippable(const Atom& atom) -> bool {
+  return atom.repeat == Repeat::kOptional || atom.repeat == Repeat::kStar;
+}
+
+constexpr auto IsRepeatable(const Atom& atom) -> bool {
+  return atom.repeat == Repeat::kPlus || atom.repeat == Repeat::kStar;
+}
+
+// 加入 state 及可跳过可选原子到达的后续状态
+constexpr void InsertClosure(const Nfa& nfa, StateSet& set, size_t state) {
+  Insert(set, state);
+  while (!nfa.is_end[state] && IsSkippable(nfa.atoms[state])) {
+    Insert(set, ++state);
+  }
+}
+
+struct KeepVote {
+  bool keep = false;
+  bool drop = false;
+};
+
+// 从 from 集合读入字节 byte 后到达的集合
+constexpr auto Step(const Nfa& nfa, const StateSet& from, unsigned char byte,
+                    KeepVote& vote) -> StateSet {
+  StateSet to{};
+  for (size_t s = 0; s < nfa.size; ++s) {
+    if (!Has(from, s)) {
+      continue;
+    }
+    if (!nfa.is_end[s] && nfa.atoms[s].chars.Contains(byte)) {
+      InsertClosure(nfa, to, s + 1);
+      (nfa.atoms[s].keep ? vote.keep : vote.drop) = true;
+    }
+    // 刚匹配完可重复的原子时可以停留在原地
+    if (!nfa.is_first[s] && IsRepeatable(nfa.atoms[s - 1]) &&
+        nfa.atoms[s - 1].chars.Contains(byte)) {
+      InsertClosure(nfa, to, s);
+      (nfa.atoms[s - 1].keep ? vote.keep : vote.drop) = true;
+    }
+  }
+  return to;
+}
+}  // namespace Detail
+
+// 编译为容量上限的 DFA，实际规模记录在 state_count / class_count，
+// 再用 Shrink 裁剪为紧凑的表
+template <typename Tag, size_t N>
+constexpr auto Compile(const std::array<Grammar<Tag>, N>& grammars)
+    -> Dfa<Tag, kMaxDfaStates, kMaxClasses> {
+  using Detail::StateSet;
+  Detail::Nfa nfa;
+  StateSet start{};
+  for (size_t g = 0; g < N; ++g) {
+    const auto atoms = grammars[g].pattern.Atoms();
+    if (nfa.size + atoms.size() + 1 > kMaxNfaStates) {
+      throw std::length_error("ID 文法总规模超出上限");
+    }
+    const size_t base = nfa.size;
+    for (size_t i = 0; i <= atoms.size(); ++i) {
+      nfa.is_end[base + i] = (i == atoms.size());
+      nfa.is_first[base + i] = (i == 0);
+      nfa.grammar[base + i] = g;
+      if (i < atoms.size()) {
+        nfa.atoms[base + i] = atoms[i];
+      }
+    }
+    nfa.size += atoms.size() + 1;
+    Detail::InsertClosure(nfa, start, base);
+  }
+
+  // 字节等价类：能匹配到的原子完全相同的字节归为一类，类 0 不匹配任何原子
+  Dfa<Tag, kMaxDfaStates, kMaxClasses> dfa;
+  std::array<StateSet, kMaxClasses> class_atoms{};
+  std::array<unsigned char, kMaxClasses> class_byte{};
+  size_t class_count = 1;
+  for (size_t b = 0; b < 256; ++b) {
+    StateSet atoms{};
+    for (size_t s = 0; s < nfa.size; ++s) {
+      if (!nfa.is_end[s] &&
+          nfa.atoms[s].chars.Contains(static_cast<unsigned char>(b))) {
+        Detail::Insert(atoms, s);
+      }
+    }
+    size_t cls = 0;
+    while (cls < class_count && class_atoms[cls] != atoms) {
+      ++cls;
+    }
+    if (cls == class_count) {
+      if (class_count == kMaxClasses) {
+        throw std::length_error("ID 文法的字符类过多");
+      }
+      class_atoms[cls] = atoms;
+      class_byte[cls] = static_cast<unsigned char>(b);
+      ++class_count;
+    }
+    dfa.byte_class[b] = static_cast<uint8_t>(cls);
+  }
+
+  // 子集构造
+  std::array<StateSet, kMaxDfaStates> sets{};
+  sets[kStartState] = start;
+  size_t state_count = 2;
+  for (size_t d = kStartState; d < state_count; ++d) {
+    for (size_t g = 0; g < N; ++g) {
+      bool accepted = false;
+      for (size_t s = 0; s < nfa.size; ++s) {
+        accepted |= nfa.is_end[s] && nfa.grammar[s] == g &&
+                    Detail::Has(sets[d], s);
+      }
+      if (accepted) {
+        dfa.accept[d] = grammars[g].tag;
+        break;
+      }
+    }
+    for (size_t cls = 1; cls < class_count; ++cls) {
+      Detail::KeepVote vote;
+      const StateSet target =
+          Detail::Step(nfa, sets[d], class_byte[cls], vote);
+      if (Detail::IsEmpty(target)) {
+        continue;  // 默认转入死状态
+      }
+      if (vote.keep && vote.drop) {
+        throw std::logic_error("ID 文法冲突：同一字符的保留动作不一致");
+      }
+      size_t found = kStartState;
+      while (found < state_count && sets[found] != target) {
+        ++found;
+      }
+      if (found == state_count) {
+        if (state_count == kMaxDfaStates) {
+          throw std::length_error("ID 文法生成的 DFA 状态过多");
+        }
+        sets[state_count++] = target;
+      }
+      dfa.next[d][cls] =
+          static_cast<uint8_t>(found | (vote.keep ? kKeepBit : 0));
+    }
+  }
+  dfa.state_count = state_count;
+  dfa.class_count = class_count;
+  return dfa;
+}
+
+template <size_t States, size_t Classes, typename Tag, size_t S, size_t C>
+constexpr auto Shrink(const Dfa<Tag, S, C>& raw) -> Dfa<Tag, States, Classes> {
+  if (raw.state_count != States || raw.class_count != Classes) {
+    throw std::logic_error("DFA 裁剪尺寸与实际规模不符");
+  }
+  Dfa<Tag, States, Classes> dfa;
+  dfa.byte_class = raw.byte_class;
+  for (size_t d = 0; d < States; ++d) {
+    for (size_t cls = 0; cls < Classes; ++cls) {
+      dfa.next[d][cls] = raw.next[d][cls];
+    }
+    dfa.accept[d] = raw.accept[d];
+  }
+  return dfa;
+}
+
+}  // namespace IdGrammar
+
+#endif  // ID_GRAMMAR_HPP
@@ -0,0 +1,92 @@
+// core/utils/id_list.hpp
+#ifndef ID_LIST_HPP
+#define ID_LIST_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// 一组 ID 首尾相接存放在同一块缓冲区中，只另记每个 ID 的结束位置。
+// 追加时不为单个 ID 分配内存；Clear 保留容量，复用同一对象时稳态零分配。
+class IdList {
+ public:
+  class Iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::string_view;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = std::string_view;
+
+    Iterator() = default;
+    Iterator(const IdList* list, size_t index) : list_(list), index_(index) {}
+
+    auto operator*() const -> std::string_view { return (*list_)[index_]; }
+    auto operator++() -> Iterator& {
+      ++index_;
+      return *this;
+    }
+    auto operator++(int) -> Iterator {
+      Iterator old = *this;
+      ++index_;
+      return old;
+    }
+    auto operator==(const Iterator& other) const -> bool {
+      return index_ == other.index_;
+    }
+
+   private:
+    const IdList* list_ = nullptr;
+    size_t index_ = 0;
+  };
+
+  void Append(std::string_view id) {
+    bytes_.append(id);
+    ends_.push_back(bytes_.size());
+  }
+
+  // 拼接型 ID 直接写入缓冲区，写完后调用 EndId
+  [[nodiscard]] auto Bytes() -> std::string& { return bytes_; }
+  void EndId() { ends_.push_back(bytes_.size()); }
+
+  void Reserve(size_t ids, size_t bytes) {
+    ends_.reserve(ids);
+    bytes_.reserve(bytes);
+  }
+  void Clear() {
+    bytes_.clear();
+    ends_.clear();
+  }
+
+  [[nodiscard]] auto Size() const -> size_t { return ends_.size(); }
+  [[nodiscard]] auto Empty() const -> bool { return ends_.empty(); }
+  [[nodiscard]] auto operator[](size_t i) const -> std::string_view {
+    const size_t begin = (i == 0) ? 0 : ends_[i - 1];
+    return {bytes_.data() + begin, ends_[i] - begin};
+  }
+  [[nodiscard]] auto begin() const -> Iterator { return {this, 0}; }
+  [[nodiscard]] auto end() const -> Iterator { return {this, ends_.size()}; }
+
+  // 生成指向本列表的视图数组，写入调用方复用的 views；
+  // 列表再次追加后视图失效
+  void ViewsInto(std::vector<std::string_view>& views) const {
+    views.clear();
+    size_t begin = 0;
+    for (const size_t end : ends_) {
+      views.emplace_back(bytes_.data() + begin, end - begin);
+      begin = end;
+    }
+  }
+
+  auto operator==(const IdList& other) const -> bool {
+    return bytes_ == other.bytes_ && ends_ == other.ends_;
+  }
+
+ private:
+  std::string bytes_;
+  std::vector<size_t> ends_;
+};
+
+#endif  // ID_LIST_HPP
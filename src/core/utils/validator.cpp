@@ -1,88 +1,104 @@
 // core/utils/validator.cpp
 #include "core/utils/validator.hpp"
 
+#include <array>
 #include <string>
+#include <utility>
 
-auto Validator::IsValidIdFormat(const std::string& id) -> bool {
-  std::string alpha_part;
-  std::string digit_part;
+#include "core/utils/id_grammar.hpp"
 
-  // 使用状态机来解析输入字符串，新逻辑支持'-'作为分隔符
-  enum class ParseState {
-    kReadingAlpha,      // 正在读取字母部分
-    kReadingSeparator,  // 正在读取分隔符 (空格或'-')
-    kReadingDigits      // 正在读取数字部分
-  };
+namespace {
+using IdGrammar::Char;
+using IdGrammar::Digits;
+using IdGrammar::Letters;
+using IdGrammar::Literal;
+using IdGrammar::Separator;
+using Validator::IdVendor;
 
-  ParseState current_state = ParseState::kReadingAlpha;
-  bool hyphen_seen = false;  // 标记是否已遇到'-'
+// 按优先级排列：同时符合多条文法时取靠前的一条。
+// 字母开头的格式都去掉分隔段，与通用文法的规范化结果保持一致
+// （已入库的 HEYZO1234 等记录不受影响）。
+constexpr std::array<IdGrammar::Grammar<IdVendor>, 5> kVendorGrammars{{
+    {IdVendor::kHeyzo, Literal("HEYZO") + Separator() + Digits(4, 4)},
+    {IdVendor::kFc2Ppv, Literal("FC2") + Separator() + Literal("PPV") +
+                            Separator() + Digits(6, 7)},
+    {IdVendor::kCaribbean, Digits(6, 6) + Char('-') + Digits(3, 3)},
+    {IdVendor::kIppondo, Digits(6, 6) + Char('_') + Digits(3, 3)},
+    {IdVendor::kGeneric, Letters(1) + Separator() + Digits(1)},
+}};
 
-  for (const char kC : id) {
-    switch (current_state) {
-      case ParseState::kReadingAlpha:
-        if (IsAlphaChar(kC)) {
-          alpha_part += kC;
-        } else if (IsDigitChar(kC)) {
-          // 字母部分结束，直接进入数字部分
-          if (alpha_part.empty()) {
-            return false;  // ID不能以数字开头
-          }
-          current_state = ParseState::kReadingDigits;
-          digit_part += kC;
-        } else if (IsSpaceChar(kC) || kC == '-') {
-          // 字母部分结束，进入分隔符部分
-          if (alpha_part.empty()) {
-            return false;  // ID不能以分隔符开头
-          }
-          current_state = ParseState::kReadingSeparator;
-          if (kC == '-') {
-            hyphen_seen = true;
-          }
-        } else {
-          return false;  // 字母区段出现无效字符
-        }
-        break;
+constexpr auto kRawIdDfa = IdGrammar::Compile(kVendorGrammars);
+constexpr auto kIdDfa =
+    IdGrammar::Shrink<kRawIdDfa.state_count, kRawIdDfa.class_count>(kRawIdDfa);
 
-      case ParseState::kReadingSeparator:
-        if (IsDigitChar(kC)) {
-          // 分隔符结束后，开始读取数字
-          current_state = ParseState::kReadingDigits;
-          digit_part += kC;
-        } else if (kC == '-') {
-          if (hyphen_seen) {
-            return false;  // 不允许多个'-'
-          }
-          hyphen_seen = true;
-        } else if (!IsSpaceChar(kC)) {
-          return false;  // 分隔符区段出现无效字符 (如字母)
-        }
-        // 如果是空格，则继续忽略
-        break;
+// 编译期自检
+constexpr auto Accepts(std::string_view id) -> IdVendor {
+  std::array<char, 32> out{};
+  size_t size = 0;
+  return kIdDfa.Run(id, out.data(), size);
+}
+static_assert(Accepts("abc-123") == IdVendor::kGeneric);
+static_assert(Accepts("heyzo 0904") == IdVendor::kHeyzo);
+static_assert(Accepts("FC2-PPV-1234567") == IdVendor::kFc2Ppv);
+static_assert(Accepts("031315-827") == IdVendor::kCaribbean);
+static_assert(Accepts("091416_382") == IdVendor::kIppondo);
+static_assert(Accepts("12ab") == IdVendor::kNone);
+}  // namespace
 
-      case ParseState::kReadingDigits:
-        if (IsDigitChar(kC)) {
-          digit_part += kC;
-        } else {
-          return false;  // 数字区段出现无效字符 (如空格, '-', 或字母)
-        }
-        break;
-    }
-  }
+auto Validator::AppendCanonicalId(std::string_view raw_id, std::string& out)
+    -> IdVendor {
+  const size_t base = out.size();
+  out.resize(base + raw_id.size());
+  size_t written = 0;
+  const IdVendor vendor = kIdDfa.Run(raw_id, out.data() + base, written);
+  out.resize(vendor == IdVendor::kNone ? base : base + written);
+  return vendor;
+}
 
-  // --- 关键修改点 ---
-  // 循环结束后，必须成功进入并完成数字读取阶段
-  if (current_state != ParseState::kReadingDigits || digit_part.empty()) {
-    // 此检查会拒绝如 "abc-" 或 "abc " 这样以分隔符结尾的无效输入
-    return false;
-  }
+auto Validator::ParseId(std::string_view raw_id) -> ParsedId {
+  ParsedId parsed;
+  parsed.vendor = AppendCanonicalId(raw_id, parsed.canonical);
+  return parsed;
+}
 
-  // 根据收集到的字母 and 数字部分的长度进行最终验证
-  const size_t kAlphaLen = alpha_part.length();
-  const size_t kDigitLen = digit_part.length();
+auto Validator::IsValidIdFormat(std::string_view id) -> bool {
+  std::array<char, 64> scratch{};
+  if (id.size() > scratch.size()) {
+    return ParseId(id).IsValid();
+  }
+  size_t written = 0;
+  return kIdDfa.Run(id, scratch.data(), written) != IdVendor::kNone;
+}
 
-  // 字母长度 and 数字长度
-  bool is_alpha_len_valid = (kAlphaLen >= 1);  // 字母部分至少为1个
-  bool is_digit_len_valid = (kDigitLen >= 1);  // 数字部分至少为1个
+auto Validator::CanonicalizeId(std::string_view raw_id) -> std::string {
+  ParsedId parsed = ParseId(raw_id);
+  if (parsed.IsValid()) {
+    return std::move(parsed.canonical);
+  }
+  std::string canonical_id;
+  canonical_id.reserve(raw_id.length());
+  for (char c : raw_id) {
+    if (IsAlphaChar(c) || IsDigitChar(c)) {
+      canonical_id += c;
+    }
+  }
+  return canonical_id;
+}
 
-  return is_alpha_len_valid && is_digit_len_valid;
-}
\ No newline at end of file
+auto Validator::VendorName(IdVendor vendor) -> std::string_view {
+  switch (vendor) {
+    case IdVendor::kHeyzo:
+      return "heyzo";
+    case IdVendor::kFc2Ppv:
+      return "fc2-ppv";
+    case IdVendor::kCaribbean:
+      return "carib";
+    case IdVendor::kIppondo:
+      return "1pondo";
+    case IdVendor::kGeneric:
+      return "generic";
+    case IdVendor::kNone:
+      break;
+  }
+  return "none";
+}
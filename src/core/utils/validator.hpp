@@ -2,17 +2,52 @@
 #ifndef VALIDATOR_HPP
 #define VALIDATOR_HPP
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 
 namespace Validator {
+// 已知的 ID 文法（厂商）；kNone 表示不符合任何文法
+enum class IdVendor : uint8_t {
+  kNone,
+  kHeyzo,      // HEYZO-1234
+  kFc2Ppv,     // FC2-PPV-1234567
+  kCaribbean,  // 123456-789
+  kIppondo,    // 123456_789
+  kGeneric     // 字母段 + 分隔段 + 数字段，如 ABC-123
+};
+
+struct ParsedId {
+  IdVendor vendor = IdVendor::kNone;
+  std::string canonical;
+
+  [[nodiscard]] auto IsValid() const -> bool {
+    return vendor != IdVendor::kNone;
+  }
+};
+
 /**
  * @brief 验证ID格式是否正确
- * 规则: 2, 3或4个字母 (不区分大小写), 后跟2, 3或4位数字,
- * 中间可有空格或一个'-'作为分隔符。
+ * 规则: 符合任一已知文法。通用文法为若干字母 (不区分大小写) 后跟若干数字,
+ * 中间可有空格或一个'-'作为分隔符; 其余为各厂商的专有格式, 见 validator.cpp。
  * @param id 要验证的ID字符串
  * @return 如果格式正确则返回true, 否则返回false
  */
-auto IsValidIdFormat(const std::string& id) -> bool;
+auto IsValidIdFormat(std::string_view id) -> bool;
+
+// 规范化：去掉分隔段，入库与查询都使用规范化后的形式；
+// 纯数字的厂商格式保留其 '-' / '_'，以免不同厂商的编号相撞。
+// 对不合法的输入只保留字母与数字。
+auto CanonicalizeId(std::string_view raw_id) -> std::string;
+
+// 一趟完成校验与规范化，并给出命中的文法
+auto ParseId(std::string_view raw_id) -> ParsedId;
+
+// 同 ParseId，但把规范化结果追加到 out 末尾，不额外分配；
+// 不合法时返回 IdVendor::kNone 且 out 保持不变
+auto AppendCanonicalId(std::string_view raw_id, std::string& out) -> IdVendor;
+
+auto VendorName(IdVendor vendor) -> std::string_view;
 
 // --- 移至头文件的公共辅助函数 ---
 // 使其在 Application.cpp 中也可用
@@ -0,0 +1,141 @@
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "core/app/application.hpp"
+#include "core/data/fast_query_db.hpp"
+#include "core/infrastructure/database_manager.hpp"
+#include "core/io/mapped_text_reader.hpp"
+
+namespace {
+
+constexpr size_t kIdsPerLabel = 100000;
+constexpr size_t kGenerateBatch = 1024;
+constexpr size_t kGenerateCommit = 1000000;
+
+// 第 index 个 ID：两位字母标签 + 5 位数字，按 index 递增即按字节序递增
+auto MakeId(size_t index) -> std::string {
+  const size_t label = index / kIdsPerLabel;
+  std::string id;
+  id.push_back(static_cast<char>('A' + label / 26));
+  id.push_back(static_cast<char>('A' + label % 26));
+  const std::string digits = std::to_string(index % kIdsPerLabel);
+  id.append(5 - digits.size(), '0').append(digits);
+  return id;
+}
+
+// 写入 [0, count) 的 ID；库已是这个规模时直接复用
+void Generate(const std::filesystem::path& path, size_t count) {
+  FastQueryDB db(path.string());
+  if (db.GetCount() == count) {
+    return;
+  }
+  std::vector<std::string> owned;
+  std::vector<std::string_view> batch;
+  size_t uncommitted = 0;
+  db.BeginTransaction();
+  for (size_t i = 0; i < count; i += kGenerateBatch) {
+    owned.clear();
+    for (size_t k = i; k < std::min(count, i + kGenerateBatch); ++k) {
+      owned.push_back(MakeId(k));
+    }
+    batch.assign(owned.begin(), owned.end());
+    (void)db.AddMany(batch);
+    uncommitted += batch.size();
+    if (uncommitted >= kGenerateCommit) {
+      db.CommitTransaction();
+      db.BeginTransaction();
+      uncommitted = 0;
+    }
+  }
+  db.CommitTransaction();
+}
+
+// 候选清单：一半是库中已有的、一半是新的，随机打乱，每 1000 行一行格式错误
+void GenerateCandidates(const std::filesystem::path& path, size_t db_rows,
+                        size_t lines) {
+  std::mt19937_64 rng(42);
+  std::vector<size_t> indexes(lines);
+  for (size_t i = 0; i < lines; ++i) {
+    indexes[i] = (i % 2 == 0) ? rng() % std::max<size_t>(db_rows, 1)
+                              : db_rows + rng() % std::max<size_t>(lines, 1);
+  }
+  std::ofstream out(path);
+  for (size_t i = 0; i < lines; ++i) {
+    out << (i % 1000 == 999 ? std::string("bad_id") : MakeId(indexes[i]))
+        << '\n';
+  }
+}
+
+auto PeakRssMb() -> double {
+  rusage usage{};
+  getrusage(RUSAGE_SELF, &usage);
+  return static_cast<double>(usage.ru_maxrss) / 1024.0;
+}
+
+}  // namespace
+
+// 用法: avlib_check_file_bench [库行数，默认 10000000] [候选行数，默认 1000000]
+//                              [数据目录]
+// 分别以逐块查询与归并连接核对同一份候选清单；已有同规模的库时直接复用
+auto main(int argc, char** argv) -> int {
+  const size_t db_rows =
+      (argc > 1) ? static_cast<size_t>(std::strtoull(argv[1], nullptr, 10))
+                 : 10000000;
+  const size_t lines =
+      (argc > 2) ? static_cast<size_t>(std::strtoull(argv[2], nullptr, 10))
+                 : 1000000;
+  const std::filesystem::path dir =
+      (argc > 3) ? std::filesystem::path(argv[3])
+                 : std::filesystem::temp_directory_path() / "avlib_check_bench";
+  std::filesystem::create_directories(dir);
+
+  const auto generate_start = std::chrono::steady_clock::now();
+  Generate(dir / "owned.sqlite3", db_rows);
+  const std::filesystem::path candidates = dir / "candidates.txt";
+  GenerateCandidates(candidates, db_rows, lines);
+  std::cout << "inputs ready: "
+            << std::chrono::duration<double>(
+                   std::chrono::steady_clock::now() - generate_start)
+                   .count()
+            << " s, peak rss " << PeakRssMb() << " MB\n";
+
+  Application app(std::make_unique<DatabaseManager>(dir.string()));
+  app.SetCurrentDatabase("owned.sqlite3");
+  const std::filesystem::path out_dir = dir / "out";
+
+  struct Case {
+    std::string_view name;
+    CheckStrategy strategy;
+  };
+  constexpr Case kCases[] = {{"lookup", CheckStrategy::kLookup},
+                             {"merge-join", CheckStrategy::kMergeJoin}};
+  for (const Case& c : kCases) {
+    IO::MappedTextReader reader;
+    CheckOptions options;
+    options.strategy = c.strategy;
+    const auto start = std::chrono::steady_clock::now();
+    const CheckResult result = app.PerformCheckFile(
+        reader, candidates.string(), out_dir.string(), options);
+    const double seconds = std::chrono::duration<double>(
+                               std::chrono::steady_clock::now() - start)
+                               .count();
+    std::cout << c.name << ": " << seconds << " s, "
+              << static_cast<double>(lines) / seconds << " lines/s, new "
+              << result.new_count << ", owned " << result.owned_count
+              << ", invalid " << result.invalid_format_count
+              << ", peak rss " << PeakRssMb() << " MB\n";
+  }
+  std::filesystem::remove_all(out_dir);
+  return 0;
+}
@@ -0,0 +1,161 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "core/utils/batch_validator.hpp"
+#include "core/utils/validator.hpp"
+
+namespace {
+
+// 改用 DFA 之前的逐字符状态机，作为对照基线
+auto LegacyIsValidIdFormat(std::string_view id) -> bool {
+  enum class ParseState { kReadingAlpha, kReadingSeparator, kReadingDigits };
+  ParseState state = ParseState::kReadingAlpha;
+  size_t alpha_len = 0;
+  size_t digit_len = 0;
+  bool hyphen_seen = false;
+  for (const char c : id) {
+    switch (state) {
+      case ParseState::kReadingAlpha:
+        if (Validator::IsAlphaChar(c)) {
+          ++alpha_len;
+        } else if (Validator::IsDigitChar(c) && alpha_len > 0) {
+          state = ParseState::kReadingDigits;
+          ++digit_len;
+        } else if ((Validator::IsSpaceChar(c) || c == '-') && alpha_len > 0) {
+          state = ParseState::kReadingSeparator;
+          hyphen_seen = (c == '-');
+        } else {
+          return false;
+        }
+        break;
+      case ParseState::kReadingSeparator:
+        if (Validator::IsDigitChar(c)) {
+          state = ParseState::kReadingDigits;
+          ++digit_len;
+        } else if (c == '-') {
+          if (hyphen_seen) {
+            return false;
+          }
+          hyphen_seen = true;
+        } else if (!Validator::IsSpaceChar(c)) {
+          return false;
+        }
+        break;
+      case ParseState::kReadingDigits:
+        if (!Validator::IsDigitChar(c)) {
+          return false;
+        }
+        ++digit_len;
+        break;
+    }
+  }
+  return state == ParseState::kReadingDigits && digit_len > 0;
+}
+
+auto LegacyCanonicalizeId(std::string_view raw_id) -> std::string {
+  std::string canonical_id;
+  canonical_id.reserve(raw_id.length());
+  for (const char c : raw_id) {
+    if (Validator::IsAlphaChar(c) || Validator::IsDigitChar(c)) {
+      canonical_id += c;
+    }
+  }
+  return canonical_id;
+}
+
+// 约 70% 通用格式、10% 厂商格式、20% 非法行
+auto MakeLines(size_t count) -> std::vector<std::string> {
+  std::mt19937 rng(7);
+  std::uniform_int_distribution<int> pick(0, 99);
+  std::uniform_int_distribution<int> digit(0, 9);
+  std::uniform_int_distribution<int> letter(0, 25);
+  constexpr std::string_view kSeparators[] = {"-", "", " ", " - "};
+  std::vector<std::string> lines;
+  lines.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    const int kind = pick(rng);
+    std::string line;
+    if (kind < 70) {
+      for (int k = 2 + kind % 3; k > 0; --k) {
+        line.push_back(static_cast<char>('A' + letter(rng)));
+      }
+      line += kSeparators[kind % 4];
+      for (int k = 3 + kind % 2; k > 0; --k) {
+        line.push_back(static_cast<char>('0' + digit(rng)));
+      }
+    } else if (kind < 80) {
+      line = (kind % 2 == 0) ? "FC2-PPV-" : "031315-";
+      for (int k = (kind % 2 == 0) ? 7 : 3; k > 0; --k) {
+        line.push_back(static_cast<char>('0' + digit(rng)));
+      }
+    } else {
+      line = "[" + std::to_string(i) + "] misc.txt";
+    }
+    lines.push_back(std::move(line));
+  }
+  return lines;
+}
+
+template <typename Fn>
+void Measure(std::string_view name, size_t lines, Fn&& fn) {
+  const auto start = std::chrono::steady_clock::now();
+  const size_t valid = fn();
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  const double ns =
+      std::chrono::duration<double, std::nano>(elapsed).count() /
+      static_cast<double>(lines);
+  std::cout << name << ": " << ns << " ns/line, valid " << valid << '\n';
+}
+
+}  // namespace
+
+auto main(int argc, char** argv) -> int {
+  const size_t count =
+      (argc > 1) ? static_cast<size_t>(std::strtoull(argv[1], nullptr, 10))
+                 : 2000000;
+  const std::vector<std::string> owned = MakeLines(count);
+  const std::vector<std::string_view> lines(owned.begin(), owned.end());
+
+  Measure("legacy state machine", count, [&] {
+    size_t valid = 0;
+    for (const std::string_view line : lines) {
+      if (LegacyIsValidIdFormat(line)) {
+        valid += LegacyCanonicalizeId(line).empty() ? 0 : 1;
+      }
+    }
+    return valid;
+  });
+
+  Measure("dfa parse (allocating)", count, [&] {
+    size_t valid = 0;
+    for (const std::string_view line : lines) {
+      valid += Validator::ParseId(line).IsValid() ? 1 : 0;
+    }
+    return valid;
+  });
+
+  Measure("dfa append (reused buffer)", count, [&] {
+    size_t valid = 0;
+    std::string buffer;
+    for (const std::string_view line : lines) {
+      buffer.clear();
+      valid += (Validator::AppendCanonicalId(line, buffer) !=
+                Validator::IdVendor::kNone)
+                   ? 1
+                   : 0;
+    }
+    return valid;
+  });
+
+  Measure("batch validator", count, [&] {
+    Validator::CanonicalIdBuffer buffer;
+    Validator::ValidateBatch(lines, buffer);
+    return buffer.Size();
+  });
+  return 0;
+}
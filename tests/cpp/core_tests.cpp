@@ -1,13 +1,85 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
+#include <future>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <random>
+#include <ranges>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 
+#ifdef __linux__
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include "capi/avlib.h"
+#include "core/app/application.hpp"
+#include "core/app/import_pipeline.hpp"
+#include "core/app/set_algebra.hpp"
+#include "core/concurrency/bounded_queue.hpp"
+#include "core/concurrency/job_progress.hpp"
+#include "core/concurrency/job_scheduler.hpp"
+#include "core/data/bloom_filter.hpp"
+#include "core/data/cross_db_index.hpp"
+#include "core/data/fast_query_db.hpp"
+#include "core/data/hash_index_repository.hpp"
+#include "core/data/id_snapshot.hpp"
+#include "core/data/id_hash_index.hpp"
+#include "core/data/packed_id_codec.hpp"
+#include "core/data/packed_id_db.hpp"
+#include "core/data/packed_id_migrator.hpp"
+#include "core/data/snapshot_repository.hpp"
+#include "core/infrastructure/database_directory.hpp"
+#include "core/infrastructure/database_manager.hpp"
+#include "core/io/buffered_text_writer.hpp"
+#include "core/io/external_id_sorter.hpp"
+#include "core/io/mapped_text_reader.hpp"
 #include "core/io/text_file_reader.hpp"
+#include "core/service/query_protocol.hpp"
+#include "core/service/unix_socket_server.hpp"
+#include "core/utils/batch_validator.hpp"
 #include "core/utils/validator.hpp"
 
+namespace {
+// 全局 operator new 计数，用于验证稳态路径不逐个 ID 分配内存
+std::atomic<size_t> g_allocation_count{0};
+}  // namespace
+
+auto operator new(std::size_t size) -> void* {
+  g_allocation_count.fetch_add(1, std::memory_order_relaxed);
+  if (void* memory = std::malloc(size == 0 ? 1 : size)) {
+    return memory;
+  }
+  throw std::bad_alloc();
+}
+
+// GCC 会把替换后的 operator delete 中的 free 误判为与内建 new 不匹配
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t /*size*/) noexcept {
+  std::free(memory);
+}
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
 namespace {
 
 auto Check(bool condition, const std::string& message) -> bool {
@@ -27,6 +99,37 @@ auto TestValidator() -> bool {
   ok &= Check(!Validator::IsValidIdFormat("ab-"), "validator rejects trailing separator");
   ok &= Check(!Validator::IsValidIdFormat("ab--12"), "validator rejects double hyphen");
   ok &= Check(!Validator::IsValidIdFormat("12ab"), "validator rejects leading digits");
+
+  using Validator::IdVendor;
+  const auto parsed = [](std::string_view raw) { return Validator::ParseId(raw); };
+  ok &= Check(parsed("abc-1234").vendor == IdVendor::kGeneric &&
+                  parsed("abc-1234").canonical == "abc1234",
+              "validator tags generic ids");
+  ok &= Check(parsed("HEYZO-0904").vendor == IdVendor::kHeyzo &&
+                  parsed("HEYZO-0904").canonical == "HEYZO0904" &&
+                  parsed("HEYZO-09041").vendor == IdVendor::kGeneric,
+              "validator recognizes HEYZO and falls back to generic");
+  ok &= Check(parsed("FC2-PPV-1234567").vendor == IdVendor::kFc2Ppv &&
+                  parsed("fc2 ppv 123456").canonical == "fc2ppv123456" &&
+                  !parsed("FC2-PPV-12345").IsValid(),
+              "validator recognizes FC2-PPV");
+  ok &= Check(parsed("031315-827").vendor == IdVendor::kCaribbean &&
+                  parsed("031315-827").canonical == "031315-827" &&
+                  parsed("091416_382").vendor == IdVendor::kIppondo &&
+                  parsed("091416_382").canonical == "091416_382",
+              "validator keeps separators of digit-only vendor ids");
+  ok &= Check(!Validator::IsValidIdFormat("031315827") &&
+                  !Validator::IsValidIdFormat("031315 827") &&
+                  !Validator::IsValidIdFormat("03131-827"),
+              "validator rejects malformed digit-only ids");
+  ok &= Check(Validator::CanonicalizeId("031315-827") == "031315-827" &&
+                  Validator::CanonicalizeId("ab -12") == "ab12",
+              "canonicalize matches parsed canonical form");
+
+  std::string appended = "x";
+  ok &= Check(Validator::AppendCanonicalId("ab--12", appended) == IdVendor::kNone &&
+                  appended == "x",
+              "append canonical leaves output untouched on invalid input");
   return ok;
 }
 
@@ -56,12 +159,2297 @@ auto TestTextFileReader() -> bool {
   return ok;
 }
 
+auto TestFastQueryDbBatch() -> bool {
+  const auto db_file =
+      std::filesystem::temp_directory_path() / "avlib_core_tests_batch.sqlite3";
+  std::error_code ec;
+  std::filesystem::remove(db_file, ec);
+
+  bool ok = true;
+  try {
+    FastQueryDB db(db_file.string());
+    ok &= Check(db.Add("abc123"), "fast db adds abc123");
+
+    const std::vector<std::string_view> batch = {"abc123", "xyz9", "xyz9", "q\"1"};
+    const std::vector<bool> added = db.AddMany(batch);
+    ok &= Check(added.size() == 4, "fast db AddMany returns one status per id");
+    ok &= Check(!added[0], "fast db AddMany reports existing id");
+    ok &= Check(added[1], "fast db AddMany inserts new id");
+    ok &= Check(!added[2], "fast db AddMany reports in-batch repeat");
+    ok &= Check(added[3], "fast db AddMany handles quoted id");
+    ok &= Check(db.GetCount() == 3, "fast db count after AddMany");
+
+    const std::vector<std::string_view> probe = {"nope1", "xyz9", "abc123",
+                                                 "q\"1"};
+    const std::vector<bool> found = db.ExistsMany(probe);
+    ok &= Check(found.size() == 4, "fast db ExistsMany returns one status per id");
+    ok &= Check(!found[0], "fast db ExistsMany misses unknown id");
+    ok &= Check(found[1] && found[2] && found[3],
+                "fast db ExistsMany finds stored ids");
+    ok &= Check(db.ExistsMany({}).empty(), "fast db ExistsMany accepts empty batch");
+
+    // 另一个连接持有排他锁：批量语句以 SQLITE_BUSY 结束，必须报错而不是
+    // 把整批当作"已存在"或"不存在"
+    sqlite3* raw = nullptr;
+    sqlite3_open(db_file.string().c_str(), &raw);
+    sqlite3_exec(raw, "BEGIN EXCLUSIVE;", nullptr, nullptr, nullptr);
+    bool add_threw = false;
+    bool exists_threw = false;
+    try {
+      (void)db.AddMany(std::vector<std::string_view>{"busy1", "busy2"});
+    } catch (const std::runtime_error&) {
+      add_threw = true;
+    }
+    try {
+      (void)db.ExistsMany(probe);
+    } catch (const std::runtime_error&) {
+      exists_threw = true;
+    }
+    sqlite3_exec(raw, "ROLLBACK;", nullptr, nullptr, nullptr);
+    sqlite3_close(raw);
+    ok &= Check(add_threw && exists_threw,
+                "fast db batch statements report SQLITE_BUSY");
+    ok &= Check(db.AddMany(std::vector<std::string_view>{"busy1"})[0],
+                "fast db batch statements recover after busy");
+  } catch (const std::exception& ex) {
+    ok &= Check(false, std::string("fast db unexpected exception: ") + ex.what());
+  }
+
+  std::filesystem::remove(db_file, ec);
+  return ok;
+}
+
+auto TestFastQueryDbCount() -> bool {
+  const auto db_file =
+      std::filesystem::temp_directory_path() / "avlib_core_tests_count.sqlite3";
+  std::error_code ec;
+  std::filesystem::remove(db_file, ec);
+
+  bool ok = true;
+  try {
+    // 模拟旧版本创建的库：只有 ids 表，没有计数元数据
+    {
+      sqlite3* raw = nullptr;
+      sqlite3_open(db_file.string().c_str(), &raw);
+      sqlite3_exec(raw,
+                   "CREATE TABLE ids (id TEXT PRIMARY KEY NOT NULL);"
+                   "INSERT INTO ids VALUES ('a1'), ('b2');",
+                   nullptr, nullptr, nullptr);
+      sqlite3_close(raw);
+    }
+
+    FastQueryDB db(db_file.string());
+    ok &= Check(db.GetCount() == 2, "count metadata seeded from legacy table");
+    db.Add("c3");
+    db.Add("c3");
+    ok &= Check(db.GetCount() == 3, "count metadata follows Add");
+
+    db.BeginTransaction();
+    db.Add("d4");
+    db.RollbackTransaction();
+    ok &= Check(db.GetCount() == 3, "count metadata follows rollback");
+
+    // 另一个连接（等价于其他进程）写入同一文件
+    {
+      sqlite3* raw = nullptr;
+      sqlite3_open(db_file.string().c_str(), &raw);
+      sqlite3_exec(raw,
+                   "INSERT INTO ids VALUES ('e5');"
+                   "DELETE FROM ids WHERE id = 'a1';",
+                   nullptr, nullptr, nullptr);
+      sqlite3_close(raw);
+    }
+    ok &= Check(db.GetCount() == 3, "count metadata follows external writers");
+  } catch (const std::exception& ex) {
+    ok &= Check(false, std::string("count unexpected exception: ") + ex.what());
+  }
+
+  std::filesystem::remove(db_file, ec);
+  return ok;
+}
+
+auto TestPackedIdCodec() -> bool {
+  bool ok = true;
+  const auto parts = PackedIdCodec::Split("ABC00123");
+  ok &= Check(parts && parts->label == "ABC" && parts->digits == "00123",
+              "codec splits label and trailing digits");
+  ok &= Check(!PackedIdCodec::Split("ABC"), "codec rejects id without digits");
+  ok &= Check(!PackedIdCodec::Split("A12345678901"),
+              "codec rejects more than 10 digits");
+
+  const uint64_t key = PackedIdCodec::Encode(7, "00123");
+  std::string digits;
+  PackedIdCodec::AppendDigits(key, digits);
+  ok &= Check(PackedIdCodec::LabelIdOf(key) == 7, "codec keeps label id");
+  ok &= Check(digits == "00123", "codec keeps zero padding");
+  ok &= Check(PackedIdCodec::Encode(7, "0123") != key,
+              "codec distinguishes padding widths");
+  ok &= Check(PackedIdCodec::Encode(7, "9999999999") <
+                  PackedIdCodec::Encode(8, "0"),
+              "codec orders by label first");
+  return ok;
+}
+
+auto TestPackedIdDb() -> bool {
+  const auto db_file =
+      std::filesystem::temp_directory_path() / "avlib_core_tests_packed.sqlite3";
+  std::error_code ec;
+  std::filesystem::remove(db_file, ec);
+
+  bool ok = true;
+  try {
+    {
+      FastQueryDB text_db(db_file.string());
+      const std::vector<std::string_view> seed = {
+          "abc00123", "ABC123", "xyz", "b12345678901", "heyzo0042"};
+      text_db.AddMany(seed);
+    }
+    ok &= Check(!PackedIdDB::IsPackedLayout(db_file.string()),
+                "text layout detected before migration");
+
+    const LayoutMigrationReport report =
+        PackedIdMigrator::MigrateInPlace(db_file.string());
+    ok &= Check(report.migrated_count == 5, "migration copies every id");
+    ok &= Check(PackedIdDB::IsPackedLayout(db_file.string()),
+                "packed layout detected after migration");
+
+    PackedIdDB db(db_file.string());
+    ok &= Check(db.GetCount() == 5, "packed db count after migration");
+    ok &= Check(db.Exists("abc00123") && !db.Exists("abc123"),
+                "packed db keeps zero padding");
+    ok &= Check(db.Exists("ABC123") && db.Exists("xyz") &&
+                    db.Exists("b12345678901"),
+                "packed db keeps case and overflow ids");
+    ok &= Check(!db.Exists("qqq1"), "packed db misses unknown label");
+
+    const std::vector<std::string_view> batch = {"abc00123", "new77", "new77",
+                                                 "zz"};
+    const std::vector<bool> added = db.AddMany(batch);
+    ok &= Check(!added[0] && added[1] && !added[2] && added[3],
+                "packed db AddMany statuses");
+    const std::vector<bool> found =
+        db.ExistsMany(std::vector<std::string_view>{"new77", "new078", "zz", "xyz"});
+    ok &= Check(found[0] && !found[1] && found[2] && found[3],
+                "packed db ExistsMany statuses");
+    ok &= Check(db.GetCount() == 7, "packed db count follows AddMany");
+
+    {
+      sqlite3* raw = nullptr;
+      sqlite3_open(db_file.string().c_str(), &raw);
+      sqlite3_exec(raw, "BEGIN EXCLUSIVE;", nullptr, nullptr, nullptr);
+      bool add_threw = false;
+      bool exists_threw = false;
+      try {
+        (void)db.AddMany(std::vector<std::string_view>{"new78", "zz2"});
+      } catch (const std::runtime_error&) {
+        add_threw = true;
+      }
+      try {
+        (void)db.ExistsMany(std::vector<std::string_view>{"new77", "zz"});
+      } catch (const std::runtime_error&) {
+        exists_threw = true;
+      }
+      sqlite3_exec(raw, "ROLLBACK;", nullptr, nullptr, nullptr);
+      sqlite3_close(raw);
+      ok &= Check(add_threw && exists_threw,
+                  "packed db batch statements report SQLITE_BUSY");
+    }
+
+    db.BeginTransaction();
+    db.Add("rolled1");
+    db.RollbackTransaction();
+    ok &= Check(db.Add("other5") && db.Exists("other5") && !db.Exists("rolled1"),
+                "packed db label cache survives rollback");
+
+    std::vector<std::string> all = db.GetAllIds();
+    std::sort(all.begin(), all.end());
+    const std::vector<std::string> expected = {
+        "ABC123", "abc00123", "b12345678901", "heyzo0042",
+        "new77",  "other5",   "xyz",          "zz"};
+    ok &= Check(all == expected, "packed db round-trips all ids");
+  } catch (const std::exception& ex) {
+    ok &= Check(false, std::string("packed db unexpected exception: ") + ex.what());
+  }
+  std::filesystem::remove(db_file, ec);
+
+  // 标签字典已满：新标签下的 ID 存入文本表，且仍能查到；
+  // 旧版本留下的越界标签不得用于编码
+  try {
+    { PackedIdDB created(db_file.string()); }
+    {
+      sqlite3* raw = nullptr;
+      sqlite3_open(db_file.string().c_str(), &raw);
+      const std::string sql =
+          "INSERT INTO id_labels (label_id, label) VALUES (" +
+          std::to_string(PackedIdCodec::kMaxLabelId) + ", 'last'), (" +
+          std::to_string(PackedIdCodec::kMaxLabelId + 5ULL) + ", 'stale');";
+      sqlite3_exec(raw, sql.c_str(), nullptr, nullptr, nullptr);
+      sqlite3_close(raw);
+    }
+    PackedIdDB db(db_file.string());
+    ok &= Check(db.Add("last1") && db.Add("fresh1") && db.Add("stale1"),
+                "packed db adds ids once the label dictionary is full");
+    ok &= Check(db.Exists("last1") && db.Exists("fresh1") &&
+                    db.Exists("stale1"),
+                "packed db finds ids stored while the dictionary is full");
+    const std::vector<std::string_view> probe = {"fresh1", "stale1", "fresh2"};
+    const std::vector<bool> found = db.ExistsMany(probe);
+    ok &= Check(found[0] && found[1] && !found[2],
+                "packed db ExistsMany checks the overflow table");
+    const std::vector<bool> added = db.AddMany(probe);
+    ok &= Check(!added[0] && !added[1] && added[2] && db.GetCount() == 4,
+                "packed db AddMany does not re-insert overflowed ids");
+    std::vector<std::string> all = db.GetAllIds();
+    std::sort(all.begin(), all.end());
+    ok &= Check(all == std::vector<std::string>{"fresh1", "fresh2", "last1",
+                                                "stale1"},
+                "packed db never encodes an over-limit label");
+  } catch (const std::exception& ex) {
+    ok &= Check(false, std::string("packed db full dictionary threw: ") +
+                           ex.what());
+  }
+
+  std::filesystem::remove(db_file, ec);
+  return ok;
+}
+
+auto TestIdHashIndex() -> bool {
+  bool ok = true;
+  IdHashIndex index;
+  for (int i = 0; i < 5000; ++i) {
+    index.Insert("ABC" + std::to_string(i));
+  }
+  const std::string long_id = "VERYLONGLABELNAME1234567";
+  ok &= Check(index.Insert(long_id), "hash index inserts arena id");
+  ok &= Check(!index.Insert("ABC42"), "hash index rejects duplicate");
+  ok &= Check(index.Size() == 5001, "hash index size after growth");
+  ok &= Check(index.Contains("ABC4999") && index.Contains(long_id),
+              "hash index finds inline and arena ids");
+  ok &= Check(!index.Contains("ABC5000") && !index.Contains("VERYLONGLABELNAME1"),
+              "hash index misses absent ids");
+  index.Clear();
+  ok &= Check(index.Size() == 0 && !index.Contains("ABC1"), "hash index clears");
+  return ok;
+}
+
+auto TestHashIndexRepository() -> bool {
+  const auto db_file =
+      std::filesystem::temp_directory_path() / "avlib_core_tests_hash.sqlite3";
+  std::error_code ec;
+  std::filesystem::remove(db_file, ec);
+
+  bool ok = true;
+  try {
+    {
+      FastQueryDB seed(db_file.string());
+      seed.Add("abc1");
+    }
+    HashIndexRepository repo(std::make_unique<FastQueryDB>(db_file.string()));
+    ok &= Check(repo.Exists("abc1"), "hash repo loads existing ids");
+    ok &= Check(repo.GetStats().memory_bytes > 0, "hash repo reports memory");
+
+    const std::vector<bool> added =
+        repo.AddMany(std::vector<std::string_view>{"abc1", "abc2"});
+    ok &= Check(!added[0] && added[1], "hash repo AddMany writes through");
+    repo.BeginTransaction();
+    repo.Add("abc3");
+    repo.RollbackTransaction();
+    ok &= Check(!repo.Exists("abc3"), "hash repo forgets rolled back ids");
+
+    FastQueryDB check(db_file.string());
+    ok &= Check(check.Exists("abc2") && check.GetCount() == 2,
+                "hash repo persists to sqlite");
+  } catch (const std::exception& ex) {
+    ok &= Check(false, std::string("hash repo unexpected exception: ") + ex.what());
+  }
+
+  std::filesystem::remove(db_file, ec);
+  return ok;
+}
+
+auto TestBloomFilter() -> bool {
+  bool ok = true;
+  BloomFilter filter(20000, 0.01);
+  for (int i = 0; i < 20000; ++i) {
+    filter.Insert("ABC" + std::to_string(i));
+  }
+  bool no_false_negative = true;
+  for (int i = 0; i < 20000; ++i) {
+    no_false_negative &= filter.MayContain("ABC" + std::to_string(i));
+  }
+  ok &= Check(no_false_negative, "bloom filter has no false negatives");
+  int false_positives = 0;
+  for (int i = 0; i < 20000; ++i) {
+    false_positives += filter.MayContain("XYZ" + std::to_string(i)) ? 1 : 0;
+  }
+  ok &= Check(false_positives < 600, "bloom filter false positive rate near target");
+
+  const auto db_file =
+      std::filesystem::temp_directory_path() / "avlib_core_tests_bloom.sqlite3";
+  const std::string bloom_file = db_file.string() + ".bloom";
+  std::error_code ec;
+  std::filesystem::remove(db_file, ec);
+  std::filesystem::remove(bloom_file, ec);
+
+  try {
+    filter.Save(bloom_file, 7);
+    uint64_t generation = 0;
+    const auto loaded = BloomFilter::Load(bloom_file, generation);
+    ok &= Check(loaded && generation == 7 && loaded->MayContain("ABC123") &&
+                    loaded->InsertedCount() == 20000,
+                "bloom filter save/load round trip");
+    std::filesystem::remove(bloom_file, ec);
+
+    {
+      FastQueryDB db(db_file.string());
+      db.AddMany(std::vector<std::string_view>{"abc1", "abc2"});
+      ok &= Check(!db.GetStats().filter.loaded, "filter is opt-in");
+      ok &= Check(db.RebuildFilter(0.01), "filter rebuilds");
+      db.Add("abc3");
+      ok &= Check(db.Exists("abc3") && db.Exists("abc1") && !db.Exists("zzz9"),
+                  "filtered lookups stay exact");
+      const FilterStats stats = db.GetStats().filter;
+      ok &= Check(stats.loaded && !stats.stale && stats.lookups == 3 &&
+                      stats.rejected + stats.false_positives == 1,
+                  "filter counters track lookups");
+    }
+    ok &= Check(std::filesystem::exists(bloom_file), "filter persisted on close");
+
+    // 外部连接写入后，过滤器不再覆盖全部 ID，必须退回直接查询
+    {
+      FastQueryDB db(db_file.string());
+      ok &= Check(db.GetStats().filter.loaded, "filter reloads on open");
+      sqlite3* raw = nullptr;
+      sqlite3_open(db_file.string().c_str(), &raw);
+      sqlite3_exec(raw, "INSERT INTO ids VALUES ('ext1');", nullptr, nullptr,
+                   nullptr);
+      sqlite3_close(raw);
+      ok &= Check(db.Exists("ext1") && db.GetStats().filter.stale,
+                  "filter detects external writers");
+
+      // 重建时库被另一个连接排他锁住：不能保存缺了 ID 的过滤器
+      sqlite3_open(db_file.string().c_str(), &raw);
+      sqlite3_exec(raw, "BEGIN EXCLUSIVE;", nullptr, nullptr, nullptr);
+      const bool rebuilt = db.RebuildFilter(0.01);
+      sqlite3_exec(raw, "ROLLBACK;", nullptr, nullptr, nullptr);
+      sqlite3_close(raw);
+      ok &= Check(!rebuilt && db.Exists("abc1") && db.Exists("ext1"),
+                  "filter rebuild fails on an interrupted scan");
+    }
+  } catch (const std::exception& ex) {
+    ok &= Check(false, std::string("bloom unexpected exception: ") + ex.what());
+  }
+
+  std::filesystem::remove(db_file, ec);
+  std::filesystem::remove(bloom_file, ec);
+  return ok;
+}
+
+auto TestIdSnapshot() -> bool {
+  const auto snapshot_file =
+      std::filesystem::temp_directory_path() / "avlib_core_tests.avidx";
+  std::error_code ec;
+  std::filesystem::remove(snapshot_file, ec);
+
+  bool ok = true;
+  try {
+    // 大量公共前缀、长短不一，并含重复项
+    std::vector<std::string> ids;
+    for (int i = 0; i < 3000; ++i) {
+      ids.push_back("ABC" + std::to_string(i * 7));
+      ids.push_back("LONGLABELNAME" + std::to_string(i));
+    }
+    ids.push_back("A1");
+    ids.push_back("ABC7");
+    IdSnapshot::Write(snapshot_file.string(), ids, IdSnapshot::SourceStamp{42, 7, 3});
+
+    const auto stamp = IdSnapshot::ReadSourceStamp(snapshot_file.string());
+    ok &= Check(stamp && stamp->size == 42 && stamp->mtime_ns == 7 &&
+                    stamp->change_counter == 3,
+                "snapshot records source stamp");
+
+    SnapshotRepository repo(snapshot_file.string());
+    ok &= Check(repo.GetCount() == 6001 && repo.IsReadOnly(),
+                "snapshot dedups ids");
+    bool all_found = true;
+    for (const auto& id : ids) {
+      all_found &= repo.Exists(id);
+    }
+    ok &= Check(all_found, "snapshot finds every id");
+    ok &= Check(!repo.Exists("A") && !repo.Exists("A0") && !repo.Exists("ABC") &&
+                    !repo.Exists("ABC8") && !repo.Exists("ABC70000") &&
+                    !repo.Exists("LONGLABELNAME") && !repo.Exists("ZZZ1") &&
+                    !repo.Exists(""),
+                "snapshot rejects absent ids");
+
+    std::vector<std::string> expected = ids;
+    std::sort(expected.begin(), expected.end());
+    expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+    ok &= Check(repo.GetAllIds() == expected, "snapshot round-trips all ids");
+
+    bool threw = false;
+    try {
+      repo.Add("NEW1");
+    } catch (const std::logic_error&) {
+      threw = true;
+    }
+    ok &= Check(threw, "snapshot rejects writes");
+  } catch (const std::exception& ex) {
+    ok &= Check(false, std::string("snapshot unexpected exception: ") + ex.what());
+  }
+
+  try {
+    IdSnapshot::Write(snapshot_file.string(), {}, IdSnapshot::SourceStamp{});
+    SnapshotRepository empty(snapshot_file.string());
+    ok &= Check(empty.GetCount() == 0 && !empty.Exists("ABC1"),
+                "empty snapshot opens");
+  } catch (const std::exception& ex) {
+    ok &= Check(false, std::string("empty snapshot exception: ") + ex.what());
+  }
+
+  // 大小与修改时间都没变的提交也会让快照引擎重新生成快照
+  const auto dir =
+      std::filesystem::temp_directory_path() / "avlib_core_tests_snapshot_db";
+  std::filesystem::remove_all(dir, ec);
+  try {
+    DatabaseManager manager(dir.string());
+    manager.CreateDatabase("snap");
+    manager.GetCurrentDb()->Add("ABC1");
+    manager.SetQueryEngine("snap.sqlite3", QueryEngine::kSnapshot);
+    const auto db_file = dir / "snap.sqlite3";
+    const auto size = std::filesystem::file_size(db_file);
+    const auto mtime = std::filesystem::last_write_time(db_file);
+    {
+      FastQueryDB other(db_file.string());
+      other.Add("ABC2");
+    }
+    std::filesystem::last_write_time(db_file, mtime);
+    manager.SetQueryEngine("snap.sqlite3", QueryEngine::kSqlite);
+    manager.SetQueryEngine("snap.sqlite3", QueryEngine::kSnapshot);
+    ok &= Check(std::filesystem::file_size(db_file) == size &&
+                    manager.GetCurrentDb()->Exists("ABC2"),
+                "snapshot refreshes after a same-size commit");
+  } catch (const std::exception& ex) {
+    ok &= Check(false, std::string("snapshot engine exception: ") + ex.what());
+  }
+
+  std::filesystem::remove(snapshot_file, ec);
+  std::filesystem::remove_all(dir, ec);
+  return ok;
+}
+
+auto TestStreamingExport() -> bool {
+  const auto dir = std::filesystem::temp_directory_path();
+  const auto db_file = dir / "avlib_core_tests_stream.sqlite3";
+  const auto packed_file = dir / "avlib_core_tests_stream_packed.sqlite3";
+  const auto text_file = dir / "avlib_core_tests_stream.txt";
+  std::error_code ec;
+  std::filesystem::remove(db_file, ec);
+  std::filesystem::remove(packed_file, ec);
+
+  bool ok = true;
+  try {
+    std::vector<std::string> ids;
+    for (int i = 0; i < 2500; ++i) {
+      ids.push_back("ABC" + std::to_string(i));
+    }
+    ids.push_back("VERYLONGLABELNAME1");
+    const std::vector<std::string_view> id_views(ids.begin(), ids.end());
+    {
+      FastQueryDB db(db_file.string());
+      db.AddMany(id_views);
+    }
+    {
+      PackedIdDB db(packed_file.string());
+      db.AddMany(id_views);
+    }
+    std::vector<std::string> expected = ids;
+    std::sort(expected.begin(), expected.end());
+
+    auto collect = [&](const IIdRepository& repo, const std::string& name,
+                       const std::filesystem::path& path) {
+      std::vector<std::string> seen;
+      size_t chunks = 0;
+      const bool completed =
+          repo.ForEachId([&](std::span<const std::string_view> chunk) {
+            ++chunks;
+            seen.insert(seen.end(), chunk.begin(), chunk.end());
+            return chunk.size() <= 1024;
+          });
+      std::sort(seen.begin(), seen.end());
+      ok &= Check(completed && chunks >= 3 && seen == expected,
+                  name + " ForEachId visits every id in chunks");
+
+      size_t first_only = 0;
+      const bool stopped = !repo.ForEachId(
+          [&](std::span<const std::string_view> chunk) {
+            first_only += chunk.size();
+            return false;
+          });
+      ok &= Check(stopped && first_only > 0 && first_only < expected.size(),
+                  name + " ForEachId stops when asked");
+
+      // 另一个连接持有排他锁：遍历必须报错，而不是当作空库遍历完成
+      sqlite3* raw = nullptr;
+      sqlite3_open(path.string().c_str(), &raw);
+      sqlite3_exec(raw, "BEGIN EXCLUSIVE;", nullptr, nullptr, nullptr);
+      const auto keep_going = [](std::span<const std::string_view>) {
+        return true;
+      };
+      bool scan_threw = false;
+      bool sorted_threw = false;
+      try {
+        (void)repo.ForEachId(keep_going);
+      } catch (const std::runtime_error&) {
+        scan_threw = true;
+      }
+      try {
+        (void)repo.ForEachIdSorted(keep_going);
+      } catch (const std::runtime_error&) {
+        sorted_threw = true;
+      }
+      sqlite3_exec(raw, "ROLLBACK;", nullptr, nullptr, nullptr);
+      sqlite3_close(raw);
+      ok &= Check(scan_threw && sorted_threw,
+                  name + " ForEachId reports a locked database");
+    };
+    collect(FastQueryDB(db_file.string()), "text layout", db_file);
+    collect(PackedIdDB(packed_file.string()), "packed layout", packed_file);
+
+    // 极小缓冲区，覆盖整块写出与超长行直写两条路径
+    {
+      IO::BufferedTextWriter writer(text_file.string(), 8);
+      writer.WriteLine("ABC1");
+      writer.WriteLine("VERYLONGLABELNAME1");
+      writer.WriteLine("");
+      writer.WriteLine("XYZ2");
+      writer.Close();
+      ok &= Check(writer.LinesWritten() == 4, "writer counts lines");
+    }
+    std::ifstream in(text_file);
+    const std::string content((std::istreambuf_iterator<char>(in)),
+                              std::istreambuf_iterator<char>());
+    ok &= Check(content == "ABC1\nVERYLONGLABELNAME1\n\nXYZ2\n",
+                "writer output matches input lines");
+  } catch (const std::exception& ex) {
+    ok &= Check(false, std::string("stream unexpected exception: ") + ex.what());
+  }
+
+  std::filesystem::remove(db_file, ec);
+  std::filesystem::remove(packed_file, ec);
+  std::filesystem::remove(text_file, ec);
+  return ok;
+}
+
+auto TestImportPipeline() -> bool {
+  bool ok = true;
+  {
+    Concurrency::BoundedQueue<int> queue(2);
+    ok &= Check(queue.Push(1) && queue.Push(2), "queue accepts up to capacity");
+    queue.Close();
+    ok &= Check(!queue.Push(3), "closed queue rejects pushes");
+    const auto a = queue.Pop();
+    const auto b = queue.Pop();
+    ok &= Check(a == 1 && b == 2 && !queue.Pop(), "closed queue drains then ends");
+  }
+
+  const auto dir = std::filesystem::temp_directory_path();
+  const auto db_file = dir / "avlib_core_tests_pipeline.sqlite3";
+  const auto text_file = dir / "avlib_core_tests_pipeline.txt";
+  std::error_code ec;
+  std::filesystem::remove(db_file, ec);
+  {
+    std::ofstream out(text_file);
+    for (int i = 0; i < 20000; ++i) {
+      out << "ABC-" << i << "\r\n";
+      if (i % 10 == 0) {
+        out << "ABC" << i << '\n';  // 与上一行规范化后相同
+      }
+      if (i % 100 == 0) {
+        out << "12-bad\n";
+      }
+    }
+  }
+
+  try {
+    FastQueryDB db(db_file.string());
+    db.Add("ABC5");
+    IO::TextFileReader reader;
+    ImportOptions options;
+    options.worker_count = 3;
+    options.commit_batch_size = 1000;
+    options.read_batch_lines = 500;
+    options.queue_depth = 2;
+    const ImportCounts counts =
+        ImportPipeline::Run(reader, text_file.string(), db, options);
+    ok &= Check(counts.line_count == 22200, "pipeline reads every line");
+    ok &= Check(counts.invalid_format_count == 200, "pipeline counts invalid lines");
+    ok &= Check(counts.success_count == 19999 && counts.exist_count == 2001,
+                "pipeline counts new and existing ids");
+    ok &= Check(db.GetCount() == 20000 && db.Exists("ABC19999"),
+                "pipeline commits every batch");
+
+    IO::MappedTextReader mapped_reader;
+    const ImportCounts again =
+        ImportPipeline::Run(mapped_reader, text_file.string(), db, options);
+    ok &= Check(again.line_count == 22200 && again.success_count == 0 &&
+                    again.exist_count == 22000,
+                "pipeline runs on the mapped reader");
+
+    bool threw = false;
+    try {
+      ImportPipeline::Run(reader, (dir / "avlib_missing_file.txt").string(), db,
+                          options);
+    } catch (const std::runtime_error&) {
+      threw = true;
+    }
+    ok &= Check(threw && db.GetCount() == 20000,
+                "pipeline reports reader failures");
+  } catch (const std::exception& ex) {
+    ok &= Check(false, std::string("pipeline unexpected exception: ") + ex.what());
+  }
+
+  std::filesystem::remove(db_file, ec);
+  std::filesystem::remove(text_file, ec);
+  return ok;
+}
+
+auto TestMappedTextReader() -> bool {
+  const auto temp_file =
+      std::filesystem::temp_directory_path() / "avlib_core_tests_mapped.txt";
+  bool ok = true;
+  IO::MappedTextReader reader;
+  try {
+    {
+      std::ofstream out(temp_file.string(), std::ios::binary);
+      out << "line1\r\nline2\n\nline3\r\nlast";
+    }
+    const std::vector<std::string> lines = reader.ReadAllLines(temp_file.string());
+    ok &= Check(lines == std::vector<std::string>{"line1", "line2", "", "line3",
+                                                  "last"},
+                "mapped reader splits lines and trims CR");
+
+    // 批次在读取函数返回、原文件被删除后依然有效
+    std::vector<LineBatch> batches;
+    reader.ReadLineBatches(temp_file.string(), 2, [&](LineBatch&& batch) {
+      batches.push_back(std::move(batch));
+      return true;
+    });
+    std::filesystem::remove(temp_file);
+    ok &= Check(batches.size() == 3 && batches[2].lines.size() == 1 &&
+                    batches[0].lines[0] == "line1" &&
+                    batches[2].lines[0] == "last",
+                "mapped reader batches outlive the call");
+
+    {
+      std::ofstream out(temp_file.string(), std::ios::binary);
+    }
+    ok &= Check(reader.ReadAllLines(temp_file.string()).empty(),
+                "mapped reader handles empty files");
+  } catch (const std::exception& ex) {
+    ok &= Check(false, std::string("mapped reader unexpected exception: ") + ex.what());
+  }
+
+  bool threw = false;
+  try {
+    reader.ReadAllLines((temp_file.parent_path() / "avlib_missing.txt").string());
+  } catch (const std::runtime_error&) {
+    threw = true;
+  }
+  ok &= Check(threw, "mapped reader throws on missing file");
+
+  std::error_code ec;
+  std::filesystem::remove(temp_file, ec);
+  return ok;
+}
+
+auto TestBatchValidator() -> bool {
+  bool ok = true;
+  // 随机生成的行首尾相接放在同一块缓冲区里，覆盖任意对齐与缓冲区末尾
+  constexpr std::string_view kAlphabet = "aZbY09-- \t\t_.#\xe3\x80";
+  std::mt19937 rng(20240611);
+  std::uniform_int_distribution<size_t> length_dist(0, 40);
+  std::uniform_int_distribution<size_t> char_dist(0, kAlphabet.size() - 1);
+  std::vector<size_t> lengths;
+  std::string pool;
+  for (int i = 0; i < 20000; ++i) {
+    // 一半的行按合法形状拼出，否则随机串几乎全部非法
+    std::string line;
+    if (i % 50 == 1) {
+      constexpr std::array<std::string_view, 4> kVendorIds{
+          "HEYZO-0904", "FC2-PPV-1234567", "031315-827", "091416_382"};
+      line = kVendorIds[static_cast<size_t>(i / 50) % kVendorIds.size()];
+    } else if (i % 2 == 0) {
+      line.append(1 + length_dist(rng) % 6, static_cast<char>('A' + i % 26));
+      line.append(length_dist(rng) % 3, (i % 3 == 0) ? '\t' : ' ');
+      if (i % 4 == 0) {
+        line.push_back('-');
+      }
+      line.append(length_dist(rng) % 8, static_cast<char>('0' + i % 10));
+      if (i % 10 == 0 && !line.empty()) {
+        line[char_dist(rng) % line.size()] = kAlphabet[char_dist(rng)];
+      }
+    } else {
+      const size_t length = length_dist(rng);
+      for (size_t k = 0; k < length; ++k) {
+        line.push_back(kAlphabet[char_dist(rng)]);
+      }
+    }
+    lengths.push_back(line.size());
+    pool += line;
+  }
+  pool.shrink_to_fit();
+  std::vector<std::string_view> lines;
+  size_t offset = 0;
+  for (const size_t length : lengths) {
+    lines.emplace_back(pool.data() + offset, length);
+    offset += length;
+  }
+
+  Validator::CanonicalIdBuffer expected;
+  for (size_t i = 0; i < lines.size(); ++i) {
+    if (Validator::IsValidIdFormat(lines[i])) {
+      expected.ids.Append(Validator::CanonicalizeId(lines[i]));
+      expected.sources.push_back(static_cast<uint32_t>(i));
+    } else {
+      expected.invalid_count++;
+    }
+  }
+  ok &= Check(expected.Size() > 1000 && expected.invalid_count > 1000,
+              "batch validator test data mixes valid and invalid lines");
+
+  for (const auto kernel : {Validator::BatchKernel::kScalar,
+                            Validator::BatchKernel::kSse2,
+                            Validator::BatchKernel::kAvx2}) {
+    if (!Validator::IsBatchKernelSupported(kernel)) {
+      continue;
+    }
+    const std::string name = std::to_string(static_cast<int>(kernel));
+    Validator::CanonicalIdBuffer actual;
+    Validator::ValidateBatch(lines, actual, kernel);
+    ok &= Check(actual.ids == expected.ids &&
+                    actual.sources == expected.sources &&
+                    actual.invalid_count == expected.invalid_count,
+                "batch validator kernel " + name + " matches scalar validator");
+  }
+
+  Validator::CanonicalIdBuffer buffer;
+  const std::vector<std::string_view> sample{"abc-123", "x", "DEF \t45"};
+  Validator::ValidateBatch(sample, buffer);
+  ok &= Check(buffer.Size() == 2 && buffer[0] == "abc123" &&
+                  buffer[1] == "DEF45" && buffer.sources[1] == 2 &&
+                  buffer.invalid_count == 1,
+              "batch validator canonicalizes and records sources");
+  return ok;
+}
+
+// 只含一个库的目录，供 Application 测试使用
+class SingleDbCatalog : public IDatabaseCatalog {
+ public:
+  explicit SingleDbCatalog(std::unique_ptr<IIdRepository> db)
+      : db_(std::move(db)) {}
+
+  void LoadDefaultDatabase() override {}
+  auto CreateDatabase(const std::string& /*db_name_raw*/) -> bool override {
+    return false;
+  }
+  auto SwitchToDatabase(const std::string& db_name) -> bool override {
+    return db_name == name_;
+  }
+  auto DeleteDatabase(const std::string& /*db_name*/) -> bool override {
+    return false;
+  }
+  [[nodiscard]] auto DatabaseExists(const std::string& db_name) const
+      -> bool override {
+    return db_name == name_;
+  }
+  auto MigrateToPackedLayout(const std::string& /*db_name*/)
+      -> std::optional<LayoutMigrationReport> override {
+    return std::nullopt;
+  }
+  auto SetQueryEngine(const std::string& /*db_name*/, QueryEngine /*engine*/)
+      -> bool override {
+    return false;
+  }
+  [[nodiscard]] auto GetQueryEngine(const std::string& /*db_name*/) const
+      -> QueryEngine override {
+    return QueryEngine::kSqlite;
+  }
+  auto ExistsInAll(std::span<const std::string_view> ids)
+      -> CrossDbLookup override {
+    return {{name_}, {db_->ExistsMany(ids)}};
+  }
+  auto GetCrossDbStats() -> CrossDbStats override {
+    const size_t count = db_->GetCount();
+    return {{name_}, {count}, count, count, 0};
+  }
+  auto OpenReader(const std::string& /*db_name*/)
+      -> std::unique_ptr<IIdRepository> override {
+    return nullptr;
+  }
+  void SetMemoryBudget(size_t /*budget_bytes*/) override {}
+  [[nodiscard]] auto GetMemoryStats() const -> CatalogMemoryStats override {
+    return {};
+  }
+  [[nodiscard]] auto GetCurrentDb() const -> IIdRepository* override {
+    return db_.get();
+  }
+  [[nodiscard]] auto GetCurrentDbName() const -> const std::string& override {
+    return name_;
+  }
+  [[nodiscard]] auto GetAllDbNames() const
+      -> std::vector<std::string> override {
+    return {name_};
+  }
+  auto ListDatabases() -> std::vector<DatabaseInfo> override {
+    DatabaseInfo info;
+    info.name = name_;
+    info.record_count = db_->GetCount();
+    return {info};
+  }
+
+ private:
+  std::unique_ptr<IIdRepository> db_;
+  std::string name_ = "test.sqlite3";
+};
+
+// 第 fail_at 次 AddMany 时抛出，模拟导入中途的写入失败（如磁盘已满）
+class FailingAddRepository : public IIdRepository {
+ public:
+  FailingAddRepository(std::unique_ptr<IIdRepository> inner, size_t fail_at)
+      : inner_(std::move(inner)), fail_at_(fail_at) {}
+
+  auto Add(const std::string& id) -> bool override { return inner_->Add(id); }
+  [[nodiscard]] auto Exists(const std::string& id) const -> bool override {
+    return inner_->Exists(id);
+  }
+  [[nodiscard]] auto GetCount() const -> size_t override {
+    return inner_->GetCount();
+  }
+  [[nodiscard]] auto GetAllIds() const -> std::vector<std::string> override {
+    return inner_->GetAllIds();
+  }
+  auto ForEachId(const IdChunkVisitor& visitor) const -> bool override {
+    return inner_->ForEachId(visitor);
+  }
+  auto ForEachIdSorted(const IdChunkVisitor& visitor) const -> bool override {
+    return inner_->ForEachIdSorted(visitor);
+  }
+  [[nodiscard]] auto ExistsMany(std::span<const std::string_view> ids) const
+      -> std::vector<bool> override {
+    return inner_->ExistsMany(ids);
+  }
+  auto AddMany(std::span<const std::string_view> ids)
+      -> std::vector<bool> override {
+    if (++add_calls_ == fail_at_) {
+      throw std::runtime_error("database or disk is full");
+    }
+    return inner_->AddMany(ids);
+  }
+  [[nodiscard]] auto GetStats() const -> RepositoryStats override {
+    return inner_->GetStats();
+  }
+  auto RebuildFilter(double false_positive_rate) -> bool override {
+    return inner_->RebuildFilter(false_positive_rate);
+  }
+  [[nodiscard]] auto IsReadOnly() const -> bool override {
+    return inner_->IsReadOnly();
+  }
+  void BeginTransaction() override { inner_->BeginTransaction(); }
+  void CommitTransaction() override { inner_->CommitTransaction(); }
+  void RollbackTransaction() override { inner_->RollbackTransaction(); }
+
+ private:
+  std::unique_ptr<IIdRepository> inner_;
+  size_t fail_at_;
+  size_t add_calls_ = 0;
+};
+
+auto TestApplicationAllocations() -> bool {
+  const auto db_file =
+      std::filesystem::temp_directory_path() / "avlib_core_tests_app.sqlite3";
+  std::error_code ec;
+  std::filesystem::remove(db_file, ec);
+
+  bool ok = true;
+  try {
+    Application app(std::make_unique<SingleDbCatalog>(
+        std::make_unique<FastQueryDB>(db_file.string())));
+
+    // 标签故意超过短字符串优化的长度，逐个分配会直接体现在计数上
+    constexpr size_t kBatch = 2000;
+    auto make_input = [](size_t round) {
+      std::string text;
+      for (size_t i = 0; i < kBatch; ++i) {
+        text += "LONGVENDORLABEL-" + std::to_string(round * kBatch + i) + ' ';
+      }
+      text += "bad_id";
+      return text;
+    };
+    auto split = [](const std::string& text) {
+      std::vector<std::string_view> views;
+      size_t begin = 0;
+      while (begin < text.size()) {
+        const size_t end = std::min(text.find(' ', begin), text.size());
+        views.emplace_back(text.data() + begin, end - begin);
+        begin = end + 1;
+      }
+      return views;
+    };
+
+    // 预热：让复用缓冲区达到稳态容量
+    for (size_t round = 0; round < 2; ++round) {
+      const std::string text = make_input(round);
+      const std::vector<std::string_view> ids = split(text);
+      app.PerformAdd(ids);
+      app.PerformQuery(ids);
+    }
+
+    const std::string text = make_input(2);
+    const std::vector<std::string_view> ids = split(text);
+    const size_t before_add = g_allocation_count.load();
+    const AddResult added = app.PerformAdd(ids);
+    const size_t add_allocations = g_allocation_count.load() - before_add;
+    const size_t before_query = g_allocation_count.load();
+    const QueryResult queried = app.PerformQuery(ids);
+    const size_t query_allocations = g_allocation_count.load() - before_query;
+
+    ok &= Check(added.success_count == kBatch && added.invalid_format_count == 1,
+                "app add counts new and invalid ids");
+    ok &= Check(queried.found_count == kBatch && queried.invalid_format_count == 1 &&
+                    queried.invalid_ids[0] == "bad_id" &&
+                    queried.found_ids[0] == "LONGVENDORLABEL-4000",
+                "app query keeps original spelling");
+    ok &= Check(add_allocations < 32,
+                "app add does not allocate per id (" +
+                    std::to_string(add_allocations) + " allocations)");
+    ok &= Check(query_allocations < 32,
+                "app query does not allocate per id (" +
+                    std::to_string(query_allocations) + " allocations)");
+
+    // 任意字符串区间经重载转为视图
+    const std::vector<std::string> owned = {"abc1", "", "zz"};
+    const AddResult owned_result = app.PerformAdd(owned);
+    ok &= Check(owned_result.success_count == 1 &&
+                    owned_result.invalid_format_count == 1,
+                "app add accepts string ranges and skips empty entries");
+  } catch (const std::exception& ex) {
+    ok &= Check(false, std::string("app allocation test exception: ") + ex.what());
+  }
+  std::filesystem::remove(db_file, ec);
+  return ok;
+}
+
+auto TestImportFailureReporting() -> bool {
+  const auto dir = std::filesystem::temp_directory_path();
+  const auto db_file = dir / "avlib_core_tests_import_fail.sqlite3";
+  const auto text_file = dir / "avlib_core_tests_import_fail.txt";
+  std::error_code ec;
+  std::filesystem::remove(db_file, ec);
+  {
+    std::ofstream out(text_file);
+    for (int i = 0; i < 5000; ++i) {
+      out << "XYZ-" << i << '\n';
+    }
+  }
+
+  bool ok = true;
+  try {
+    // 每批 500 个 ID、每 1000 个提交一次，第 5 批写入时失败
+    Application app(std::make_unique<SingleDbCatalog>(
+        std::make_unique<FailingAddRepository>(
+            std::make_unique<FastQueryDB>(db_file.string()), 5)));
+    ImportOptions options;
+    options.worker_count = 1;
+    options.commit_batch_size = 1000;
+    options.read_batch_lines = 500;
+    IO::TextFileReader reader;
+
+    const ImportResult missing = app.PerformImportFile(
+        reader, (dir / "avlib_missing_file.txt").string(), options);
+    ok &= Check(app.GetLastError() == ErrorCode::kFileOpenFailed &&
+                    missing.success_count == 0,
+                "import of a missing file reports open failure");
+
+    const ImportResult failed =
+        app.PerformImportFile(reader, text_file.string(), options);
+    ok &= Check(app.GetLastError() == ErrorCode::kImportFailed,
+                "mid-import write failure is not reported as open failure");
+    ok &= Check(failed.success_count == 2000,
+                "import failure reports the committed counts");
+  } catch (const std::exception& ex) {
+    ok &= Check(false,
+                std::string("import failure test exception: ") + ex.what());
+  }
+  try {
+    const FastQueryDB db(db_file.string());
+    ok &= Check(db.GetCount() == 2000,
+                "import failure keeps exactly the committed batches");
+  } catch (const std::exception& ex) {
+    ok &= Check(false,
+                std::string("import failure test exception: ") + ex.what());
+  }
+  std::filesystem::remove(db_file, ec);
+  std::filesystem::remove(text_file, ec);
+  return ok;
+}
+
+auto BinaryFrame(Service::QueryProtocol::Opcode opcode, std::string_view payload)
+    -> std::string {
+  std::string frame(1, Service::QueryProtocol::kBinaryMarker);
+  frame.push_back(static_cast<char>(opcode));
+  for (size_t i = 0; i < 4; ++i) {
+    frame.push_back(static_cast<char>((payload.size() >> (8 * i)) & 0xFF));
+  }
+  frame.append(payload);
+  return frame;
+}
+
+auto TestQueryProtocol() -> bool {
+  const auto db_file =
+      std::filesystem::temp_directory_path() / "avlib_core_tests_protocol.sqlite3";
+  std::error_code ec;
+  std::filesystem::remove(db_file, ec);
+
+  bool ok = true;
+  try {
+    Application app(std::make_unique<SingleDbCatalog>(
+        std::make_unique<FastQueryDB>(db_file.string())));
+    Service::ServiceCounters counters;
+    Service::QueryProtocol protocol(app, counters);
+    using Opcode = Service::QueryProtocol::Opcode;
+
+    std::string output;
+    const std::string adds = "add\tABC-123\tABC123\tbad_id\r\nping\n";
+    ok &= Check(protocol.Consume(adds, output) == adds.size() &&
+                    output == "ok\tadded\texists\tinvalid\nok\n",
+                "protocol text add and ping");
+
+    // 相邻查询帧合并为一批；末尾不完整的请求留待下次
+    output.clear();
+    const std::string pipelined =
+        "query\tABC 123\nquery\tzz9\t\n" + BinaryFrame(Opcode::kQuery, "ABC123\nbad_id\n") +
+        "query\tabc";
+    const std::optional<size_t> consumed = protocol.Consume(pipelined, output);
+    std::string expected = "ok\tfound\nok\tmissing\tskipped\n";
+    expected.append(1, '\0').append(1, '\0').append("\x02\0\0\0", 4);
+    expected.push_back(static_cast<char>(IdOutcome::kFound));
+    expected.push_back(static_cast<char>(IdOutcome::kInvalid));
+    ok &= Check(consumed == pipelined.size() - 9, "protocol keeps partial request");
+    ok &= Check(output == expected, "protocol pipelined text and binary replies");
+    const Service::ServiceStats stats = counters.Snapshot();
+    ok &= Check(stats.requests == 5 && stats.batches == 2 &&
+                    stats.ids_queried == 5 && stats.ids_added == 3,
+                "protocol counts requests and merged batches");
+
+    output.clear();
+    protocol.Consume("frob\nuse\tmissing.sqlite3\nquery\n", output);
+    ok &= Check(output == "error\tunknown_command\nerror\tdb_not_exist\nerror\tno_ids\n",
+                "protocol reports errors per request");
+    output.clear();
+    protocol.Consume("stats\n", output);
+    ok &= Check(output.starts_with("ok\tdb=test.sqlite3\trecords=1\t") &&
+                    output.find("\terrors=3\t") != std::string::npos,
+                "protocol stats include request counters");
+
+    output.clear();
+    const std::string huge(Service::QueryProtocol::kMaxLineBytes + 1, 'a');
+    ok &= Check(!protocol.Consume(huge, output).has_value() &&
+                    output == "error\trequest_too_large\n",
+                "protocol rejects oversized lines");
+  } catch (const std::exception& ex) {
+    ok &= Check(false, std::string("protocol test exception: ") + ex.what());
+  }
+  std::filesystem::remove(db_file, ec);
+  return ok;
+}
+
+auto TestUnixSocketServer() -> bool {
+#ifdef __linux__
+  const auto db_file =
+      std::filesystem::temp_directory_path() / "avlib_core_tests_server.sqlite3";
+  const auto socket_file =
+      std::filesystem::temp_directory_path() / "avlib_core_tests.sock";
+  std::error_code ec;
+  std::filesystem::remove(db_file, ec);
+
+  bool ok = true;
+  try {
+    Application app(std::make_unique<SingleDbCatalog>(
+        std::make_unique<FastQueryDB>(db_file.string())));
+    Service::UnixSocketServer server(app, socket_file.string());
+    server.Listen();
+    std::thread loop([&server] { server.Run(); });
+
+    // 本地测试客户端：一次写出全部流水线请求，再读到对端关闭为止
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    const std::string path = socket_file.string();
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    ok &= Check(connect(fd, reinterpret_cast<const sockaddr*>(&address),
+                        sizeof(address)) == 0,
+                "server accepts local connections");
+
+    std::string requests = "add\tABC-123\tXYZ-9\n";
+    constexpr size_t kPipelined = 2000;
+    for (size_t i = 0; i < kPipelined; ++i) {
+      requests += (i % 2 == 0) ? "query\tABC123\n" : "query\tnope-1\n";
+    }
+    requests += "stats\n";
+    for (size_t sent = 0; sent < requests.size();) {
+      const ssize_t n = write(fd, requests.data() + sent, requests.size() - sent);
+      if (n <= 0) {
+        break;
+      }
+      sent += static_cast<size_t>(n);
+    }
+    shutdown(fd, SHUT_WR);
+
+    std::string replies;
+    std::array<char, 4096> buffer{};
+    while (true) {
+      const ssize_t n = read(fd, buffer.data(), buffer.size());
+      if (n <= 0) {
+        break;
+      }
+      replies.append(buffer.data(), static_cast<size_t>(n));
+    }
+    close(fd);
+
+    const size_t reply_lines = static_cast<size_t>(
+        std::count(replies.begin(), replies.end(), '\n'));
+    ok &= Check(reply_lines == kPipelined + 2, "server answers every pipelined request");
+    ok &= Check(replies.starts_with("ok\tadded\tadded\nok\tfound\nok\tmissing\n"),
+                "server replies in request order");
+    ok &= Check(replies.find("\nok\tdb=test.sqlite3\trecords=2\t") != std::string::npos,
+                "server stats reply");
+
+    server.Stop();
+    loop.join();
+    const Service::ServiceStats stats = server.GetStats();
+    ok &= Check(stats.connections_accepted == 1 && stats.connections_open == 0 &&
+                    stats.requests == kPipelined + 2 && stats.ids_queried == kPipelined &&
+                    stats.batches < kPipelined && stats.bytes_in == requests.size(),
+                "server counts requests and coalesces pipelined queries");
+  } catch (const std::exception& ex) {
+    ok &= Check(false, std::string("server test exception: ") + ex.what());
+  }
+  std::filesystem::remove(db_file, ec);
+  return ok;
+#else
+  return true;
+#endif
+}
+
+auto TestCApi() -> bool {
+  const auto db_file =
+      std::filesystem::temp_directory_path() / "avlib_core_tests_capi.sqlite3";
+  std::error_code ec;
+  std::filesystem::remove(db_file, ec);
+  const std::string path = db_file.string();
+
+  bool ok = Check(avlib_api_version() == AVLIB_API_VERSION, "capi version");
+  avlib_db* db = nullptr;
+  ok &= Check(avlib_open(path.c_str(), 0, &db) == AVLIB_ERROR_NOT_FOUND &&
+                  db == nullptr && *avlib_last_error() != '\0',
+              "capi open reports missing file");
+  ok &= Check(avlib_open(path.c_str(), AVLIB_OPEN_CREATE, &db) == AVLIB_OK &&
+                  db != nullptr,
+              "capi open creates database");
+  if (db == nullptr) {
+    return false;
+  }
+
+  const std::string_view batch = "ABC-123\nABC123\r\nbad_id\n\nXYZ 9";
+  std::array<uint8_t, 8> outcomes{};
+  size_t count = 0;
+  ok &= Check(avlib_add_many(db, batch.data(), batch.size(), outcomes.data(),
+                             2, &count) == AVLIB_ERROR_BUFFER_TOO_SMALL &&
+                  count == 5,
+              "capi reports required outcome capacity");
+  ok &= Check(avlib_add_many(db, batch.data(), batch.size(), outcomes.data(),
+                             outcomes.size(), &count) == AVLIB_OK &&
+                  count == 5 && outcomes[0] == AVLIB_ID_ADDED &&
+                  outcomes[1] == AVLIB_ID_EXISTS &&
+                  outcomes[2] == AVLIB_ID_INVALID &&
+                  outcomes[3] == AVLIB_ID_SKIPPED &&
+                  outcomes[4] == AVLIB_ID_ADDED,
+              "capi add outcomes per line");
+
+  const std::string_view query = "abc 123\nABC 123\nXYZ-9\n";
+  ok &= Check(avlib_exists_many(db, query.data(), query.size(), outcomes.data(),
+                                outcomes.size(), &count) == AVLIB_OK &&
+                  count == 3 && outcomes[0] == AVLIB_ID_MISSING &&
+                  outcomes[1] == AVLIB_ID_FOUND && outcomes[2] == AVLIB_ID_FOUND,
+              "capi exists outcomes per line");
+
+  // 只有空行的批次逐行跳过，不算出错
+  const std::string_view blank = "\n\r\n";
+  outcomes.fill(0xFF);
+  ok &= Check(avlib_exists_many(db, blank.data(), blank.size(), outcomes.data(),
+                                outcomes.size(), &count) == AVLIB_OK &&
+                  count == 2 && outcomes[0] == AVLIB_ID_SKIPPED &&
+                  outcomes[1] == AVLIB_ID_SKIPPED,
+              "capi skips a query of blank lines");
+  outcomes.fill(0xFF);
+  ok &= Check(avlib_add_many(db, blank.data(), blank.size(), outcomes.data(),
+                             outcomes.size(), &count) == AVLIB_OK &&
+                  count == 2 && outcomes[0] == AVLIB_ID_SKIPPED &&
+                  outcomes[1] == AVLIB_ID_SKIPPED,
+              "capi skips an add of blank lines");
+
+  uint64_t total = 0;
+  ok &= Check(avlib_count(db, &total) == AVLIB_OK && total == 2, "capi count");
+  std::string streamed;
+  auto collect = [](void* user_data, const char* ids, size_t ids_len,
+                    size_t /*id_count*/) -> int {
+    static_cast<std::string*>(user_data)->append(ids, ids_len).push_back('\n');
+    return 1;
+  };
+  ok &= Check(avlib_for_each_id(db, collect, &streamed) == AVLIB_OK &&
+                  (streamed == "ABC123\nXYZ9\n" || streamed == "XYZ9\nABC123\n"),
+              "capi streams ids");
+  auto stop = [](void*, const char*, size_t, size_t) -> int { return 0; };
+  ok &= Check(avlib_for_each_id(db, stop, nullptr) == AVLIB_ERROR_STOPPED,
+              "capi visitor can stop iteration");
+  avlib_close(db);
+
+  db = nullptr;
+  ok &= Check(avlib_open(path.c_str(), AVLIB_OPEN_HASH_INDEX, &db) == AVLIB_OK,
+              "capi reopens with hash index engine");
+  if (db != nullptr) {
+    ok &= Check(avlib_exists_many(db, query.data(), query.size(),
+                                  outcomes.data(), outcomes.size(),
+                                  &count) == AVLIB_OK &&
+                    outcomes[1] == AVLIB_ID_FOUND,
+                "capi hash index lookup");
+    avlib_close(db);
+  }
+  std::filesystem::remove(db_file, ec);
+  return ok;
+}
+
+auto TestCrossDbIndex() -> bool {
+  CrossDbIndex index;
+  // 同一容器超过 4096 个元素后转为位图形态
+  for (int i = 0; i < 6000; ++i) {
+    index.Insert("ABC" + std::to_string(10000 + i), 0);
+  }
+  for (int i = 0; i < 6000; i += 2) {
+    index.Insert("ABC" + std::to_string(10000 + i), 2);
+  }
+  index.Insert("NODIGITS", 1);
+  index.Insert("XYZ12345678901", 1);
+  index.Insert("ABC010000", 1);  // 前导零不同即为不同 ID
+
+  bool ok = Check(index.Size() == 6003, "cross index size");
+  ok &= Check(index.Lookup("ABC10000") == 0b101 &&
+                  index.Lookup("ABC10001") == 0b001 &&
+                  index.Lookup("ABC15999") == 0b001 &&
+                  index.Lookup("ABC16000") == 0,
+              "cross index bitmap container lookup");
+  ok &= Check(index.Lookup("NODIGITS") == 0b010 &&
+                  index.Lookup("XYZ12345678901") == 0b010 &&
+                  index.Lookup("ABC010000") == 0b010 &&
+                  index.Lookup("QQQ1") == 0,
+              "cross index text and leading-zero ids");
+
+  CrossDbIndex other;
+  other.Insert("ZZZ7", 3);
+  other.Insert("ABC10001", 3);
+  other.Insert("NODIGITS", 3);
+  index.Merge(other);
+  ok &= Check(index.Lookup("ZZZ7") == 0b1000 &&
+                  index.Lookup("ABC10001") == 0b1001 &&
+                  index.Lookup("NODIGITS") == 0b1010 &&
+                  index.Size() == 6004,
+              "cross index merge relabels");
+  ok &= Check(index.CountAny(0b0001) == 6000 && index.CountAny(0b0100) == 3000 &&
+                  index.CountAll(0b0101) == 3000 &&
+                  index.CountAny(0b1111) == 6004 && index.CountAll(0b1001) == 1,
+              "cross index union and intersection counts");
+  index.Clear();
+  ok &= Check(index.Size() == 0 && index.Lookup("ABC10000") == 0,
+              "cross index clears");
+  return ok;
+}
+
+auto TestCrossDatabaseQuery() -> bool {
+  const auto dir =
+      std::filesystem::temp_directory_path() / "avlib_core_tests_cross";
+  std::error_code ec;
+  std::filesystem::remove_all(dir, ec);
+  std::filesystem::create_directories(dir);
+
+  // 批量足够大，SQLite 库会被切成多段分给额外的连接
+  constexpr size_t kIds = 20000;
+  std::vector<std::string> ids;
+  ids.reserve(kIds);
+  for (size_t i = 0; i < kIds; ++i) {
+    ids.push_back("ABC" + std::to_string(10000 + i));
+  }
+  auto every = [&](size_t step) {
+    std::vector<std::string_view> picked;
+    for (size_t i = 0; i < kIds; i += step) {
+      picked.push_back(ids[i]);
+    }
+    return picked;
+  };
+
+  bool ok = true;
+  try {
+    Application app(std::make_unique<DatabaseManager>(dir.string()));
+    app.PerformCreateDatabase("beta");
+    app.PerformAdd(every(3));
+    app.PerformCreateDatabase("alpha");
+    app.PerformAdd(every(2));
+    app.PerformCreateDatabase("gamma");
+    app.PerformAdd(every(5));
+    app.PerformSetQueryEngine(QueryEngine::kHashIndex);
+    ok &= Check(app.GetLastError() == ErrorCode::kNone,
+                "cross query setup succeeds");
+
+    std::vector<std::string_view> batch(ids.begin(), ids.end());
+    batch.emplace_back("bad_id");
+    batch.emplace_back("");
+    const CrossQueryResult result = app.PerformCrossQuery(batch);
+    ok &= Check(app.GetLastResult() == ResultCode::kCrossQueryCompleted,
+                "cross query completes");
+    ok &= Check(result.databases == std::vector<std::string>{"alpha.sqlite3",
+                                                             "beta.sqlite3",
+                                                             "gamma.sqlite3"},
+                "cross query lists databases sorted by name");
+    bool hits_match = result.outcomes.size() == batch.size();
+    size_t expected_found = 0;
+    for (size_t i = 0; hits_match && i < kIds; ++i) {
+      std::vector<uint32_t> expected;
+      for (const auto& [db, step] :
+           {std::pair<uint32_t, size_t>{0, 2}, {1, 3}, {2, 5}}) {
+        if (i % step == 0) {
+          expected.push_back(db);
+        }
+      }
+      expected_found += expected.empty() ? 0 : 1;
+      const auto hits = result.HitsOf(i);
+      hits_match &= std::ranges::equal(hits, expected) &&
+                    result.outcomes[i] == (expected.empty()
+                                               ? IdOutcome::kNotFound
+                                               : IdOutcome::kFound);
+    }
+    ok &= Check(hits_match, "cross query reports every database per id");
+    ok &= Check(result.found_count == expected_found &&
+                    result.not_found_count == kIds - expected_found &&
+                    result.invalid_format_count == 1,
+                "cross query counts");
+    ok &= Check(result.outcomes[kIds] == IdOutcome::kInvalid &&
+                    result.outcomes[kIds + 1] == IdOutcome::kSkipped &&
+                    result.HitsOf(kIds + 1).empty(),
+                "cross query marks invalid and empty input");
+
+    // 写入后再次查询，额外的读连接能看到新数据
+    app.SetCurrentDatabase("beta.sqlite3");
+    app.PerformAdd(std::vector<std::string_view>{ids[1]});
+    const CrossQueryResult again =
+        app.PerformCrossQuery(std::vector<std::string_view>{ids[1]});
+    ok &= Check(again.HitsOf(0).size() == 1 && again.HitsOf(0)[0] == 1,
+                "cross query sees later writes");
+
+    // 其他进程（此处为另一个连接）的写入不经过索引同步，按文件变化直接查库
+    {
+      FastQueryDB other((dir / "beta.sqlite3").string());
+      other.Add(ids[11]);
+    }
+    const CrossQueryResult external =
+        app.PerformCrossQuery(std::vector<std::string_view>{ids[11], ids[30]});
+    ok &= Check(external.HitsOf(0).size() == 1 &&
+                    external.HitsOf(0)[0] == 1 &&
+                    external.HitsOf(1).size() == 3,
+                "cross query sees writes from other connections");
+
+    const CrossDbStats stats = app.GetCrossDbStats();
+    ok &= Check(stats.counts == std::vector<size_t>{10000, 6669, 4000} &&
+                    stats.union_count == expected_found + 2 &&
+                    stats.shared_count == (kIds + 29) / 30 &&
+                    stats.memory_bytes > 0,
+                "cross stats from index");
+
+    // 超过索引可容纳的库数后退回逐库并发查询
+    for (size_t i = 0; i < CrossDbIndex::kMaxDatabases; ++i) {
+      app.PerformCreateDatabase("extra" + std::to_string(i));
+    }
+    const CrossQueryResult fallback = app.PerformCrossQuery(batch);
+    bool fallback_match = fallback.databases.size() ==
+                              CrossDbIndex::kMaxDatabases + 3 &&
+                          fallback.found_count == expected_found + 2;
+    for (size_t i = 0; fallback_match && i < kIds; i += 7) {
+      fallback_match &= std::ranges::equal(
+          fallback.HitsOf(i) | std::views::transform([&](uint32_t d) {
+            return fallback.databases[d];
+          }),
+          result.HitsOf(i) | std::views::transform([&](uint32_t d) {
+            return result.databases[d];
+          }));
+    }
+    ok &= Check(fallback_match, "cross query falls back to fan-out");
+  } catch (const std::exception& ex) {
+    ok = Check(false, std::string("cross query threw: ") + ex.what());
+  }
+  std::filesystem::remove_all(dir, ec);
+  return ok;
+}
+
+auto TestCrossIndexLocalWrites() -> bool {
+  const auto dir =
+      std::filesystem::temp_directory_path() / "avlib_core_tests_cross_local";
+  std::error_code ec;
+  std::filesystem::remove_all(dir, ec);
+  std::filesystem::create_directories(dir);
+
+  using Names = std::vector<std::string>;
+  bool ok = true;
+  try {
+    DatabaseManager manager(dir.string());
+    manager.CreateDatabase("one");
+    manager.GetCurrentDb()->Add("ABC100");
+    manager.CreateDatabase("two");
+    const std::array<std::string_view, 3> probe{"ABC100", "ABC200", "ABC300"};
+    (void)manager.ExistsInAll(probe);
+    ok &= Check(manager.ChangedSinceCrossIndex().empty(),
+                "cross index build stamps every database");
+
+    // 本库自己提交的写入（事务内与事务外）已同步进索引，查询仍取自索引
+    IIdRepository* two = manager.GetCurrentDb();
+    two->BeginTransaction();
+    (void)two->AddMany(std::array<std::string_view, 1>{"ABC200"});
+    two->CommitTransaction();
+    two->Add("ABC300");
+    ok &= Check(manager.ChangedSinceCrossIndex().empty(),
+                "local writes keep the cross index path");
+    const CrossDbLookup lookup = manager.ExistsInAll(probe);
+    ok &= Check(lookup.databases == Names{"one.sqlite3", "two.sqlite3"} &&
+                    lookup.contains[0] == std::vector<bool>{true, false,
+                                                            false} &&
+                    lookup.contains[1] == std::vector<bool>{false, true, true},
+                "cross index answers with local writes");
+
+    // 索引就绪后新建的库直接登记，不视为已变化
+    manager.CreateDatabase("three");
+    ok &= Check(manager.ChangedSinceCrossIndex().empty(),
+                "new database is indexed without a rebuild");
+
+    // 其他连接的写入仍能从文件头的修改计数看出
+    {
+      FastQueryDB other((dir / "one.sqlite3").string());
+      other.Add("ABC400");
+    }
+    ok &= Check(manager.ChangedSinceCrossIndex() == Names{"one.sqlite3"},
+                "external write marks only its database changed");
+  } catch (const std::exception& ex) {
+    ok = Check(false, std::string("cross index local writes threw: ") +
+                          ex.what());
+  }
+  std::filesystem::remove_all(dir, ec);
+  return ok;
+}
+
+auto TestSetAlgebra() -> bool {
+  const auto dir =
+      std::filesystem::temp_directory_path() / "avlib_core_tests_sets";
+  std::error_code ec;
+  std::filesystem::remove_all(dir, ec);
+  std::filesystem::create_directories(dir);
+
+  // 长度不一、含前导零和超长数字（紧凑布局的溢出表）的 ID，
+  // 字节序与数值序不同
+  constexpr size_t kIds = 6000;
+  std::vector<std::string> ids;
+  for (size_t i = 0; i < kIds; ++i) {
+    ids.push_back("ABC" + std::to_string(i));
+  }
+  ids.emplace_back("ABC12345678901");
+  ids.emplace_back("ABC0012");
+  ids.emplace_back("ZZ1");
+  auto every = [&](size_t step) {
+    std::vector<std::string_view> picked;
+    for (size_t i = 0; i < ids.size(); i += step) {
+      picked.push_back(ids[i]);
+    }
+    return picked;
+  };
+  auto sorted_set = [](std::vector<std::string_view> picked) {
+    std::vector<std::string> out(picked.begin(), picked.end());
+    std::ranges::sort(out);
+    return out;
+  };
+  const std::vector<std::string> alpha = sorted_set(every(2));
+  const std::vector<std::string> beta = sorted_set(every(3));
+  const std::vector<std::string> gamma = sorted_set(every(5));
+  auto read_lines = [](const std::filesystem::path& path) {
+    std::vector<std::string> lines;
+    std::ifstream in(path);
+    for (std::string line; std::getline(in, line);) {
+      lines.push_back(line);
+    }
+    return lines;
+  };
+
+  bool ok = true;
+  try {
+    Application app(std::make_unique<DatabaseManager>(dir.string()));
+    app.PerformCreateDatabase("alpha");
+    app.PerformAdd(every(2));
+    app.PerformCreateDatabase("beta");
+    app.PerformAdd(every(3));
+    app.PerformCreateDatabase("gamma");
+    app.PerformAdd(every(5));
+    (void)app.PerformMigrateToPackedLayout();
+    ok &= Check(app.GetLastError() == ErrorCode::kNone,
+                "set algebra setup succeeds");
+    const std::vector<std::string> inputs{"alpha.sqlite3", "beta.sqlite3",
+                                          "gamma.sqlite3"};
+
+    std::vector<std::string> expected;
+    std::ranges::set_union(alpha, beta, std::back_inserter(expected));
+    std::vector<std::string> expected_union;
+    std::ranges::set_union(expected, gamma,
+                           std::back_inserter(expected_union));
+    const SetOperationResult united = app.PerformSetOperationToFile(
+        SetOperation::kUnion, inputs, (dir / "union.txt").string());
+    ok &= Check(app.GetLastResult() == ResultCode::kSetOperationCompleted &&
+                    united.output_count == expected_union.size() &&
+                    united.input_counts ==
+                        std::vector<size_t>{alpha.size(), beta.size(),
+                                            gamma.size()},
+                "union to file reports counts");
+    ok &= Check(read_lines(dir / "union.txt") == expected_union,
+                "union file is sorted and deduplicated");
+
+    expected.clear();
+    std::ranges::set_intersection(alpha, beta, std::back_inserter(expected));
+    std::vector<std::string> expected_shared;
+    std::ranges::set_intersection(expected, gamma,
+                                  std::back_inserter(expected_shared));
+    const SetOperationResult shared = app.PerformSetOperationToDatabase(
+        SetOperation::kIntersect, inputs, "shared");
+    ok &= Check(app.GetLastResult() == ResultCode::kSetOperationCompleted &&
+                    shared.output_count == expected_shared.size() &&
+                    shared.target == "shared.sqlite3" &&
+                    app.GetCurrentDbName() == "gamma.sqlite3",
+                "intersect to database restores current database");
+    {
+      FastQueryDB written((dir / "shared.sqlite3").string());
+      ok &= Check(written.GetAllIds() == expected_shared,
+                  "intersect database holds the shared ids");
+    }
+
+    expected.clear();
+    std::ranges::set_difference(alpha, beta, std::back_inserter(expected));
+    std::vector<std::string> expected_only;
+    std::ranges::set_difference(expected, gamma,
+                                std::back_inserter(expected_only));
+    app.PerformSetOperationToFile(SetOperation::kDifference, inputs,
+                                  (dir / "only.txt").string());
+    ok &= Check(read_lines(dir / "only.txt") == expected_only,
+                "difference subtracts every later input");
+
+    app.PerformSetOperationToFile(
+        SetOperation::kUnion, std::vector<std::string>{"alpha.sqlite3"},
+        (dir / "x.txt").string());
+    ok &= Check(app.GetLastError() == ErrorCode::kSetInputsInvalid,
+                "set operation needs two inputs");
+    app.PerformSetOperationToFile(
+        SetOperation::kUnion,
+        std::vector<std::string>{"alpha.sqlite3", "alpha.sqlite3"},
+        (dir / "x.txt").string());
+    ok &= Check(app.GetLastError() == ErrorCode::kSetInputsInvalid,
+                "set operation rejects repeated inputs");
+    app.PerformSetOperationToFile(
+        SetOperation::kUnion,
+        std::vector<std::string>{"alpha.sqlite3", "missing.sqlite3"},
+        (dir / "x.txt").string());
+    ok &= Check(app.GetLastError() == ErrorCode::kDbNotExist,
+                "set operation reports missing input");
+    app.PerformSetOperationToDatabase(SetOperation::kUnion, inputs, "shared");
+    ok &= Check(app.GetLastError() == ErrorCode::kDbNameExists,
+                "set operation keeps existing output database");
+
+    // 输入库中后部的页损坏：归并读到那里时失败，此前已分批提交过的
+    // 新库不应留下
+    {
+      constexpr size_t kBigIds = 300000;
+      std::vector<std::string> big_ids;
+      big_ids.reserve(kBigIds);
+      for (size_t i = 0; i < kBigIds; ++i) {
+        big_ids.push_back("BIG" + std::to_string(1000000 + i));
+      }
+      app.PerformCreateDatabase("big");
+      app.PerformAdd(big_ids);
+      app.SetCurrentDatabase("gamma.sqlite3");
+      const auto big_file = dir / "big.sqlite3";
+      const auto size = std::filesystem::file_size(big_file);
+      std::fstream file(big_file, std::ios::in | std::ios::out |
+                                      std::ios::binary);
+      file.seekp(static_cast<std::streamoff>(size / 4096 * 3 / 4 * 4096));
+      const std::string garbage(4096, '\xff');
+      file.write(garbage.data(), static_cast<std::streamsize>(garbage.size()));
+    }
+    const SetOperationResult broken = app.PerformSetOperationToDatabase(
+        SetOperation::kUnion,
+        std::vector<std::string>{"alpha.sqlite3", "big.sqlite3"}, "broken");
+    ok &= Check(app.GetLastError() == ErrorCode::kSetOperationFailed &&
+                    broken.restored_previous &&
+                    app.GetCurrentDbName() == "gamma.sqlite3",
+                "failed set operation reports and restores current database");
+    const std::vector<std::string> names = app.GetDatabaseNames();
+    ok &= Check(std::ranges::find(names, "broken.sqlite3") == names.end() &&
+                    !std::filesystem::exists(dir / "broken.sqlite3"),
+                "failed set operation removes the partial output database");
+
+    // 访问者提前中止时读取线程随之退出
+    FastQueryDB left((dir / "alpha.sqlite3").string());
+    FastQueryDB right((dir / "beta.sqlite3").string());
+    const std::array<const IIdRepository*, 2> readers{&left, &right};
+    size_t chunks = 0;
+    const SetMergeCounts stopped = SetAlgebra::Merge(
+        SetOperation::kUnion, readers,
+        [&chunks](std::span<const std::string_view> /*chunk*/) {
+          ++chunks;
+          return false;
+        });
+    ok &= Check(chunks == 1 && stopped.output_count < expected_union.size(),
+                "set merge stops when the sink declines");
+  } catch (const std::exception& ex) {
+    ok = Check(false, std::string("set algebra threw: ") + ex.what());
+  }
+  std::filesystem::remove_all(dir, ec);
+  return ok;
+}
+
+auto TestMemoryBudget() -> bool {
+  const auto dir =
+      std::filesystem::temp_directory_path() / "avlib_core_tests_budget";
+  std::error_code ec;
+  std::filesystem::remove_all(dir, ec);
+  std::filesystem::create_directories(dir);
+
+  using Names = std::vector<std::string>;
+  bool ok = true;
+  try {
+    DatabaseManager manager(dir.string());
+    // 每个连接按最小的 1 MiB 页缓存计入，预算只够同时打开三个库
+    manager.SetMemoryBudget((size_t{7} << 20) / 2);
+    for (int i = 0; i < 5; ++i) {
+      manager.CreateDatabase("db" + std::to_string(i));
+      manager.GetCurrentDb()->Add("ABC" + std::to_string(100 + i));
+    }
+    CatalogMemoryStats stats = manager.GetMemoryStats();
+    ok &= Check(stats.cache_bytes_per_connection == (size_t{1} << 20) &&
+                    stats.open_databases ==
+                        Names{"db4.sqlite3", "db3.sqlite3", "db2.sqlite3"} &&
+                    stats.used_bytes <= stats.budget_bytes &&
+                    stats.evictions == 2,
+                "budget evicts least recently used databases");
+
+    // 切回过的库成为最近使用，下一次淘汰的是最久未用的 db3
+    manager.SwitchToDatabase("db2.sqlite3");
+    manager.SwitchToDatabase("db0.sqlite3");
+    ok &= Check(manager.GetCurrentDb()->Exists("ABC100"),
+                "evicted database reopens with its data");
+    ok &= Check(manager.GetMemoryStats().open_databases ==
+                    Names{"db0.sqlite3", "db2.sqlite3", "db4.sqlite3"},
+                "switching refreshes recency");
+
+    // 跨库查询为未打开的库临时开连接，用完按预算回收，不进入连接池
+    const std::array<std::string_view, 1> probe{"ABC101"};
+    const CrossDbLookup lookup = manager.ExistsInAll(probe);
+    ok &= Check(lookup.databases.size() == 5 && lookup.contains[1][0],
+                "cross query reaches evicted databases");
+    stats = manager.GetMemoryStats();
+    ok &= Check(stats.open_databases.size() == 3 &&
+                    stats.extra_connections == 0 &&
+                    stats.used_bytes <= stats.budget_bytes,
+                "cross query connections are released over budget");
+
+    // 预算小于单个连接时仍保留当前库
+    manager.SetMemoryBudget(1);
+    ok &= Check(manager.GetMemoryStats().open_databases ==
+                        Names{"db0.sqlite3"} &&
+                    manager.GetCurrentDb() != nullptr &&
+                    manager.GetCurrentDb()->GetCount() == 1,
+                "current database survives any budget");
+    manager.SetMemoryBudget(DatabaseManager::kDefaultMemoryBudgetBytes);
+  } catch (const std::exception& ex) {
+    ok = Check(false, std::string("memory budget threw: ") + ex.what());
+  }
+  std::filesystem::remove_all(dir, ec);
+  return ok;
+}
+
+auto TestDatabaseDirectory() -> bool {
+  const auto dir =
+      std::filesystem::temp_directory_path() / "avlib_core_tests_directory";
+  std::error_code ec;
+  std::filesystem::remove_all(dir, ec);
+  std::filesystem::create_directories(dir);
+  const auto write_file = [](const std::filesystem::path& path,
+                             std::string_view content) {
+    std::ofstream(path, std::ios::binary | std::ios::app) << content;
+  };
+
+  using Names = std::vector<std::string>;
+  bool ok = true;
+  try {
+    DatabaseManager manager(dir.string());
+    manager.CreateDatabase("a");
+    manager.GetCurrentDb()->Add("ABC100");
+    manager.GetCurrentDb()->Add("ABC101");
+    {
+      // 另一个连接在目录下新建库，清单无需重新扫描也能看到
+      FastQueryDB other((dir / "b.sqlite3").string());
+      other.Add("ABC200");
+    }
+    {
+      PackedIdDB packed((dir / "p.sqlite3").string());
+      packed.Add("ABC300");
+      packed.Add("NODIGITS");
+    }
+    // 没有计数元数据的旧库：列举时只读统计，不顺带升级
+    sqlite3* legacy = nullptr;
+    sqlite3_open((dir / "legacy.sqlite3").string().c_str(), &legacy);
+    sqlite3_exec(legacy,
+                 "CREATE TABLE ids (id TEXT PRIMARY KEY NOT NULL);"
+                 "INSERT INTO ids VALUES ('ABC1'), ('ABC2'), ('ABC3');",
+                 nullptr, nullptr, nullptr);
+    sqlite3_close(legacy);
+    write_file(dir / "notes.txt", "x");
+    write_file(dir / "a.sqlite3-journal", "x");
+    std::vector<DatabaseInfo> listing = manager.ListDatabases();
+    ok &= Check(listing.size() == 4 && listing[0].name == "a.sqlite3" &&
+                    listing[0].record_count == 2 &&
+                    listing[1].name == "b.sqlite3" &&
+                    listing[1].record_count == 1 &&
+                    listing[1].size_bytes ==
+                        std::filesystem::file_size(dir / "b.sqlite3"),
+                "listing carries size and record count");
+    ok &= Check(listing[2].record_count == 3 && listing[3].record_count == 2,
+                "listing counts legacy and packed databases");
+    sqlite3_open((dir / "legacy.sqlite3").string().c_str(), &legacy);
+    sqlite3_stmt* schema = nullptr;
+    sqlite3_prepare_v2(legacy, "SELECT COUNT(*) FROM sqlite_master;", -1,
+                       &schema, nullptr);
+    const bool untouched = sqlite3_step(schema) == SQLITE_ROW &&
+                           sqlite3_column_int64(schema, 0) == 2;
+    sqlite3_finalize(schema);
+    sqlite3_close(legacy);
+    ok &= Check(untouched, "listing does not upgrade legacy databases");
+    std::filesystem::remove(dir / "legacy.sqlite3");
+    std::filesystem::remove(dir / "p.sqlite3");
+    std::filesystem::remove(dir / "b.sqlite3");
+    ok &= Check(!manager.DatabaseExists("b.sqlite3") &&
+                    manager.GetAllDbNames() == Names{"a.sqlite3"},
+                "listing drops removed database");
+
+    DatabaseDirectory watched(dir.string());
+    (void)watched.List();
+    write_file(dir / "c.sqlite3", "x");
+    watched.SetRecordCount("c.sqlite3", 7);
+    for (int i = 0; i < 10; ++i) {
+      (void)watched.Contains("a.sqlite3");
+    }
+    if (watched.IsNotifying()) {
+      ok &= Check(watched.ScanCount() == 1 &&
+                      watched.Names() == Names{"a.sqlite3", "c.sqlite3"},
+                  "notified listing refreshes without rescanning");
+    }
+    // 文件内容变化后记下的记录数作废
+    ok &= Check(watched.List()[1].record_count == 7,
+                "record count survives while file is unchanged");
+    write_file(dir / "c.sqlite3", "more");
+    watched.Touch("c.sqlite3");
+    ok &= Check(!watched.List()[1].record_count.has_value(),
+                "record count is dropped when the file changes");
+
+    DatabaseDirectory polled(dir.string(), std::chrono::milliseconds(20),
+                             false);
+    ok &= Check(!polled.IsNotifying() && polled.Contains("c.sqlite3"),
+                "polling directory lists existing files");
+    std::filesystem::remove(dir / "c.sqlite3");
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    ok &= Check(!polled.Contains("c.sqlite3") && polled.ScanCount() == 2,
+                "polling directory rescans after the interval");
+  } catch (const std::exception& ex) {
+    ok = Check(false, std::string("database directory threw: ") + ex.what());
+  }
+  std::filesystem::remove_all(dir, ec);
+  return ok;
+}
+
+auto TestViewModel() -> bool {
+  const auto db_file =
+      std::filesystem::temp_directory_path() / "avlib_core_tests_view.sqlite3";
+  std::error_code ec;
+  std::filesystem::remove(db_file, ec);
+
+  bool ok = true;
+  try {
+    auto catalog = std::make_unique<SingleDbCatalog>(
+        std::make_unique<FastQueryDB>(db_file.string()));
+    IIdRepository* db = catalog->GetCurrentDb();
+    Application app(std::move(catalog));
+
+    const uint64_t first = app.GetViewModel().revision;
+    ok &= Check(app.GetViewModel().revision == first &&
+                    app.GetViewModel().total_records == 0,
+                "view model is reused without operations");
+
+    // 绕过 Application 的写入不会让快照过期，说明读取快照不查询数据库
+    db->Add("ABC100");
+    ok &= Check(app.GetViewModel().total_records == 0,
+                "view model does not query the database on read");
+
+    const std::array<std::string_view, 1> ids{"ABC101"};
+    app.PerformAdd(ids);
+    const AppViewModel& view_model = app.GetViewModel();
+    ok &= Check(view_model.revision == first + 1 &&
+                    view_model.total_records == 2 &&
+                    view_model.repository_stats.engine ==
+                        db->GetStats().engine,
+                "view model refreshes once after an operation");
+
+    app.PerformAdd(std::span<const std::string_view>{});
+    ok &= Check(app.GetViewModel().revision == first + 2,
+                "failed operations also refresh the view model");
+  } catch (const std::exception& ex) {
+    ok = Check(false, std::string("view model threw: ") + ex.what());
+  }
+  std::filesystem::remove(db_file, ec);
+  return ok;
+}
+
+auto TestJobCancellation() -> bool {
+  const auto dir = std::filesystem::temp_directory_path();
+  const auto db_file = dir / "avlib_core_tests_jobs.sqlite3";
+  const auto text_file = dir / "avlib_core_tests_jobs.txt";
+  const auto export_file = dir / "avlib_core_tests_jobs_out.txt";
+  std::error_code ec;
+  std::filesystem::remove(db_file, ec);
+  {
+    std::ofstream out(text_file);
+    for (int i = 0; i < 20000; ++i) {
+      out << "ABC" << i << '\n';
+    }
+  }
+
+  bool ok = true;
+  try {
+    Application app(std::make_unique<SingleDbCatalog>(
+        std::make_unique<FastQueryDB>(db_file.string())));
+    IO::TextFileReader reader;
+    ImportOptions options;
+    options.worker_count = 1;
+    options.read_batch_lines = 1000;
+    options.queue_depth = 1;
+
+    // 开始前就请求取消：写完第一批后在批次边界停下，并提交已写入的部分
+    Concurrency::JobProgress cancelled;
+    cancelled.RequestCancel();
+    options.progress = &cancelled;
+    ImportResult imported =
+        app.PerformImportFile(reader, text_file.string(), options);
+    ok &= Check(imported.cancelled && imported.success_count == 1000 &&
+                    app.GetTotalRecords() == 1000 && cancelled.Rows() == 1000,
+                "cancelled import commits at a batch boundary");
+
+    Concurrency::JobProgress progress;
+    options.progress = &progress;
+    imported = app.PerformImportFile(reader, text_file.string(), options);
+    ok &= Check(!imported.cancelled && imported.success_count == 19000 &&
+                    progress.Rows() == 20000 && progress.Fraction() == 1.0,
+                "import reports progress by file bytes");
+
+    Concurrency::JobProgress export_cancelled;
+    export_cancelled.RequestCancel();
+    const ExportResult exported =
+        app.PerformExport(export_file.string(), &export_cancelled);
+    ok &= Check(exported.cancelled &&
+                    app.GetLastResult() == ResultCode::kExportCompleted &&
+                    !std::filesystem::exists(export_file),
+                "cancelled export removes the partial file");
+
+    std::vector<std::string> ids;
+    for (int i = 0; i < 20000; i += 2) {
+      ids.push_back("ABC" + std::to_string(i));
+    }
+    ids.emplace_back("bad_id");
+    const std::vector<std::string_view> views(ids.begin(), ids.end());
+    Concurrency::JobProgress query_progress;
+    QueryResult queried = app.PerformQuery(views, &query_progress);
+    ok &= Check(!queried.cancelled && queried.found_count == 10000 &&
+                    queried.invalid_format_count == 1 &&
+                    query_progress.Rows() == 10000,
+                "batched query reports progress");
+
+    Concurrency::JobProgress query_cancelled;
+    query_cancelled.RequestCancel();
+    queried = app.PerformQuery(views, &query_cancelled);
+    const bool all_skipped = std::all_of(
+        queried.outcomes.begin(), queried.outcomes.end() - 1,
+        [](IdOutcome outcome) { return outcome == IdOutcome::kSkipped; });
+    ok &= Check(queried.cancelled && queried.found_count == 0 &&
+                    queried.not_found_count == 0 &&
+                    queried.invalid_format_count == 1 && all_skipped &&
+                    queried.outcomes.back() == IdOutcome::kInvalid &&
+                    app.GetLastError() == ErrorCode::kNone,
+                "cancelled query leaves remaining ids unqueried");
+  } catch (const std::exception& ex) {
+    ok = Check(false, std::string("job cancellation threw: ") + ex.what());
+  }
+  std::filesystem::remove(db_file, ec);
+  std::filesystem::remove(text_file, ec);
+  std::filesystem::remove(export_file, ec);
+  return ok;
+}
+
+auto TestJobScheduler() -> bool {
+  using Concurrency::JobPriority;
+  using Concurrency::JobProgress;
+  bool ok = true;
+  try {
+    Concurrency::JobScheduler scheduler(4, 1);
+
+    // 交互任务在批量任务的 Checkpoint 处插入执行
+    std::mutex order_mutex;
+    std::vector<std::string> order;
+    auto record = [&](std::string step) {
+      const std::scoped_lock lock(order_mutex);
+      order.push_back(std::move(step));
+    };
+    std::promise<void> bulk_started;
+    std::promise<void> interactive_submitted;
+    auto bulk = scheduler.Submit(JobPriority::kBulk, [&](JobProgress& p) {
+      record("bulk-0");
+      bulk_started.set_value();
+      interactive_submitted.get_future().wait();
+      p.Checkpoint();
+      record("bulk-1");
+      return 7;
+    });
+    bulk_started.get_future().wait();
+    auto interactive = scheduler.Submit(
+        JobPriority::kInteractive, [&](JobProgress&) { record("query"); });
+    interactive_submitted.set_value();
+    interactive.result.get();
+    ok &= Check(bulk.result.get() == 7, "bulk job returns its value");
+    ok &= Check(order == std::vector<std::string>{"bulk-0", "query", "bulk-1"},
+                "interactive job runs at the bulk checkpoint");
+
+    // 队列满时 TrySubmit 立即返回，Submit 的异常经 future 带回
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::promise<void> blocker_started;
+    auto blocker = scheduler.Submit(JobPriority::kBulk, [&](JobProgress&) {
+      blocker_started.set_value();
+      released.wait();
+    });
+    blocker_started.get_future().wait();
+    auto queued = scheduler.Submit(JobPriority::kBulk, [](JobProgress&) {
+      throw std::runtime_error("boom");
+    });
+    auto rejected =
+        scheduler.TrySubmit(JobPriority::kBulk, [](JobProgress&) {});
+    ok &= Check(!rejected.has_value() &&
+                    scheduler.PendingCount(JobPriority::kBulk) == 1,
+                "full bulk queue rejects TrySubmit");
+    release.set_value();
+    blocker.result.get();
+    bool threw = false;
+    try {
+      queued.result.get();
+    } catch (const std::runtime_error&) {
+      threw = true;
+    }
+    ok &= Check(threw, "job exception propagates through the future");
+  } catch (const std::exception& ex) {
+    ok = Check(false, std::string("job scheduler threw: ") + ex.what());
+  }
+
+  // 导入在事务之间让出执行权，插入的查询看到已提交的部分
+  const auto dir = std::filesystem::temp_directory_path();
+  const auto db_file = dir / "avlib_core_tests_scheduler.sqlite3";
+  const auto text_file = dir / "avlib_core_tests_scheduler.txt";
+  std::error_code ec;
+  std::filesystem::remove(db_file, ec);
+  {
+    std::ofstream out(text_file);
+    for (int i = 0; i < 5000; ++i) {
+      out << "ABC" << i << '\n';
+    }
+  }
+  try {
+    Application app(std::make_unique<SingleDbCatalog>(
+        std::make_unique<FastQueryDB>(db_file.string())));
+    Concurrency::JobScheduler scheduler;
+    std::future<size_t> seen;
+    auto import = scheduler.Submit(JobPriority::kBulk, [&](JobProgress& p) {
+      seen = scheduler
+                 .Submit(JobPriority::kInteractive,
+                         [&](JobProgress&) { return app.GetTotalRecords(); })
+                 .result;
+      IO::TextFileReader reader;
+      ImportOptions options;
+      options.worker_count = 1;
+      options.read_batch_lines = 1000;
+      options.commit_batch_size = 1000;
+      options.progress = &p;
+      return app.PerformImportFile(reader, text_file.string(), options);
+    });
+    const ImportResult imported = import.result.get();
+    ok &= Check(imported.success_count == 5000 && seen.get() == 1000,
+                "import yields to a query after its first commit");
+  } catch (const std::exception& ex) {
+    ok = Check(false, std::string("scheduled import threw: ") + ex.what());
+  }
+  std::filesystem::remove(db_file, ec);
+  std::filesystem::remove(text_file, ec);
+  return ok;
+}
+
+auto TestExternalSort() -> bool {
+  bool ok = true;
+  const auto temp_dir =
+      std::filesystem::temp_directory_path() / "avlib_core_tests_sort";
+  std::error_code ec;
+  std::filesystem::remove_all(temp_dir, ec);
+  std::filesystem::create_directories(temp_dir);
+
+  // 极小的内存预算迫使排序分成许多段，段内与段间都有重复
+  std::vector<std::string> input;
+  for (int i = 0; i < 3000; ++i) {
+    input.push_back("ID" + std::to_string((i * 7919) % 1000));
+  }
+  std::vector<std::string> expected = input;
+  std::ranges::sort(expected);
+  expected.erase(std::unique(expected.begin(), expected.end()),
+                 expected.end());
+  try {
+    IO::SortCounts counts;
+    std::vector<std::string> merged;
+    {
+      IO::ExternalIdSorter sorter(4096, temp_dir);
+      for (const std::string& id : input) {
+        sorter.Add(id);
+      }
+      counts = sorter.Merge([&](std::span<const std::string_view> chunk) {
+        merged.insert(merged.end(), chunk.begin(), chunk.end());
+        return true;
+      });
+      ok &= Check(!std::filesystem::is_empty(temp_dir),
+                  "external sort spills runs to disk");
+    }
+    ok &= Check(merged == expected, "external sort yields sorted unique ids");
+    ok &= Check(counts.run_count > 1 && counts.input_count == 3000 &&
+                    counts.unique_count == 1000 &&
+                    counts.duplicate_count == 2000,
+                "external sort counts duplicates across runs");
+    ok &= Check(std::filesystem::is_empty(temp_dir),
+                "external sort removes its runs");
+
+    IO::ExternalIdSorter in_memory(1 << 20, temp_dir);
+    for (const std::string& id : input) {
+      in_memory.Add(id);
+    }
+    merged.clear();
+    counts = in_memory.Merge([&](std::span<const std::string_view> chunk) {
+      merged.insert(merged.end(), chunk.begin(), chunk.end());
+      return true;
+    });
+    ok &= Check(merged == expected && counts.run_count == 0 &&
+                    std::filesystem::is_empty(temp_dir),
+                "small inputs sort in memory");
+  } catch (const std::exception& ex) {
+    ok = Check(false, std::string("external sort threw: ") + ex.what());
+  }
+
+  // 排序导入：文件内重复与库中已有的 ID 分开计数
+  const auto db_file = temp_dir / "sorted.sqlite3";
+  const auto text_file = temp_dir / "sorted.txt";
+  {
+    std::ofstream out(text_file);
+    for (int i = 0; i < 5000; ++i) {
+      out << "XYZ" << (4999 - i) % 2500 << '\n';
+    }
+    out << "bad_id\n";
+  }
+  try {
+    Application app(std::make_unique<SingleDbCatalog>(
+        std::make_unique<FastQueryDB>(db_file.string())));
+    app.PerformAdd(std::vector<std::string>{"XYZ1", "XYZ2"});
+    IO::MappedTextReader reader;
+    ImportOptions options;
+    options.sorted_bulk_load = true;
+    options.sort_memory_bytes = 8192;
+    options.sort_temp_dir = temp_dir.string();
+    options.commit_batch_size = 1000;
+    Concurrency::JobProgress progress;
+    options.progress = &progress;
+    const ImportResult imported =
+        app.PerformImportFile(reader, text_file.string(), options);
+    ok &= Check(imported.success_count == 2498 && imported.exist_count == 2 &&
+                    imported.duplicate_count == 2500 &&
+                    imported.invalid_format_count == 1 &&
+                    app.GetTotalRecords() == 2500,
+                "sorted import counts in-file duplicates separately");
+
+    const std::vector<std::string> lines = {"QQ1", "QQ1", "XYZ7", "bad_id"};
+    const ImportResult from_lines = app.PerformImportLines(lines, options);
+    ok &= Check(from_lines.success_count == 1 && from_lines.exist_count == 1 &&
+                    from_lines.duplicate_count == 1 &&
+                    from_lines.invalid_format_count == 1,
+                "sorted line import de-duplicates");
+  } catch (const std::exception& ex) {
+    ok = Check(false, std::string("sorted import threw: ") + ex.what());
+  }
+  std::filesystem::remove_all(temp_dir, ec);
+  return ok;
+}
+
+auto ReadFileLines(const std::filesystem::path& path)
+    -> std::vector<std::string> {
+  std::vector<std::string> lines;
+  std::ifstream in(path);
+  for (std::string line; std::getline(in, line);) {
+    lines.push_back(line);
+  }
+  return lines;
+}
+
+auto TestCandidateCheck() -> bool {
+  bool ok = true;
+  const auto temp_dir =
+      std::filesystem::temp_directory_path() / "avlib_core_tests_check";
+  std::error_code ec;
+  std::filesystem::remove_all(temp_dir, ec);
+  std::filesystem::create_directories(temp_dir);
+  const auto db_file = temp_dir / "check.sqlite3";
+  const auto text_file = temp_dir / "candidates.txt";
+  // 库中有 XYZ0..XYZ99；候选为 XYZ50..XYZ149 倒序，每个出现两次
+  {
+    std::ofstream out(text_file);
+    for (int i = 149; i >= 50; --i) {
+      out << "XYZ" << i << "\nXYZ" << i << '\n';
+    }
+    out << "bad_id\n\n";
+  }
+  std::vector<std::string> expected_new;
+  std::vector<std::string> expected_owned;
+  for (int i = 50; i < 150; ++i) {
+    (i < 100 ? expected_owned : expected_new)
+        .push_back("XYZ" + std::to_string(i));
+  }
+  std::ranges::sort(expected_new);
+  std::ranges::sort(expected_owned);
+
+  try {
+    Application app(std::make_unique<SingleDbCatalog>(
+        std::make_unique<FastQueryDB>(db_file.string())));
+    std::vector<std::string> owned;
+    for (int i = 0; i < 100; ++i) {
+      owned.push_back("XYZ" + std::to_string(i));
+    }
+    app.PerformAdd(owned);
+
+    struct Case {
+      CheckStrategy strategy;
+      bool merge_join;
+    };
+    constexpr Case kCases[] = {{CheckStrategy::kLookup, false},
+                               {CheckStrategy::kMergeJoin, true},
+                               {CheckStrategy::kAuto, true}};
+    for (const Case& c : kCases) {
+      const auto out_dir = temp_dir / "out";
+      std::filesystem::remove_all(out_dir, ec);
+      IO::MappedTextReader reader;
+      CheckOptions options;
+      options.strategy = c.strategy;
+      options.read_batch_lines = 16;
+      options.sort_memory_bytes = 512;  // 强制外部排序分段
+      options.sort_temp_dir = temp_dir.string();
+      Concurrency::JobProgress progress;
+      options.progress = &progress;
+      const CheckResult result = app.PerformCheckFile(
+          reader, text_file.string(), out_dir.string(), options);
+      ok &= Check(app.GetLastResult() == ResultCode::kCheckCompleted &&
+                      result.new_count == 50 && result.owned_count == 50 &&
+                      result.duplicate_count == 100 &&
+                      result.invalid_format_count == 1 &&
+                      result.merge_join == c.merge_join,
+                  "check file counts new, owned and invalid candidates");
+      ok &= Check(ReadFileLines(out_dir / CandidateCheck::kNewFileName) ==
+                          expected_new &&
+                      ReadFileLines(out_dir / CandidateCheck::kOwnedFileName) ==
+                          expected_owned &&
+                      ReadFileLines(out_dir /
+                                    CandidateCheck::kInvalidFileName) ==
+                          std::vector<std::string>{"bad_id"},
+                  "check file writes sorted partitions");
+      ok &= Check(progress.Fraction() > 0.99,
+                  "check file reports progress for both phases");
+    }
+    ok &= Check(app.GetTotalRecords() == 100, "check file leaves db intact");
+
+    IO::MappedTextReader reader;
+    app.PerformCheckFile(reader, (temp_dir / "missing.txt").string(),
+                         (temp_dir / "out").string());
+    ok &= Check(app.GetLastError() == ErrorCode::kFileOpenFailed,
+                "check file reports a missing candidate list");
+  } catch (const std::exception& ex) {
+    ok = Check(false, std::string("check file threw: ") + ex.what());
+  }
+  std::filesystem::remove_all(temp_dir, ec);
+  return ok;
+}
+
 }  // namespace
 
 auto main() -> int {
   const bool validator_ok = TestValidator();
   const bool reader_ok = TestTextFileReader();
-  if (validator_ok && reader_ok) {
+  const bool mapped_reader_ok = TestMappedTextReader();
+  const bool batch_validator_ok = TestBatchValidator();
+  const bool batch_ok = TestFastQueryDbBatch();
+  const bool count_ok = TestFastQueryDbCount();
+  const bool codec_ok = TestPackedIdCodec();
+  const bool packed_ok = TestPackedIdDb();
+  const bool hash_index_ok = TestIdHashIndex();
+  const bool hash_repo_ok = TestHashIndexRepository();
+  const bool bloom_ok = TestBloomFilter();
+  const bool snapshot_ok = TestIdSnapshot();
+  const bool stream_ok = TestStreamingExport();
+  const bool pipeline_ok = TestImportPipeline();
+  const bool app_alloc_ok = TestApplicationAllocations();
+  const bool import_fail_ok = TestImportFailureReporting();
+  const bool protocol_ok = TestQueryProtocol();
+  const bool server_ok = TestUnixSocketServer();
+  const bool capi_ok = TestCApi();
+  const bool cross_index_ok = TestCrossDbIndex();
+  const bool cross_ok = TestCrossDatabaseQuery();
+  const bool cross_local_ok = TestCrossIndexLocalWrites();
+  const bool sets_ok = TestSetAlgebra();
+  const bool budget_ok = TestMemoryBudget();
+  const bool directory_ok = TestDatabaseDirectory();
+  const bool view_model_ok = TestViewModel();
+  const bool jobs_ok = TestJobCancellation();
+  const bool scheduler_ok = TestJobScheduler();
+  const bool sort_ok = TestExternalSort();
+  const bool check_ok = TestCandidateCheck();
+  if (validator_ok && reader_ok && mapped_reader_ok && batch_validator_ok &&
+      batch_ok && count_ok && codec_ok && packed_ok && hash_index_ok &&
+      hash_repo_ok && bloom_ok && snapshot_ok && stream_ok && pipeline_ok &&
+      app_alloc_ok && import_fail_ok && protocol_ok && server_ok && capi_ok &&
+      cross_index_ok && cross_ok && cross_local_ok && sets_ok && budget_ok &&
+      directory_ok && view_model_ok && jobs_ok && scheduler_ok && sort_ok &&
+      check_ok) {
     std::cout << "All core tests passed.\n";
     return 0;
   }
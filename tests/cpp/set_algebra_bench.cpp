@@ -0,0 +1,126 @@
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "core/app/application.hpp"
+#include "core/data/fast_query_db.hpp"
+#include "core/infrastructure/database_manager.hpp"
+
+namespace {
+
+constexpr size_t kIdsPerLabel = 100000;
+constexpr size_t kGenerateBatch = 1024;
+constexpr size_t kGenerateCommit = 1000000;
+
+// 第 index 个 ID：两位字母标签 + 5 位数字，按 index 递增即按字节序递增
+auto MakeId(size_t index) -> std::string {
+  const size_t label = index / kIdsPerLabel;
+  std::string id;
+  id.push_back(static_cast<char>('A' + label / 26));
+  id.push_back(static_cast<char>('A' + label % 26));
+  const std::string digits = std::to_string(index % kIdsPerLabel);
+  id.append(5 - digits.size(), '0').append(digits);
+  return id;
+}
+
+// 写入 [first, first + count) 的 ID；库已是这个规模时直接复用
+void Generate(const std::filesystem::path& path, size_t first, size_t count) {
+  FastQueryDB db(path.string());
+  if (db.GetCount() == count) {
+    return;
+  }
+  std::vector<std::string> owned;
+  std::vector<std::string_view> batch;
+  size_t uncommitted = 0;
+  db.BeginTransaction();
+  for (size_t i = 0; i < count; i += kGenerateBatch) {
+    owned.clear();
+    for (size_t k = i; k < std::min(count, i + kGenerateBatch); ++k) {
+      owned.push_back(MakeId(first + k));
+    }
+    batch.assign(owned.begin(), owned.end());
+    (void)db.AddMany(batch);
+    uncommitted += batch.size();
+    if (uncommitted >= kGenerateCommit) {
+      db.CommitTransaction();
+      db.BeginTransaction();
+      uncommitted = 0;
+    }
+  }
+  db.CommitTransaction();
+}
+
+auto PeakRssMb() -> double {
+  rusage usage{};
+  getrusage(RUSAGE_SELF, &usage);
+  return static_cast<double>(usage.ru_maxrss) / 1024.0;
+}
+
+template <typename Fn>
+void Measure(std::string_view name, Fn&& fn) {
+  const auto start = std::chrono::steady_clock::now();
+  const SetOperationResult result = fn();
+  const double seconds = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+  std::cout << name << ": " << seconds << " s, output "
+            << result.output_count << ", peak rss " << PeakRssMb()
+            << " MB\n";
+}
+
+}  // namespace
+
+// 用法: avlib_set_algebra_bench [行数，默认 10000000] [数据目录]
+// 两个库各 N 行、重叠一半；数据目录下已有同规模的库时直接复用
+auto main(int argc, char** argv) -> int {
+  const size_t rows =
+      (argc > 1) ? static_cast<size_t>(std::strtoull(argv[1], nullptr, 10))
+                 : 10000000;
+  const std::filesystem::path dir =
+      (argc > 2) ? std::filesystem::path(argv[2])
+                 : std::filesystem::temp_directory_path() / "avlib_set_bench";
+  std::filesystem::create_directories(dir);
+
+  const auto generate_start = std::chrono::steady_clock::now();
+  Generate(dir / "a.sqlite3", 0, rows);
+  Generate(dir / "b.sqlite3", rows / 2, rows);
+  std::cout << "inputs ready: "
+            << std::chrono::duration<double>(
+                   std::chrono::steady_clock::now() - generate_start)
+                   .count()
+            << " s, peak rss " << PeakRssMb() << " MB\n";
+
+  Application app(std::make_unique<DatabaseManager>(dir.string()));
+  const std::vector<std::string> inputs{"a.sqlite3", "b.sqlite3"};
+  const std::filesystem::path out_file = dir / "out.txt";
+  const std::filesystem::path out_db = dir / "out.sqlite3";
+
+  struct Case {
+    std::string_view name;
+    SetOperation operation;
+  };
+  constexpr Case kCases[] = {{"union", SetOperation::kUnion},
+                             {"intersect", SetOperation::kIntersect},
+                             {"difference", SetOperation::kDifference}};
+  for (const Case& c : kCases) {
+    Measure(std::string(c.name) + " -> file", [&] {
+      return app.PerformSetOperationToFile(c.operation, inputs,
+                                           out_file.string());
+    });
+    std::filesystem::remove(out_db);
+    Measure(std::string(c.name) + " -> db", [&] {
+      return app.PerformSetOperationToDatabase(c.operation, inputs, "out");
+    });
+    std::filesystem::remove(out_db);
+  }
+  std::filesystem::remove(out_file);
+  return 0;
+}
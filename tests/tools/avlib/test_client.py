@@ -0,0 +1,35 @@
+from pathlib import Path
+
+import pytest
+
+from tools.avlib.client import AvLibDatabase, AvLibError, Outcome, find_library, load_library
+
+pytestmark = pytest.mark.skipif(find_library() is None, reason="libavlib is not built")
+
+
+def test_add_then_query_reports_outcome_per_line(tmp_path: Path) -> None:
+    db_path = tmp_path / "lib.sqlite3"
+    with AvLibDatabase(db_path, create=True) as db:
+        assert db.add_many(["ABC-123", "ABC123", "bad_id", ""]) == [
+            Outcome.ADDED,
+            Outcome.EXISTS,
+            Outcome.INVALID,
+            Outcome.SKIPPED,
+        ]
+        assert db.exists_many(["ABC 123", "XYZ-1"]) == [Outcome.FOUND, Outcome.MISSING]
+        assert db.count() == 1
+        assert list(db.iter_ids()) == ["ABC123"]
+
+
+def test_raw_interface_grows_small_outcome_buffer(tmp_path: Path) -> None:
+    with AvLibDatabase(tmp_path / "lib.sqlite3", create=True) as db:
+        db.add_many(["ABC-1"])
+        outcomes = bytearray(1)
+        assert db.exists_raw(b"ABC1\nXYZ2\nbad_id", outcomes) == 3
+        assert list(outcomes) == [Outcome.FOUND, Outcome.MISSING, Outcome.INVALID]
+
+
+def test_missing_database_raises(tmp_path: Path) -> None:
+    with pytest.raises(AvLibError) as error:
+        AvLibDatabase(tmp_path / "missing.sqlite3", library=load_library())
+    assert error.value.status == 2
@@ -0,0 +1,3 @@
+from .client import AvLibDatabase, AvLibError, Outcome, load_library
+
+__all__ = ["AvLibDatabase", "AvLibError", "Outcome", "load_library"]
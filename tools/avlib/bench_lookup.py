@@ -0,0 +1,89 @@
+"""对比三种“库里有没有这个番号”的调用方式的延迟：
+
+1. subprocess：每次检查启动一次 MyAVLib_Cmd（现有做法）
+2. ctypes 单条：进程内经 libavlib 每次查询一个 ID
+3. ctypes 批量：进程内一次查询一批 ID
+
+用法：
+    python -m tools.avlib.bench_lookup --exe out/bin/MyAVLib_Cmd --db database.sqlite3
+库文件取可执行文件旁 data/ 目录下的同名库，保证两种方式查询的是同一个库。
+"""
+
+from __future__ import annotations
+
+import argparse
+import random
+import statistics
+import subprocess
+import time
+from pathlib import Path
+from typing import Callable
+
+from .client import AvLibDatabase, load_library
+
+
+def _percentile(samples: list[float], fraction: float) -> float:
+    ordered = sorted(samples)
+    return ordered[min(len(ordered) - 1, int(fraction * len(ordered)))]
+
+
+def _measure(name: str, ids: list[str], check: Callable[[str], object]) -> None:
+    latencies: list[float] = []
+    for raw_id in ids:
+        start = time.perf_counter()
+        check(raw_id)
+        latencies.append(time.perf_counter() - start)
+    print(
+        f"{name:<22} p50 {statistics.median(latencies) * 1e6:10.1f} us"
+        f"  p99 {_percentile(latencies, 0.99) * 1e6:10.1f} us"
+        f"  total {sum(latencies):8.3f} s  ({len(ids)} ids)"
+    )
+
+
+def _make_ids(count: int) -> list[str]:
+    rng = random.Random(7)
+    letters = "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+    return [
+        "".join(rng.choice(letters) for _ in range(rng.randint(2, 5))) + f"-{rng.randint(1, 999):03d}"
+        for _ in range(count)
+    ]
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description="libavlib 与子进程方式的查询延迟对比")
+    parser.add_argument("--exe", default="out/bin/MyAVLib_Cmd", help="MyAVLib_Cmd 可执行文件")
+    parser.add_argument("--lib", default=None, help="libavlib 路径（默认自动查找）")
+    parser.add_argument("--db", default="database.sqlite3", help="data 目录下的库名")
+    parser.add_argument("--samples", type=int, default=200, help="subprocess 方式的查询次数")
+    parser.add_argument("--batch", type=int, default=100_000, help="ctypes 方式的 ID 数量")
+    args = parser.parse_args()
+
+    exe = Path(args.exe).resolve()
+    db_path = exe.parent / "data" / args.db
+    library = load_library(args.lib)
+    ids = _make_ids(max(args.samples, args.batch))
+
+    _measure(
+        "subprocess per id",
+        ids[: args.samples],
+        lambda raw_id: subprocess.run(
+            [str(exe), "--db", args.db, "query", raw_id], capture_output=True, check=True
+        ),
+    )
+    with AvLibDatabase(db_path, library=library) as db:
+        _measure("ctypes per id", ids[: args.batch], db.exists)
+
+        joined = "\n".join(ids[: args.batch]).encode("utf-8")
+        outcomes = bytearray(args.batch)
+        start = time.perf_counter()
+        db.exists_raw(joined, outcomes)
+        elapsed = time.perf_counter() - start
+        print(
+            f"{'ctypes batch':<22} {elapsed / args.batch * 1e6:10.3f} us/id"
+            f"  total {elapsed:8.3f} s  ({args.batch} ids)"
+        )
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
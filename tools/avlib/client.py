@@ -0,0 +1,194 @@
+"""libavlib 的 ctypes 封装：进程内批量查询/添加，无需启动 MyAVLib_Cmd。
+
+ID 批量以 b"\\n".join(...) 的一块字节缓冲区传入，结果写入 bytearray，
+C 侧直接读写这两块内存，不做逐个 ID 的转换。
+"""
+
+from __future__ import annotations
+
+import ctypes
+import os
+import sys
+from enum import IntEnum
+from pathlib import Path
+from typing import Iterator, Sequence
+
+API_VERSION = 1
+
+OPEN_CREATE = 0x1
+OPEN_HASH_INDEX = 0x2
+OPEN_SNAPSHOT = 0x4
+
+_STATUS_OK = 0
+_STATUS_BUFFER_TOO_SMALL = 4
+
+REPO_ROOT = Path(__file__).resolve().parent.parent.parent
+
+
+class Outcome(IntEnum):
+    """与 avlib_id_outcome 一致。"""
+
+    SKIPPED = 0
+    INVALID = 1
+    ADDED = 2
+    EXISTS = 3
+    FOUND = 4
+    MISSING = 5
+
+
+class AvLibError(RuntimeError):
+    def __init__(self, status: int, message: str) -> None:
+        super().__init__(f"avlib error {status}: {message}")
+        self.status = status
+
+
+_VISITOR = ctypes.CFUNCTYPE(
+    ctypes.c_int, ctypes.c_void_p, ctypes.POINTER(ctypes.c_char), ctypes.c_size_t, ctypes.c_size_t
+)
+
+
+def _library_names() -> list[str]:
+    if sys.platform == "win32":
+        return ["libavlib.dll", "avlib.dll"]
+    if sys.platform == "darwin":
+        return ["libavlib.dylib"]
+    return ["libavlib.so"]
+
+
+def find_library() -> Path | None:
+    """依次查找环境变量 AVLIB_LIBRARY 与构建输出目录 out/lib、out/bin。"""
+    override = os.environ.get("AVLIB_LIBRARY")
+    if override:
+        return Path(override)
+    for directory in (REPO_ROOT / "out" / "lib", REPO_ROOT / "out" / "bin"):
+        for name in _library_names():
+            candidate = directory / name
+            if candidate.exists():
+                return candidate
+    return None
+
+
+def load_library(path: str | Path | None = None) -> ctypes.CDLL:
+    resolved = Path(path) if path is not None else find_library()
+    if resolved is None:
+        raise FileNotFoundError("libavlib not found; build the 'avlib' target or set AVLIB_LIBRARY")
+    lib = ctypes.CDLL(str(resolved))
+
+    lib.avlib_api_version.restype = ctypes.c_int
+    lib.avlib_last_error.restype = ctypes.c_char_p
+    lib.avlib_open.argtypes = [ctypes.c_char_p, ctypes.c_uint32, ctypes.POINTER(ctypes.c_void_p)]
+    lib.avlib_open.restype = ctypes.c_int
+    lib.avlib_close.argtypes = [ctypes.c_void_p]
+    lib.avlib_close.restype = None
+    lib.avlib_count.argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.c_uint64)]
+    lib.avlib_count.restype = ctypes.c_int
+    batch_args = [
+        ctypes.c_void_p,
+        ctypes.c_char_p,
+        ctypes.c_size_t,
+        ctypes.c_void_p,
+        ctypes.c_size_t,
+        ctypes.POINTER(ctypes.c_size_t),
+    ]
+    lib.avlib_exists_many.argtypes = batch_args
+    lib.avlib_exists_many.restype = ctypes.c_int
+    lib.avlib_add_many.argtypes = batch_args
+    lib.avlib_add_many.restype = ctypes.c_int
+    lib.avlib_for_each_id.argtypes = [ctypes.c_void_p, _VISITOR, ctypes.c_void_p]
+    lib.avlib_for_each_id.restype = ctypes.c_int
+
+    version = lib.avlib_api_version()
+    if version != API_VERSION:
+        raise AvLibError(-1, f"unsupported libavlib API version {version}")
+    return lib
+
+
+class AvLibDatabase:
+    """一个已打开的库。可作为上下文管理器使用。"""
+
+    def __init__(
+        self,
+        db_path: str | Path,
+        *,
+        create: bool = False,
+        engine: str = "sqlite",
+        library: ctypes.CDLL | None = None,
+    ) -> None:
+        self._lib = library if library is not None else load_library()
+        flags = OPEN_CREATE if create else 0
+        flags |= {"sqlite": 0, "hash": OPEN_HASH_INDEX, "snapshot": OPEN_SNAPSHOT}[engine]
+        handle = ctypes.c_void_p()
+        self._check(self._lib.avlib_open(os.fsencode(db_path), flags, ctypes.byref(handle)))
+        self._handle = handle
+        self._outcomes = bytearray(4096)
+
+    def close(self) -> None:
+        if self._handle:
+            self._lib.avlib_close(self._handle)
+            self._handle = ctypes.c_void_p()
+
+    def __enter__(self) -> AvLibDatabase:
+        return self
+
+    def __exit__(self, *exc_info: object) -> None:
+        self.close()
+
+    def count(self) -> int:
+        value = ctypes.c_uint64()
+        self._check(self._lib.avlib_count(self._handle, ctypes.byref(value)))
+        return value.value
+
+    def exists_many(self, ids: Sequence[str]) -> list[Outcome]:
+        return self._run(self._lib.avlib_exists_many, _join(ids))
+
+    def add_many(self, ids: Sequence[str]) -> list[Outcome]:
+        return self._run(self._lib.avlib_add_many, _join(ids))
+
+    def exists(self, raw_id: str) -> bool:
+        return self.exists_many([raw_id])[0] == Outcome.FOUND
+
+    def exists_raw(self, joined: bytes, outcomes: bytearray) -> int:
+        """零拷贝接口：joined 为以 \\n 分隔的 ID，结果逐字节写入 outcomes，返回 ID 个数。"""
+        return self._run_into(self._lib.avlib_exists_many, joined, outcomes)
+
+    def iter_ids(self) -> Iterator[str]:
+        chunks: list[str] = []
+
+        @_VISITOR
+        def visit(_user: int, data: ctypes.POINTER(ctypes.c_char), size: int, _count: int) -> int:
+            chunks.append(ctypes.string_at(data, size).decode("utf-8"))
+            return 1
+
+        self._check(self._lib.avlib_for_each_id(self._handle, visit, None))
+        for chunk in chunks:
+            yield from chunk.split("\n")
+
+    def _run(self, fn: ctypes._CFuncPtr, joined: bytes) -> list[Outcome]:
+        count = self._run_into(fn, joined, self._outcomes)
+        return [Outcome(value) for value in self._outcomes[:count]]
+
+    def _run_into(self, fn: ctypes._CFuncPtr, joined: bytes, outcomes: bytearray) -> int:
+        count = ctypes.c_size_t()
+        while True:
+            buffer = (ctypes.c_char * len(outcomes)).from_buffer(outcomes)
+            status = fn(self._handle, joined, len(joined), buffer, len(outcomes), ctypes.byref(count))
+            if status != _STATUS_BUFFER_TOO_SMALL:
+                break
+            # 调用方缓冲区不足时按所需大小扩容后重试
+            del buffer
+            outcomes.extend(bytes(count.value - len(outcomes)))
+        self._check(status)
+        return count.value
+
+    def _check(self, status: int) -> None:
+        if status != _STATUS_OK:
+            message = self._lib.avlib_last_error() or b""
+            raise AvLibError(status, message.decode("utf-8", errors="replace"))
+
+
+def _join(ids: Sequence[str]) -> bytes:
+    joined = "\n".join(ids)
+    if ids and ids[-1] == "":
+        # 末尾换行会被当作结束符，空 ID 在末尾时需再补一个换行
+        joined += "\n"
+    return joined.encode("utf-8")